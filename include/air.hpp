@@ -0,0 +1,137 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include "EZ-Template/piston.hpp"
+
+/*! \namespace air
+ *  \brief Keeps track of the air left in the tank from every piston move
+ *
+ *  It has the ability to:
+ *
+ *      -count the moves of each piston and the air each one takes from its bore and stroke
+ *
+ *      -estimate the tank pressure as it is used and leaks, and predict it a while ahead
+ *
+ *      -warn when the pressure is running low or is low
+ *
+ *  There is no pressure sensor, so it is all worked out from the moves. Every piston move has to go through
+ *  air::set() to be counted. Each move fills one side of the cylinder from the tank and the other side is
+ *  vented, the tank and cylinder settle to the same pressure at a constant temperature.
+ */
+namespace air{
+
+    /*!
+    * \brief warning levels, in order
+    */
+    enum Warning{
+        NONE = 0,
+        RUNNING_LOW = 1,   // predicted to be low within WARN_S at the rate it has been used
+        TOO_LOW = 2        // under LOW_PSI now
+    };
+
+    /*!
+    * \brief one piston and what it has used
+    */
+    struct Cylinder{
+        const char* name = "";
+        ez::Piston* piston = nullptr;
+        double bore = 0;          // in
+        double stroke = 0;        // in
+        double rod = 0;           // in, 0 for a single acting cylinder that springs back
+        int cylinders = 1;        // cylinders moved by this piston
+        int extends = 0;
+        int retracts = 0;
+        double used = 0;          // in^3 of cylinder filled
+    };
+
+    /*!
+    * \brief atmospheric pressure in psi
+    */
+    inline const double ATMOSPHERE_PSI = 14.7;
+
+    /*!
+    * \brief under this the pistons don't move with full force, in psi
+    */
+    inline const double LOW_PSI = 50;
+
+    /*!
+    * \brief how far ahead the running low warning looks, in seconds
+    */
+    inline const double WARN_S = 20;
+
+    /*!
+    * \brief describe the tank, call once in initialize()
+    * \param volume_in3 the air tanks together, in cubic inches
+    * \param start_psi pressure it is pumped to before a match
+    * \param leak_psi_per_min how fast it drops with nothing moving
+    */
+    void tank_set(double volume_in3, double start_psi, double leak_psi_per_min = 0);
+
+    /*!
+    * \brief add a piston to count
+    * \param name name used when reporting, must outlive the program
+    * \param piston the referenced piston
+    * \param bore_in bore of the cylinder
+    * \param stroke_in stroke of the cylinder
+    * \param rod_in rod diameter of a double acting cylinder, 0 if it springs back and only uses air going out
+    * \param cylinders how many cylinders the piston moves
+    */
+    void add(const char* name, ez::Piston& piston, double bore_in, double stroke_in, double rod_in = 0, int cylinders = 1);
+
+    /*!
+    * \brief move a piston and count the air it takes, nothing is used if it is already there
+    * \param piston the referenced piston
+    * \param out true to extend
+    */
+    void set(ez::Piston& piston, bool out);
+
+    /*!
+    * \brief the tank was pumped back up, every count starts over, done at the start of autonomous and of opcontrol
+    * off the field
+    */
+    void reset();
+
+    /*!
+    * \brief the estimated tank pressure now, in psi
+    */
+    double pressure();
+
+    /*!
+    * \brief the tank pressure predicted a while from now at the rate it has been used, in psi
+    * \param seconds how far ahead
+    */
+    double predict(double seconds);
+
+    /*!
+    * \brief moves of the average piston left before the pressure is under LOW_PSI
+    */
+    int moves_left();
+
+    /*!
+    * \brief the current warning level
+    */
+    Warning warning();
+
+    /*!
+    * \brief called when the warning level goes up, from the task that moved the piston
+    * \param callback gets the new level and the pressure, must not block
+    */
+    void on_warning(std::function<void(Warning warning, double psi)> callback);
+
+    /*!
+    * \brief the number of pistons added
+    */
+    int count();
+
+    /*!
+    * \brief one piston and what it has used
+    * \param index from 0 to count() - 1
+    */
+    Cylinder get(int index);
+
+    /*!
+    * \brief the name of a warning level
+    */
+    const char* warning_to_string(Warning warning);
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "api.h"
+
+/*! \namespace alloc
+ *  \brief Counts heap allocations, to drive the control path to none and keep it there
+ *
+ *  It has the ability to:
+ *
+ *      -count every operator new by the task that made it and the labelled region it was made in
+ *
+ *      -mark tasks hot, and once armed flag every allocation a hot task makes, or stop the program
+ *       on the first one so the abort screen or the debugger shows where it came from
+ *
+ *  It replaces the global operator new and delete. On the brain that reaches everything linked into
+ *  the hot image: our code and every template it instantiates, like the vectors built at a pid_odom_set
+ *  call. EZ-Template's own allocations are inside the cold package and are only counted in the sim,
+ *  or with EZ-Template.a added to EXCLUDE_COLD_LIBRARIES in the Makefile.
+ *
+ *  Counting and flagging never allocate or block, so it is safe in any task.
+ */
+namespace alloc{
+
+    /*!
+    * \brief what an allocation does
+    */
+    enum Mode{
+        OFF = 0,      // nothing, new is malloc
+        COUNT = 1,    // counted by task and region
+        FLAG = 2,     // counted, and one in a hot task is a violation
+        TRAP = 3      // counted, and the first violation stops the program
+    };
+
+    /*!
+    * \brief the most tasks and regions counted, allocations past them only go in the totals
+    */
+    inline const int MAX_TASKS = 12;
+    inline const int MAX_REGIONS = 16;
+
+    /*!
+    * \brief allocations made by a task or in a region
+    */
+    struct Counts{
+        const char* name = "";
+        std::uint32_t allocations = 0;
+        std::uint32_t bytes = 0;
+        std::uint32_t violations = 0;     // allocations while armed in a hot task
+        bool hot = false;                 // tasks only
+    };
+
+    /*!
+    * \brief the last violation
+    */
+    struct Violation{
+        const char* task = "";
+        const char* region = "";      // "" outside every region
+        std::uint32_t size = 0;
+        std::uint32_t time = 0;       // millis
+    };
+
+    /*!
+    * \brief set what an allocation does
+    */
+    void mode_set(Mode mode);
+
+    Mode mode_get();
+
+    /*!
+    * \brief mark the calling task hot, it must not allocate once armed
+    */
+    void hot();
+
+    /*!
+    * \brief mark a task hot, for tasks that aren't ours like chassis.ez_auto
+    */
+    void hot(pros::Task task);
+
+    /*!
+    * \brief zero every count, the tasks, regions and hot marks are kept
+    */
+    void reset();
+
+    /*!
+    * \brief allocations, frees and violations since the last reset(), every task together
+    */
+    std::uint32_t allocations();
+    std::uint32_t frees();
+    std::uint32_t violations();
+
+    /*!
+    * \brief the last violation since the last reset()
+    */
+    Violation last_violation();
+
+    /*!
+    * \brief the counts of each task, ids go from 0 to task_count() - 1
+    */
+    Counts task(int id);
+    int task_count();
+
+    /*!
+    * \brief the counts of each region, ids go from 0 to region_count() - 1
+    */
+    Counts region(int id);
+    int region_count();
+
+    /*!
+    * \brief counts what the calling task allocates in its lifetime under name, use ALLOC_REGION
+    */
+    class Region{
+        public:
+        explicit Region(const char* name);
+        ~Region();
+
+        private:
+        int previous;
+    };
+}
+
+#define ALLOC_CONCAT_INNER(a, b) a##b
+#define ALLOC_CONCAT(a, b) ALLOC_CONCAT_INNER(a, b)
+
+/*!
+* \brief count the allocations in the rest of the enclosing scope under name, a string literal
+*/
+#define ALLOC_REGION(name) alloc::Region ALLOC_CONCAT(alloc_region_, __LINE__)(name)
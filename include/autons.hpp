@@ -1,6 +1,7 @@
 #pragma once
 
 void default_constants();
+void warm_paths();
 
 void drive_example();
 void turn_example();
@@ -17,6 +18,8 @@ void odom_boomerang_example();
 void odom_boomerang_injected_pure_pursuit_example();
 void measure_offsets();
 void measure_dsr_offsets();
+void tune_long_goal();
+void tune_middle_goal();
 
 void test();
 
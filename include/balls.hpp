@@ -0,0 +1,180 @@
+#pragma once
+
+#include <cstdint>
+#include "control_loop.hpp"
+
+/*! \namespace balls
+ *  \brief Tracks the balls inside the robot from the optical sensor in the intake path
+ *
+ *  It has the ability to:
+ *
+ *      -see a ball and its color at the sensor, read every control tick with the shortest integration time
+ *
+ *      -keep a queue of the balls inside with where each one is, moved along by the outtake's speed
+ *
+ *      -throw out balls of the other alliance's color at the right moment, by reversing the outtake or
+ *       firing the Middle or LowScore piston
+ *
+ *      -count balls in the robot and balls out of the top, and the balls per second going out
+ *
+ *  Everything runs inside the control loop and never blocks. Positions are inches along the path,
+ *  0 is the optical sensor and EXIT_IN is where a ball leaves the top of the robot.
+ */
+namespace balls{
+
+    /*!
+    * \brief the color of a ball
+    */
+    enum Color{
+        NONE = 0,   // couldn't tell, it is kept whatever the alliance
+        RED = 1,
+        BLUE = 2
+    };
+
+    /*!
+    * \brief how balls of the wrong color are thrown out
+    */
+    enum Eject{
+        OFF = 0,
+        OUTTAKE_REVERSE = 1,  // reverse the outtake so the ball drops back out
+        MIDDLE = 2,           // fire the Middle piston so the ball goes out the middle
+        LOW_SCORE = 3         // fire the LowScore piston so the ball goes out the bottom
+    };
+
+    /*!
+    * \brief one ball in the robot
+    */
+    struct Ball{
+        Color color = NONE;
+        double position = 0;        // inches past the sensor
+        std::uint32_t seen = 0;     // millis it reached the sensor
+    };
+
+    /*!
+    * \brief the most balls the queue holds, it is only a few more than fit in the robot
+    */
+    inline const int MAX_BALLS = 8;
+
+    /*!
+    * \brief proximity at or over this is a ball in front of the sensor, 0 to 255
+    */
+    inline const int PROXIMITY_BALL = 150;
+
+    /*!
+    * \brief hues of a red ball wrap around 0, this far either side of it
+    */
+    inline const double RED_HUE = 30;
+
+    /*!
+    * \brief hues of a blue ball, from and to
+    */
+    inline const double BLUE_HUE_LOW = 180;
+    inline const double BLUE_HUE_HIGH = 260;
+
+    /*!
+    * \brief inches a ball moves per outtake revolution, measure it on the robot
+    */
+    inline const double INCHES_PER_REV = 1.4;
+
+    /*!
+    * \brief roller rpm either way that counts as stopped, a coasting motor doesn't read exactly 0
+    */
+    inline const double STILL_RPM = 5;
+
+    /*!
+    * \brief where a wrong ball is thrown out and where balls leave the top, inches past the sensor
+    */
+    inline const double EJECT_IN = 6;
+    inline const double EXIT_IN = 9;
+
+    /*!
+    * \brief how long the outtake reverses or the piston stays out to throw one ball, in ms
+    */
+    inline const int EJECT_MS = 150;
+
+    /*!
+    * \brief balls per second is counted over this window, in ms
+    */
+    inline const std::uint32_t THROUGHPUT_MS = 2000;
+
+    /*!
+    * \brief set up the sensor and add the tracker to the control loop, call before ctrl::start()
+    */
+    void start();
+
+    /*!
+    * \brief runs the tracker, called by the control loop every tick
+    * \param sample the sample from this tick's sense stage
+    */
+    void tick(const ctrl::Sample& sample);
+
+    /*!
+    * \brief our color, balls of the other color are thrown out, NONE keeps all of them
+    */
+    void alliance_set(Color color);
+
+    /*!
+    * \brief our color
+    */
+    Color alliance_get();
+
+    /*!
+    * \brief keep our color on the sd card, so a brain that restarts between matches still has it
+    * \return false if it couldn't be written
+    */
+    bool alliance_save(const char* file);
+
+    /*!
+    * \brief set our color from a file alliance_save() wrote
+    * \return false if there's no such file, the color is left alone
+    */
+    bool alliance_load(const char* file);
+
+    /*!
+    * \brief how balls of the wrong color are thrown out
+    */
+    void eject_set(Eject eject);
+
+    /*!
+    * \brief forget every ball, for a robot that was emptied by hand
+    */
+    void clear();
+
+    /*!
+    * \brief balls inside the robot
+    */
+    int ball_count();
+
+    /*!
+    * \brief a ball in the robot
+    * \param index 0 is the one furthest along
+    */
+    Ball get(int index);
+
+    /*!
+    * \brief balls that went out of the top since the program started
+    */
+    int scored();
+
+    /*!
+    * \brief balls of the wrong color thrown out since the program started
+    */
+    int ejected();
+
+    /*!
+    * \brief balls per second out of the top over the last THROUGHPUT_MS
+    */
+    double throughput();
+
+    /*!
+    * \brief wait until a wrong colored ball is about to go out of the top, or the time runs out
+    * \param timeout_ms longest to wait
+    * \return true if a wrong ball got there
+    */
+    bool wait_wrong_color(int timeout_ms);
+
+    /*!
+    * \brief the name of a color
+    */
+    const char* color_to_string(Color color);
+}
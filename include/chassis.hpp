@@ -0,0 +1,442 @@
+#pragma once
+
+#include <cstdint>
+#include <initializer_list>
+#include <span>
+#include <utility>
+#include <vector>
+#include "EZ-Template/api.hpp"
+#include "alloc.hpp"
+#include "path.hpp"
+#include "settle.hpp"
+
+class DSRDS;
+
+/*!
+* \class Chassis
+* \brief ez::Drive with the calls our autons make routed through our own code.
+*
+* Constructed exactly like ez::Drive. Only the functions declared here behave differently,
+* everything else is plain EZ-Template.
+*
+* Every motion set and wait is passed to the profiler. The motion setters take the same arguments as
+* EZ-Template's. Overloads whose first argument is usually written in braces are spelled out, because
+* a braced list can't be forwarded through a template.
+*/
+class Chassis : public ez::Drive{
+    public:
+
+    using ez::Drive::Drive;
+
+    /*!
+    * \brief ez::Drive::initialize(), then reserves the path buffers
+    */
+    void initialize();
+
+    /*!
+    * \brief sets EZ-Template's smoothing constants and the ones our paths are smoothed with
+    */
+    void odom_path_smooth_constants_set(double weight_smooth, double weight_data, double tolerance);
+
+    /*!
+    * \brief caches the path of a pure pursuit motion ahead of it, so the motion only looks it up
+    *
+    * The waypoints, spacing and smoothing constants have to be exactly the motion's. Call it in
+    * initialize() or competition_initialize(), not while a path is being followed.
+    *
+    * \param build path::SMOOTH for pid_odom_set and pid_odom_smooth_pp_set, path::INJECT for
+    *        pid_odom_injected_pp_set, path::RAW for pid_odom_pp_set
+    * \param movements the motion's waypoints
+    * \return false if the cache is full
+    */
+    bool path_warm(path::Build build, std::span<const ez::odom> movements);
+    bool path_warm(path::Build build, std::span<const ez::united_odom> movements);
+    bool path_warm(path::Build build, std::initializer_list<ez::odom> movements);
+    bool path_warm(path::Build build, std::initializer_list<ez::united_odom> movements);
+
+    /*!
+    * \brief the paths pure pursuit motions follow, with their cache and timing
+    */
+    path::Path paths;
+
+    /*!
+    * \brief how drive_push() ended
+    */
+    struct Push{
+        enum Exit{
+            CONTACT = 0,    // the robot stalled against something
+            TIMEOUT = 1     // the time ran out first
+        };
+        Exit exit = TIMEOUT;
+        std::uint32_t time = 0;       // ms from the start of the push to contact or the timeout
+        double wall_distance = -1;    // in from the robot's center to the wall, from the DSR sensor facing the push, -1 without one
+        double wall_angle = 0;        // deg the robot is turned off square to the wall, from two DSR sensors facing the push, the imu without them
+    };
+
+    /*!
+    * \brief sets the chassis to voltage on the next control tick
+    *
+    * PID is disabled right away so a motion set after this call still wins, the voltage itself
+    * is written in the actuate stage of the control loop.
+    *
+    * \param left voltage for left side, -127 to 127
+    * \param right voltage for right side, -127 to 127
+    */
+    void drive_set(int left, int right);
+
+    /*!
+    * \brief drive at a voltage until the robot stalls against something, instead of for a fixed time
+    *
+    * Contact needs the drive to have slowed down and one of: drive current up, a jolt on the imu
+    * or the DSR sensor facing the push inside wall_in. It has to hold for PUSH_CONFIRM_MS. Nothing is
+    * checked for the first PUSH_SPINUP_MS, while the drive is still getting going.
+    *
+    * \param power voltage for both sides, -127 to 127, negative pushes backwards
+    * \param timeout_ms the push ends here with or without contact
+    * \param hold_power voltage kept on after contact to hold pressure, 0 stops the drive
+    * \param wall_in DSR range that counts as touching, in inches, 0 doesn't use DSR
+    */
+    Push drive_push(int power, int timeout_ms, int hold_power = 0, double wall_in = 0);
+
+    /*!
+    * \brief contact has to hold this long, in ms
+    */
+    inline static const std::uint32_t PUSH_CONFIRM_MS = 60;
+
+    /*!
+    * \brief contact isn't checked this long into a push, in ms
+    */
+    inline static const std::uint32_t PUSH_SPINUP_MS = 150;
+
+    /*!
+    * \brief the drive has slowed once under this fraction of the fastest it went during the push
+    */
+    inline static const double PUSH_SLOW_FRACTION = 0.3;
+
+    /*!
+    * \brief the drive has slowed once under this too, in rpm, for pushes that start against something
+    */
+    inline static const double PUSH_SLOW_RPM = 10;
+
+    /*!
+    * \brief drive current is up over this fraction of its stall current at the push voltage
+    */
+    inline static const double PUSH_CURRENT_FRACTION = 0.6;
+
+    /*!
+    * \brief an imu jolt bigger than this is a hit, in g
+    */
+    inline static const double PUSH_JOLT_G = 0.5;
+
+    /*!
+    * \brief lock the code in a while loop until the robot has settled
+    *
+    * Drive, turn and swing motions exit on EZ-Template's exit conditions or on the settle detector,
+    * whichever is first. Odom motions use EZ-Template's pid_wait() and their exit is recorded as settle::UNKNOWN.
+    * Every call leaves a settle::Record.
+    */
+    void pid_wait();
+
+    template <typename... Params>
+    void pid_drive_set(Params&&... params){
+        ez::Drive::pid_drive_set(std::forward<Params>(params)...);
+        profile_set("pid_drive_set");
+    }
+
+    template <typename... Params>
+    void pid_turn_set(Params&&... params){
+        ez::Drive::pid_turn_set(std::forward<Params>(params)...);
+        profile_set("pid_turn_set");
+    }
+    template <typename... Params>
+    void pid_turn_set(ez::pose target, Params&&... params){
+        ez::Drive::pid_turn_set(target, std::forward<Params>(params)...);
+        profile_set("pid_turn_set");
+    }
+    template <typename... Params>
+    void pid_turn_set(ez::united_pose target, Params&&... params){
+        ez::Drive::pid_turn_set(target, std::forward<Params>(params)...);
+        profile_set("pid_turn_set");
+    }
+
+    template <typename... Params>
+    void pid_turn_relative_set(Params&&... params){
+        ez::Drive::pid_turn_relative_set(std::forward<Params>(params)...);
+        profile_set("pid_turn_relative_set");
+    }
+
+    template <typename... Params>
+    void pid_swing_set(Params&&... params){
+        ez::Drive::pid_swing_set(std::forward<Params>(params)...);
+        profile_set("pid_swing_set");
+    }
+
+    template <typename... Params>
+    void pid_swing_relative_set(Params&&... params){
+        ez::Drive::pid_swing_relative_set(std::forward<Params>(params)...);
+        profile_set("pid_swing_relative_set");
+    }
+
+    template <typename... Params>
+    void pid_odom_set(Params&&... params){
+        ALLOC_REGION("pid_odom_set");
+        ez::Drive::pid_odom_set(std::forward<Params>(params)...);
+        profile_set("pid_odom_set");
+    }
+    template <typename... Params>
+    void pid_odom_set(ez::odom movement, Params&&... params){
+        ALLOC_REGION("pid_odom_set");
+        ez::Drive::pid_odom_set(movement, std::forward<Params>(params)...);
+        profile_set("pid_odom_set");
+    }
+    template <typename... Params>
+    void pid_odom_set(ez::united_odom movement, Params&&... params){
+        ALLOC_REGION("pid_odom_set");
+        ez::Drive::pid_odom_set(movement, std::forward<Params>(params)...);
+        profile_set("pid_odom_set");
+    }
+    template <typename... Params>
+    void pid_odom_set(std::span<const ez::odom> movements, Params&&... params){
+        if(movements.size() == 1){
+            pid_odom_set(movements.front(), std::forward<Params>(params)...);
+        }else{
+            path_set("pid_odom_set", path::SMOOTH, movements, std::forward<Params>(params)...);
+        }
+    }
+    template <typename... Params>
+    void pid_odom_set(std::initializer_list<ez::odom> movements, Params&&... params){
+        pid_odom_set(std::span<const ez::odom>(movements.begin(), movements.size()), std::forward<Params>(params)...);
+    }
+    template <typename... Params>
+    void pid_odom_set(std::vector<ez::odom> movements, Params&&... params){
+        pid_odom_set(std::span<const ez::odom>(movements), std::forward<Params>(params)...);
+    }
+    template <typename... Params>
+    void pid_odom_set(std::span<const ez::united_odom> movements, Params&&... params){
+        if(movements.size() == 1){
+            pid_odom_set(movements.front(), std::forward<Params>(params)...);
+        }else{
+            path_set("pid_odom_set", path::SMOOTH, movements, std::forward<Params>(params)...);
+        }
+    }
+    template <typename... Params>
+    void pid_odom_set(std::initializer_list<ez::united_odom> movements, Params&&... params){
+        pid_odom_set(std::span<const ez::united_odom>(movements.begin(), movements.size()), std::forward<Params>(params)...);
+    }
+    template <typename... Params>
+    void pid_odom_set(std::vector<ez::united_odom> movements, Params&&... params){
+        pid_odom_set(std::span<const ez::united_odom>(movements), std::forward<Params>(params)...);
+    }
+    template <std::size_t N, typename... Params>
+    void pid_odom_set(const ez::united_odom (&movements)[N], Params&&... params){
+        pid_odom_set(std::span<const ez::united_odom>(movements), std::forward<Params>(params)...);
+    }
+
+    template <typename... Params>
+    void pid_odom_ptp_set(ez::odom movement, Params&&... params){
+        ALLOC_REGION("pid_odom_ptp_set");
+        ez::Drive::pid_odom_ptp_set(movement, std::forward<Params>(params)...);
+        profile_set("pid_odom_ptp_set");
+    }
+    template <typename... Params>
+    void pid_odom_ptp_set(ez::united_odom movement, Params&&... params){
+        ALLOC_REGION("pid_odom_ptp_set");
+        ez::Drive::pid_odom_ptp_set(movement, std::forward<Params>(params)...);
+        profile_set("pid_odom_ptp_set");
+    }
+
+    template <typename... Params>
+    void pid_odom_boomerang_set(ez::odom movement, Params&&... params){
+        ALLOC_REGION("pid_odom_boomerang_set");
+        ez::Drive::pid_odom_boomerang_set(movement, std::forward<Params>(params)...);
+        profile_set("pid_odom_boomerang_set");
+    }
+    template <typename... Params>
+    void pid_odom_boomerang_set(ez::united_odom movement, Params&&... params){
+        ALLOC_REGION("pid_odom_boomerang_set");
+        ez::Drive::pid_odom_boomerang_set(movement, std::forward<Params>(params)...);
+        profile_set("pid_odom_boomerang_set");
+    }
+
+    template <typename... Params>
+    void pid_odom_pp_set(std::span<const ez::odom> movements, Params&&... params){
+        path_set("pid_odom_pp_set", path::RAW, movements, std::forward<Params>(params)...);
+    }
+    template <typename... Params>
+    void pid_odom_pp_set(std::initializer_list<ez::odom> movements, Params&&... params){
+        pid_odom_pp_set(std::span<const ez::odom>(movements.begin(), movements.size()), std::forward<Params>(params)...);
+    }
+    template <typename... Params>
+    void pid_odom_pp_set(std::vector<ez::odom> movements, Params&&... params){
+        pid_odom_pp_set(std::span<const ez::odom>(movements), std::forward<Params>(params)...);
+    }
+    template <typename... Params>
+    void pid_odom_pp_set(std::span<const ez::united_odom> movements, Params&&... params){
+        path_set("pid_odom_pp_set", path::RAW, movements, std::forward<Params>(params)...);
+    }
+    template <typename... Params>
+    void pid_odom_pp_set(std::initializer_list<ez::united_odom> movements, Params&&... params){
+        pid_odom_pp_set(std::span<const ez::united_odom>(movements.begin(), movements.size()), std::forward<Params>(params)...);
+    }
+    template <typename... Params>
+    void pid_odom_pp_set(std::vector<ez::united_odom> movements, Params&&... params){
+        pid_odom_pp_set(std::span<const ez::united_odom>(movements), std::forward<Params>(params)...);
+    }
+
+    template <typename... Params>
+    void pid_odom_injected_pp_set(std::span<const ez::odom> movements, Params&&... params){
+        path_set("pid_odom_injected_pp_set", path::INJECT, movements, std::forward<Params>(params)...);
+    }
+    template <typename... Params>
+    void pid_odom_injected_pp_set(std::initializer_list<ez::odom> movements, Params&&... params){
+        pid_odom_injected_pp_set(std::span<const ez::odom>(movements.begin(), movements.size()), std::forward<Params>(params)...);
+    }
+    template <typename... Params>
+    void pid_odom_injected_pp_set(std::vector<ez::odom> movements, Params&&... params){
+        pid_odom_injected_pp_set(std::span<const ez::odom>(movements), std::forward<Params>(params)...);
+    }
+    template <typename... Params>
+    void pid_odom_injected_pp_set(std::span<const ez::united_odom> movements, Params&&... params){
+        path_set("pid_odom_injected_pp_set", path::INJECT, movements, std::forward<Params>(params)...);
+    }
+    template <typename... Params>
+    void pid_odom_injected_pp_set(std::initializer_list<ez::united_odom> movements, Params&&... params){
+        pid_odom_injected_pp_set(std::span<const ez::united_odom>(movements.begin(), movements.size()), std::forward<Params>(params)...);
+    }
+    template <typename... Params>
+    void pid_odom_injected_pp_set(std::vector<ez::united_odom> movements, Params&&... params){
+        pid_odom_injected_pp_set(std::span<const ez::united_odom>(movements), std::forward<Params>(params)...);
+    }
+
+    template <typename... Params>
+    void pid_odom_smooth_pp_set(std::span<const ez::odom> movements, Params&&... params){
+        path_set("pid_odom_smooth_pp_set", path::SMOOTH, movements, std::forward<Params>(params)...);
+    }
+    template <typename... Params>
+    void pid_odom_smooth_pp_set(std::initializer_list<ez::odom> movements, Params&&... params){
+        pid_odom_smooth_pp_set(std::span<const ez::odom>(movements.begin(), movements.size()), std::forward<Params>(params)...);
+    }
+    template <typename... Params>
+    void pid_odom_smooth_pp_set(std::vector<ez::odom> movements, Params&&... params){
+        pid_odom_smooth_pp_set(std::span<const ez::odom>(movements), std::forward<Params>(params)...);
+    }
+    template <typename... Params>
+    void pid_odom_smooth_pp_set(std::span<const ez::united_odom> movements, Params&&... params){
+        path_set("pid_odom_smooth_pp_set", path::SMOOTH, movements, std::forward<Params>(params)...);
+    }
+    template <typename... Params>
+    void pid_odom_smooth_pp_set(std::initializer_list<ez::united_odom> movements, Params&&... params){
+        pid_odom_smooth_pp_set(std::span<const ez::united_odom>(movements.begin(), movements.size()), std::forward<Params>(params)...);
+    }
+    template <typename... Params>
+    void pid_odom_smooth_pp_set(std::vector<ez::united_odom> movements, Params&&... params){
+        pid_odom_smooth_pp_set(std::span<const ez::united_odom>(movements), std::forward<Params>(params)...);
+    }
+
+    /*!
+    * \brief ez::Drive::pid_wait_quick() that is recorded by the profiler
+    */
+    void pid_wait_quick();
+
+    /*!
+    * \brief ez::Drive::pid_wait_quick_chain() that is recorded by the profiler
+    */
+    void pid_wait_quick_chain();
+
+    template <typename Target>
+    void pid_wait_until(Target target){
+        std::uint32_t start = pros::millis();
+        ez::Drive::pid_wait_until(target);
+        profile_until("pid_wait_until", start);
+    }
+    void pid_wait_until(ez::pose target);
+    void pid_wait_until(ez::united_pose target);
+    void pid_wait_until_point(ez::pose target);
+    void pid_wait_until_point(ez::united_pose target);
+    void pid_wait_until_index(int index);
+    void pid_wait_until_index_started(int index);
+
+    /*!
+    * \brief sets the velocity aware settle for drive motions
+    * \param error error threshold in inches
+    * \param velocity velocity threshold in inches per second
+    * \param hold_ms time both have to stay under their thresholds
+    * \param predict_ms prediction horizon for the early exit, 0 disables it
+    */
+    void pid_drive_settle_set(double error, double velocity, int hold_ms, int predict_ms = 0);
+
+    /*!
+    * \brief sets the velocity aware settle for turn motions
+    * \param error error threshold in degrees
+    * \param velocity velocity threshold in degrees per second
+    * \param hold_ms time both have to stay under their thresholds
+    * \param predict_ms prediction horizon for the early exit, 0 disables it
+    */
+    void pid_turn_settle_set(double error, double velocity, int hold_ms, int predict_ms = 0);
+
+    /*!
+    * \brief sets the velocity aware settle for swing motions
+    * \param error error threshold in degrees
+    * \param velocity velocity threshold in degrees per second
+    * \param hold_ms time both have to stay under their thresholds
+    * \param predict_ms prediction horizon for the early exit, 0 disables it
+    */
+    void pid_swing_settle_set(double error, double velocity, int hold_ms, int predict_ms = 0);
+
+    private:
+
+    SettleDetector drive_settle;
+
+    path::Smoothing smoothing;
+
+    /*!
+    * \brief builds a path from the robot's pose and starts pure pursuit along it
+    */
+    template <typename Movement, typename... Params>
+    void path_set(const char* call, path::Build build, std::span<const Movement> movements, Params&&... params){
+        ALLOC_REGION(call);
+        if(movements.empty()){
+            return;
+        }
+        ez::Drive::pid_odom_pp_set(paths.build(build, odom_pose_get(), movements, odom_path_spacing_get(), smoothing), std::forward<Params>(params)...);
+        profile_set(call);
+    }
+
+    /*!
+    * \brief write the drive voltage now or through the control loop, without touching PID or the profiler
+    */
+    void voltage_set(int left, int right);
+
+    /*!
+    * \brief deg the robot is turned off square to the wall, from two DSR sensors facing it or the imu without them
+    */
+    double wall_angle(DSRDS* first, DSRDS* second);
+
+    SettleDetector turn_settle;
+    SettleDetector swing_settle;
+
+    /*!
+    * \brief error of the running motion in inches or degrees
+    */
+    double motion_error(ez::e_mode mode);
+
+    /*!
+    * \brief the PID whose exit conditions the running motion uses
+    */
+    ez::PID& motion_pid(ez::e_mode mode);
+
+    /*!
+    * \brief checks EZ-Template's exit conditions the same way ez::Drive::pid_wait() does
+    */
+    settle::Exit ez_exit(ez::e_mode mode, ez::exit_output& left, ez::exit_output& right);
+
+    /*!
+    * \brief starts a profiler step for the motion that was just set
+    */
+    void profile_set(const char* call);
+
+    /*!
+    * \brief adds a profiler step for a wait that returned part way through the motion
+    */
+    void profile_until(const char* call, std::uint32_t start);
+};
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include "EZ-Template/api.hpp"
+#include "roller.hpp"
+
+/*! \namespace ctrl
+ *  \brief The lockstep control loop
+ *
+ *  One high priority task that runs, in order, every tick:
+ *
+ *      -sense: reads every sensor in one batch
+ *
+ *      -estimate: snapshots the odom pose next to the sensor batch
+ *
+ *      -control: runs the subsystem state machines, then the roller controllers and jam state machines
+ *
+ *      -actuate: writes every buffered motor command in one batch
+ *
+ *  EZ-Template's own PID and tracking still run in chassis.ez_auto (it is compiled into EZ-Template.a),
+ *  the loop runs above it (tasks::PRIORITY_CONTROL) so our outputs never wait behind it.
+ */
+namespace ctrl{
+
+    /*!
+    * \brief everything read in one sense stage
+    */
+    struct Sample{
+        std::uint64_t time = 0;   // micros at the start of the sense stage
+        double left = 0;          // left drive sensor in inches
+        double right = 0;         // right drive sensor in inches
+        double imu = 0;           // imu rotation in degrees
+        ez::pose pose = {0, 0, 0};
+    };
+
+    /*!
+    * \brief sense to actuate timing of the loop, all times in microseconds
+    *
+    * Lateness and deadline misses are in the loop's tasks::Stats.
+    */
+    struct Timing{
+        std::uint32_t ticks = 0;
+        std::uint32_t last_tick = 0;      // sense start to actuate end of the last tick
+        std::uint32_t worst_tick = 0;     // worst sense start to actuate end
+    };
+
+    /*!
+    * \brief starts the loop, call once in initialize() after everything is added
+    * \param period_ms the tick period in milliseconds
+    */
+    void start(int period_ms = ez::util::DELAY_TIME);
+
+    /*!
+    * \brief true once start() has been called
+    */
+    bool running();
+
+    /*!
+    * \brief add a roller so it is sensed, watched for jams and actuated every tick
+    * \param roller the referenced roller
+    */
+    void add_roller(Roller& roller);
+
+    /*!
+    * \brief add a state machine to run in the control stage
+    * \param tick called once per tick with the fresh sample
+    */
+    void add_subsystem(std::function<void(const Sample&)> tick);
+
+    /*!
+    * \brief buffer a chassis voltage for the next actuate stage
+    * \param left voltage for left side, -127 to 127
+    * \param right voltage for right side, -127 to 127
+    */
+    void drive_set(int left, int right);
+
+    /*!
+    * \brief the most recent sample
+    */
+    Sample sample();
+
+    /*!
+    * \brief the timing of the loop so far
+    */
+    Timing timing();
+
+    /*!
+    * \brief clears the worst case timing
+    */
+    void timing_reset();
+
+    /*!
+    * \brief period of the loop in milliseconds
+    */
+    inline int period = ez::util::DELAY_TIME;
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstdint>
+#include "pros/misc.hpp"
+
+/*! \namespace driver
+ *  \brief Driver control input, read once a tick and turned into drive commands from lookup tables
+ *
+ *  It has the ability to:
+ *
+ *      -read every stick and button of the master controller once a tick, with presses and releases
+ *       worked out against the last tick so every caller sees the same edges
+ *
+ *      -look the sticks up in tables of EZ-Template's joystick curves, rebuilt only when the curve buttons change them
+ *
+ *      -drive flipped split arcade without writing the drive again when the command hasn't changed
+ *
+ *      -measure the time from reading a moved stick to the drive command it makes
+ *
+ *  Everything is called from the opcontrol task, read() at the top of every iteration.
+ */
+namespace driver{
+
+    /*!
+    * \brief period of the opcontrol loop, in ms
+    */
+    inline const std::uint32_t PERIOD_MS = 5;
+
+    /*!
+    * \brief the controller as it was at the start of this tick
+    */
+    struct Snapshot{
+        std::uint32_t time = 0;       // us when it was read
+        int left_x = 0;
+        int left_y = 0;
+        int right_x = 0;
+        int right_y = 0;
+        std::uint32_t held = 0;       // a bit for each button, from L1
+        std::uint32_t pressed = 0;    // down this tick and up the last
+        std::uint32_t released = 0;   // up this tick and down the last
+    };
+
+    /*!
+    * \brief time from reading a moved stick to the drive command, in us
+    */
+    struct Latency{
+        std::uint32_t last = 0;
+        std::uint32_t max = 0;
+        double average = 0;
+        std::uint32_t samples = 0;
+        std::uint32_t writes = 0;     // drive commands written
+        std::uint32_t skipped = 0;    // drive commands that were already there
+    };
+
+    /*!
+    * \brief read the controller, call once at the top of every opcontrol iteration
+    */
+    void read();
+
+    /*!
+    * \brief the controller as read this tick
+    */
+    const Snapshot& get();
+
+    /*!
+    * \brief true while the button is down
+    */
+    bool held(pros::controller_digital_e_t button);
+
+    /*!
+    * \brief true on the tick the button went down
+    */
+    bool pressed(pros::controller_digital_e_t button);
+
+    /*!
+    * \brief true on the tick the button came up
+    */
+    bool released(pros::controller_digital_e_t button);
+
+    /*!
+    * \brief fill the curve tables from the chassis, done by the first drive call and after the curve buttons
+    */
+    void curves_build();
+
+    /*!
+    * \brief flipped split arcade from this tick's snapshot, the right stick drives and the left stick turns
+    */
+    void arcade_flipped();
+
+    /*!
+    * \brief the drive command last written, 0 inside the joystick threshold, safe to read from any task
+    */
+    int left_command();
+    int right_command();
+
+    /*!
+    * \brief make the next drive call write even if the command hasn't changed, for after something else drove
+    */
+    void outputs_reset();
+
+    /*!
+    * \brief stick to motor latency and drive writes so far
+    */
+    Latency latency();
+}
@@ -63,15 +63,32 @@ class DSRDS{
     double read_raw();
 
     /*!
-    * \brief read from the sensor in inches
+    * \brief read from the sensor in inches, retrying until it gets a valid reading
+    *
+    * Returns -1 right away if the sensor is unplugged.
     */
     double read_raw_in(int time_out = 60000);
 
     /*!
-    * \brief read with offsets applied, used for odom resets
+    * \brief read with offsets applied, used for odom resets, -1 if the sensor is unplugged
     */
     double read(int time_out = 60000);
 
+    /*!
+    * \brief take one non-blocking reading, called by the control loop in the sense stage
+    */
+    void sense();
+
+    /*!
+    * \brief the reading from the last sense() in inches, negative if it was invalid
+    */
+    double get_sensed_in();
+
+    /*!
+    * \brief the reading from the last sense() with offsets applied, negative if it was invalid
+    */
+    double read_sensed();
+
     /*!
     * \brief set x offset
     * \param x the x offset in inches
@@ -121,6 +138,22 @@ class DSRDS{
     */
     Dir get_dir();
 
+    /*!
+    * \brief get the port the sensor is plugged into
+    */
+    int get_port();
+
+    /*!
+    * \brief mark the sensor as plugged in or not, set by the health monitor
+    * \param connected false stops reads and odom resets from using this sensor
+    */
+    void set_connected(bool connected);
+
+    /*!
+    * \brief false once the sensor has been found unplugged
+    */
+    bool is_connected();
+
     /*!
     * \brief get the direction of the sensor as a string (for debugging purposes)
     * \return the direction of the sensor as a string
@@ -155,6 +188,16 @@ class DSRDS{
     */
     Dir dir;
 
+    /*!
+    * \brief the reading from the last sense() in inches, negative if it was invalid
+    */
+    double sensed = -1;
+
+    /*!
+    * \brief false once the sensor has been found unplugged
+    */
+    bool connected = true;
+
     /*!
     * \brief the direction of the sensor as a string, used for debugging purposes
     */
@@ -165,6 +208,12 @@ class DSRDS{
     */
     pros::Distance sensor;
 
+    /*!
+    * \brief applies the offsets and the robot angle to a reading in inches
+    * \param reading the reading in inches
+    */
+    double apply_offsets(double reading);
+
     /*!
     * \brief a helper function to convert the direction enum to a string for debugging purposes
     * \param direction the direction of the sensor
@@ -218,6 +267,8 @@ namespace DSR{
 
     /*!
     * \brief used in autonomous to reset the tracking values based on specified distance sensor readings.
+    *
+    * An axis whose sensor is unplugged is left alone.
     * \param sensorX_dir the direction of the sensor used for x tracking
     * \param sensorY_dir the direction of the sensor used for y tracking
     * \param sensorX_specified the specific sensor used for x tracking (defaults to the first one mentioned)
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include "control_loop.hpp"
+
+/*! \namespace health
+ *  \brief Disconnect detection for every smart port device, with fallbacks
+ *
+ *  It has the ability to:
+ *
+ *      -check the plugged type of every added port every CHECK_TICKS control ticks
+ *
+ *      -notice a dropped imu in the same tick through its error reading
+ *
+ *      -switch odom to the drive motors when a tracking wheel drops, with EZ-Template's tracking off
+ *       for the swap so its task isn't using the tracker while it goes
+ *
+ *      -turn EZ-Template's tracking off when the imu drops and track from the drive motors instead
+ *
+ *      -stop DSR from reading or resetting with an unplugged sensor
+ *
+ *  Everything runs inside the control loop and never blocks. Failures latch, a device that comes back
+ *  is reported but the fallback stays on for the rest of the run.
+ */
+namespace health{
+
+    /*!
+    * \brief what a device is used for, decides the expected type and the fallback
+    */
+    enum Role{
+        DRIVE_MOTOR,
+        ROLLER,
+        IMU,
+        TRACKER_LEFT,
+        TRACKER_RIGHT,
+        TRACKER_FRONT,
+        TRACKER_BACK,
+        DISTANCE,
+        OPTICAL
+    };
+
+    /*!
+    * \brief the state of one device
+    */
+    struct Device{
+        const char* name = "";
+        int port = 0;
+        Role role = DRIVE_MOTOR;
+        bool ok = true;                 // plugged in and the right type right now
+        bool degraded = false;          // the fallback for this device is on
+        std::uint32_t faults = 0;       // times it dropped
+        std::uint32_t fault_time = 0;   // millis of the last drop
+    };
+
+    /*!
+    * \brief the plugged type sweep runs every this many control ticks
+    */
+    inline const int CHECK_TICKS = 3;
+
+    /*!
+    * \brief add a device to watch
+    * \param name name used when reporting, must outlive the program
+    * \param port the smart port, negative (reversed) ports are fine
+    * \param role what the device is used for
+    */
+    void add(const char* name, int port, Role role);
+
+    /*!
+    * \brief runs the checks and fallbacks, called by the control loop every tick
+    * \param sample the sample from this tick's sense stage
+    */
+    void check(const ctrl::Sample& sample);
+
+    /*!
+    * \brief called in the control loop whenever a device drops or comes back
+    * \param callback the function to call, must not block
+    */
+    void on_fault(std::function<void(const Device&)> callback);
+
+    /*!
+    * \brief true if the device on this port is plugged in (true for ports that weren't added)
+    * \param port the smart port
+    */
+    bool ok(int port);
+
+    /*!
+    * \brief true if the pose is coming from the drive motors instead of EZ-Template's tracking
+    */
+    bool imu_degraded();
+
+    /*!
+    * \brief the number of devices added
+    */
+    int count();
+
+    /*!
+    * \brief the state of one device
+    * \param index from 0 to count() - 1
+    */
+    Device get(int index);
+}
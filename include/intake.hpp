@@ -2,3 +2,81 @@
 #include "subsystems.hpp"
 
 void intake_opcontrol();
+
+/*! \namespace rollers
+ *  \brief The intake and outtake run together at the speeds of what the robot is doing with the balls
+ *
+ *  It has the ability to:
+ *
+ *      -keep a profile of intake and outtake rpm for each action, held by the rollers' velocity control
+ *
+ *      -tune a profile on the robot for the most balls per second into a goal without jamming
+ */
+namespace rollers{
+
+    /*!
+    * \brief what the rollers are doing
+    */
+    enum Action{
+        STOP = 0,
+        INTAKE = 1,        // pick balls up and keep them
+        LONG_GOAL = 2,     // out of the top into the long goal
+        MIDDLE_GOAL = 3,   // back out of the top into the middle goal, with Middle set
+        LOW_SCORE = 4      // everything back out of the front, with LowScore set
+    };
+
+    /*!
+    * \brief speeds for one action in the rpm the motors report, 0 lets a roller coast
+    */
+    struct Profile{
+        double intake_rpm = 0;
+        double outtake_rpm = 0;
+    };
+
+    /*!
+    * \brief free speed of the roller motors, in rpm
+    */
+    inline const double MAX_RPM = 600;
+
+    /*!
+    * \brief run the rollers at an action's profile, they only look for jams when it moves balls through
+    */
+    void set(Action action);
+
+    /*!
+    * \brief the action the rollers were last set to
+    */
+    Action get();
+
+    /*!
+    * \brief change the speeds of an action, takes effect the next time it is set
+    */
+    void profile_set(Action action, Profile profile);
+
+    /*!
+    * \brief the speeds of an action
+    */
+    Profile profile_get(Action action);
+
+    /*!
+    * \brief find the speed with the most balls per second for an action
+    *
+    * Set up the robot at the goal and keep feeding it balls the whole time. The profile is scaled so
+    * the faster roller runs at each speed from rpm_low to MAX_RPM, each for window_ms, and the balls
+    * scored in that time are counted by the ball tracker. A speed that jammed is thrown out. The best one
+    * is kept as the action's profile and printed to the terminal as a line for main.cpp. The defaults try
+    * 5 speeds in about 9 s, so the sweep is done inside the 15 s a selector auton gets.
+    *
+    * \param action the action to tune
+    * \param window_ms how long to count balls at each speed
+    * \param rpm_low the slowest speed to try
+    * \param rpm_step how much faster each try is
+    * \return the profile that was kept
+    */
+    Profile tune(Action action, int window_ms = 1500, double rpm_low = 400, double rpm_step = 50);
+
+    /*!
+    * \brief the name of an action
+    */
+    const char* action_to_string(Action action);
+}
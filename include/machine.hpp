@@ -0,0 +1,127 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+/*!
+* \class Machine
+* \brief A state machine for a mechanism, ticked by the control loop.
+*
+* It has the ability to:
+*
+*   -take requests from any task without blocking, the tick picks up the latest one
+*
+*   -move toward the request through guarded transitions, at most one a tick
+*
+*   -hold every state for a minimum time before it can be left, so a piston finishes moving and
+*    mechanisms don't chatter
+*
+* States and requests are ints, usually from one enum, and a request is the state it asks for. On every
+* tick past the current state's minimum, the first transition whose from, request and guard all match is
+* taken. Nothing happens once the state is the request.
+*/
+class Machine{
+    public:
+
+    /*!
+    * \brief matches every state as a transition's from, or every request
+    */
+    inline static const int ANY = -1;
+
+    /*!
+    * \brief constructor for Machine
+    * \param name shown in logs
+    * \param initial the state it starts in, entered on the first tick
+    */
+    Machine(const char* name, int initial);
+
+    /*!
+    * \brief add a state
+    * \param state the state
+    * \param name shown in logs
+    * \param min_ms it is held at least this long once entered
+    * \param enter run in the control loop on entering it, must not block
+    */
+    void state_add(int state, const char* name, std::uint32_t min_ms, std::function<void()> enter = nullptr);
+
+    /*!
+    * \brief add a transition, they are tried in the order they were added
+    * \param from the state it leaves, or ANY
+    * \param request the request it serves, or ANY
+    * \param to the state it enters
+    * \param guard it is only taken while this is true, nullptr always is, must not block
+    */
+    void transition_add(int from, int request, int to, std::function<bool()> guard = nullptr);
+
+    /*!
+    * \brief ask for a state, returns right away
+    */
+    void request(int state);
+
+    /*!
+    * \brief the state asked for last
+    */
+    int get_request();
+
+    /*!
+    * \brief the state it is in
+    */
+    int get_state();
+
+    /*!
+    * \brief the name of the state it is in
+    */
+    const char* get_state_name();
+
+    /*!
+    * \brief the name of the machine
+    */
+    const char* get_name();
+
+    /*!
+    * \brief millis the current state was entered
+    */
+    std::uint32_t get_entered();
+
+    /*!
+    * \brief called in the control loop on every change of state
+    * \param callback gets the state left and the state entered, must not block
+    */
+    void on_change(std::function<void(int from, int to)> callback);
+
+    /*!
+    * \brief take a transition if one is ready, called by the control loop every tick
+    * \param now_ms the time of this tick's sample
+    */
+    void tick(std::uint32_t now_ms);
+
+    private:
+
+    struct State{
+        const char* name = "";
+        std::uint32_t min_ms = 0;
+        std::function<void()> enter = nullptr;
+    };
+
+    struct Transition{
+        int from;
+        int request;
+        int to;
+        std::function<bool()> guard;
+    };
+
+    //the states indexed by their number
+    std::vector<State> states;
+    std::vector<Transition> transitions;
+    std::function<void(int, int)> change_callback = nullptr;
+    const char* name;
+
+    std::atomic<int> requested;
+    std::atomic<int> state;
+    std::atomic<std::uint32_t> entered;
+    bool started = false;
+
+    void enter(int to, std::uint32_t now_ms);
+};
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstdint>
+#include "control_loop.hpp"
+#include "machine.hpp"
+
+/*! \namespace mech
+ *  \brief The mechanisms as state machines, autons and opcontrol only post requests
+ *
+ *  It has the ability to:
+ *
+ *      -run the ball path (intake, outtake, Middle and LowScore) through loading and each way of scoring,
+ *       opening a piston before the rollers push balls at it and closing it before they go another way
+ *
+ *      -run Wing and MatchLoad with a minimum time out or in
+ *
+ *  Every request returns right away, the machines are ticked by the control loop and move the
+ *  mechanisms the same tick they change state.
+ */
+namespace mech{
+
+    /*!
+    * \brief states of the ball path, the ones a request can ask for are marked
+    */
+    enum Path{
+        IDLE = 0,           // request, rollers off
+        LOAD = 1,           // request, intake balls and keep them
+        SCORE_LONG = 2,     // request, out of the top into the long goal
+        OPEN_MIDDLE = 3,    // Middle going out, the intake backs off so the balls don't jam on it
+        SCORE_MIDDLE = 4,   // request, back out of the top into the middle goal
+        OPEN_LOW = 5,       // LowScore going out, rollers off
+        SCORE_LOW = 6,      // request, everything back out of the front into the low goal
+        UNLOAD = 7,         // request, everything back out of the front with the pistons in
+        CLOSING = 8,        // Middle and LowScore going in before the balls go another way
+        LOAD_LOW = 9        // request, intake balls and keep them with LowScore out, so scoring low starts right away
+    };
+
+    /*!
+    * \brief how long a piston takes to finish moving, in ms
+    */
+    inline const std::uint32_t PISTON_MS = 100;
+
+    /*!
+    * \brief how long the intake backs off while Middle goes out, in ms
+    */
+    inline const std::uint32_t MIDDLE_OPEN_MS = 200;
+
+    /*!
+    * \brief intake speed backing off while Middle goes out, in rpm
+    */
+    inline const double MIDDLE_BACKOFF_RPM = -280;
+
+    /*!
+    * \brief least time in a rolling state, so quick requests don't chatter the rollers, in ms
+    */
+    inline const std::uint32_t DWELL_MS = 50;
+
+    /*!
+    * \brief set up the machines and add them to the control loop, call before ctrl::start()
+    */
+    void start();
+
+    /*!
+    * \brief ticks every machine, called by the control loop every tick
+    * \param sample the sample from this tick's sense stage
+    */
+    void tick(const ctrl::Sample& sample);
+
+    /*!
+    * \brief ball path requests
+    */
+    void stop();
+    void load();
+    void load_low();
+    void score_long();
+    void score_middle();
+    void score_low();
+    void unload();
+
+    /*!
+    * \brief request Wing out or in
+    */
+    void wing(bool out);
+
+    /*!
+    * \brief request MatchLoad out or in
+    */
+    void matchload(bool out);
+
+    /*!
+    * \brief true if Wing was last requested out
+    */
+    bool wing_get();
+
+    /*!
+    * \brief true if MatchLoad was last requested out
+    */
+    bool matchload_get();
+
+    /*!
+    * \brief the state of the ball path
+    */
+    Path get_path();
+
+    /*!
+    * \brief the machines, for their requests, states and on_change()
+    */
+    Machine& path();
+    Machine& wing_machine();
+    Machine& matchload_machine();
+}
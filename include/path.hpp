@@ -0,0 +1,203 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "EZ-Template/api.hpp"
+
+/*! \namespace path
+ *  \brief Pure pursuit paths built in buffers reserved once, so starting a motion doesn't allocate
+ *
+ *  It has the ability to:
+ *
+ *      -inject points between the waypoints at EZ-Template's spacing, and smooth them the way
+ *       EZ-Template's smooth_path() does, both in place in the same buffers every time
+ *
+ *      -keep which injected point each waypoint ended up at, so pid_wait_until_index() still counts waypoints
+ *
+ *      -cache every path it builds by a hash of its waypoints, spacing and smoothing constants, so a path
+ *       warmed in initialize() or loaded from the sd card is only looked up when the motion starts
+ *
+ *      -time every build
+ *
+ *  A path is the part from the robot to the first waypoint, injected when the motion starts because the
+ *  robot is never quite in the same place, then the rest from the first waypoint on, which is what gets
+ *  cached injected and smoothed. When the motion starts only the corner where the two meet is smoothed,
+ *  toward the injected points also kept in the cache, so the path has the shape EZ-Template gives it by
+ *  smoothing all of it from the robot.
+ *
+ *  The finished path goes to ez::Drive::pid_odom_pp_set(), which follows it without injecting or smoothing
+ *  again. That call takes a std::vector by value, so handing it over is the one allocation left, and what
+ *  EZ-Template does with it inside the cold package is its own.
+ *
+ *  The cache file is a FileHeader, its Entries, the points of every entry, the same points before smoothing,
+ *  then the index each waypoint ended at in every entry. Points are ez::odom as they are in memory, so a
+ *  file from another build of EZ-Template is turned down.
+ */
+namespace path{
+
+    /*!
+    * \brief the most points in a path after injection, the spacing is widened for longer paths to fit
+    */
+    inline const int MAX_POINTS = 1024;
+
+    /*!
+    * \brief smoothing gives up after this many passes over the path, converged or not
+    */
+    inline const int MAX_SMOOTH_PASSES = 1000;
+
+    /*!
+    * \brief smoothing at motion start only moves this many points either side of the first waypoint, at
+    * EZ-Template's constants smoothing the corner moves points a few away from it and nothing this far
+    */
+    inline const int JOINT_POINTS = 32;
+
+    /*!
+    * \brief the most paths and points cached, paths past them are built every time
+    */
+    inline const int MAX_CACHED = 64;
+    inline const int MAX_CACHED_POINTS = 8192;
+
+    /*!
+    * \brief what is done to the waypoints
+    */
+    enum Build{
+        RAW = 0,      // followed as they are, pid_odom_pp_set
+        INJECT = 1,   // points injected between them, pid_odom_injected_pp_set
+        SMOOTH = 2    // injected and smoothed, pid_odom_smooth_pp_set and pid_odom_set
+    };
+
+    /*!
+    * \brief EZ-Template's smoothing constants, the same defaults
+    */
+    struct Smoothing{
+        double weight_smooth = 0.75;
+        double weight_data = 0.03;
+        double tolerance = 0.0001;
+    };
+
+    /*!
+    * \brief how long building paths took, times in microseconds
+    */
+    struct Timing{
+        std::uint32_t builds = 0;
+        std::uint32_t last = 0;
+        std::uint32_t worst = 0;
+        int last_points = 0;
+        int most_points = 0;
+        int last_passes = 0;      // smoothing passes, only the joint's when it came from the cache
+        int most_passes = 0;
+        std::uint32_t hit_worst = 0;  // the slowest build from the cache
+        int hit_passes = 0;           // and the most passes one took
+        std::uint32_t grown = 0;  // builds that went past the reserved buffers and allocated
+        std::uint32_t hits = 0;   // builds whose waypoints were in the cache
+        std::uint32_t misses = 0;
+        int cached = 0;           // paths in the cache
+    };
+
+    /*!
+    * \brief starts the cache file
+    */
+    struct FileHeader{
+        char magic[4] = {'P', 'T', 'H', '2'};
+        std::uint32_t entries = 0;
+        std::uint32_t points = 0;
+        std::uint32_t ends = 0;
+        std::uint32_t point_size = sizeof(ez::odom);
+    };
+
+    /*!
+    * \brief one cached path, from its first waypoint on
+    */
+    struct Entry{
+        std::uint64_t key = 0;        // hash of the build, waypoints, spacing and smoothing constants
+        std::uint32_t first = 0;      // its first point in the cached points
+        std::uint32_t ends = 0;       // its first waypoint index in the cached indexes
+        std::uint16_t points = 0;
+        std::uint16_t waypoints = 0;
+        std::uint32_t reserved = 0;
+    };
+
+    /*!
+    * \class Path
+    * \brief one path at a time, rebuilt in place for every motion
+    */
+    class Path{
+        public:
+
+        /*!
+        * \brief allocate the buffers and the cache, call once before anything else
+        */
+        void reserve();
+
+        /*!
+        * \brief build a path from the robot's pose through the waypoints
+        * \param build what is done to the waypoints
+        * \param start the robot's pose
+        * \param waypoints where it goes
+        * \param spacing injected points are this far apart, in inches
+        * \param smoothing used for SMOOTH
+        * \return the path, valid until the next build
+        */
+        const std::vector<ez::odom>& build(Build build, ez::pose start, std::span<const ez::odom> waypoints, double spacing, const Smoothing& smoothing);
+        const std::vector<ez::odom>& build(Build build, ez::pose start, std::span<const ez::united_odom> waypoints, double spacing, const Smoothing& smoothing);
+
+        /*!
+        * \brief cache a path ahead of the motion that follows it, not while one is being followed
+        * \return false if the cache is full
+        */
+        bool warm(Build build, std::span<const ez::odom> waypoints, double spacing, const Smoothing& smoothing);
+        bool warm(Build build, std::span<const ez::united_odom> waypoints, double spacing, const Smoothing& smoothing);
+
+        /*!
+        * \brief the point a waypoint of the last build ended up at, index itself if there's no such waypoint
+        */
+        int index(int waypoint) const;
+
+        /*!
+        * \brief write the paths warmed or followed since boot to a file
+        * \return false if it couldn't be written
+        */
+        bool save(const char* file);
+
+        /*!
+        * \brief add the paths in a file to the cache, all of them or none
+        * \return how many were added
+        */
+        int load(const char* file);
+
+        /*!
+        * \brief true if the cache has paths the last save() didn't, or loaded paths nothing used since
+        */
+        bool changed() const;
+
+        /*!
+        * \brief timing of every build since reserve()
+        */
+        const Timing& timing() const;
+
+        private:
+
+        //the path, the waypoints or the cached part while building, and the unsmoothed path
+        std::vector<ez::odom> points;
+        std::vector<ez::odom> data;
+        std::vector<ez::odom> raw;
+        std::vector<std::uint16_t> ends;
+        Timing times;
+
+        std::vector<Entry> entries;
+        std::vector<bool> used;       // warmed or followed since boot
+        std::vector<ez::odom> cached_points;
+        std::vector<ez::odom> cached_raw;     // cached_points before smoothing
+        std::vector<std::uint16_t> cached_ends;
+        bool unsaved = false;
+
+        int find(std::uint64_t hash);
+        void injected(std::vector<ez::odom>& path, std::span<const ez::odom> waypoints, double spacing);
+        int body(Build build, std::span<const ez::odom> waypoints, double spacing, const Smoothing& smoothing);
+        int smooth(const Smoothing& smoothing, ez::pose from, int first, int last);
+        int store(std::uint64_t hash, Build build);
+        int finish(Build build, ez::pose start, const ez::odom& first, int entry, double spacing, const Smoothing& smoothing);
+        std::size_t capacity() const;
+    };
+}
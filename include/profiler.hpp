@@ -0,0 +1,187 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include "EZ-Template/api.hpp"
+
+/*! \namespace prof
+ *  \brief Per step timing of an auton
+ *
+ *  It has the ability to:
+ *
+ *      -time every chassis.pid_*_set call until the pid_wait* that finishes it
+ *
+ *      -time pid_wait_until* calls and annotated delays
+ *
+ *      -watch the drive and the rollers through every delay, to see how much of it was needed
+ *
+ *      -work out the slack of every step, time spent waiting that didn't move the robot
+ *
+ *      -write every step of the run to /usd/profile.csv and keep a summary sorted by slack
+ *
+ *  Steps go into a fixed buffer of MAX_STEPS, nothing is allocated during the run.
+ *  Nothing is recorded outside of begin() and end().
+ */
+namespace prof{
+
+    /*!
+    * \brief what a step was
+    */
+    enum Kind{
+        MOTION = 0,       // pid_*_set or drive_set until the wait that finished it
+        WAIT_UNTIL = 1,   // pid_wait_until*, the motion keeps going after it
+        DELAY = 2         // prof::delay
+    };
+
+    /*!
+    * \brief the drive is moving above this, in rpm
+    */
+    inline const int DRIVE_STILL_RPM = 5;
+
+    /*!
+    * \brief a roller drawing more than this is pushing balls, in mA
+    */
+    inline const double ROLLER_LOADED_MA = 900;
+
+    /*!
+    * \brief a running roller slower than this fraction of its fastest in the delay has a ball in it
+    */
+    inline const double BALL_SLOWDOWN = 0.85;
+
+    /*!
+    * \brief a roller is still changing speed for this long after its command changed, in ms
+    */
+    inline const std::uint32_t ROLLER_SPIN_MS = 150;
+
+    /*!
+    * \brief one step of the auton, times are millis
+    */
+    struct Step{
+        Kind kind = MOTION;
+        const char* label = "";   // the label that was set when the step started
+        const char* call = "";    // the function that started the step
+        const char* wait = "";    // the function that finished it
+        const char* exit = "";    // exit reason
+        std::uint32_t start = 0;
+        std::uint32_t end = 0;
+        std::uint32_t slack = 0;  // ms of the step that didn't move the robot closer
+        std::uint32_t settled = 0;        // DELAY: ms into it the drive stopped for good, 0 if it never moved
+        std::uint32_t current_low = 0;    // DELAY: ms into it the roller current dropped for good
+        std::uint32_t balls_stopped = 0;  // DELAY: ms into it the rollers stopped being slowed by balls
+        int jams = 0;                     // roller jams since the program started, when the step finished
+        double target = 0;
+        double final_error = 0;
+        ez::pose pose = {0, 0, 0};  // where the robot was at the end
+    };
+
+    /*!
+    * \brief the most steps one run can hold, later steps are dropped
+    */
+    inline const int MAX_STEPS = 256;
+
+    /*!
+    * \brief clear the buffer and start recording a run
+    * \param auton name of the auton, copied up to the first new line
+    */
+    void begin(const char* auton);
+
+    /*!
+    * \brief stop recording, rank the steps by slack and write the csv
+    *
+    * Does nothing if nothing is recording, so it is safe to call from disabled() and opcontrol()
+    * to finish an auton that got cut off.
+    */
+    void end();
+
+    /*!
+    * \brief true between begin() and end()
+    */
+    bool running();
+
+    /*!
+    * \brief label every step started from now on
+    * \param name the label, must outlive the program (a string literal)
+    */
+    void label(const char* name);
+
+    /*!
+    * \brief start a motion step, the open motion is closed as replaced
+    * \param call the function that set the motion
+    * \param target the PID target
+    */
+    void motion_set(const char* call, double target);
+
+    /*!
+    * \brief finish the open motion step
+    * \param wait the function that waited on it
+    * \param final_error error when the wait returned
+    * \param exit why the wait returned
+    * \param slack time of the wait that was spent at the target
+    */
+    void motion_done(const char* wait, double final_error, const char* exit, std::uint32_t slack);
+
+    /*!
+    * \brief add a wait that returns part way through the motion
+    * \param wait the function that waited
+    * \param start millis the wait started
+    * \param final_error error when the wait returned
+    */
+    void wait_until(const char* wait, std::uint32_t start, double final_error);
+
+    /*!
+    * \brief pros::delay that is recorded as a step
+    *
+    * While recording, the drive and the rollers are sampled every tick. The slack is the time left after
+    * the last of them settled: the drive stopped, the roller current dropped and the rollers got back
+    * to speed with no balls slowing them. The exit is the one that settled last, Idle if none of them
+    * did anything.
+    *
+    * \param ms time to wait
+    * \param label what the wait is for, must outlive the program (a string literal)
+    */
+    void delay(int ms, const char* label = nullptr);
+
+    /*!
+    * \brief called with every step and its index as it finishes, while recording
+    *
+    * Motions finish when their wait returns, so they can come after steps with a higher index.
+    */
+    void on_step(std::function<void(int index, const Step& step)> callback);
+
+    /*!
+    * \brief the number of steps in the last run
+    */
+    int count();
+
+    /*!
+    * \brief one step of the last run
+    * \param index from 0 to count() - 1, in the order they happened
+    */
+    Step get(int index);
+
+    /*!
+    * \brief the step with the rank-th most slack, valid after end()
+    * \param rank 0 is the step with the most slack
+    */
+    Step ranked(int rank);
+
+    /*!
+    * \brief the name of the last run
+    */
+    const char* auton();
+
+    /*!
+    * \brief length of the last run in ms
+    */
+    std::uint32_t total();
+
+    /*!
+    * \brief slack of the last run added up in ms
+    */
+    std::uint32_t total_slack();
+
+    /*!
+    * \brief name of a step kind
+    */
+    const char* kind_to_string(Kind kind);
+}
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <cstdint>
+#include "control_loop.hpp"
+
+/*! \namespace replay
+ *  \brief Records a driven route in opcontrol and drives it again as an auton
+ *
+ *  It has the ability to:
+ *
+ *      -record the drive command, the pose and the mechanism requests every control tick, into a
+ *       slot file on the sd card
+ *
+ *      -add every slot on the sd card to the auton selector at boot
+ *
+ *      -drive a recording again from the recorded commands, steering back onto the recorded pose
+ *       trace so it doesn't drift the way replaying the commands alone would
+ *
+ *  Poses are kept relative to where the recording started, so a recording plays from wherever the
+ *  robot is when it starts. Recording and playing run inside the control loop and never block,
+ *  saving to the sd card happens once when a recording stops.
+ */
+namespace replay{
+
+    /*!
+    * \brief one control tick of a recording, 10 bytes in the file
+    */
+    struct Frame{
+        std::int16_t x = 0;           // hundredths of an inch from the start, sideways
+        std::int16_t y = 0;           // hundredths of an inch from the start, forward
+        std::int16_t theta = 0;       // hundredths of a degree from the start heading, -180 to 180
+        std::int8_t left = 0;         // drive command, -127 to 127
+        std::int8_t right = 0;
+        std::uint8_t path = 0;        // mech::Path requested
+        std::uint8_t pistons = 0;     // Wing requested out on bit 0, MatchLoad on bit 1
+    };
+
+    /*!
+    * \brief the start of a slot file, followed by frames
+    */
+    struct Header{
+        char magic[4] = {'R', 'P', 'L', '1'};
+        std::uint16_t period = 0;     // ms between frames
+        std::uint16_t reserved = 0;
+        std::uint32_t frames = 0;
+    };
+
+    /*!
+    * \brief how far a playback was off the recorded poses
+    */
+    struct Tracking{
+        std::uint32_t frames = 0;     // frames played
+        double last = 0;              // in off the recorded pose at the last frame
+        double worst = 0;             // in, worst over the playback
+        double heading = 0;           // deg off the recorded heading at the last frame
+    };
+
+    /*!
+    * \brief the longest recording, 60 s at the default control period
+    */
+    inline const int MAX_FRAMES = 6000;
+
+    /*!
+    * \brief slot files are /usd/replay_<slot>.bin
+    */
+    inline const int MAX_SLOTS = 10;
+
+    /*!
+    * \brief steering back onto the recorded poses, in drive command per inch and per degree
+    */
+    inline const double ALONG_KP = 6;       // behind or ahead of the recorded pose
+    inline const double CROSS_KP = 2;       // to the side of the recorded pose, turns toward it
+    inline const double HEADING_KP = 1.5;   // off the recorded heading
+
+    /*!
+    * \brief add the recorder to the control loop and every slot on the sd card to the auton selector,
+    *        call once in initialize() after the rest of the autons are added and before ctrl::start()
+    */
+    void start();
+
+    /*!
+    * \brief records or plays a frame, called by the control loop every tick
+    * \param sample the sample from this tick's sense stage
+    */
+    void tick(const ctrl::Sample& sample);
+
+    /*!
+    * \brief start recording from where the robot is, drive with driver::arcade_flipped() so it has a command to record
+    */
+    void record_start();
+
+    /*!
+    * \brief stop recording, save it to the first free slot and add it to the auton selector
+    * \return the slot, -1 if there was nothing to save or no sd card
+    */
+    int record_stop();
+
+    /*!
+    * \brief start or stop recording, for a button
+    */
+    void record_toggle();
+
+    /*!
+    * \brief true while recording
+    */
+    bool recording();
+
+    /*!
+    * \brief load a slot file to play
+    * \return false if it isn't there or isn't a recording
+    */
+    bool load(int slot);
+
+    /*!
+    * \brief drive the loaded or last recorded route from where the robot is, returns when it is done
+    * \param correct false to only replay the commands, for comparing
+    */
+    void play(bool correct = true);
+
+    /*!
+    * \brief load a slot and play it, the auton each slot is added to the selector with
+    */
+    void run(int slot);
+
+    /*!
+    * \brief stop playing and recording right away, for the field ending the period
+    *
+    * A recording can outlast the auton that plays it, and the field only kills the auton's task,
+    * so disabled() and opcontrol() call this before the playback drives into the driver's time.
+    * A recording cut off here isn't saved.
+    */
+    void stop();
+
+    /*!
+    * \brief true while playing
+    */
+    bool playing();
+
+    /*!
+    * \brief the frames recorded or loaded
+    */
+    int frames();
+
+    /*!
+    * \brief how the last playback tracked the recorded poses
+    */
+    Tracking tracking();
+}
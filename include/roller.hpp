@@ -0,0 +1,256 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include "api.h"
+
+/*!
+* \class Roller
+* \brief A motor for the intake or outtake whose commands go through the control loop.
+*
+* It has the ability to:
+*
+*   -buffer voltage commands until the next control tick
+*
+*   -cache the sensor readings taken in the sense stage
+*
+*   -hold a velocity with feedforward and PID on the measured rpm, so the speed doesn't drop with the
+*    battery or the balls
+*
+*   -notice a jam from current, velocity and temperature, back it out and go back to the command, only while
+*    it is armed so a roller holding balls against a stopped one isn't taken for a jam
+*
+* When the control loop isn't running, move() writes straight to the motor like pros::Motor::move(),
+* move_velocity() hands the velocity to the motor's own controller, and nothing watches for jams.
+*/
+class Roller{
+    public:
+
+    /*!
+    * \brief what the jam state machine is doing
+    */
+    enum JamState{
+        CLEAR = 0,        // running the command
+        REVERSING = 1,    // backing a jam out
+        RESUMING = 2,     // back on the command, stalls are ignored while it spins up
+        STUCK = 3         // too many jams in a row, off until the command changes
+    };
+
+    /*!
+    * \brief constructor for Roller
+    * \param port the port the motor is plugged into (negative reverses it)
+    */
+    Roller(int port);
+
+    /*!
+    * \brief command the roller, -127 to 127
+    * \param voltage the voltage to apply on the next control tick
+    */
+    void move(int voltage);
+
+    /*!
+    * \brief hold a velocity, run by the control loop with the constants from velocity_constants_set()
+    * \param rpm the velocity, in the rpm the motor reports
+    */
+    void move_velocity(double rpm);
+
+    /*!
+    * \brief sets the velocity controller, the output is -127 to 127
+    * \param kv feedforward per rpm of target, 127 / the free speed to start
+    * \param ks feedforward added in the direction of the target, to get over friction
+    * \param kp per rpm of error
+    * \param ki per rpm second of error, it only adds up while the output isn't maxed out
+    * \param kd per rpm per second the error changes
+    */
+    void velocity_constants_set(double kv, double ks, double kp, double ki, double kd);
+
+    /*!
+    * \brief get the last commanded voltage, -127 to 127, stale while holding a velocity
+    */
+    int get_command();
+
+    /*!
+    * \brief true while holding a velocity from move_velocity()
+    */
+    bool is_velocity();
+
+    /*!
+    * \brief the velocity being held in rpm, 0 while running on voltage
+    */
+    double get_target_velocity();
+
+    /*!
+    * \brief read velocity, current and temperature into the cache (sense stage)
+    */
+    void sense();
+
+    /*!
+    * \brief write the buffered command if it changed (actuate stage)
+    */
+    void actuate();
+
+    /*!
+    * \brief run at a voltage for a while instead of the command, then go back to the command
+    *
+    * Only works while the control loop is running. Jams aren't looked for during a pulse.
+    *
+    * \param voltage -127 to 127
+    * \param ms how long
+    */
+    void pulse(int voltage, int ms);
+
+    /*!
+    * \brief run the jam state machine, called by the control loop every tick (control stage)
+    * \param now_ms the time of this tick's sample
+    */
+    void control(std::uint32_t now_ms);
+
+    /*!
+    * \brief sets jam detection and recovery, a current of 0 turns it off
+    * \param current_ma a jam draws more than this while cool, it is scaled down as the motor heats up
+    * \param velocity_rpm a jam turns slower than this
+    * \param detect_ms both have to hold this long
+    * \param reverse_ms how long to back a jam out for
+    * \param reverse_voltage voltage to back it out with, 0 to 127, applied against the command
+    * \param retries jams in a row before giving up until the command changes
+    */
+    void jam_set(double current_ma, double velocity_rpm, int detect_ms, int reverse_ms, int reverse_voltage, int retries);
+
+    /*!
+    * \brief look for jams or not, a roller that stalls holding balls on purpose would spit them out backing it out
+    * \param armed true while the roller is meant to move balls through, the default
+    */
+    void jam_arm(bool armed);
+
+    /*!
+    * \brief called in the control loop every time a jam is found
+    * \param callback gets the total number of jams, must not block
+    */
+    void on_jam(std::function<void(int jams)> callback);
+
+    /*!
+    * \brief jams found since the program started
+    */
+    int get_jams();
+
+    /*!
+    * \brief what the jam state machine is doing
+    */
+    JamState get_jam_state();
+
+    /*!
+    * \brief a stall is ignored this long after the roller starts or resumes, in ms
+    */
+    inline static const std::uint32_t SPINUP_MS = 150;
+
+    /*!
+    * \brief jams further apart than this aren't in a row, in ms
+    */
+    inline static const std::uint32_t JAM_STREAK_MS = 1000;
+
+    /*!
+    * \brief velocity in rpm from the last sense stage
+    */
+    double get_velocity();
+
+    /*!
+    * \brief current draw in mA from the last sense stage
+    */
+    double get_current();
+
+    /*!
+    * \brief temperature in celsius from the last sense stage
+    */
+    double get_temperature();
+
+    /*!
+    * \brief the motor object from the PROS API
+    */
+    pros::Motor motor;
+
+    private:
+
+    /*!
+    * \brief the command posted by autons / opcontrol, picked up by actuate()
+    */
+    std::atomic<int> command;
+
+    /*!
+    * \brief move_velocity() target and whether it is used instead of the command
+    */
+    std::atomic<double> target;
+    std::atomic<bool> velocity_mode;
+
+    /*!
+    * \brief bumped every time the command or target changes, the control stage starts over on it
+    */
+    std::atomic<int> requests;
+    int last_request = 0;
+
+    /*!
+    * \brief the last command actually written to the motor, used to skip redundant writes
+    */
+    int written;
+
+    /*!
+    * \brief what actuate() writes, the command unless a jam is being backed out
+    */
+    std::atomic<int> output;
+
+    /*!
+    * \brief pulse() voltage and the millis it ends
+    */
+    int pulse_voltage = 0;
+    std::uint32_t pulse_end = 0;
+
+    /*!
+    * \brief velocity constants, see velocity_constants_set()
+    */
+    double kv = 0;
+    double ks = 0;
+    double kp = 0;
+    double ki = 0;
+    double kd = 0;
+
+    /*!
+    * \brief velocity controller
+    */
+    double integral = 0;
+    double last_error = 0;
+    std::uint32_t last_control = 0;
+
+    /*!
+    * \brief the velocity controller's voltage for this tick, -127 to 127
+    */
+    int velocity_output(std::uint32_t now_ms);
+
+    /*!
+    * \brief jam constants, see jam_set()
+    */
+    double jam_current = 0;
+    double jam_velocity = 0;
+    std::uint32_t jam_detect = 0;
+    std::uint32_t jam_reverse = 0;
+    int jam_voltage = 0;
+    int jam_retries = 0;
+
+    /*!
+    * \brief jam state machine
+    */
+    JamState jam_state = CLEAR;
+    std::atomic<bool> jam_armed;
+    std::uint32_t state_start = 0;    // ms the state or the command started
+    std::uint32_t stall_start = 0;    // ms the stall started, 0 while not stalled
+    std::uint32_t last_jam = 0;
+    int streak = 0;
+    std::atomic<int> jams;
+    std::function<void(int)> jam_callback = nullptr;
+
+    /*!
+    * \brief cached sensor readings
+    */
+    double velocity;
+    double current;
+    double temperature;
+};
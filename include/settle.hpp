@@ -0,0 +1,185 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include "EZ-Template/api.hpp"
+
+/*!
+* \class SettleDetector
+* \brief Decides when a motion has settled from filtered error and filtered velocity.
+*
+* Like okapi's SettledUtil, but it also needs the velocity to be near zero, and it can exit early
+* when the error is closing fast enough to be inside the threshold within the prediction time.
+*/
+class SettleDetector{
+    public:
+
+    /*!
+    * \brief the state the detector is in after an update
+    */
+    enum State{
+        MOVING = 0,
+        HOLDING = 1,      // inside the error and velocity thresholds, waiting out the hold time
+        SETTLED = 2,
+        PREDICTED = 3     // will be inside the error threshold within the prediction time
+    };
+
+    /*!
+    * \brief constructor for SettleDetector, thresholds of 0 disable the detector
+    * \param error error threshold in motion units (inches or degrees)
+    * \param velocity velocity threshold in motion units per second
+    * \param hold_ms time both have to stay under their thresholds
+    * \param predict_ms prediction horizon for the early exit, 0 disables it
+    */
+    SettleDetector(double error = 0, double velocity = 0, int hold_ms = 0, int predict_ms = 0);
+
+    /*!
+    * \brief set all constants at once
+    */
+    void constants_set(double error, double velocity, int hold_ms, int predict_ms);
+
+    /*!
+    * \brief true if the thresholds have been set
+    */
+    bool enabled();
+
+    /*!
+    * \brief clear the filters and timers, call at the start of every motion
+    */
+    void reset();
+
+    /*!
+    * \brief feed the detector one error sample
+    * \param error the error in motion units
+    * \param time_ms the time of the sample in milliseconds
+    * \return the state after this sample
+    */
+    State update(double error, std::uint32_t time_ms);
+
+    /*!
+    * \brief filtered error from the last update
+    */
+    double error_get();
+
+    /*!
+    * \brief filtered velocity from the last update, in motion units per second
+    */
+    double velocity_get();
+
+    /*!
+    * \brief the velocity threshold in motion units per second
+    */
+    double velocity_threshold_get();
+
+    /*!
+    * \brief weight of the newest sample in both filters
+    */
+    inline static const double FILTER = 0.35;
+
+    private:
+    double error_threshold;
+    double velocity_threshold;
+    int hold_time;
+    int predict_time;
+
+    bool has_sample = false;
+    double filtered_error = 0;
+    double filtered_velocity = 0;
+    std::uint32_t last_time = 0;
+    std::uint32_t hold_start = 0;
+    bool holding = false;
+};
+
+/*! \namespace settle
+ *  \brief Per motion exit instrumentation
+ *
+ *  Every chassis.pid_wait() leaves a Record behind with its exit reason, the time it spent in each
+ *  exit state and its overshoot. The last RECORDS records are kept, and they are printed to the terminal
+ *  when EZ-Template's pid_print_toggle is on.
+ *
+ *  Odom motions wait inside EZ-Template, so their reason is worked out from the final error and they
+ *  have no phase times.
+ */
+namespace settle{
+
+    /*!
+    * \brief why a motion ended
+    */
+    enum Exit{
+        RUNNING = 0,
+        SMALL = 1,        // EZ small exit
+        BIG = 2,          // EZ big exit
+        VELOCITY = 3,     // EZ velocity exit
+        MA = 4,           // EZ current exit
+        SETTLED = 5,      // filtered error and velocity under threshold
+        PREDICTED = 6,    // predicted to settle within the prediction time
+        NO_CONSTANTS = 7, // EZ had no exit constants for the motion, it returns at once like EZ's pid_wait
+        TIMEOUT = 8,      // ran for MAX_WAIT_MS without exiting
+        UNKNOWN = 9       // an odom motion, EZ-Template exits it inside its own pid_wait() and doesn't say why
+    };
+
+    /*!
+    * \brief the longest a chassis.pid_wait() waits, whatever the exit constants are
+    */
+    inline const std::uint32_t MAX_WAIT_MS = 10000;
+
+    /*!
+    * \brief the exit states time is split between
+    */
+    enum Phase{
+        FAR = 0,          // error above the big error
+        BIG_ZONE = 1,     // error under the big error
+        SMALL_ZONE = 2,   // error under the small error
+        STOPPED = 3,      // velocity under the settle velocity, counted on top of the zones
+        PHASES = 4
+    };
+
+    /*!
+    * \brief one motion
+    */
+    struct Record{
+        ez::e_mode mode = ez::DISABLE;
+        Exit exit = RUNNING;
+        std::uint32_t start = 0;               // millis the wait started
+        std::uint32_t end = 0;                 // millis the wait returned
+        double target = 0;
+        double final_error = 0;
+        double overshoot = 0;                  // farthest past the target, in motion units
+        std::uint32_t phase_time[PHASES] = {}; // ms
+    };
+
+    /*!
+    * \brief how many records are kept
+    */
+    inline const int RECORDS = 64;
+
+    /*!
+    * \brief store a finished record and print it if printing is on
+    */
+    void add(const Record& record);
+
+    /*!
+    * \brief called with every finished record
+    */
+    void on_record(std::function<void(const Record&)> callback);
+
+    /*!
+    * \brief the number of records stored, at most RECORDS
+    */
+    int count();
+
+    /*!
+    * \brief a stored record, 0 is the oldest still kept
+    */
+    Record get(int index);
+
+    /*!
+    * \brief the record of the last motion
+    */
+    Record last();
+
+    /*!
+    * \brief name of an exit reason
+    */
+    const char* exit_to_string(Exit exit);
+}
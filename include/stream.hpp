@@ -0,0 +1,237 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+/*! \namespace stream
+ *  \brief Live binary channels over the serial link, for graphing instead of pid_print_toggle's text
+ *
+ *  It has the ability to:
+ *
+ *      -send the chosen channels every few control ticks, as integers of a fixed scale, with each
+ *       frame holding only the change from the last frame sent and a full KEY frame every KEY_EVERY
+ *
+ *      -frame every message with a CRC and COBS so the host finds the next frame after a lost byte
+ *
+ *      -send the schema, the channels and their scales, every SCHEMA_MS so the host can join late
+ *
+ *      -keep to a byte budget for the link, sending every second, fourth... sample when it is
+ *       saturated instead of blocking, and coming back to the chosen rate when it drains
+ *
+ *  Frames are a COBS encoded payload, its CRC-16/CCITT little endian at the end, and a 0 byte.
+ *  A payload is a Kind, the frame sequence (u16), then:
+ *
+ *      SCHEMA: time ms (varint), VERSION, period ms (u16), decimation (u8), channel mask (u32), a float scale per channel
+ *      KEY:    time ms (varint), every channel's value (zigzag varint)
+ *      DELTA:  ms since the last frame (varint), every channel's change since the last frame (zigzag varint)
+ *
+ *  Values are round(value * scale), in Channel order, for the channels in the mask. The codec below is
+ *  inline so sim/build/decode builds from this header without the brain's sources.
+ */
+namespace stream{
+
+    /*!
+    * \brief format version, in the schema
+    */
+    inline const std::uint8_t VERSION = 1;
+
+    /*!
+    * \brief every channel that can be sent, a bit in the mask each
+    */
+    enum Channel{
+        X = 0,              // odom in
+        Y = 1,
+        THETA = 2,          // odom deg
+        LEFT = 3,           // drive sensors in
+        RIGHT = 4,
+        IMU = 5,            // imu deg
+        PID_TARGET = 6,     // the running motion's main PID, the left side for drives
+        PID_ERROR = 7,
+        PID_OUTPUT = 8,
+        INTAKE_RPM = 9,
+        OUTTAKE_RPM = 10,
+        INTAKE_MA = 11,
+        OUTTAKE_MA = 12,
+        CPU = 13,           // percent of the brain the registered tasks used, see tasks.hpp
+        LOOP_RUN = 14,      // the control loop's last run time in us
+        OVERRUNS = 15,      // iterations of every registered task that ran past their period, so far
+        CHANNELS = 16
+    };
+
+    /*!
+    * \brief column names and the scale each channel is sent at, in Channel order
+    */
+    inline const char* const NAMES[CHANNELS] = {"x", "y", "theta", "left", "right", "imu", "pid_target", "pid_error", "pid_output",
+                                                "intake_rpm", "outtake_rpm", "intake_ma", "outtake_ma", "cpu_pct", "loop_run_us", "overruns"};
+    inline const float SCALES[CHANNELS] = {100, 100, 100, 100, 100, 100, 100, 100, 10, 10, 10, 1, 1, 10, 1, 1};
+
+    /*!
+    * \brief channel masks for start()
+    */
+    inline const std::uint32_t POSE = 0b111;
+    inline const std::uint32_t DRIVE = 0b111000;
+    inline const std::uint32_t PID = 0b111000000;
+    inline const std::uint32_t ROLLERS = 0b1111000000000;
+    inline const std::uint32_t TASKS = 0b1110000000000000;
+    inline const std::uint32_t ALL = (1u << CHANNELS) - 1;
+
+    /*!
+    * \brief what a frame holds
+    */
+    enum Kind{
+        SCHEMA = 1,
+        KEY = 2,
+        DELTA = 3
+    };
+
+    /*!
+    * \brief a full KEY frame after this many DELTA frames, so a lost frame costs at most this many
+    */
+    inline const int KEY_EVERY = 25;
+    inline const std::uint32_t SCHEMA_MS = 2000;
+
+    /*!
+    * \brief longest payload and longest frame on the wire
+    */
+    inline const std::size_t MAX_PAYLOAD = 1 + 2 + 5 + 1 + 2 + 1 + 4 + 4 * CHANNELS;
+    inline const std::size_t MAX_FRAME = MAX_PAYLOAD + 2 + MAX_PAYLOAD / 254 + 2;
+
+    /*!
+    * \brief default link budget, the brain's serial at 115200 baud, set it lower for the controller's radio
+    */
+    inline const std::uint32_t LINK_BYTES = 11520;
+
+    /*!
+    * \brief the most samples skipped between two sent, 2^MAX_DECIMATION_SHIFT
+    */
+    inline const int MAX_DECIMATION_SHIFT = 5;
+
+    /*!
+    * \brief sending so far, read from any task
+    */
+    struct Stats{
+        std::uint32_t frames = 0;     // frames sent whole
+        std::uint32_t bytes = 0;
+        std::uint32_t skipped = 0;    // samples not sent because the link was saturated
+        std::uint32_t short_writes = 0;   // frames the serial driver only took part of
+        int decimation = 1;           // every this many samples is sent now
+    };
+
+    /*!
+    * \brief start sending, the first call starts the task, later ones change the channels and the rate
+    * \param channels a mask of Channel bits
+    * \param period_ms time between samples, rounded to whole control ticks
+    */
+    void start(std::uint32_t channels, std::uint32_t period_ms);
+
+    /*!
+    * \brief stop sending
+    */
+    void stop();
+
+    /*!
+    * \brief bytes per second the link can take, sending is decimated to stay under it
+    */
+    void link_set(std::uint32_t bytes_per_second);
+
+    /*!
+    * \brief send to this file instead of stdout, before start()
+    */
+    void output_set(FILE* file);
+
+    /*!
+    * \brief what has been sent so far
+    */
+    Stats stats();
+
+    /*!
+    * \brief CRC-16/CCITT, polynomial 0x1021 from 0xFFFF
+    */
+    inline std::uint16_t crc16(const std::uint8_t* data, std::size_t size){
+        std::uint16_t crc = 0xFFFF;
+        for(std::size_t i = 0; i < size; i++){
+            crc ^= std::uint16_t(data[i]) << 8;
+            for(int bit = 0; bit < 8; bit++){
+                crc = crc & 0x8000 ? std::uint16_t((crc << 1) ^ 0x1021) : std::uint16_t(crc << 1);
+            }
+        }
+        return crc;
+    }
+
+    /*!
+    * \brief COBS encode, out needs size + size / 254 + 1 bytes, no 0 is written
+    * \return bytes written
+    */
+    inline std::size_t cobs_encode(const std::uint8_t* in, std::size_t size, std::uint8_t* out){
+        std::size_t code_at = 0;
+        std::size_t written = 1;
+        std::uint8_t code = 1;
+        for(std::size_t i = 0; i < size; i++){
+            if(in[i] != 0){
+                out[written++] = in[i];
+                code++;
+            }
+            if(in[i] == 0 || code == 0xFF){
+                out[code_at] = code;
+                code_at = written++;
+                code = 1;
+            }
+        }
+        out[code_at] = code;
+        return written;
+    }
+
+    /*!
+    * \brief COBS decode a frame without its 0, out needs size bytes
+    * \return bytes written, 0 if it isn't valid COBS
+    */
+    inline std::size_t cobs_decode(const std::uint8_t* in, std::size_t size, std::uint8_t* out){
+        std::size_t written = 0;
+        std::size_t i = 0;
+        while(i < size){
+            std::uint8_t code = in[i++];
+            if(code == 0 || i + code - 1 > size){
+                return 0;
+            }
+            for(int j = 1; j < code; j++){
+                out[written++] = in[i++];
+            }
+            if(code != 0xFF && i < size){
+                out[written++] = 0;
+            }
+        }
+        return written;
+    }
+
+    /*!
+    * \brief varints are 7 bits a byte, low bits first, and zigzag folds signed values into them
+    */
+    inline void varint_put(std::uint8_t*& at, std::uint32_t value){
+        while(value >= 0x80){
+            *at++ = std::uint8_t(value | 0x80);
+            value >>= 7;
+        }
+        *at++ = std::uint8_t(value);
+    }
+
+    inline bool varint_get(const std::uint8_t*& at, const std::uint8_t* end, std::uint32_t& value){
+        value = 0;
+        for(int shift = 0; shift < 35 && at < end; shift += 7){
+            std::uint8_t byte = *at++;
+            value |= std::uint32_t(byte & 0x7F) << shift;
+            if((byte & 0x80) == 0){
+                return true;
+            }
+        }
+        return false;
+    }
+
+    inline std::uint32_t zigzag(std::int32_t value){
+        return (std::uint32_t(value) << 1) ^ std::uint32_t(value >> 31);
+    }
+
+    inline std::int32_t unzigzag(std::uint32_t value){
+        return std::int32_t(value >> 1) ^ -std::int32_t(value & 1);
+    }
+}
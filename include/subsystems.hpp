@@ -3,13 +3,17 @@
 #include "EZ-Template/api.hpp"
 #include "EZ-Template/piston.hpp"
 #include "api.h"
+#include "chassis.hpp"
+#include "roller.hpp"
 
-extern Drive chassis;
+extern Chassis chassis;
 
 // Your motors, sensors, etc. should go here.  Below are examples
 
-inline pros::Motor outtake(-8);
-inline pros::Motor intake(6);
+inline Roller outtake(-8);
+inline Roller intake(6);
+
+inline pros::Optical ball_sensor(9);  // in the intake path, facing the balls
 
 inline ez::Piston Middle('A', true);
 inline ez::Piston Wing('D');
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include "api.h"
+
+/*! \namespace tasks
+ *  \brief Registry for every task that has to run on time
+ *
+ *  It has the ability to:
+ *
+ *      -give each task an explicit priority and period
+ *
+ *      -measure the actual period and the worst release to run lateness
+ *
+ *      -count deadline misses and starvation, and call back when one happens
+ *
+ *      -measure how long each iteration ran, the share of the brain each task uses, and flag iterations
+ *       that run longer than their period
+ *
+ *  A registered task calls add() once from inside itself and wait() at the end of every iteration.
+ *
+ *  An iteration's run time is from its release to its wait(), less what the registered tasks that
+ *  preempted it ran in between. Adopted tasks (EZ-Template's ez_auto) and PROS's own tasks aren't
+ *  measured, what they run while a registered task is mid iteration is counted as that task's.
+ */
+namespace tasks{
+
+    /*!
+    * \brief priorities for every task in the project, highest first
+    *
+    * Display work and the telemetry writer sit below everything else so they can never delay odom or PID.
+    */
+    inline const std::uint32_t PRIORITY_CONTROL = TASK_PRIORITY_DEFAULT + 2;  // ctrl loop
+    inline const std::uint32_t PRIORITY_EZ = TASK_PRIORITY_DEFAULT + 1;       // chassis.ez_auto, EZ-Template odom and PID
+    inline const std::uint32_t PRIORITY_USER = TASK_PRIORITY_DEFAULT;         // autonomous and opcontrol
+    inline const std::uint32_t PRIORITY_DISPLAY = TASK_PRIORITY_MIN + 1;      // ez_screen_task
+    inline const std::uint32_t PRIORITY_LOG = TASK_PRIORITY_MIN + 1;          // telemetry writer
+
+    /*!
+    * \brief a task is starved when it hasn't run for this many periods
+    */
+    inline const std::uint32_t STARVE_PERIODS = 3;
+
+    /*!
+    * \brief the most tasks that can be registered
+    */
+    inline const int MAX_TASKS = 8;
+
+    /*!
+    * \brief the window a task's cpu share is measured over
+    */
+    inline const std::uint32_t USAGE_MS = 1000;
+
+    /*!
+    * \brief measurements for one task, times in microseconds unless noted
+    */
+    struct Stats{
+        const char* name = "";
+        std::uint32_t priority = 0;
+        std::uint32_t period = 0;         // ms, 0 if the task isn't measured
+        std::uint32_t runs = 0;
+        std::uint32_t misses = 0;         // iterations that finished after their deadline
+        std::uint32_t starved = 0;        // times it went STARVE_PERIODS periods without running
+        std::uint32_t last_period = 0;    // between the last two iterations
+        std::uint32_t worst_period = 0;
+        std::uint32_t worst_late = 0;     // release to actually running
+        std::uint64_t last_start = 0;     // micros when the last iteration started
+        std::uint32_t last_run = 0;       // the last iteration's run time
+        std::uint32_t worst_run = 0;
+        std::uint32_t overruns = 0;       // iterations that ran longer than the period
+        float cpu = 0;                    // percent of the brain it used over the last USAGE_MS
+    };
+
+    /*!
+    * \brief register the calling task and set its priority
+    *
+    * Calling this again with the same name (opcontrol restarting) reuses the entry.
+    *
+    * \param name name shown in the stats, must outlive the task
+    * \param priority the priority to run at
+    * \param period_ms the period in milliseconds
+    * \return the id to pass to wait()
+    */
+    int add(const char* name, std::uint32_t priority, std::uint32_t period_ms);
+
+    /*!
+    * \brief register a task we don't own the loop of, only its priority is managed
+    * \param name name shown in the stats
+    * \param task the task
+    * \param priority the priority to run at
+    * \return the id of the entry
+    */
+    int adopt(const char* name, pros::Task task, std::uint32_t priority);
+
+    /*!
+    * \brief stop checking a task's deadlines while it is busy outside its loop, like opcontrol running the auton
+    * \param id the id from add()
+    */
+    void pause(int id);
+
+    /*!
+    * \brief start a paused task's loop again from now, so the time it spent paused isn't a miss
+    * \param id the id from add()
+    */
+    void resume(int id);
+
+    /*!
+    * \brief ends this iteration, records a miss if it ran past its deadline, and sleeps until the next release
+    * \param id the id from add()
+    */
+    void wait(int id);
+
+    /*!
+    * \brief looks for starved tasks, the highest priority loop calls this every tick
+    *
+    * Paused tasks, and tasks PROS has killed (opcontrol once autonomous starts), are skipped.
+    */
+    void check();
+
+    /*!
+    * \brief called with the task id whenever a deadline is missed or a task starves
+    * \param callback the function to call, runs inside the task that noticed
+    */
+    void on_miss(std::function<void(int)> callback);
+
+    /*!
+    * \brief called with the task id whenever an iteration runs longer than its period
+    * \param callback the function to call, runs inside the task that overran
+    */
+    void on_overrun(std::function<void(int)> callback);
+
+    /*!
+    * \brief percent of the brain the registered tasks used over the last USAGE_MS, the rest went to
+    *        EZ-Template, PROS and idle
+    */
+    float cpu_total();
+
+    /*!
+    * \brief overruns of every registered task so far
+    */
+    std::uint32_t overruns_total();
+
+    /*!
+    * \brief the stats of one task
+    * \param id the id from add() or adopt()
+    */
+    Stats get(int id);
+
+    /*!
+    * \brief the number of registered tasks, ids go from 0 to count() - 1
+    */
+    int count();
+}
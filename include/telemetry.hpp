@@ -0,0 +1,209 @@
+#pragma once
+
+#include <cstdint>
+
+namespace ctrl{
+    struct Sample;
+}
+
+/*! \namespace telemetry
+ *  \brief Binary run logs on the sd card, without the control tasks ever waiting on it
+ *
+ *  It has the ability to:
+ *
+ *      -take fixed size records of the pose, PID targets and terms, motors, DSR samples and events from
+ *       any task, into a lock free ring buffer
+ *
+ *      -log the pose, the running motion's PID and the DSR sensors every control tick and the motors
+ *       every MOTOR_TICKS ticks
+ *
+ *      -write the records out from its own lowest priority task, in BLOCK_BYTES blocks, to a file that
+ *       was made full size before the match so a slow sd card write never reaches the control tasks
+ *
+ *      -start every run with a header block holding the auton and the calibration in use, and count
+ *       the records dropped because the buffer or the file was full
+ *
+ *  The file is a run of BLOCK_BYTES blocks, each a Block header and BLOCK_RECORDS records, or a Header for
+ *  a new run. Anything after the last block in sequence is left from preallocating and isn't the log.
+ */
+namespace telemetry{
+
+    /*!
+    * \brief what a record holds
+    */
+    enum Type{
+        NONE = 0,       // padding at the end of a block
+        POSE = 1,       // x, y, theta, left, right, imu from the control loop sample
+        TARGET = 2,     // id is the ez::e_mode, left, right, turn, swing, heading and xy PID targets
+        PID = 3,        // id is a Pid, target, current, error, integral, derivative, output
+        MOTOR = 4,      // id is the port, current mA, temperature C, velocity rpm, command, jams
+        DISTANCE = 5,   // id is the DSR sensor index, sensed in, with offsets in, x offset, y offset
+        EVENT = 6,      // id is an Event, the values depend on it
+        TEXT = 7        // id is the Event it names, text holds up to 24 characters
+    };
+
+    /*!
+    * \brief the PID in a PID record
+    */
+    enum Pid{
+        PID_LEFT = 0,
+        PID_RIGHT = 1,
+        PID_TURN = 2,
+        PID_SWING = 3,
+        PID_HEADING = 4,
+        PID_XY = 5,
+        PID_ANGULAR = 6
+    };
+
+    /*!
+    * \brief events, with what their values are
+    */
+    enum Event{
+        RUN = 0,          // a run started, the header block comes before it
+        STEP = 1,         // a profiler step finished, port is its index: kind, duration ms, slack ms, target, final error,
+                          //   then a TEXT record with the call that started it
+        JAM = 2,          // port is the roller's: jams so far
+        FAULT = 3,        // port is the device's: plugged, faults so far
+        DSR_RESET = 4,    // port is the x sensor: x before, y before, x after, y after, an axis that wasn't reset is unchanged
+        DEADLINE = 5,     // port is the task id: misses so far, times starved
+        MARK = 6,         // anything worth finding later, then a TEXT record
+        OVERRUN = 7,      // port is the task id: run us, period us, overruns so far
+        AIR = 8           // port is the air::Warning it went up to: psi, psi predicted air::WARN_S ahead
+    };
+
+    /*!
+    * \brief one record, 32 bytes
+    */
+    struct Record{
+        std::uint32_t time = 0;   // micros since boot
+        std::uint8_t type = NONE;
+        std::uint8_t id = 0;
+        std::uint16_t port = 0;   // EVENT: the port or index it is about
+        union{
+            float values[6];
+            char text[24];
+        };
+        Record() : values{}{}
+    };
+
+    /*!
+    * \brief size of a block in the file, written whole
+    */
+    inline const int BLOCK_BYTES = 512;
+
+    /*!
+    * \brief records in a data block, after its Block header
+    */
+    inline const int BLOCK_RECORDS = BLOCK_BYTES / sizeof(Record) - 1;
+
+    /*!
+    * \brief the start of a data block, the same size as a record
+    */
+    struct Block{
+        char magic[4] = {'T', 'L', 'M', 'B'};
+        std::uint32_t sequence = 0;   // blocks since the start of the file, headers included
+        std::uint16_t run = 0;
+        std::uint16_t records = 0;    // records used, the rest are NONE
+        std::uint32_t dropped = 0;    // records dropped since boot, when the block was written
+        std::uint8_t reserved[16] = {};
+    };
+
+    /*!
+    * \brief the block that starts a run, with the calibration in use
+    */
+    struct Header{
+        char magic[4] = {'T', 'L', 'M', 'R'};
+        std::uint32_t sequence = 0;
+        std::uint16_t run = 0;
+        std::uint16_t version = 1;
+        std::uint16_t record_bytes = sizeof(Record);
+        std::uint16_t block_bytes = BLOCK_BYTES;
+        std::uint32_t start = 0;      // micros the run started
+        std::uint32_t dropped = 0;
+        char name[48] = "";           // the auton, or opcontrol
+        float tick_per_inch = 0;
+        float drive_width = 0;
+        float imu_scaler = 0;
+        float trackers[4] = {};       // left, right, front and back tracker distance to center, 0 without one
+        std::uint32_t dsr_count = 0;
+        float dsr_offsets[8][2] = {}; // x and y offset of each DSR sensor
+        float pid[7][4] = {};         // kp, ki, kd, start_i of each Pid
+        std::uint8_t reserved[BLOCK_BYTES - 280] = {};
+    };
+
+    /*!
+    * \brief the file made at boot, big enough for about 20 minutes of runs
+    */
+    inline const std::uint32_t FILE_BYTES = 32 * 1024 * 1024;
+
+    /*!
+    * \brief records the ring buffer holds, the writer drains it every WRITE_MS
+    */
+    inline const int RING_RECORDS = 1024;
+    inline const std::uint32_t WRITE_MS = 20;
+
+    /*!
+    * \brief motors are logged every this many control ticks
+    */
+    inline const int MOTOR_TICKS = 10;
+
+    /*!
+    * \brief open the next free /usd/tlm_<n>.bin if there is an sd card, start the writer and add the
+    *        per tick logging to the control loop, call once in initialize() before ctrl::start()
+    */
+    void start();
+
+    /*!
+    * \brief log to this file instead, made FILE_BYTES long now
+    * \return false if it couldn't be made
+    */
+    bool open(const char* path);
+
+    /*!
+    * \brief start a run, its header block takes the calibration as it is now
+    * \param name the auton, or opcontrol
+    */
+    void begin(const char* name);
+
+    /*!
+    * \brief add a record from any task, it is dropped and counted if the buffer is full
+    */
+    void push(const Record& record);
+
+    /*!
+    * \brief log the pose, the PID of the running motion and the DSR sensors, and the motors every MOTOR_TICKS,
+    *        called by the control loop every tick
+    * \param sample the sample from this tick's sense stage
+    */
+    void tick(const ctrl::Sample& sample);
+
+    /*!
+    * \brief log an event
+    * \param event what happened
+    * \param port the port or index it is about
+    * \param a, b, c, d, e, f its values
+    */
+    void event(Event event, int port, float a = 0, float b = 0, float c = 0, float d = 0, float e = 0, float f = 0);
+
+    /*!
+    * \brief log a TEXT record, truncated to 24 characters
+    * \param event the event it names
+    */
+    void text(Event event, const char* text);
+
+    /*!
+    * \brief have the writer write the part filled block and flush the file, for the end of a run, doesn't wait for it
+    */
+    void flush();
+
+    /*!
+    * \brief records dropped because the buffer or the file was full
+    */
+    std::uint32_t dropped();
+
+    /*!
+    * \brief records and blocks written to the file so far
+    */
+    std::uint32_t written();
+    std::uint32_t blocks();
+}
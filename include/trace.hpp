@@ -0,0 +1,134 @@
+#pragma once
+
+#include <cstdint>
+
+/*! \namespace trace
+ *  \brief Timeline of what every task was doing, for sim/build/timeline to turn into a Chrome/Perfetto trace
+ *
+ *  It has the ability to:
+ *
+ *      -time a scope with TRACE_SPAN(name), or record a span that was timed somewhere else
+ *
+ *      -keep the spans of each task in its own buffer, written only by that task so recording never
+ *       takes a lock, with the newest MAX_SPANS kept
+ *
+ *      -keep named tracks for timelines that aren't a task's, like the states of a Machine
+ *
+ *      -save every buffer to a file once recording stops
+ *
+ *  Spans are timed with pros::micros(). Names are kept as pointers until the file is saved, so they
+ *  have to be string literals or outlive the save. EZ-Template's own tasks are compiled into
+ *  EZ-Template.a and can't be spanned from inside, what they do shows up in the control loop and the
+ *  waits of the task that started the motion.
+ *
+ *  The file is a FileHeader, a TrackHeader per track, the names, each a 16 bit length and its characters,
+ *  then the Spans of every track in the order of the tracks.
+ */
+namespace trace{
+
+    /*!
+    * \brief the most tasks and named tracks
+    */
+    inline const int MAX_TRACKS = 10;
+
+    /*!
+    * \brief spans kept per track, about 50s of the control loop
+    */
+    inline const int MAX_SPANS = 32768;
+
+    /*!
+    * \brief starts the file
+    */
+    struct FileHeader{
+        char magic[4] = {'T', 'R', 'C', '1'};
+        std::uint32_t tracks = 0;
+        std::uint32_t names = 0;
+        std::uint32_t dropped = 0;    // spans from tasks that didn't get a track
+    };
+
+    /*!
+    * \brief one task or named track
+    */
+    struct TrackHeader{
+        char name[32] = {};
+        std::uint32_t priority = 0;   // 0 for a named track
+        std::uint32_t spans = 0;
+        std::uint32_t overwritten = 0;    // older spans lost to newer ones
+        std::uint8_t task = 0;        // 1 if it is a task
+        std::uint8_t reserved[3] = {};
+    };
+
+    /*!
+    * \brief one span in the file
+    */
+    struct Span{
+        std::uint32_t begin = 0;      // micros since start()
+        std::uint32_t duration = 0;   // micros
+        std::uint16_t name = 0;       // index into the names
+        std::uint16_t reserved = 0;
+    };
+
+    /*!
+    * \brief clear every buffer and start recording
+    */
+    void start();
+
+    /*!
+    * \brief stop recording, spans that end after this are dropped
+    */
+    void stop();
+
+    /*!
+    * \brief true between start() and stop()
+    */
+    bool recording();
+
+    /*!
+    * \brief add a span to the calling task's track
+    * \param name what it was, must outlive the save
+    * \param begin micros it started
+    * \param end micros it ended
+    */
+    void record(const char* name, std::uint64_t begin, std::uint64_t end);
+
+    /*!
+    * \brief add a span to a named track, only ever from one task
+    * \param track the track's name, the same pointer every time
+    * \param name what it was, must outlive the save
+    * \param begin micros it started
+    * \param end micros it ended
+    */
+    void record_on(const char* track, const char* name, std::uint64_t begin, std::uint64_t end);
+
+    /*!
+    * \brief write every track to a file, call after stop()
+    * \return false if it couldn't be written
+    */
+    bool save(const char* path);
+
+    /*!
+    * \brief spans lost since start(), overwritten or from tasks past MAX_TRACKS
+    */
+    std::uint32_t dropped();
+
+    /*!
+    * \brief times its own lifetime into the calling task's track, use TRACE_SPAN
+    */
+    class Scope{
+        public:
+        explicit Scope(const char* name);
+        ~Scope();
+
+        private:
+        const char* name;
+        std::uint64_t begin;
+    };
+}
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+
+/*!
+* \brief time the rest of the enclosing scope as a span called name
+*/
+#define TRACE_SPAN(name) trace::Scope TRACE_CONCAT(trace_span_, __LINE__)(name)
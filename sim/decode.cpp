@@ -0,0 +1,90 @@
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "decode.hpp"
+
+/*
+Decodes the brain's binary stream (see stream.hpp) into CSV, one row a sample.
+
+    sim/build/decode capture.bin                    a capture of the link, CSV on stdout
+    sim/build/decode /dev/ttyACM1 --follow          the brain's user port as it comes, every row flushed as soon
+                                                    as it is decoded, to pipe into a live plot
+    sim/build/decode capture.bin -o run.csv         CSV to a file, the counts still go to stderr
+
+Rows are time_ms, sequence, then a column per streamed channel. When the brain changes channels a new
+header row is written before the rows that use them. What was lost on the link is counted at the end.
+*/
+
+int main(int argc, char** argv){
+    const char* path = nullptr;
+    const char* csv_path = nullptr;
+    bool follow = false;
+    for(int i = 1; i < argc; i++){
+        if(std::strcmp(argv[i], "--follow") == 0){
+            follow = true;
+        }else if(std::strcmp(argv[i], "-o") == 0 && i + 1 < argc){
+            csv_path = argv[++i];
+        }else{
+            path = argv[i];
+        }
+    }
+    if(path == nullptr){
+        fprintf(stderr, "usage: decode FILE|PORT [--follow] [-o CSV]\n");
+        return 2;
+    }
+
+    int input = std::strcmp(path, "-") == 0 ? STDIN_FILENO : open(path, O_RDONLY | O_NOCTTY);
+    if(input < 0){
+        fprintf(stderr, "%s: can't open it\n", path);
+        return 1;
+    }
+    //a serial port hands every byte over as it is, no line editing or echo
+    termios settings;
+    if(isatty(input) && tcgetattr(input, &settings) == 0){
+        cfmakeraw(&settings);
+        tcsetattr(input, TCSANOW, &settings);
+    }
+    FILE* csv = csv_path == nullptr ? stdout : std::fopen(csv_path, "w");
+    if(csv == nullptr){
+        fprintf(stderr, "%s: can't write it\n", csv_path);
+        return 1;
+    }
+
+    decode::Decoder decoder;
+    decoder.on_schema = [&](){
+        fprintf(csv, "time_ms,sequence");
+        for(int channel : decoder.channels()){
+            fprintf(csv, ",%s", stream::NAMES[channel]);
+        }
+        fprintf(csv, "\n");
+    };
+    decoder.on_row = [&](const decode::Row& row){
+        fprintf(csv, "%u,%u", unsigned(row.time), unsigned(row.sequence));
+        for(double value : row.values){
+            fprintf(csv, ",%g", value);
+        }
+        fprintf(csv, "\n");
+        if(follow){
+            std::fflush(csv);
+        }
+    };
+
+    std::uint8_t buffer[4096];
+    while(true){
+        ssize_t size = read(input, buffer, sizeof(buffer));
+        if(size <= 0){
+            break;
+        }
+        decoder.feed(buffer, size);
+    }
+    std::fflush(csv);
+
+    const decode::Counts& counts = decoder.counts;
+    fprintf(stderr, "%u rows from %u frames, %u bad, %u lost, %u waiting for a key, %u schemas, %ums period, decimated to 1 in %i\n",
+            unsigned(counts.rows), unsigned(counts.frames), unsigned(counts.bad), unsigned(counts.lost), unsigned(counts.unkeyed),
+            unsigned(counts.schemas), unsigned(decoder.period), decoder.decimation);
+    return counts.rows > 0 ? 0 : 1;
+}
@@ -0,0 +1,193 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <vector>
+#include "stream.hpp"
+
+/*! \namespace decode
+ *  \brief Turns the brain's stream (see stream.hpp) back into samples, for decode.cpp
+ *
+ *  Bytes go in as they come off the link, in any size of piece. Frames are cut at every 0 byte,
+ *  and anything that isn't a whole frame with the right CRC is counted and dropped, so text
+ *  printed on the same link only costs the frames it lands in. DELTA frames after a lost frame
+ *  are dropped until the next KEY frame.
+ */
+namespace decode{
+
+    /*!
+    * \brief one sample, the values in the order of channels()
+    */
+    struct Row{
+        std::uint32_t time = 0;       // ms on the brain
+        std::uint16_t sequence = 0;
+        std::vector<double> values;
+    };
+
+    /*!
+    * \brief what the decoder has seen
+    */
+    struct Counts{
+        std::uint32_t frames = 0;     // good frames, schemas included
+        std::uint32_t rows = 0;
+        std::uint32_t bad = 0;        // pieces between two 0 bytes that weren't a frame
+        std::uint32_t lost = 0;       // frames missing from the sequence
+        std::uint32_t unkeyed = 0;    // DELTA frames dropped waiting for a KEY
+        std::uint32_t schemas = 0;
+    };
+
+    struct Decoder{
+        std::function<void(const Row&)> on_row = nullptr;
+        std::function<void()> on_schema = nullptr;   // the channels changed, called before the rows that use them
+        Counts counts;
+        std::uint16_t period = 0;     // ms between samples the brain was asked for
+        int decimation = 1;           // what the brain was down to when it last sent the schema
+
+        /*!
+        * \brief the channels in each row, as stream::Channel
+        */
+        const std::vector<int>& channels() const{
+            return channel_list;
+        }
+
+        /*!
+        * \brief add bytes read off the link
+        */
+        void feed(const std::uint8_t* data, std::size_t size){
+            for(std::size_t i = 0; i < size; i++){
+                if(data[i] != 0){
+                    //a frame is never this long, this is text or noise, keep the tail in case a frame starts in it
+                    if(buffer.size() >= 2 * stream::MAX_FRAME){
+                        buffer.clear();
+                        counts.bad++;
+                    }
+                    buffer.push_back(data[i]);
+                    continue;
+                }
+                if(!buffer.empty()){
+                    frame(buffer.data(), buffer.size());
+                    buffer.clear();
+                }
+            }
+        }
+
+    private:
+        std::vector<std::uint8_t> buffer;
+        std::vector<int> channel_list;
+        std::vector<float> scales;
+        std::vector<std::int32_t> values;
+        std::uint32_t mask = 0;
+        std::uint32_t time = 0;
+        std::uint16_t next_sequence = 0;
+        bool sequenced = false;
+        bool keyed = false;
+
+        void frame(const std::uint8_t* encoded, std::size_t size){
+            std::uint8_t payload[2 * stream::MAX_FRAME];
+            std::size_t length = size <= sizeof(payload) ? stream::cobs_decode(encoded, size, payload) : 0;
+            if(length < 5 || stream::crc16(payload, length - 2) != (payload[length - 2] | payload[length - 1] << 8)){
+                counts.bad++;
+                return;
+            }
+            length -= 2;
+            counts.frames++;
+
+            std::uint16_t sequence = std::uint16_t(payload[1] | payload[2] << 8);
+            if(sequenced && sequence != next_sequence){
+                counts.lost += std::uint16_t(sequence - next_sequence);
+                keyed = false;
+            }
+            sequenced = true;
+            next_sequence = sequence + 1;
+
+            const std::uint8_t* at = payload + 3;
+            const std::uint8_t* end = payload + length;
+            std::uint32_t stamp = 0;
+            if(!stream::varint_get(at, end, stamp)){
+                counts.bad++;
+                return;
+            }
+            switch(payload[0]){
+                case stream::SCHEMA:
+                    schema(stamp, at, end);
+                    break;
+                case stream::KEY:
+                case stream::DELTA:
+                    sample(payload[0] == stream::KEY, stamp, sequence, at, end);
+                    break;
+                default:
+                    counts.bad++;
+                    break;
+            }
+        }
+
+        void schema(std::uint32_t stamp, const std::uint8_t* at, const std::uint8_t* end){
+            if(end - at < 8 || at[0] != stream::VERSION){
+                counts.bad++;
+                return;
+            }
+            period = std::uint16_t(at[1] | at[2] << 8);
+            decimation = at[3];
+            std::uint32_t next_mask = at[4] | at[5] << 8 | at[6] << 16 | std::uint32_t(at[7]) << 24;
+            at += 8;
+            std::vector<int> next_channels;
+            std::vector<float> next_scales;
+            for(int channel = 0; channel < stream::CHANNELS; channel++){
+                if((next_mask & (1u << channel)) == 0){
+                    continue;
+                }
+                if(end - at < 4){
+                    counts.bad++;
+                    return;
+                }
+                float scale;
+                std::memcpy(&scale, at, sizeof(scale));
+                at += sizeof(scale);
+                next_channels.push_back(channel);
+                next_scales.push_back(scale);
+            }
+            counts.schemas++;
+            time = stamp;
+            keyed = false;
+            bool changed = next_mask != mask || next_scales != scales;
+            mask = next_mask;
+            channel_list = next_channels;
+            scales = next_scales;
+            values.assign(channel_list.size(), 0);
+            if(changed && on_schema != nullptr){
+                on_schema();
+            }
+        }
+
+        void sample(bool key, std::uint32_t stamp, std::uint16_t sequence, const std::uint8_t* at, const std::uint8_t* end){
+            if(scales.empty() || (!key && !keyed)){
+                counts.unkeyed++;
+                return;
+            }
+            std::vector<std::int32_t> next = values;
+            for(std::size_t i = 0; i < next.size(); i++){
+                std::uint32_t folded;
+                if(!stream::varint_get(at, end, folded)){
+                    counts.bad++;
+                    return;
+                }
+                next[i] = key ? stream::unzigzag(folded) : next[i] + stream::unzigzag(folded);
+            }
+            values = next;
+            time = key ? stamp : time + stamp;
+            keyed = true;
+            counts.rows++;
+            if(on_row == nullptr){
+                return;
+            }
+            Row row;
+            row.time = time;
+            row.sequence = sequence;
+            for(std::size_t i = 0; i < values.size(); i++){
+                row.values.push_back(values[i] / scales[i]);
+            }
+            on_row(row);
+        }
+    };
+}
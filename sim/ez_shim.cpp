@@ -0,0 +1,2123 @@
+#include <cmath>
+#include <sstream>
+#include "main.h"
+#include "sim.hpp"
+
+/*
+EZ-Template only ships as a prebuilt ARM library, so the parts of it the project uses are written
+again here against the same headers. The motions follow the 3.2 behavior closely enough to tune with:
+PID with derivative on measurement, the same exit timers, slew, heading hold, point to point,
+boomerang and injected pure pursuit (smoothing is skipped here, Chassis smooths its own paths before
+handing them over). The brain screen, the sd card, the
+controller curve buttons and the PID tuner do nothing.
+*/
+
+pros::Controller master(pros::E_CONTROLLER_MASTER);
+
+namespace ez{
+    void ez_template_print(){}
+
+    void screen_print(std::string text, int line){}
+
+    std::string exit_to_string(exit_output input){
+        switch(input){
+            case RUNNING:
+                return "Running";
+            case SMALL_EXIT:
+                return "Small";
+            case BIG_EXIT:
+                return "Big";
+            case VELOCITY_EXIT:
+                return "Velocity";
+            case mA_EXIT:
+                return "mA";
+            case ERROR_NO_CONSTANTS:
+                return "Error: Exit condition constants not set!";
+            default:
+                return "Error: Out of bounds!";
+        }
+    }
+
+    namespace util{
+        bool AUTON_RAN = true;
+
+        int places_after_decimal(double input, int min){
+            return min;
+        }
+
+        std::string to_string_with_precision(double input, int n){
+            std::ostringstream out;
+            out.precision(n);
+            out << std::fixed << input;
+            return out.str();
+        }
+
+        int sgn(double input){
+            if(input > 0){
+                return 1;
+            }
+            if(input < 0){
+                return -1;
+            }
+            return 0;
+        }
+
+        bool reversed_active(double input){
+            return input < 0;
+        }
+
+        double clamp(double input, double max, double min){
+            if(input > max){
+                return max;
+            }
+            if(input < min){
+                return min;
+            }
+            return input;
+        }
+
+        double clamp(double input, double max){
+            return clamp(input, std::fabs(max), -std::fabs(max));
+        }
+
+        double to_deg(double input){
+            return input * (180.0 / M_PI);
+        }
+
+        double to_rad(double input){
+            return input * (M_PI / 180.0);
+        }
+
+        double absolute_angle_to_point(pose itarget, pose icurrent){
+            return to_deg(std::atan2(itarget.x - icurrent.x, itarget.y - icurrent.y));
+        }
+
+        double distance_to_point(pose itarget, pose icurrent){
+            return std::hypot(itarget.x - icurrent.x, itarget.y - icurrent.y);
+        }
+
+        double wrap_angle(double theta){
+            while(theta > 180){
+                theta -= 360;
+            }
+            while(theta < -180){
+                theta += 360;
+            }
+            return theta;
+        }
+
+        pose vector_off_point(double added, pose icurrent){
+            double angle = to_rad(icurrent.theta);
+            return {icurrent.x + added * std::sin(angle), icurrent.y + added * std::cos(angle), icurrent.theta};
+        }
+
+        double turn_shortest(double target, double current, bool print){
+            return current + wrap_angle(target - current);
+        }
+
+        double turn_longest(double target, double current, bool print){
+            double shortest = turn_shortest(target, current);
+            return shortest - 360 * sgn(shortest - current);
+        }
+
+        //an angle that isn't set has to stay exactly ANGLE_NOT_SET, converting it rounds it to something else
+        pose united_pose_to_pose(united_pose input){
+            double theta = input.theta == p_ANGLE_NOT_SET ? ANGLE_NOT_SET : input.theta.convert(okapi::degree);
+            return {input.x.convert(okapi::inch), input.y.convert(okapi::inch), theta};
+        }
+
+        odom united_odom_to_odom(united_odom input){
+            return {united_pose_to_pose(input.target), input.drive_direction, input.max_xy_speed, input.turn_behavior};
+        }
+
+        std::vector<odom> united_odoms_to_odoms(std::vector<united_odom> inputs){
+            std::vector<odom> output;
+            for(const united_odom& input : inputs){
+                output.push_back(united_odom_to_odom(input));
+            }
+            return output;
+        }
+    }
+
+    /////
+    // PID
+    /////
+
+    PID::PID(){}
+
+    PID::PID(double p, double i, double d, double start_i, std::string name){
+        constants_set(p, i, d, start_i);
+        name_set(name);
+    }
+
+    void PID::constants_set(double p, double i, double d, double p_start_i){
+        constants = {p, i, d, p_start_i};
+    }
+
+    PID::Constants PID::constants_get(){
+        return constants;
+    }
+
+    bool PID::constants_set_check(){
+        return constants.kp != 0 || constants.ki != 0 || constants.kd != 0 || constants.start_i != 0;
+    }
+
+    void PID::exit_condition_set(int p_small_exit_time, double p_small_error, int p_big_exit_time, double p_big_error, int p_velocity_exit_time, int p_mA_timeout){
+        exit = {p_small_exit_time, p_small_error, p_big_exit_time, p_big_error, p_velocity_exit_time, p_mA_timeout};
+    }
+
+    void PID::target_set(double input){
+        target = input;
+    }
+
+    double PID::target_get(){
+        return target;
+    }
+
+    void PID::variables_reset(){
+        output = 0;
+        target = 0;
+        error = 0;
+        prev_error = 0;
+        integral = 0;
+        time = 0;
+        prev_time = 0;
+    }
+
+    void PID::timers_reset(){
+        i = 0;
+        j = 0;
+        k = 0;
+        l = 0;
+        m = 0;
+    }
+
+    double PID::compute(double current){
+        error = target - current;
+        cur = current;
+        return raw_compute();
+    }
+
+    double PID::compute_error(double err, double current){
+        error = err;
+        cur = current;
+        return raw_compute();
+    }
+
+    double PID::raw_compute(){
+        //derivative on measurement so a new target doesn't kick the output
+        derivative = cur - prev_current;
+        if(constants.ki != 0){
+            if(std::fabs(error) < constants.start_i){
+                integral += error;
+            }
+            if(util::sgn(error) != util::sgn(prev_error) && reset_i_sgn){
+                integral = 0;
+            }
+        }
+        output = error * constants.kp + integral * constants.ki - derivative * constants.kd;
+        prev_current = cur;
+        prev_error = error;
+        return output;
+    }
+
+    void PID::name_set(std::string p_name){
+        name = p_name;
+        name_active = !name.empty();
+    }
+
+    std::string PID::name_get(){
+        return name;
+    }
+
+    void PID::i_reset_toggle(bool toggle){
+        reset_i_sgn = toggle;
+    }
+
+    bool PID::i_reset_get(){
+        return reset_i_sgn;
+    }
+
+    void PID::velocity_sensor_secondary_set(double secondary_sensor){
+        second_sensor = secondary_sensor;
+    }
+
+    double PID::velocity_sensor_secondary_get(){
+        return second_sensor;
+    }
+
+    void PID::velocity_sensor_secondary_toggle_set(bool toggle){
+        use_second_sensor = toggle;
+    }
+
+    bool PID::velocity_sensor_secondary_toggle_get(){
+        return use_second_sensor;
+    }
+
+    void PID::velocity_sensor_main_exit_set(double zero){
+        velocity_zero_main = zero;
+    }
+
+    double PID::velocity_sensor_main_exit_get(){
+        return velocity_zero_main;
+    }
+
+    void PID::velocity_sensor_secondary_exit_set(double zero){
+        velocity_zero_secondary = zero;
+    }
+
+    double PID::velocity_sensor_secondary_exit_get(){
+        return velocity_zero_secondary;
+    }
+
+    void PID::exit_condition_print(ez::exit_output exit_type){}
+
+    exit_output PID::exit_condition(bool print){
+        if(!(exit.small_error && exit.small_exit_time && exit.big_error && exit.big_exit_time && exit.velocity_exit_time && exit.mA_timeout)){
+            return ERROR_NO_CONSTANTS;
+        }
+
+        if(std::fabs(error) < exit.small_error){
+            j += util::DELAY_TIME;
+            i = 0;
+            if(j > exit.small_exit_time){
+                timers_reset();
+                return SMALL_EXIT;
+            }
+        }else{
+            j = 0;
+        }
+
+        if(std::fabs(error) < exit.big_error){
+            i += util::DELAY_TIME;
+            if(i > exit.big_exit_time){
+                timers_reset();
+                return BIG_EXIT;
+            }
+        }else{
+            i = 0;
+        }
+
+        if(std::fabs(derivative) <= velocity_zero_main){
+            k += util::DELAY_TIME;
+            if(k > exit.velocity_exit_time){
+                timers_reset();
+                return VELOCITY_EXIT;
+            }
+        }else{
+            k = 0;
+        }
+        return RUNNING;
+    }
+
+    exit_output PID::exit_condition(pros::Motor sensor, bool print){
+        return exit_condition(std::vector<pros::Motor>{sensor}, print);
+    }
+
+    exit_output PID::exit_condition(std::vector<pros::Motor> sensor, bool print){
+        bool over = false;
+        for(pros::Motor& motor : sensor){
+            over |= motor.is_over_current() == 1;
+        }
+        if(over){
+            l += util::DELAY_TIME;
+            if(l > exit.mA_timeout){
+                timers_reset();
+                return mA_EXIT;
+            }
+        }else{
+            l = 0;
+        }
+        return exit_condition(print);
+    }
+
+    /////
+    // slew
+    /////
+
+    slew::slew(){}
+
+    slew::slew(double distance, int minimum_speed){
+        constants_set(distance, minimum_speed);
+    }
+
+    void slew::constants_set(double distance, int minimum_speed){
+        constants = {double(minimum_speed), distance};
+    }
+
+    slew::Constants slew::constants_get(){
+        return constants;
+    }
+
+    void slew::initialize(bool enabled, double maximum_speed, double target, double current){
+        is_enabled = enabled && constants.distance_to_travel > 0;
+        max_speed = maximum_speed;
+        sign = util::sgn(target - current);
+        x_intercept = current + constants.distance_to_travel * sign;
+        y_intercept = max_speed * sign;
+        slope = (sign * constants.min_speed - y_intercept) / (x_intercept - current);
+    }
+
+    double slew::iterate(double current){
+        if(is_enabled){
+            error = x_intercept - current;
+            if(util::sgn(error) != sign){
+                is_enabled = false;
+            }else{
+                last_output = (slope * error + y_intercept) * sign;
+            }
+        }
+        if(!is_enabled){
+            last_output = max_speed;
+        }
+        return last_output;
+    }
+
+    bool slew::enabled(){
+        return is_enabled;
+    }
+
+    double slew::output(){
+        return last_output;
+    }
+
+    void slew::speed_max_set(double speed){
+        max_speed = speed;
+    }
+
+    double slew::speed_max_get(){
+        return max_speed;
+    }
+
+    /////
+    // Piston
+    /////
+
+    Piston::Piston(int input_port, bool default_state) : piston(input_port, default_state){
+        reversed = default_state;
+    }
+
+    void Piston::set(bool input){
+        piston.set_value(reversed ? !input : input);
+        current = input;
+    }
+
+    bool Piston::get(){
+        return current;
+    }
+
+    void Piston::button_toggle(int toggle){
+        if(toggle && !last_press){
+            set(!current);
+        }
+        last_press = toggle;
+    }
+
+    void Piston::buttons(int active, int deactive){
+        if(active && !current){
+            set(true);
+        }else if(deactive && current){
+            set(false);
+        }
+    }
+
+    /////
+    // tracking_wheel
+    /////
+
+    tracking_wheel::tracking_wheel(int port, double wheel_diameter, double distance_to_center, double ratio)
+        : adi_encoder(0, 0, false), smart_encoder(port){
+        IS_TRACKER = DRIVE_ROTATION;
+        WHEEL_DIAMETER = wheel_diameter;
+        DISTANCE_TO_CENTER = distance_to_center;
+        RATIO = ratio;
+        ENCODER_TICKS_PER_REV = 36000.0;
+    }
+
+    double tracking_wheel::get_raw(){
+        return smart_encoder.get_position();
+    }
+
+    double tracking_wheel::get(){
+        return get_raw() / ticks_per_inch();
+    }
+
+    void tracking_wheel::reset(){
+        smart_encoder.reset_position();
+    }
+
+    double tracking_wheel::ticks_per_inch(){
+        return ENCODER_TICKS_PER_REV * RATIO / (WHEEL_DIAMETER * M_PI);
+    }
+
+    void tracking_wheel::distance_to_center_set(double input){
+        DISTANCE_TO_CENTER = input;
+    }
+
+    double tracking_wheel::distance_to_center_get(){
+        return IS_FLIPPED ? -DISTANCE_TO_CENTER : DISTANCE_TO_CENTER;
+    }
+
+    void tracking_wheel::distance_to_center_flip_set(bool input){
+        IS_FLIPPED = input;
+    }
+
+    bool tracking_wheel::distance_to_center_flip_get(){
+        return IS_FLIPPED;
+    }
+
+    void tracking_wheel::ticks_per_rev_set(double input){
+        ENCODER_TICKS_PER_REV = input;
+    }
+
+    double tracking_wheel::ticks_per_rev_get(){
+        return ENCODER_TICKS_PER_REV;
+    }
+
+    void tracking_wheel::ratio_set(double input){
+        RATIO = input;
+    }
+
+    double tracking_wheel::ratio_get(){
+        return RATIO;
+    }
+
+    void tracking_wheel::wheel_diameter_set(double input){
+        WHEEL_DIAMETER = input;
+    }
+
+    double tracking_wheel::wheel_diameter_get(){
+        return WHEEL_DIAMETER;
+    }
+
+    /////
+    // Auton selector
+    /////
+
+    Auton::Auton(){}
+
+    Auton::Auton(std::string name, std::function<void()> callback) : Name(name), auton_call(callback){}
+
+    AutonSelector::AutonSelector(){
+        auton_count = 0;
+        auton_page_current = 0;
+        last_auton_page_current = 0;
+    }
+
+    AutonSelector::AutonSelector(std::vector<Auton> autons) : AutonSelector(){
+        autons_add(autons);
+    }
+
+    void AutonSelector::selected_auton_call(){
+        if(auton_page_current >= 0 && auton_page_current < int(Autons.size())){
+            Autons[auton_page_current].auton_call();
+        }
+    }
+
+    void AutonSelector::selected_auton_print(){}
+
+    void AutonSelector::autons_add(std::vector<Auton> autons){
+        Autons.insert(Autons.end(), autons.begin(), autons.end());
+        auton_count = Autons.size();
+    }
+
+    namespace as{
+        AutonSelector auton_selector;
+        bool turn_off = false;
+        int amount_of_blank_pages = 0;
+        pros::adi::DigitalIn* limit_switch_left = nullptr;
+        pros::adi::DigitalIn* limit_switch_right = nullptr;
+
+        void initialize(){}
+
+        void shutdown(){}
+
+        bool enabled(){
+            return false;
+        }
+
+        int page_blank_current(){
+            return -1;
+        }
+
+        bool page_blank_is_on(int page){
+            return false;
+        }
+
+        void page_blank_remove(int page){}
+
+        void page_blank_remove_all(){}
+
+        int page_blank_amount(){
+            return 0;
+        }
+    }
+}
+
+/////
+// Drive
+/////
+
+//distance to a steering point inside which the angle stops chasing it and is held
+static const double HOLD_DISTANCE = 6.0;
+
+static bool angle_held = false;
+static double held_angle = 0;
+
+//last reading of every tracker odom has used, so one can be swapped out mid run, fixed size so odom
+//never allocates like EZ-Template's doesn't
+struct TrackerLast{
+    ez::tracking_wheel* tracker = nullptr;
+    double last = 0;
+};
+static TrackerLast tracker_last[4];
+
+static double tracker_delta(ez::tracking_wheel* tracker){
+    double now = tracker->get();
+    for(TrackerLast& entry : tracker_last){
+        if(entry.tracker == tracker || entry.tracker == nullptr){
+            double delta = entry.tracker == nullptr ? 0 : now - entry.last;
+            entry = {tracker, now};
+            return delta;
+        }
+    }
+    return 0;
+}
+
+Drive::Drive(std::vector<int> left_motor_ports, std::vector<int> right_motor_ports, int imu_port, double wheel_diameter, double ticks, double ratio)
+    : imu(imu_port), left_tracker(0, 0, false), right_tracker(0, 0, false), left_rotation(0), right_rotation(0),
+      ez_auto([this]{ this->ez_auto_task(); }, TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "EZ-Template"){
+    for(int port : left_motor_ports){
+        left_motors.push_back(pros::Motor(port));
+    }
+    for(int port : right_motor_ports){
+        right_motors.push_back(pros::Motor(port));
+    }
+    odom_tracker_left = nullptr;
+    odom_tracker_right = nullptr;
+    odom_tracker_front = nullptr;
+    odom_tracker_back = nullptr;
+
+    WHEEL_DIAMETER = wheel_diameter;
+    CARTRIDGE = ticks;
+    RATIO = ratio;
+    CIRCUMFERENCE = WHEEL_DIAMETER * M_PI;
+    //the sim reports motor positions in degrees of the wheel
+    TICK_PER_REV = 360.0;
+    TICK_PER_INCH = TICK_PER_REV / CIRCUMFERENCE;
+    max_speed = 127;
+    mode = DISABLE;
+    current_swing = LEFT_SWING;
+    JOYSTICK_THRESHOLD = 5;
+    left_curve_scale = 0;
+    right_curve_scale = 0;
+    odom_path_smooth_constants_set(0.75, 0.03, 0.0001);
+}
+
+void Drive::initialize(){
+    imu_calibration_complete = true;
+    drive_sensor_reset();
+}
+
+void Drive::drive_mode_set(e_mode p_mode, bool stop_drive){
+    mode = p_mode;
+    if(mode == DISABLE && stop_drive){
+        private_drive_set(0, 0);
+    }
+}
+
+e_mode Drive::drive_mode_get(){
+    return mode;
+}
+
+void Drive::private_drive_set(int left, int right){
+    left = util::clamp(left, 127, -127);
+    right = util::clamp(right, 127, -127);
+    for(pros::Motor& motor : left_motors){
+        motor.move_voltage(left * (12000.0 / 127.0));
+    }
+    for(pros::Motor& motor : right_motors){
+        motor.move_voltage(right * (12000.0 / 127.0));
+    }
+}
+
+void Drive::drive_set(int left, int right){
+    private_drive_set(left, right);
+}
+
+void Drive::drive_brake_set(pros::motor_brake_mode_e_t brake_type){
+    CURRENT_BRAKE = brake_type;
+    for(pros::Motor& motor : left_motors){
+        motor.set_brake_mode(brake_type);
+    }
+    for(pros::Motor& motor : right_motors){
+        motor.set_brake_mode(brake_type);
+    }
+}
+
+pros::motor_brake_mode_e_t Drive::drive_brake_get(){
+    return CURRENT_BRAKE;
+}
+
+double Drive::drive_tick_per_inch(){
+    return TICK_PER_INCH;
+}
+
+double Drive::drive_sensor_left(){
+    return left_motors.front().get_position() / drive_tick_per_inch();
+}
+
+double Drive::drive_sensor_right(){
+    return right_motors.front().get_position() / drive_tick_per_inch();
+}
+
+int Drive::drive_sensor_left_raw(){
+    return left_motors.front().get_position();
+}
+
+int Drive::drive_sensor_right_raw(){
+    return right_motors.front().get_position();
+}
+
+int Drive::drive_velocity_left(){
+    return left_motors.front().get_actual_velocity();
+}
+
+int Drive::drive_velocity_right(){
+    return right_motors.front().get_actual_velocity();
+}
+
+double Drive::drive_mA_left(){
+    return left_motors.front().get_current_draw();
+}
+
+double Drive::drive_mA_right(){
+    return right_motors.front().get_current_draw();
+}
+
+void Drive::drive_sensor_reset(){
+    for(pros::Motor& motor : left_motors){
+        motor.tare_position();
+    }
+    for(pros::Motor& motor : right_motors){
+        motor.tare_position();
+    }
+    for(tracking_wheel* tracker : {odom_tracker_left, odom_tracker_right, odom_tracker_front, odom_tracker_back}){
+        if(tracker != nullptr){
+            tracker->reset();
+        }
+    }
+    for(TrackerLast& entry : tracker_last){
+        entry = TrackerLast();
+    }
+    l_last = 0;
+    r_last = 0;
+}
+
+double Drive::drive_imu_get(){
+    return imu.get_rotation() * IMU_SCALER;
+}
+
+void Drive::drive_imu_reset(double new_heading){
+    imu.set_rotation(new_heading / IMU_SCALER);
+    t_last = new_heading;
+}
+
+void Drive::drive_imu_scaler_set(double scaler){
+    IMU_SCALER = scaler;
+}
+
+double Drive::drive_imu_scaler_get(){
+    return IMU_SCALER;
+}
+
+bool Drive::drive_imu_calibrate(bool run_loading_animation){
+    imu_calibration_complete = true;
+    return true;
+}
+
+bool Drive::drive_imu_calibrated(){
+    return imu_calibration_complete;
+}
+
+void Drive::drive_width_set(double input){
+    global_track_width = input;
+}
+
+void Drive::drive_width_set(okapi::QLength p_input){
+    drive_width_set(p_input.convert(okapi::inch));
+}
+
+double Drive::drive_width_get(){
+    return global_track_width;
+}
+
+void Drive::drive_angle_set(double angle){
+    headingPID.target_set(angle);
+    drive_imu_reset(angle);
+}
+
+void Drive::drive_angle_set(okapi::QAngle p_angle){
+    drive_angle_set(p_angle.convert(okapi::degree));
+}
+
+void Drive::pid_print_toggle(bool toggle){
+    print_toggle = toggle;
+}
+
+bool Drive::pid_print_toggle_get(){
+    return print_toggle;
+}
+
+void Drive::pid_drive_toggle(bool toggle){
+    drive_toggle = toggle;
+}
+
+bool Drive::pid_drive_toggle_get(){
+    return drive_toggle;
+}
+
+/////
+// Odometry
+/////
+
+void Drive::odom_enable(bool input){
+    odometry_enabled = input;
+}
+
+bool Drive::odom_enabled(){
+    return odometry_enabled;
+}
+
+void Drive::odom_x_set(double x){
+    odom_current.x = x;
+}
+
+void Drive::odom_x_set(okapi::QLength p_x){
+    odom_x_set(p_x.convert(okapi::inch));
+}
+
+double Drive::odom_x_get(){
+    return odom_current.x;
+}
+
+void Drive::odom_y_set(double y){
+    odom_current.y = y;
+}
+
+void Drive::odom_y_set(okapi::QLength p_y){
+    odom_y_set(p_y.convert(okapi::inch));
+}
+
+double Drive::odom_y_get(){
+    return odom_current.y;
+}
+
+void Drive::odom_theta_set(double a){
+    odom_current.theta = a;
+    drive_angle_set(a);
+}
+
+void Drive::odom_theta_set(okapi::QAngle p_a){
+    odom_theta_set(p_a.convert(okapi::degree));
+}
+
+double Drive::odom_theta_get(){
+    return odom_current.theta;
+}
+
+void Drive::odom_pose_set(pose itarget){
+    odom_xyt_set(itarget.x, itarget.y, itarget.theta);
+}
+
+void Drive::odom_pose_set(united_pose itarget){
+    odom_pose_set(util::united_pose_to_pose(itarget));
+}
+
+void Drive::odom_xy_set(double x, double y){
+    odom_x_set(x);
+    odom_y_set(y);
+}
+
+void Drive::odom_xy_set(okapi::QLength p_x, okapi::QLength p_y){
+    odom_xy_set(p_x.convert(okapi::inch), p_y.convert(okapi::inch));
+}
+
+void Drive::odom_xyt_set(double x, double y, double t){
+    odom_xy_set(x, y);
+    odom_theta_set(t);
+}
+
+void Drive::odom_xyt_set(okapi::QLength p_x, okapi::QLength p_y, okapi::QAngle p_t){
+    odom_xyt_set(p_x.convert(okapi::inch), p_y.convert(okapi::inch), p_t.convert(okapi::degree));
+}
+
+pose Drive::odom_pose_get(){
+    return odom_current;
+}
+
+void Drive::odom_reset(){
+    odom_xyt_set(0.0, 0.0, 0.0);
+}
+
+void Drive::odom_tracker_left_set(tracking_wheel* input){
+    odom_tracker_left = input;
+    odom_tracker_left_enabled = input != nullptr;
+    if(input != nullptr){
+        input->distance_to_center_flip_set(true);
+    }
+}
+
+void Drive::odom_tracker_right_set(tracking_wheel* input){
+    odom_tracker_right = input;
+    odom_tracker_right_enabled = input != nullptr;
+}
+
+void Drive::odom_tracker_front_set(tracking_wheel* input){
+    odom_tracker_front = input;
+    odom_tracker_front_enabled = input != nullptr;
+}
+
+void Drive::odom_tracker_back_set(tracking_wheel* input){
+    odom_tracker_back = input;
+    odom_tracker_back_enabled = input != nullptr;
+    if(input != nullptr){
+        input->distance_to_center_flip_set(true);
+    }
+}
+
+void Drive::odom_boomerang_dlead_set(double input){
+    dlead = input;
+}
+
+double Drive::odom_boomerang_dlead_get(){
+    return dlead;
+}
+
+void Drive::odom_boomerang_distance_set(double distance){
+    max_boomerang_distance = distance;
+}
+
+void Drive::odom_boomerang_distance_set(okapi::QLength p_distance){
+    odom_boomerang_distance_set(p_distance.convert(okapi::inch));
+}
+
+double Drive::odom_boomerang_distance_get(){
+    return max_boomerang_distance;
+}
+
+void Drive::odom_turn_bias_set(double bias){
+    odom_turn_bias_amount = bias;
+}
+
+double Drive::odom_turn_bias_get(){
+    return odom_turn_bias_amount;
+}
+
+void Drive::odom_path_spacing_set(double spacing){
+    SPACING = spacing;
+}
+
+void Drive::odom_path_spacing_set(okapi::QLength p_spacing){
+    odom_path_spacing_set(p_spacing.convert(okapi::inch));
+}
+
+double Drive::odom_path_spacing_get(){
+    return SPACING;
+}
+
+void Drive::odom_path_smooth_constants_set(double weight_smooth, double weight_data, double tolerance){
+    odom_smooth_weight_smooth = weight_smooth;
+    odom_smooth_weight_data = weight_data;
+    odom_smooth_tolerance = tolerance;
+}
+
+std::vector<double> Drive::odom_path_smooth_constants_get(){
+    return {odom_smooth_weight_smooth, odom_smooth_weight_data, odom_smooth_tolerance};
+}
+
+void Drive::odom_look_ahead_set(double distance){
+    LOOK_AHEAD = distance;
+}
+
+void Drive::odom_look_ahead_set(okapi::QLength p_distance){
+    odom_look_ahead_set(p_distance.convert(okapi::inch));
+}
+
+double Drive::odom_look_ahead_get(){
+    return LOOK_AHEAD;
+}
+
+/*
+Vertical trackers read forward motion minus the turn times their offset to the right, horizontal
+trackers read sideways motion plus the turn times their offset forward. Without a tracker the
+drive motors stand in for the vertical one and nothing for the horizontal one.
+*/
+void Drive::ez_tracking_task(){
+    //an unplugged imu reads PROS_ERR_F, and like EZ-Template that goes straight into the pose
+    double theta = drive_imu_get();
+    double turned = util::to_rad(theta - t_last);
+
+    double left = drive_sensor_left();
+    double right = drive_sensor_right();
+    double forward = ((left - l_last) + (right - r_last)) / 2.0;
+    l_last = left;
+    r_last = right;
+
+    tracking_wheel* vertical = odom_tracker_left_enabled ? odom_tracker_left : odom_tracker_right_enabled ? odom_tracker_right : nullptr;
+    if(vertical != nullptr){
+        forward = tracker_delta(vertical) + turned * vertical->distance_to_center_get();
+    }
+    double sideways = 0;
+    tracking_wheel* horizontal = odom_tracker_back_enabled ? odom_tracker_back : odom_tracker_front_enabled ? odom_tracker_front : nullptr;
+    if(horizontal != nullptr){
+        sideways = tracker_delta(horizontal) - turned * horizontal->distance_to_center_get();
+    }
+
+    double heading = util::to_rad(t_last) + turned / 2.0;
+    odom_current.x += forward * std::sin(heading) + sideways * std::cos(heading);
+    odom_current.y += forward * std::cos(heading) - sideways * std::sin(heading);
+    odom_current.theta = theta;
+    t_last = theta;
+}
+
+/////
+// Constants
+/////
+
+void Drive::pid_drive_constants_set(double p, double i, double d, double p_start_i){
+    pid_drive_constants_forward_set(p, i, d, p_start_i);
+    pid_drive_constants_backward_set(p, i, d, p_start_i);
+    fwd_rev_drivePID.constants_set(p, i, d, p_start_i);
+}
+
+void Drive::pid_drive_constants_forward_set(double p, double i, double d, double p_start_i){
+    forward_drivePID.constants_set(p, i, d, p_start_i);
+}
+
+void Drive::pid_drive_constants_backward_set(double p, double i, double d, double p_start_i){
+    backward_drivePID.constants_set(p, i, d, p_start_i);
+}
+
+PID::Constants Drive::pid_drive_constants_get(){
+    return fwd_rev_drivePID.constants_get();
+}
+
+void Drive::pid_heading_constants_set(double p, double i, double d, double p_start_i){
+    headingPID.constants_set(p, i, d, p_start_i);
+}
+
+void Drive::pid_turn_constants_set(double p, double i, double d, double p_start_i){
+    turnPID.constants_set(p, i, d, p_start_i);
+}
+
+void Drive::pid_swing_constants_set(double p, double i, double d, double p_start_i){
+    swingPID.constants_set(p, i, d, p_start_i);
+    forward_swingPID.constants_set(p, i, d, p_start_i);
+    backward_swingPID.constants_set(p, i, d, p_start_i);
+    fwd_rev_swingPID.constants_set(p, i, d, p_start_i);
+}
+
+void Drive::pid_odom_angular_constants_set(double p, double i, double d, double p_start_i){
+    odom_angularPID.constants_set(p, i, d, p_start_i);
+}
+
+void Drive::pid_odom_boomerang_constants_set(double p, double i, double d, double p_start_i){
+    boomerangPID.constants_set(p, i, d, p_start_i);
+}
+
+void Drive::pid_drive_exit_condition_set(int p_small_exit_time, double p_small_error, int p_big_exit_time, double p_big_error, int p_velocity_exit_time, int p_mA_timeout, bool use_imu){
+    leftPID.exit_condition_set(p_small_exit_time, p_small_error, p_big_exit_time, p_big_error, p_velocity_exit_time, p_mA_timeout);
+    rightPID.exit_condition_set(p_small_exit_time, p_small_error, p_big_exit_time, p_big_error, p_velocity_exit_time, p_mA_timeout);
+}
+
+void Drive::pid_turn_exit_condition_set(int p_small_exit_time, double p_small_error, int p_big_exit_time, double p_big_error, int p_velocity_exit_time, int p_mA_timeout, bool use_imu){
+    turnPID.exit_condition_set(p_small_exit_time, p_small_error, p_big_exit_time, p_big_error, p_velocity_exit_time, p_mA_timeout);
+}
+
+void Drive::pid_swing_exit_condition_set(int p_small_exit_time, double p_small_error, int p_big_exit_time, double p_big_error, int p_velocity_exit_time, int p_mA_timeout, bool use_imu){
+    swingPID.exit_condition_set(p_small_exit_time, p_small_error, p_big_exit_time, p_big_error, p_velocity_exit_time, p_mA_timeout);
+}
+
+void Drive::pid_odom_turn_exit_condition_set(int p_small_exit_time, double p_small_error, int p_big_exit_time, double p_big_error, int p_velocity_exit_time, int p_mA_timeout, bool use_imu){
+    odom_angularPID.exit_condition_set(p_small_exit_time, p_small_error, p_big_exit_time, p_big_error, p_velocity_exit_time, p_mA_timeout);
+    boomerangPID.exit_condition_set(p_small_exit_time, p_small_error, p_big_exit_time, p_big_error, p_velocity_exit_time, p_mA_timeout);
+}
+
+void Drive::pid_odom_drive_exit_condition_set(int p_small_exit_time, double p_small_error, int p_big_exit_time, double p_big_error, int p_velocity_exit_time, int p_mA_timeout, bool use_imu){
+    xyPID.exit_condition_set(p_small_exit_time, p_small_error, p_big_exit_time, p_big_error, p_velocity_exit_time, p_mA_timeout);
+}
+
+void Drive::pid_drive_exit_condition_set(okapi::QTime p_small_exit_time, okapi::QLength p_small_error, okapi::QTime p_big_exit_time, okapi::QLength p_big_error, okapi::QTime p_velocity_exit_time, okapi::QTime p_mA_timeout, bool use_imu){
+    pid_drive_exit_condition_set(p_small_exit_time.convert(okapi::millisecond), p_small_error.convert(okapi::inch), p_big_exit_time.convert(okapi::millisecond), p_big_error.convert(okapi::inch),
+                                 p_velocity_exit_time.convert(okapi::millisecond), p_mA_timeout.convert(okapi::millisecond), use_imu);
+}
+
+void Drive::pid_turn_exit_condition_set(okapi::QTime p_small_exit_time, okapi::QAngle p_small_error, okapi::QTime p_big_exit_time, okapi::QAngle p_big_error, okapi::QTime p_velocity_exit_time, okapi::QTime p_mA_timeout, bool use_imu){
+    pid_turn_exit_condition_set(p_small_exit_time.convert(okapi::millisecond), p_small_error.convert(okapi::degree), p_big_exit_time.convert(okapi::millisecond), p_big_error.convert(okapi::degree),
+                                p_velocity_exit_time.convert(okapi::millisecond), p_mA_timeout.convert(okapi::millisecond), use_imu);
+}
+
+void Drive::pid_swing_exit_condition_set(okapi::QTime p_small_exit_time, okapi::QAngle p_small_error, okapi::QTime p_big_exit_time, okapi::QAngle p_big_error, okapi::QTime p_velocity_exit_time, okapi::QTime p_mA_timeout, bool use_imu){
+    pid_swing_exit_condition_set(p_small_exit_time.convert(okapi::millisecond), p_small_error.convert(okapi::degree), p_big_exit_time.convert(okapi::millisecond), p_big_error.convert(okapi::degree),
+                                 p_velocity_exit_time.convert(okapi::millisecond), p_mA_timeout.convert(okapi::millisecond), use_imu);
+}
+
+void Drive::pid_odom_turn_exit_condition_set(okapi::QTime p_small_exit_time, okapi::QAngle p_small_error, okapi::QTime p_big_exit_time, okapi::QAngle p_big_error, okapi::QTime p_velocity_exit_time, okapi::QTime p_mA_timeout, bool use_imu){
+    pid_odom_turn_exit_condition_set(p_small_exit_time.convert(okapi::millisecond), p_small_error.convert(okapi::degree), p_big_exit_time.convert(okapi::millisecond), p_big_error.convert(okapi::degree),
+                                     p_velocity_exit_time.convert(okapi::millisecond), p_mA_timeout.convert(okapi::millisecond), use_imu);
+}
+
+void Drive::pid_odom_drive_exit_condition_set(okapi::QTime p_small_exit_time, okapi::QLength p_small_error, okapi::QTime p_big_exit_time, okapi::QLength p_big_error, okapi::QTime p_velocity_exit_time, okapi::QTime p_mA_timeout, bool use_imu){
+    pid_odom_drive_exit_condition_set(p_small_exit_time.convert(okapi::millisecond), p_small_error.convert(okapi::inch), p_big_exit_time.convert(okapi::millisecond), p_big_error.convert(okapi::inch),
+                                      p_velocity_exit_time.convert(okapi::millisecond), p_mA_timeout.convert(okapi::millisecond), use_imu);
+}
+
+void Drive::pid_drive_chain_constant_set(double input){
+    pid_drive_chain_forward_constant_set(input);
+    pid_drive_chain_backward_constant_set(input);
+}
+
+void Drive::pid_drive_chain_constant_set(okapi::QLength input){
+    pid_drive_chain_constant_set(input.convert(okapi::inch));
+}
+
+void Drive::pid_drive_chain_forward_constant_set(double input){
+    drive_forward_motion_chain_scale = std::fabs(input);
+}
+
+void Drive::pid_drive_chain_backward_constant_set(double input){
+    drive_backward_motion_chain_scale = std::fabs(input);
+}
+
+void Drive::pid_turn_chain_constant_set(double input){
+    turn_motion_chain_scale = std::fabs(input);
+}
+
+void Drive::pid_turn_chain_constant_set(okapi::QAngle input){
+    pid_turn_chain_constant_set(input.convert(okapi::degree));
+}
+
+void Drive::pid_swing_chain_constant_set(double input){
+    swing_forward_motion_chain_scale = std::fabs(input);
+    swing_backward_motion_chain_scale = std::fabs(input);
+}
+
+void Drive::pid_swing_chain_constant_set(okapi::QAngle input){
+    pid_swing_chain_constant_set(input.convert(okapi::degree));
+}
+
+void Drive::slew_drive_constants_set(okapi::QLength distance, int min_speed){
+    slew_drive_constants_forward_set(distance, min_speed);
+    slew_drive_constants_backward_set(distance, min_speed);
+}
+
+void Drive::slew_drive_constants_forward_set(okapi::QLength distance, int min_speed){
+    slew_forward.constants_set(distance.convert(okapi::inch), min_speed);
+}
+
+void Drive::slew_drive_constants_backward_set(okapi::QLength distance, int min_speed){
+    slew_backward.constants_set(distance.convert(okapi::inch), min_speed);
+}
+
+void Drive::slew_turn_constants_set(okapi::QAngle distance, int min_speed){
+    slew_turn.constants_set(distance.convert(okapi::degree), min_speed);
+}
+
+void Drive::slew_swing_constants_set(okapi::QLength distance, int min_speed){
+    //swings slew on the distance the moving side covers, turned into degrees of heading here
+    slew_swing.constants_set(util::to_deg(distance.convert(okapi::inch) / 6.0), min_speed);
+}
+
+void Drive::slew_swing_constants_set(okapi::QAngle distance, int min_speed){
+    slew_swing.constants_set(distance.convert(okapi::degree), min_speed);
+}
+
+void Drive::slew_drive_set(bool slew_on){
+    global_forward_drive_slew_enabled = slew_on;
+    global_backward_drive_slew_enabled = slew_on;
+}
+
+void Drive::slew_turn_set(bool slew_on){
+    global_turn_slew_enabled = slew_on;
+}
+
+void Drive::slew_swing_set(bool slew_on){
+    global_forward_swing_slew_enabled = slew_on;
+    global_backward_swing_slew_enabled = slew_on;
+}
+
+void Drive::pid_angle_behavior_set(e_angle_behavior behavior){
+    default_turn_type = behavior;
+    default_swing_type = behavior;
+    default_odom_type = behavior;
+}
+
+void Drive::pid_turn_behavior_set(e_angle_behavior behavior){
+    default_turn_type = behavior;
+}
+
+void Drive::pid_swing_behavior_set(e_angle_behavior behavior){
+    default_swing_type = behavior;
+}
+
+void Drive::pid_odom_behavior_set(e_angle_behavior behavior){
+    default_odom_type = behavior;
+}
+
+void Drive::pid_speed_max_set(int speed){
+    max_speed = std::abs(speed);
+}
+
+int Drive::pid_speed_max_get(){
+    return max_speed;
+}
+
+void Drive::pid_swing_min_set(int min){
+    swing_min = std::abs(min);
+}
+
+void Drive::pid_turn_min_set(int min){
+    turn_min = std::abs(min);
+}
+
+void Drive::pid_targets_reset(){
+    headingPID.target_set(0);
+    leftPID.target_set(0);
+    rightPID.target_set(0);
+    turnPID.target_set(0);
+    swingPID.target_set(0);
+    xyPID.target_set(0);
+    odom_target = {0, 0, 0};
+}
+
+/////
+// Opcontrol, not driven in the sim, driver:: builds its curve tables from these
+/////
+
+void Drive::opcontrol_arcade_flipped(e_type stick_type){}
+
+void Drive::opcontrol_tank(){}
+
+void Drive::opcontrol_arcade_standard(e_type stick_type){}
+
+void Drive::opcontrol_curve_default_set(double left, double right){
+    left_curve_scale = left;
+    right_curve_scale = right;
+}
+
+void Drive::opcontrol_curve_buttons_toggle(bool toggle){
+    disable_controller = toggle;
+}
+
+bool Drive::opcontrol_curve_buttons_toggle_get(){
+    return disable_controller;
+}
+
+void Drive::opcontrol_curve_buttons_iterate(){}
+
+std::vector<pros::controller_digital_e_t> Drive::opcontrol_curve_buttons_left_get(){
+    return {l_decrease_.button, l_increase_.button};
+}
+
+std::vector<pros::controller_digital_e_t> Drive::opcontrol_curve_buttons_right_get(){
+    return {r_decrease_.button, r_increase_.button};
+}
+
+//the 5225A curve EZ-Template uses, linear with a scale of 0
+static double curve(double x, double scale){
+    if(scale == 0){
+        return x;
+    }
+    return (std::pow(2.718, -(scale / 10)) + std::pow(2.718, (std::fabs(x) - 127) / 10) * (1 - std::pow(2.718, -(scale / 10)))) * x;
+}
+
+double Drive::opcontrol_curve_left(double x){
+    return curve(x, left_curve_scale);
+}
+
+double Drive::opcontrol_curve_right(double x){
+    return curve(x, right_curve_scale);
+}
+
+int Drive::opcontrol_joystick_threshold_get(){
+    return JOYSTICK_THRESHOLD;
+}
+
+//without active brake, which the project leaves off
+void Drive::opcontrol_joystick_threshold_iterate(int l_stick, int r_stick){
+    if(std::abs(l_stick) > JOYSTICK_THRESHOLD || std::abs(r_stick) > JOYSTICK_THRESHOLD){
+        private_drive_set(l_stick, r_stick);
+    }else{
+        private_drive_set(0, 0);
+    }
+}
+
+double Drive::opcontrol_drive_activebrake_get(){
+    return left_activebrakePID.constants_get().kp;
+}
+
+void Drive::opcontrol_drive_activebrake_set(double kp, double ki, double kd, double start_i){
+    left_activebrakePID.constants_set(kp, ki, kd, start_i);
+    right_activebrakePID.constants_set(kp, ki, kd, start_i);
+}
+
+void Drive::pid_tuner_enable(){}
+
+void Drive::pid_tuner_disable(){}
+
+void Drive::pid_tuner_toggle(){}
+
+bool Drive::pid_tuner_enabled(){
+    return false;
+}
+
+void Drive::pid_tuner_iterate(){}
+
+/////
+// Motions
+/////
+
+double Drive::new_turn_target_compute(double target, double current, ez::e_angle_behavior behavior){
+    switch(behavior){
+        case shortest:
+            return util::turn_shortest(target, current);
+        case longest:
+            return util::turn_longest(target, current);
+        case left_turn:
+            return turn_left(target, current);
+        case right_turn:
+            return turn_right(target, current);
+        default:
+            return target;
+    }
+}
+
+double Drive::turn_left(double target, double current, bool print){
+    double shortest = util::turn_shortest(target, current);
+    return shortest > current ? shortest - 360 : shortest;
+}
+
+double Drive::turn_right(double target, double current, bool print){
+    double shortest = util::turn_shortest(target, current);
+    return shortest < current ? shortest + 360 : shortest;
+}
+
+void Drive::pid_drive_set(double target, int speed, bool slew_on, bool toggle_heading){
+    l_start = drive_sensor_left();
+    r_start = drive_sensor_right();
+    bool backwards = target < 0;
+
+    //heading hold keeps the last angle it was given, a motion that didn't give one leaves it wherever the robot is
+    if(mode != DRIVE && mode != TURN && mode != SWING){
+        headingPID.target_set(drive_imu_get());
+    }
+
+    for(PID* pid : {&leftPID, &rightPID}){
+        pid->constants = backwards ? backward_drivePID.constants : forward_drivePID.constants;
+        pid->timers_reset();
+        pid->integral = 0;
+    }
+    leftPID.target_set(l_start + target);
+    rightPID.target_set(r_start + target);
+    leftPID.prev_current = l_start;
+    rightPID.prev_current = r_start;
+
+    slew_left.constants = backwards ? slew_backward.constants : slew_forward.constants;
+    slew_right.constants = slew_left.constants;
+    slew_left.initialize(slew_on, std::abs(speed), l_start + target, l_start);
+    slew_right.initialize(slew_on, std::abs(speed), r_start + target, r_start);
+
+    heading_on = toggle_heading;
+    pid_speed_max_set(speed);
+    drive_mode_set(DRIVE);
+}
+
+void Drive::pid_drive_set(double target, int speed){
+    pid_drive_set(target, speed, target < 0 ? global_backward_drive_slew_enabled : global_forward_drive_slew_enabled);
+}
+
+void Drive::pid_drive_set(okapi::QLength p_target, int speed, bool slew_on, bool toggle_heading){
+    pid_drive_set(p_target.convert(okapi::inch), speed, slew_on, toggle_heading);
+}
+
+void Drive::pid_drive_set(okapi::QLength p_target, int speed){
+    pid_drive_set(p_target.convert(okapi::inch), speed);
+}
+
+void Drive::pid_turn_set(double target, int speed, e_angle_behavior behavior, bool slew_on){
+    double current = drive_imu_get();
+    double new_target = new_turn_target_compute(target, current, behavior);
+    turnPID.target_set(new_target);
+    headingPID.target_set(new_target);
+    turnPID.timers_reset();
+    turnPID.integral = 0;
+    turnPID.prev_current = current;
+    slew_turn.initialize(slew_on, std::abs(speed), new_target, current);
+    pid_speed_max_set(speed);
+    drive_mode_set(TURN);
+}
+
+void Drive::pid_turn_set(double target, int speed){
+    pid_turn_set(target, speed, default_turn_type, global_turn_slew_enabled);
+}
+
+void Drive::pid_turn_set(double target, int speed, e_angle_behavior behavior){
+    pid_turn_set(target, speed, behavior, global_turn_slew_enabled);
+}
+
+void Drive::pid_turn_set(double target, int speed, bool slew_on){
+    pid_turn_set(target, speed, default_turn_type, slew_on);
+}
+
+void Drive::pid_turn_set(okapi::QAngle p_target, int speed){
+    pid_turn_set(p_target.convert(okapi::degree), speed);
+}
+
+void Drive::pid_turn_set(okapi::QAngle p_target, int speed, e_angle_behavior behavior){
+    pid_turn_set(p_target.convert(okapi::degree), speed, behavior);
+}
+
+void Drive::pid_turn_set(okapi::QAngle p_target, int speed, bool slew_on){
+    pid_turn_set(p_target.convert(okapi::degree), speed, slew_on);
+}
+
+void Drive::pid_turn_set(okapi::QAngle p_target, int speed, e_angle_behavior behavior, bool slew_on){
+    pid_turn_set(p_target.convert(okapi::degree), speed, behavior, slew_on);
+}
+
+void Drive::pid_turn_set(pose itarget, drive_directions dir, int speed, e_angle_behavior behavior, bool slew_on){
+    point_to_face[0] = itarget;
+    current_drive_direction = dir;
+    double face = util::absolute_angle_to_point(itarget, odom_current) + (dir == REV ? 180 : 0);
+    pid_turn_set(face, speed, behavior, slew_on);
+    drive_mode_set(TURN_TO_POINT);
+}
+
+void Drive::pid_turn_set(pose itarget, drive_directions dir, int speed){
+    pid_turn_set(itarget, dir, speed, default_turn_type, global_turn_slew_enabled);
+}
+
+void Drive::pid_turn_set(pose itarget, drive_directions dir, int speed, bool slew_on){
+    pid_turn_set(itarget, dir, speed, default_turn_type, slew_on);
+}
+
+void Drive::pid_turn_set(pose itarget, drive_directions dir, int speed, e_angle_behavior behavior){
+    pid_turn_set(itarget, dir, speed, behavior, global_turn_slew_enabled);
+}
+
+void Drive::pid_turn_set(united_pose p_itarget, drive_directions dir, int speed){
+    pid_turn_set(util::united_pose_to_pose(p_itarget), dir, speed);
+}
+
+void Drive::pid_turn_set(united_pose p_itarget, drive_directions dir, int speed, bool slew_on){
+    pid_turn_set(util::united_pose_to_pose(p_itarget), dir, speed, slew_on);
+}
+
+void Drive::pid_turn_set(united_pose p_itarget, drive_directions dir, int speed, e_angle_behavior behavior){
+    pid_turn_set(util::united_pose_to_pose(p_itarget), dir, speed, behavior);
+}
+
+void Drive::pid_turn_set(united_pose p_itarget, drive_directions dir, int speed, e_angle_behavior behavior, bool slew_on){
+    pid_turn_set(util::united_pose_to_pose(p_itarget), dir, speed, behavior, slew_on);
+}
+
+void Drive::pid_turn_relative_set(double target, int speed, e_angle_behavior behavior, bool slew_on){
+    pid_turn_set(turnPID.target_get() + target, speed, behavior, slew_on);
+}
+
+void Drive::pid_turn_relative_set(double target, int speed){
+    pid_turn_relative_set(target, speed, raw, global_turn_slew_enabled);
+}
+
+void Drive::pid_turn_relative_set(okapi::QAngle p_target, int speed){
+    pid_turn_relative_set(p_target.convert(okapi::degree), speed);
+}
+
+void Drive::pid_swing_set(e_swing type, double target, int speed, int opposite_speed, e_angle_behavior behavior, bool slew_on){
+    current_swing = type;
+    swing_opposite_speed = opposite_speed;
+    double current = drive_imu_get();
+    double new_target = new_turn_target_compute(target, current, behavior);
+    swingPID.target_set(new_target);
+    headingPID.target_set(new_target);
+    swingPID.timers_reset();
+    swingPID.integral = 0;
+    swingPID.prev_current = current;
+    slew_swing.initialize(slew_on, std::abs(speed), new_target, current);
+    pid_speed_max_set(speed);
+    drive_mode_set(SWING);
+}
+
+void Drive::pid_swing_set(e_swing type, double target, int speed){
+    pid_swing_set(type, target, speed, 0, default_swing_type, global_forward_swing_slew_enabled);
+}
+
+void Drive::pid_swing_set(e_swing type, double target, int speed, int opposite_speed){
+    pid_swing_set(type, target, speed, opposite_speed, default_swing_type, global_forward_swing_slew_enabled);
+}
+
+void Drive::pid_swing_set(e_swing type, double target, int speed, e_angle_behavior behavior){
+    pid_swing_set(type, target, speed, 0, behavior, global_forward_swing_slew_enabled);
+}
+
+void Drive::pid_swing_set(e_swing type, double target, int speed, bool slew_on){
+    pid_swing_set(type, target, speed, 0, default_swing_type, slew_on);
+}
+
+void Drive::pid_swing_set(e_swing type, okapi::QAngle p_target, int speed){
+    pid_swing_set(type, p_target.convert(okapi::degree), speed);
+}
+
+void Drive::pid_swing_set(e_swing type, okapi::QAngle p_target, int speed, int opposite_speed){
+    pid_swing_set(type, p_target.convert(okapi::degree), speed, opposite_speed);
+}
+
+void Drive::pid_swing_set(e_swing type, okapi::QAngle p_target, int speed, e_angle_behavior behavior){
+    pid_swing_set(type, p_target.convert(okapi::degree), speed, behavior);
+}
+
+void Drive::pid_swing_set(e_swing type, okapi::QAngle p_target, int speed, bool slew_on){
+    pid_swing_set(type, p_target.convert(okapi::degree), speed, slew_on);
+}
+
+void Drive::pid_swing_set(e_swing type, okapi::QAngle p_target, int speed, int opposite_speed, e_angle_behavior behavior, bool slew_on){
+    pid_swing_set(type, p_target.convert(okapi::degree), speed, opposite_speed, behavior, slew_on);
+}
+
+void Drive::pid_swing_relative_set(e_swing type, double target, int speed){
+    pid_swing_set(type, swingPID.target_get() + target, speed, 0, raw, global_forward_swing_slew_enabled);
+}
+
+void Drive::pid_swing_relative_set(e_swing type, okapi::QAngle p_target, int speed){
+    pid_swing_relative_set(type, p_target.convert(okapi::degree), speed);
+}
+
+void Drive::raw_pid_odom_ptp_set(odom imovement, bool slew_on){
+    odom_start = odom_current;
+    odom_target = imovement.target;
+    turn_to_point_target = imovement.target;
+    current_drive_direction = imovement.drive_direction;
+    angle_held = false;
+
+    bool backwards = imovement.drive_direction == REV;
+    xyPID.constants = backwards ? backward_drivePID.constants : forward_drivePID.constants;
+    xyPID.timers_reset();
+    xyPID.integral = 0;
+    odom_angularPID.timers_reset();
+    odom_angularPID.integral = 0;
+    boomerangPID.timers_reset();
+    boomerangPID.integral = 0;
+
+    double distance = util::distance_to_point(odom_target, odom_current);
+    xyPID.prev_current = -distance;
+    odom_angularPID.prev_current = odom_current.theta;
+    boomerangPID.prev_current = odom_current.theta;
+    slew_left.constants = backwards ? slew_backward.constants : slew_forward.constants;
+    slew_left.initialize(slew_on, std::abs(imovement.max_xy_speed), distance, 0);
+
+    pid_speed_max_set(imovement.max_xy_speed);
+    drive_mode_set(POINT_TO_POINT);
+}
+
+void Drive::pid_odom_ptp_set(odom imovement, bool slew_on){
+    was_last_pp_mode_boomerang = false;
+    raw_pid_odom_ptp_set(imovement, slew_on);
+}
+
+void Drive::pid_odom_ptp_set(odom imovement){
+    pid_odom_ptp_set(imovement, global_forward_drive_slew_enabled);
+}
+
+void Drive::pid_odom_ptp_set(united_odom p_imovement, bool slew_on){
+    pid_odom_ptp_set(util::united_odom_to_odom(p_imovement), slew_on);
+}
+
+void Drive::pid_odom_ptp_set(united_odom p_imovement){
+    pid_odom_ptp_set(util::united_odom_to_odom(p_imovement));
+}
+
+void Drive::pid_odom_boomerang_set(odom imovement, bool slew_on){
+    was_last_pp_mode_boomerang = true;
+    raw_pid_odom_ptp_set(imovement, slew_on);
+}
+
+void Drive::pid_odom_boomerang_set(odom imovement){
+    pid_odom_boomerang_set(imovement, global_forward_drive_slew_enabled);
+}
+
+void Drive::pid_odom_boomerang_set(united_odom p_imovement, bool slew_on){
+    pid_odom_boomerang_set(util::united_odom_to_odom(p_imovement), slew_on);
+}
+
+void Drive::pid_odom_boomerang_set(united_odom p_imovement){
+    pid_odom_boomerang_set(util::united_odom_to_odom(p_imovement));
+}
+
+void Drive::pid_odom_set(odom imovement, bool slew_on){
+    if(imovement.target.theta == ANGLE_NOT_SET){
+        pid_odom_ptp_set(imovement, slew_on);
+    }else{
+        pid_odom_boomerang_set(imovement, slew_on);
+    }
+}
+
+void Drive::pid_odom_set(odom imovement){
+    pid_odom_set(imovement, global_forward_drive_slew_enabled);
+}
+
+void Drive::pid_odom_set(united_odom p_imovement, bool slew_on){
+    pid_odom_set(util::united_odom_to_odom(p_imovement), slew_on);
+}
+
+void Drive::pid_odom_set(united_odom p_imovement){
+    pid_odom_set(util::united_odom_to_odom(p_imovement));
+}
+
+void Drive::pid_odom_set(double target, int speed, bool slew_on){
+    pose end = util::vector_off_point(target, odom_current);
+    end.theta = ANGLE_NOT_SET;
+    pid_odom_ptp_set({end, target < 0 ? REV : FWD, speed}, slew_on);
+}
+
+void Drive::pid_odom_set(double target, int speed){
+    pid_odom_set(target, speed, global_forward_drive_slew_enabled);
+}
+
+void Drive::pid_odom_set(okapi::QLength p_target, int speed, bool slew_on){
+    pid_odom_set(p_target.convert(okapi::inch), speed, slew_on);
+}
+
+void Drive::pid_odom_set(okapi::QLength p_target, int speed){
+    pid_odom_set(p_target.convert(okapi::inch), speed);
+}
+
+std::vector<odom> Drive::inject_points(std::vector<odom> imovements){
+    std::vector<odom> path;
+    injected_pp_index.clear();
+    pose last = odom_current;
+    for(const odom& movement : imovements){
+        double length = util::distance_to_point(movement.target, last);
+        int steps = std::max(1, int(length / SPACING));
+        for(int i = 1; i <= steps; i++){
+            odom point = movement;
+            point.target.x = last.x + (movement.target.x - last.x) * i / steps;
+            point.target.y = last.y + (movement.target.y - last.y) * i / steps;
+            point.target.theta = i == steps ? movement.target.theta : ANGLE_NOT_SET;
+            path.push_back(point);
+        }
+        injected_pp_index.push_back(path.size() - 1);
+        last = movement.target;
+    }
+    return path;
+}
+
+void Drive::raw_pid_odom_pp_set(std::vector<odom> imovements, bool slew_on){
+    if(imovements.empty()){
+        return;
+    }
+    pp_movements = std::move(imovements);
+    pp_index = 0;
+    raw_pid_odom_ptp_set(pp_movements.front(), slew_on);
+    //slew runs over the whole path, not the first injected point
+    double length = 0;
+    pose last = odom_current;
+    for(const odom& movement : pp_movements){
+        length += util::distance_to_point(movement.target, last);
+        last = movement.target;
+    }
+    slew_left.initialize(slew_on, std::abs(pp_movements.front().max_xy_speed), length, 0);
+    drive_mode_set(PURE_PURSUIT);
+}
+
+void Drive::pid_odom_injected_pp_set(std::vector<odom> imovements, bool slew_on){
+    raw_pid_odom_pp_set(inject_points(imovements), slew_on);
+}
+
+void Drive::pid_odom_injected_pp_set(std::vector<odom> imovements){
+    pid_odom_injected_pp_set(imovements, global_forward_drive_slew_enabled);
+}
+
+void Drive::pid_odom_injected_pp_set(std::vector<united_odom> p_imovements, bool slew_on){
+    pid_odom_injected_pp_set(util::united_odoms_to_odoms(p_imovements), slew_on);
+}
+
+void Drive::pid_odom_injected_pp_set(std::vector<united_odom> p_imovements){
+    pid_odom_injected_pp_set(util::united_odoms_to_odoms(p_imovements));
+}
+
+//followed as given, every point is a waypoint
+void Drive::pid_odom_pp_set(std::vector<odom> imovements, bool slew_on){
+    injected_pp_index.clear();
+    for(int i = 0; i < int(imovements.size()); i++){
+        injected_pp_index.push_back(i);
+    }
+    raw_pid_odom_pp_set(std::move(imovements), slew_on);
+}
+
+void Drive::pid_odom_pp_set(std::vector<odom> imovements){
+    pid_odom_pp_set(std::move(imovements), global_forward_drive_slew_enabled);
+}
+
+void Drive::pid_odom_pp_set(std::vector<united_odom> p_imovements, bool slew_on){
+    pid_odom_pp_set(util::united_odoms_to_odoms(p_imovements), slew_on);
+}
+
+void Drive::pid_odom_pp_set(std::vector<united_odom> p_imovements){
+    pid_odom_pp_set(util::united_odoms_to_odoms(p_imovements));
+}
+
+void Drive::pid_odom_smooth_pp_set(std::vector<odom> imovements, bool slew_on){
+    pid_odom_injected_pp_set(imovements, slew_on);
+}
+
+void Drive::pid_odom_smooth_pp_set(std::vector<odom> imovements){
+    pid_odom_smooth_pp_set(imovements, global_forward_drive_slew_enabled);
+}
+
+void Drive::pid_odom_smooth_pp_set(std::vector<united_odom> p_imovements, bool slew_on){
+    pid_odom_smooth_pp_set(util::united_odoms_to_odoms(p_imovements), slew_on);
+}
+
+void Drive::pid_odom_smooth_pp_set(std::vector<united_odom> p_imovements){
+    pid_odom_smooth_pp_set(util::united_odoms_to_odoms(p_imovements));
+}
+
+void Drive::pid_odom_set(std::vector<odom> imovements, bool slew_on){
+    if(imovements.size() == 1){
+        pid_odom_set(imovements.front(), slew_on);
+    }else{
+        pid_odom_injected_pp_set(imovements, slew_on);
+    }
+}
+
+void Drive::pid_odom_set(std::vector<odom> imovements){
+    pid_odom_set(imovements, global_forward_drive_slew_enabled);
+}
+
+void Drive::pid_odom_set(std::vector<united_odom> p_imovements, bool slew_on){
+    pid_odom_set(util::united_odoms_to_odoms(p_imovements), slew_on);
+}
+
+void Drive::pid_odom_set(std::vector<united_odom> p_imovements){
+    pid_odom_set(util::united_odoms_to_odoms(p_imovements));
+}
+
+/////
+// Control tasks
+/////
+
+void Drive::drive_pid_task(){
+    leftPID.compute(drive_sensor_left());
+    rightPID.compute(drive_sensor_right());
+    headingPID.compute(drive_imu_get());
+
+    double l_max = slew_left.iterate(drive_sensor_left());
+    double r_max = slew_right.iterate(drive_sensor_right());
+    double l_out = util::clamp(leftPID.output, l_max, -l_max);
+    double r_out = util::clamp(rightPID.output, r_max, -r_max);
+    double gyro_out = heading_on ? headingPID.output : 0;
+
+    if(drive_toggle){
+        private_drive_set(l_out + gyro_out, r_out - gyro_out);
+    }
+}
+
+void Drive::turn_pid_task(){
+    if(mode == TURN_TO_POINT){
+        double face = util::absolute_angle_to_point(point_to_face[0], odom_current) + (current_drive_direction == REV ? 180 : 0);
+        turnPID.target_set(util::turn_shortest(face, drive_imu_get()));
+    }
+    double current = drive_imu_get();
+    turnPID.compute(current);
+    double max = slew_turn.iterate(current);
+    double out = util::clamp(turnPID.output, max, -max);
+    if(turn_min != 0 && std::fabs(out) < turn_min && std::fabs(turnPID.error) > turnPID.exit.small_error){
+        out = util::sgn(out) * turn_min;
+    }
+    if(drive_toggle){
+        private_drive_set(out, -out);
+    }
+}
+
+void Drive::swing_pid_task(){
+    double current = drive_imu_get();
+    swingPID.compute(current);
+    double max = slew_swing.iterate(current);
+    double out = util::clamp(swingPID.output, max, -max);
+    double opposite = max_speed == 0 ? 0 : out * swing_opposite_speed / max_speed;
+    if(drive_toggle){
+        if(current_swing == LEFT_SWING){
+            private_drive_set(out, opposite);
+        }else{
+            private_drive_set(-opposite, -out);
+        }
+    }
+}
+
+/*
+Point to point, the other odom motions steer through this. The robot turns toward
+turn_to_point_target and drives the distance to odom_target measured along the way it points.
+*/
+void Drive::ptp_task(){
+    bool rev = current_drive_direction == REV;
+    double heading = drive_imu_get();
+    if(!std::isfinite(heading)){
+        heading = odom_current.theta;
+    }
+
+    double to_steer = util::distance_to_point(turn_to_point_target, odom_current);
+    double face = util::absolute_angle_to_point(turn_to_point_target, odom_current) + (rev ? 180 : 0);
+    if(to_steer < HOLD_DISTANCE){
+        //chasing a point right under the robot spins it, hold the angle it came in with
+        if(!angle_held){
+            angle_held = true;
+            held_angle = face;
+        }
+        face = was_last_pp_mode_boomerang && mode == POINT_TO_POINT ? odom_target.theta : held_angle;
+    }
+    double angle_error = util::wrap_angle(face - heading);
+
+    //distance left, measured along the way the robot is driving
+    double travel = util::to_rad(heading + (rev ? 180 : 0));
+    double dx = odom_target.x - odom_current.x;
+    double dy = odom_target.y - odom_current.y;
+    double along = dx * std::sin(travel) + dy * std::cos(travel);
+
+    double xy_out = xyPID.compute_error(along, -along);
+    PID& angular = was_last_pp_mode_boomerang && mode == POINT_TO_POINT ? boomerangPID : odom_angularPID;
+    double a_out = angular.compute_error(angle_error, heading);
+
+    double travelled = util::distance_to_point(odom_current, odom_start);
+    double max = std::fmin(slew_left.iterate(travelled), max_speed);
+    xy_out = util::clamp(xy_out, max, -max);
+    a_out = util::clamp(a_out, max, -max);
+    if(rev){
+        xy_out = -xy_out;
+    }
+
+    //keep the turn and scale the drive down when both sides can't have what they asked for
+    double l_out = xy_out + a_out;
+    double r_out = xy_out - a_out;
+    double faster = std::fmax(std::fabs(l_out), std::fabs(r_out));
+    if(faster > max){
+        l_out *= max / faster;
+        r_out *= max / faster;
+    }
+    if(drive_toggle){
+        private_drive_set(l_out, r_out);
+    }
+}
+
+void Drive::boomerang_task(){
+    double distance = util::distance_to_point(odom_target, odom_current);
+    double lead = std::fmin(dlead * distance, max_boomerang_distance);
+    double facing = util::to_rad(odom_target.theta);
+    //the carrot sits behind the target on the side the robot comes in from
+    double side = current_drive_direction == REV ? 1 : -1;
+    turn_to_point_target = {odom_target.x + side * lead * std::sin(facing), odom_target.y + side * lead * std::cos(facing), odom_target.theta};
+    ptp_task();
+}
+
+void Drive::pp_task(){
+    int last = pp_movements.size() - 1;
+    while(pp_index < last && util::distance_to_point(pp_movements[pp_index].target, odom_current) < LOOK_AHEAD){
+        pp_index++;
+    }
+    const odom& look = pp_movements[pp_index];
+    odom_target = look.target;
+    turn_to_point_target = look.target;
+    current_drive_direction = look.drive_direction;
+    max_speed = std::abs(look.max_xy_speed);
+    if(pp_index == last){
+        was_last_pp_mode_boomerang = false;
+    }
+    ptp_task();
+}
+
+void Drive::ez_auto_task(){
+    while(true){
+        if(odometry_enabled){
+            ez_tracking_task();
+        }
+        switch(mode){
+            case DRIVE:
+                drive_pid_task();
+                break;
+            case TURN:
+            case TURN_TO_POINT:
+                turn_pid_task();
+                break;
+            case SWING:
+                swing_pid_task();
+                break;
+            case POINT_TO_POINT:
+                was_last_pp_mode_boomerang ? boomerang_task() : ptp_task();
+                break;
+            case PURE_PURSUIT:
+                pp_task();
+                break;
+            default:
+                break;
+        }
+        pros::delay(util::DELAY_TIME);
+    }
+}
+
+/////
+// Waits
+/////
+
+//how far past a point the robot is along the line it came in on, positive once it's past
+//the point of the path a target is, the last one if it isn't on the path (a chained target was moved past it)
+static int path_point(const std::vector<odom>& path, pose target){
+    for(int i = 0; i < int(path.size()); i++){
+        if(path[i].target.x == target.x && path[i].target.y == target.y){
+            return i;
+        }
+    }
+    return int(path.size()) - 1;
+}
+
+double Drive::is_past_target(pose target, pose current){
+    pose from = odom_start;
+    if(mode == PURE_PURSUIT){
+        int point = path_point(pp_movements, target);
+        from = point > 0 ? pp_movements[point - 1].target : odom_start;
+    }
+    double dx = target.x - from.x;
+    double dy = target.y - from.y;
+    double length = std::hypot(dx, dy);
+    if(length < 0.01){
+        double travel = util::to_rad(current.theta + (current_drive_direction == REV ? 180 : 0));
+        dx = std::sin(travel);
+        dy = std::cos(travel);
+        length = 1;
+    }
+    return ((current.x - target.x) * dx + (current.y - target.y) * dy) / length;
+}
+
+static bool exited(ez::exit_output output){
+    return output != ez::RUNNING;
+}
+
+void Drive::pid_wait(){
+    exit_output left = RUNNING;
+    exit_output right = RUNNING;
+    pros::delay(util::DELAY_TIME);
+    while(true){
+        switch(mode){
+            case DRIVE:
+                left = exited(left) ? left : leftPID.exit_condition(left_motors[0]);
+                right = exited(right) ? right : rightPID.exit_condition(right_motors[0]);
+                if(exited(left) && exited(right)){
+                    interfered = left == VELOCITY_EXIT || left == mA_EXIT || right == VELOCITY_EXIT || right == mA_EXIT;
+                    return;
+                }
+                break;
+            case TURN:
+            case TURN_TO_POINT:
+                left = turnPID.exit_condition({left_motors[0], right_motors[0]});
+                break;
+            case SWING:
+                left = swingPID.exit_condition(current_swing == LEFT_SWING ? left_motors[0] : right_motors[0]);
+                break;
+            case POINT_TO_POINT:
+                left = xyPID.exit_condition({left_motors[0], right_motors[0]});
+                break;
+            case PURE_PURSUIT:
+                //nothing exits until the last point is the one being chased
+                if(pp_index == int(pp_movements.size()) - 1){
+                    left = xyPID.exit_condition({left_motors[0], right_motors[0]});
+                }
+                break;
+            default:
+                return;
+        }
+        if(mode != DRIVE && exited(left)){
+            interfered = left == VELOCITY_EXIT || left == mA_EXIT;
+            return;
+        }
+        pros::delay(util::DELAY_TIME);
+    }
+}
+
+void Drive::wait_until_drive(double target){
+    double l_target = l_start + target;
+    double r_target = r_start + target;
+    int l_sgn = util::sgn(l_target - drive_sensor_left());
+    int r_sgn = util::sgn(r_target - drive_sensor_right());
+    exit_output left = RUNNING;
+    exit_output right = RUNNING;
+    while(true){
+        if(util::sgn(l_target - drive_sensor_left()) != l_sgn && util::sgn(r_target - drive_sensor_right()) != r_sgn){
+            return;
+        }
+        left = exited(left) ? left : leftPID.exit_condition(left_motors[0]);
+        right = exited(right) ? right : rightPID.exit_condition(right_motors[0]);
+        if(exited(left) && exited(right)){
+            interfered = left == VELOCITY_EXIT || left == mA_EXIT || right == VELOCITY_EXIT || right == mA_EXIT;
+            return;
+        }
+        pros::delay(util::DELAY_TIME);
+    }
+}
+
+void Drive::wait_until_turn_swing(double target){
+    int sgn = util::sgn(target - drive_imu_get());
+    while(true){
+        if(util::sgn(target - drive_imu_get()) != sgn){
+            return;
+        }
+        exit_output output = mode == SWING ? swingPID.exit_condition(current_swing == LEFT_SWING ? left_motors[0] : right_motors[0])
+                                           : turnPID.exit_condition({left_motors[0], right_motors[0]});
+        if(exited(output)){
+            interfered = output == VELOCITY_EXIT || output == mA_EXIT;
+            return;
+        }
+        pros::delay(util::DELAY_TIME);
+    }
+}
+
+void Drive::pid_wait_until(double target){
+    if(mode == DRIVE){
+        wait_until_drive(target);
+    }else if(mode == TURN || mode == TURN_TO_POINT || mode == SWING){
+        wait_until_turn_swing(target);
+    }else{
+        //odom motions wait on the distance covered since the motion started
+        while(util::distance_to_point(odom_current, odom_start) < std::fabs(target)){
+            if(exited(xyPID.exit_condition({left_motors[0], right_motors[0]}))){
+                return;
+            }
+            pros::delay(util::DELAY_TIME);
+        }
+    }
+}
+
+void Drive::pid_wait_until(okapi::QLength target){
+    pid_wait_until(target.convert(okapi::inch));
+}
+
+void Drive::pid_wait_until(okapi::QAngle target){
+    pid_wait_until(target.convert(okapi::degree));
+}
+
+void Drive::pid_wait_until_point(pose target){
+    //a path can double back past a point before it gets there, so it only counts once the robot is on its part of the path
+    int point = mode == PURE_PURSUIT ? path_point(pp_movements, target) : 0;
+    while((mode == PURE_PURSUIT && pp_index < point) || is_past_target(target, odom_current) < 0){
+        if(mode == POINT_TO_POINT || (mode == PURE_PURSUIT && pp_index == int(pp_movements.size()) - 1)){
+            exit_output output = xyPID.exit_condition({left_motors[0], right_motors[0]});
+            if(exited(output)){
+                interfered = output == VELOCITY_EXIT || output == mA_EXIT;
+                return;
+            }
+        }
+        pros::delay(util::DELAY_TIME);
+    }
+}
+
+void Drive::pid_wait_until_point(united_pose target){
+    pid_wait_until_point(util::united_pose_to_pose(target));
+}
+
+void Drive::pid_wait_until(pose target){
+    pid_wait_until_point(target);
+}
+
+void Drive::pid_wait_until(united_pose target){
+    pid_wait_until_point(util::united_pose_to_pose(target));
+}
+
+void Drive::pid_wait_until_index(int index){
+    if(mode != PURE_PURSUIT || index < 0 || index >= int(injected_pp_index.size())){
+        return;
+    }
+    if(index == int(injected_pp_index.size()) - 1){
+        pid_wait_until_point(pp_movements.back().target);
+        return;
+    }
+    pid_wait_until_point(pp_movements[injected_pp_index[index]].target);
+}
+
+void Drive::pid_wait_until_index_started(int index){
+    if(mode != PURE_PURSUIT || index <= 0 || index >= int(injected_pp_index.size())){
+        return;
+    }
+    while(pp_index <= injected_pp_index[index - 1]){
+        pros::delay(util::DELAY_TIME);
+    }
+}
+
+void Drive::pid_wait_quick(){
+    switch(mode){
+        case DRIVE:
+            wait_until_drive(leftPID.target_get() - l_start);
+            break;
+        case TURN:
+        case TURN_TO_POINT:
+            wait_until_turn_swing(turnPID.target_get());
+            break;
+        case SWING:
+            wait_until_turn_swing(swingPID.target_get());
+            break;
+        case POINT_TO_POINT:
+            pid_wait_until_point(odom_target);
+            break;
+        case PURE_PURSUIT:
+            pid_wait_until_point(pp_movements.back().target);
+            break;
+        default:
+            break;
+    }
+}
+
+void Drive::pid_wait_quick_chain(){
+    switch(mode){
+        case DRIVE:{
+            double target = leftPID.target_get() - l_start;
+            double chain = target < 0 ? -drive_backward_motion_chain_scale : drive_forward_motion_chain_scale;
+            leftPID.target_set(leftPID.target_get() + chain);
+            rightPID.target_set(rightPID.target_get() + chain);
+            wait_until_drive(target);
+            break;
+        }
+        case TURN:
+        case TURN_TO_POINT:{
+            double target = turnPID.target_get();
+            turnPID.target_set(target + util::sgn(target - drive_imu_get()) * turn_motion_chain_scale);
+            wait_until_turn_swing(target);
+            break;
+        }
+        case SWING:{
+            double target = swingPID.target_get();
+            swingPID.target_set(target + util::sgn(target - drive_imu_get()) * swing_forward_motion_chain_scale);
+            wait_until_turn_swing(target);
+            break;
+        }
+        case POINT_TO_POINT:
+        case PURE_PURSUIT:{
+            //carry on past the target along the line the robot came in on
+            pose target = mode == PURE_PURSUIT ? pp_movements.back().target : odom_target;
+            pose from = mode == PURE_PURSUIT && pp_movements.size() > 1 ? pp_movements[pp_movements.size() - 2].target : odom_start;
+            double length = util::distance_to_point(target, from);
+            double chain = current_drive_direction == REV ? drive_backward_motion_chain_scale : drive_forward_motion_chain_scale;
+            if(length > 0.01){
+                pose extended = {target.x + (target.x - from.x) / length * chain, target.y + (target.y - from.y) / length * chain, target.theta};
+                if(mode == PURE_PURSUIT){
+                    pp_movements.back().target = extended;
+                }else{
+                    odom_target = extended;
+                    if(!was_last_pp_mode_boomerang){
+                        turn_to_point_target = extended;
+                    }
+                }
+            }
+            pid_wait_until_point(target);
+            break;
+        }
+        default:
+            break;
+    }
+}
@@ -0,0 +1,266 @@
+#include <dirent.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+#include "logs.hpp"
+#include "pool.hpp"
+
+/*
+Reads a pile of telemetry logs (/usd/tlm_<n>.bin copied off the brain, or sim runs with --log) and
+measures every profiler motion in them, every run on its own thread.
+
+    sim/build/logs logs/                                every run: auton, length, motions, jams, slips, DSR resets
+    sim/build/logs logs/ --summary --last 50            a row per motion of each auton over the last 50 runs:
+                                                        settle time, overshoot, final error, jams and slips
+    sim/build/logs logs/ --summary --by-target          a row per call and target instead, every turn to 180 of
+                                                        every auton together
+    sim/build/logs logs/ --motion "pid_turn_set 180"    that call and target in every run
+    sim/build/logs logs/ --events JAM                   every jam, with its run and time
+    --auton NAME        only runs of this auton
+    --band X            in or deg a motion's error has to stay inside to be settled, 1 if left out
+    -j N                threads
+
+Runs are in the order of their file names, numbers compared as numbers, then their order in the file.
+A motion is the profiler step of an auton, the same line of the auton in every run even when its target
+comes from a sensor.
+*/
+
+static const char* EVENT_NAMES[] = {"RUN", "STEP", "JAM", "FAULT", "DSR_RESET", "DEADLINE", "MARK", "OVERRUN", "AIR"};
+
+//tlm_2.bin before tlm_10.bin
+static bool natural_less(const std::string& a, const std::string& b){
+    std::size_t i = 0, j = 0;
+    while(i < a.size() && j < b.size()){
+        if(std::isdigit(a[i]) && std::isdigit(b[j])){
+            std::size_t i_end = a.find_first_not_of("0123456789", i);
+            std::size_t j_end = b.find_first_not_of("0123456789", j);
+            i_end = i_end == std::string::npos ? a.size() : i_end;
+            j_end = j_end == std::string::npos ? b.size() : j_end;
+            unsigned long long x = std::strtoull(a.c_str() + i, nullptr, 10);
+            unsigned long long y = std::strtoull(b.c_str() + j, nullptr, 10);
+            if(x != y){
+                return x < y;
+            }
+            i = i_end;
+            j = j_end;
+        }else{
+            if(a[i] != b[j]){
+                return a[i] < b[j];
+            }
+            i++;
+            j++;
+        }
+    }
+    return a.size() - i < b.size() - j;
+}
+
+//a file, or every .bin file in a directory
+static void paths_add(const std::string& path, std::vector<std::string>& paths){
+    DIR* dir = opendir(path.c_str());
+    if(dir == nullptr){
+        paths.push_back(path);
+        return;
+    }
+    while(dirent* entry = readdir(dir)){
+        std::string name = entry->d_name;
+        if(name.size() > 4 && name.compare(name.size() - 4, 4, ".bin") == 0){
+            paths.push_back(path + "/" + name);
+        }
+    }
+    closedir(dir);
+}
+
+//call and target, to a whole inch or degree
+static std::string target_key(const logs::Motion& motion){
+    char target[32];
+    snprintf(target, sizeof(target), "%g", std::round(motion.target) + 0.0);
+    return motion.call + " " + target;
+}
+
+static std::string stats(std::vector<double> values, const char* format){
+    if(values.empty()){
+        return "-";
+    }
+    std::sort(values.begin(), values.end());
+    char out[96];
+    std::string f = std::string(format) + "/" + format + "/" + format;
+    snprintf(out, sizeof(out), f.c_str(), logs::percentile(values, 0.5), logs::percentile(values, 0.9), values.back());
+    return out;
+}
+
+int main(int argc, char** argv){
+    std::vector<std::string> paths;
+    std::string auton;
+    std::string motion_only;
+    std::string event_only;
+    bool summary = false;
+    bool by_target = false;
+    int last = 0;
+    int threads = pool::threads_default();
+    logs::Settings settings;
+    for(int i = 1; i < argc; i++){
+        bool value = i + 1 < argc;
+        if(std::strcmp(argv[i], "--summary") == 0){
+            summary = true;
+        }else if(std::strcmp(argv[i], "--by-target") == 0){
+            by_target = true;
+        }else if(std::strcmp(argv[i], "--last") == 0 && value){
+            last = std::atoi(argv[++i]);
+        }else if(std::strcmp(argv[i], "--auton") == 0 && value){
+            auton = argv[++i];
+        }else if(std::strcmp(argv[i], "--motion") == 0 && value){
+            motion_only = argv[++i];
+        }else if(std::strcmp(argv[i], "--events") == 0 && value){
+            event_only = argv[++i];
+        }else if(std::strcmp(argv[i], "--band") == 0 && value){
+            settings.band = std::atof(argv[++i]);
+        }else if(std::strcmp(argv[i], "-j") == 0 && value){
+            threads = std::max(1, std::atoi(argv[++i]));
+        }else if(std::strncmp(argv[i], "-", 1) == 0){
+            printf("unknown option %s\n", argv[i]);
+            return 2;
+        }else{
+            paths_add(argv[i], paths);
+        }
+    }
+    if(paths.empty()){
+        printf("usage: %s FILE|DIR ... [--summary [--by-target]] [--motion \"CALL TARGET\"] [--events KIND] [--auton NAME] [--last N] [--band X] [-j N]\n", argv[0]);
+        return 2;
+    }
+    std::sort(paths.begin(), paths.end(), natural_less);
+    auto wall_start = std::chrono::steady_clock::now();
+
+    std::vector<logs::File> files(paths.size());
+    pool::run(paths.size(), threads, [&](int i){
+        if(!logs::open(paths[i], i, files[i])){
+            fprintf(stderr, "%s: can't map it\n", paths[i].c_str());
+        }
+    });
+
+    std::vector<const logs::Run*> runs;
+    std::size_t bytes = 0;
+    for(const logs::File& file : files){
+        bytes += std::size_t(file.blocks) * telemetry::BLOCK_BYTES;
+        for(const logs::Run& run : file.runs){
+            if(auton.empty() || logs::name(run) == auton){
+                runs.push_back(&run);
+            }
+        }
+    }
+    if(last > 0 && int(runs.size()) > last){
+        runs.erase(runs.begin(), runs.end() - last);
+    }
+
+    std::vector<logs::Metrics> metrics(runs.size());
+    pool::run(runs.size(), threads, [&](int i){
+        metrics[i] = logs::measure(*runs[i], i, settings);
+    });
+    double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+
+    auto run_name = [&](int i){
+        return paths[runs[i]->file] + " run " + std::to_string(runs[i]->header->run) + " " + logs::name(*runs[i]);
+    };
+
+    if(!event_only.empty()){
+        int kind = -1;
+        for(int k = 0; k < int(sizeof(EVENT_NAMES) / sizeof(EVENT_NAMES[0])); k++){
+            kind = event_only == EVENT_NAMES[k] ? k : kind;
+        }
+        if(kind < 0){
+            printf("%s: no event with that name\n", event_only.c_str());
+            return 2;
+        }
+        printf("run\ttime_ms\tport\tvalues\ttext\n");
+        for(int i = 0; i < int(runs.size()); i++){
+            for(const logs::Event& event : logs::events(*runs[i])){
+                const telemetry::Record& record = *event.record;
+                if(record.id != kind){
+                    continue;
+                }
+                printf("%s\t%.0f\t%u\t%g %g %g %g %g %g\t%s\n", run_name(i).c_str(), std::int32_t(record.time - runs[i]->header->start) / 1000.0,
+                       unsigned(record.port), record.values[0], record.values[1], record.values[2], record.values[3], record.values[4],
+                       record.values[5], event.text.c_str());
+            }
+        }
+    }else if(!motion_only.empty()){
+        printf("run\tstart_ms\tduration_ms\tsettle_ms\tovershoot\tfinal_error\tjams\tslips\n");
+        for(const logs::Metrics& run : metrics){
+            for(const logs::Motion& motion : run.motions){
+                if(target_key(motion) != motion_only){
+                    continue;
+                }
+                printf("%s\t%.0f\t%.0f\t%.0f\t%.2f\t%.2f\t%i\t%i\n", run_name(motion.run).c_str(), motion.start, motion.duration, motion.settle,
+                       motion.overshoot, motion.final_error, motion.jams, motion.slips);
+            }
+        }
+    }else if(summary){
+        struct Group{
+            std::vector<double> target, duration, settle, overshoot, error;
+            std::string call;
+            int runs = 0;
+            int unsettled = 0;
+            int jams = 0;
+            int slips = 0;
+        };
+        //auton and step sort in the order the auton runs them
+        std::map<std::pair<std::string, int>, Group> groups;
+        for(const logs::Metrics& run : metrics){
+            for(const logs::Motion& motion : run.motions){
+                std::pair<std::string, int> key = {target_key(motion), 0};
+                if(!by_target){
+                    key = {logs::name(*runs[motion.run]) + " #", motion.step};
+                }
+                Group& group = groups[key];
+                if(group.runs == 0){
+                    group.call = motion.call;
+                }
+                group.runs++;
+                group.target.push_back(motion.target);
+                group.duration.push_back(motion.duration);
+                if(motion.settle >= 0){
+                    group.settle.push_back(motion.settle);
+                }else{
+                    group.unsettled++;
+                }
+                group.overshoot.push_back(motion.overshoot);
+                group.error.push_back(std::fabs(motion.final_error));
+                group.jams += motion.jams;
+                group.slips += motion.slips;
+            }
+        }
+        printf("%-36s %6s %8s %20s %20s %9s %18s %18s %5s %5s\n", "motion", "count", "target", "duration p50/p90/max", "settle p50/p90/max",
+               "unsettled", "overshoot p50/p90", "|error| p50/p90", "jams", "slips");
+        for(const auto& [key, group] : groups){
+            std::string name = by_target ? key.first : key.first + std::to_string(key.second) + " " + group.call;
+            std::vector<double> target = group.target;
+            std::sort(target.begin(), target.end());
+            printf("%-36s %6i %8.1f %20s %20s %9i %18s %18s %5i %5i\n", name.c_str(), group.runs, logs::percentile(target, 0.5),
+                   stats(group.duration, "%.0f").c_str(),
+                   stats(group.settle, "%.0f").c_str(), group.unsettled, stats(group.overshoot, "%.2f").c_str(), stats(group.error, "%.2f").c_str(),
+                   group.jams, group.slips);
+        }
+    }else{
+        printf("run\tlength_s\tmotions\tjams\tslips\tfaults\tdeadline_misses\toverruns\tdsr_resets\tdsr_worst_in\tdropped\n");
+        for(int i = 0; i < int(runs.size()); i++){
+            const logs::Metrics& run = metrics[i];
+            double worst = 0;
+            for(const logs::Reset& reset : run.resets){
+                worst = std::max(worst, std::hypot(reset.x, reset.y));
+            }
+            printf("%s\t%.2f\t%zu\t%i\t%i\t%i\t%i\t%i\t%zu\t%.2f\t%u\n", run_name(i).c_str(), run.length / 1000, run.motions.size(), run.jams, run.slips,
+                   run.faults, run.deadlines, run.overruns, run.resets.size(), worst, unsigned(runs[i]->dropped));
+        }
+    }
+
+    fprintf(stderr, "%zu files, %zu runs, %.1f MB of log in %.3fs\n", files.size(), runs.size(), bytes / 1e6, wall);
+    for(logs::File& file : files){
+        logs::close(file);
+    }
+    return 0;
+}
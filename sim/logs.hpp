@@ -0,0 +1,387 @@
+#pragma once
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <deque>
+#include <string>
+#include <vector>
+#include "telemetry.hpp"
+
+/*! \namespace logs
+ *  \brief Reads the brain's telemetry logs (see telemetry.hpp) in place, for logs.cpp
+ *
+ *  It has the ability to:
+ *
+ *      -map a log file and index its runs and events without copying a record
+ *
+ *      -cut a run into the profiler's motions and measure each one: settle time, overshoot,
+ *       jams and wheel slip
+ *
+ *      -measure every DSR reset of a run by how far it moved the pose
+ *
+ *  A file is read up to its first block that isn't a log block, the rest is left from preallocating
+ *  and never paged in.
+ */
+namespace logs{
+
+    /*!
+    * \brief one run, pointing into the mapped file
+    */
+    struct Run{
+        const telemetry::Header* header = nullptr;
+        std::vector<const telemetry::Block*> blocks;
+        int file = 0;                 // index into the files it was read from
+        std::uint32_t dropped = 0;    // records dropped before the end of the run, since boot
+    };
+
+    /*!
+    * \brief an event of a run, and the TEXT record after it if it has one
+    */
+    struct Event{
+        const telemetry::Record* record = nullptr;
+        std::string text;
+    };
+
+    /*!
+    * \brief a mapped log file and its runs
+    */
+    struct File{
+        std::string path;
+        const std::uint8_t* data = nullptr;
+        std::size_t size = 0;
+        std::vector<Run> runs;
+        std::uint32_t blocks = 0;     // log blocks, the rest of the file wasn't read
+    };
+
+    /*!
+    * \brief a profiler motion of a run and how it went
+    */
+    struct Motion{
+        int run = 0;                  // index into the runs it was measured from
+        int step = 0;                 // the profiler's step index
+        std::string call;
+        double target = 0;
+        double start = 0;             // ms from the start of the run
+        double duration = 0;          // ms
+        double settle = -1;           // ms until the error stayed in the band, -1 if it never did
+        double overshoot = 0;         // most the error went past 0, in or deg
+        double final_error = 0;
+        int jams = 0;
+        int slips = 0;
+    };
+
+    /*!
+    * \brief a DSR reset and how far it moved the pose
+    */
+    struct Reset{
+        double time = 0;              // ms from the start of the run
+        double x = 0;                 // in it moved the pose
+        double y = 0;
+    };
+
+    /*!
+    * \brief everything measured from one run
+    */
+    struct Metrics{
+        std::vector<Motion> motions;
+        std::vector<Reset> resets;
+        int jams = 0;
+        int slips = 0;
+        int faults = 0;
+        int deadlines = 0;
+        int overruns = 0;
+        double length = 0;            // ms from the header to the last record
+    };
+
+    /*!
+    * \brief how a motion is measured
+    */
+    struct Settings{
+        double band = 1;              // in or deg, a motion is settled once its error stays inside
+        double slip_deg = 2;          // the wheels and the imu disagree on the turn by this much over slip_ms
+        double slip_ms = 100;
+    };
+
+    /*!
+    * \brief map a file and index its runs
+    * \return false if it couldn't be mapped
+    */
+    inline bool open(const std::string& path, int index, File& file){
+        file.path = path;
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if(fd < 0){
+            return false;
+        }
+        struct stat info;
+        if(fstat(fd, &info) != 0 || info.st_size < telemetry::BLOCK_BYTES){
+            ::close(fd);
+            return false;
+        }
+        void* mapped = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if(mapped == MAP_FAILED){
+            return false;
+        }
+        file.data = static_cast<const std::uint8_t*>(mapped);
+        file.size = info.st_size;
+        madvise(mapped, file.size, MADV_SEQUENTIAL);
+
+        Run* run = nullptr;
+        for(std::size_t at = 0; at + telemetry::BLOCK_BYTES <= file.size; at += telemetry::BLOCK_BYTES){
+            const std::uint8_t* block = file.data + at;
+            if(std::memcmp(block, "TLMR", 4) == 0){
+                file.runs.emplace_back();
+                run = &file.runs.back();
+                run->header = reinterpret_cast<const telemetry::Header*>(block);
+                run->file = index;
+            }else if(std::memcmp(block, "TLMB", 4) == 0){
+                //records from before the first run of the file belong to no run
+                const telemetry::Block* data = reinterpret_cast<const telemetry::Block*>(block);
+                if(run != nullptr && data->run == run->header->run){
+                    run->blocks.push_back(data);
+                    run->dropped = data->dropped;
+                }
+            }else{
+                break;
+            }
+            file.blocks++;
+        }
+        return true;
+    }
+
+    inline void close(File& file){
+        if(file.data != nullptr){
+            munmap(const_cast<std::uint8_t*>(file.data), file.size);
+            file.data = nullptr;
+        }
+    }
+
+    /*!
+    * \brief call back with every record of a run, in order
+    */
+    template <typename F>
+    inline void each(const Run& run, F callback){
+        for(const telemetry::Block* block : run.blocks){
+            const telemetry::Record* records = reinterpret_cast<const telemetry::Record*>(block + 1);
+            int count = std::min<int>(block->records, telemetry::BLOCK_RECORDS);
+            for(int i = 0; i < count; i++){
+                callback(records[i]);
+            }
+        }
+    }
+
+    /*!
+    * \brief the events of a run, with their TEXT records
+    */
+    inline std::vector<Event> events(const Run& run){
+        std::vector<Event> out;
+        each(run, [&](const telemetry::Record& record){
+            if(record.type == telemetry::EVENT){
+                out.push_back({&record, ""});
+            }else if(record.type == telemetry::TEXT && !out.empty() && out.back().record->id == record.id && out.back().text.empty()){
+                out.back().text.assign(record.text, strnlen(record.text, sizeof(record.text)));
+            }
+        });
+        return out;
+    }
+
+    inline std::string name(const Run& run){
+        return std::string(run.header->name, strnlen(run.header->name, sizeof(run.header->name)));
+    }
+
+    /*!
+    * \brief measure a run's motions and resets
+    * \param index the run's index, kept in its motions
+    */
+    inline Metrics measure(const Run& run, int index, const Settings& settings){
+        Metrics metrics;
+        std::uint32_t start = run.header->start;
+        auto ms = [start](std::uint32_t time){ return std::int32_t(time - start) / 1000.0; };
+
+        //one pass for the per tick series, the motions are cut out of them after
+        struct Point{
+            double time;
+            double value;
+            int id;
+            double target;
+        };
+        struct Pose{
+            double time, left, right, imu;
+        };
+        std::vector<Point> errors;
+        std::vector<Pose> poses;
+        std::vector<double> jams;
+        std::vector<Event> steps;
+
+        const telemetry::Record* step = nullptr;
+        each(run, [&](const telemetry::Record& record){
+            double time = ms(record.time);
+            metrics.length = std::max(metrics.length, time);
+            switch(record.type){
+                case telemetry::PID:
+                    errors.push_back({time, record.values[2], record.id, record.values[0]});
+                    break;
+                case telemetry::POSE:
+                    poses.push_back({time, record.values[3], record.values[4], record.values[5]});
+                    break;
+                case telemetry::EVENT:
+                    step = nullptr;
+                    switch(record.id){
+                        case telemetry::STEP:
+                            step = &record;
+                            steps.push_back({&record, ""});
+                            break;
+                        case telemetry::JAM:
+                            jams.push_back(time);
+                            break;
+                        case telemetry::FAULT:
+                            metrics.faults += record.values[0] == 0;
+                            break;
+                        case telemetry::DEADLINE:
+                            metrics.deadlines++;
+                            break;
+                        case telemetry::OVERRUN:
+                            metrics.overruns++;
+                            break;
+                        case telemetry::DSR_RESET:
+                            metrics.resets.push_back({time, record.values[2] - record.values[0], record.values[3] - record.values[1]});
+                            break;
+                        default:
+                            break;
+                    }
+                    break;
+                case telemetry::TEXT:
+                    if(step != nullptr && record.id == telemetry::STEP){
+                        steps.back().text.assign(record.text, strnlen(record.text, sizeof(record.text)));
+                    }
+                    step = nullptr;
+                    break;
+                default:
+                    break;
+            }
+        });
+        metrics.jams = jams.size();
+
+        //without a width in the header, the one that best fits the wheels' turning to the imu's over the run
+        double width = run.header->drive_width;
+        if(width <= 0){
+            double wheels_imu = 0;
+            double imu_imu = 0;
+            for(std::size_t i = 1; i < poses.size(); i++){
+                double wheels = (poses[i].left - poses[i - 1].left) - (poses[i].right - poses[i - 1].right);
+                double imu = (poses[i].imu - poses[i - 1].imu) * M_PI / 180;
+                wheels_imu += wheels * imu;
+                imu_imu += imu * imu;
+            }
+            width = imu_imu > 0 ? wheels_imu / imu_imu : 0;
+        }
+        //the wheels turning the robot more or less than the imu saw over slip_ms is a slip
+        std::vector<Point> slips;
+        std::deque<Pose> window;
+        for(const Pose& pose : poses){
+            window.push_back(pose);
+            while(window.front().time < pose.time - settings.slip_ms){
+                window.pop_front();
+            }
+            if(width == 0 || (!slips.empty() && pose.time - slips.back().time <= settings.slip_ms)){
+                continue;
+            }
+            const Pose& first = window.front();
+            double wheels = ((pose.left - first.left) - (pose.right - first.right)) / width * 180 / M_PI;
+            double imu = pose.imu - first.imu;
+            if(std::fabs(wheels - imu) > settings.slip_deg){
+                slips.push_back({pose.time, wheels - imu, 0, 0});
+            }
+        }
+        metrics.slips = slips.size();
+
+        auto first_after = [](const auto& series, double time){
+            return std::lower_bound(series.begin(), series.end(), time, [](const auto& point, double t){ return point.time < t; });
+        };
+        for(const Event& event : steps){
+            const telemetry::Record& record = *event.record;
+            if(record.values[0] != 0){
+                continue;    // delays and wait_until, only motions move
+            }
+            Motion motion;
+            motion.run = index;
+            motion.step = record.port;
+            motion.call = event.text;
+            motion.target = record.values[3];
+            motion.final_error = record.values[4];
+            motion.duration = record.values[1];
+            double end = ms(record.time);
+            motion.start = end - motion.duration;
+
+            //the main PID of the motion is the one logged most in it
+            int counts[7] = {};
+            auto begin = first_after(errors, motion.start);
+            auto stop = first_after(errors, end);
+            for(auto point = begin; point != stop; ++point){
+                counts[point->id]++;
+            }
+            int main = -1;
+            double target = 0;
+            for(int id : {telemetry::PID_TURN, telemetry::PID_SWING, telemetry::PID_LEFT, telemetry::PID_XY}){
+                if(main < 0 || counts[id] > counts[main]){
+                    main = id;
+                }
+            }
+            for(auto point = begin; point != stop; ++point){
+                target = point->id == main ? point->target : target;
+            }
+
+            //settled if it ended inside the band, from the last time it was outside, the first tick can
+            //still hold the last motion's target, and the first with this target the last motion's error
+            double first = 0;
+            double last = INFINITY;
+            double outside = motion.start;
+            bool fresh = false;
+            for(auto point = begin; point != stop; ++point){
+                if(point->id != main || point->target != target){
+                    continue;
+                }
+                if(!fresh){
+                    fresh = true;
+                    continue;
+                }
+                if(last == INFINITY){
+                    first = point->value;
+                }
+                last = point->value;
+                motion.overshoot = std::max(motion.overshoot, first > 0 ? -last : first < 0 ? last : 0.0);
+                if(std::fabs(last) > settings.band){
+                    outside = point->time;
+                }
+            }
+            if(std::fabs(last) <= settings.band){
+                motion.settle = outside - motion.start;
+            }
+
+            for(auto jam = std::lower_bound(jams.begin(), jams.end(), motion.start); jam != jams.end() && *jam < end; ++jam){
+                motion.jams++;
+            }
+            for(auto slip = first_after(slips, motion.start); slip != slips.end() && slip->time < end; ++slip){
+                motion.slips++;
+            }
+            metrics.motions.push_back(motion);
+        }
+        std::sort(metrics.motions.begin(), metrics.motions.end(), [](const Motion& a, const Motion& b){ return a.start < b.start; });
+        return metrics;
+    }
+
+    /*!
+    * \brief a value of a sorted list, p from 0 to 1
+    */
+    inline double percentile(const std::vector<double>& sorted, double p){
+        if(sorted.empty()){
+            return 0;
+        }
+        return sorted[std::min<std::size_t>(sorted.size() - 1, std::size_t(p * (sorted.size() - 1) + 0.5))];
+    }
+}
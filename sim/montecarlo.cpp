@@ -0,0 +1,246 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "pool.hpp"
+
+/*
+Runs one auton many times in the sim with randomized errors, spread over every core, and reports
+how far the robot strays from the run without errors.
+
+    sim/build/montecarlo "skills 106"                   1000 runs with the default errors
+    sim/build/montecarlo "skills 106" -n 5000 -j 8      5000 runs on 8 threads
+    sim/build/montecarlo "right 7" --slip 0.1 --dsr 0   the sim's error options replace the defaults
+    --tolerance IN                                      a scoring step further than this from the model is out of position
+*/
+
+//what the sim is given when an error isn't set on the command line
+static const char* DEFAULT_NOISE[][2] = {
+    {"--start", "0.5"},       // in
+    {"--angle", "1"},         // deg
+    {"--slip", "0.05"},
+    {"--drift", "0.01"},      // deg/s
+    {"--dsr", "10"},          // mm
+    {"--strength", "0.05"},
+};
+
+//a scoring step more than this far from the model's heading is out of position
+static const double ANGLE_TOLERANCE = 5;
+
+/*!
+* \brief where the robot was when one profiler step finished
+*/
+struct StepPose{
+    bool seen = false;
+    std::string kind;
+    std::string call;
+    std::string label;
+    double x = 0;
+    double y = 0;
+    double theta = 0;
+};
+
+/*!
+* \brief one sim run
+*/
+struct Run{
+    bool finished = false;
+    double time = 0;
+    double x = 0;
+    double y = 0;
+    double theta = 0;
+    std::vector<StepPose> steps;
+};
+
+static double wrap(double angle){
+    angle = std::fmod(angle + 180, 360);
+    return angle < 0 ? angle + 180 : angle - 180;
+}
+
+//pulls tab separated fields off the front of a line
+static std::string field(char*& line){
+    char* tab = std::strchr(line, '\t');
+    std::string out = tab == nullptr ? std::string(line, std::strcspn(line, "\n")) : std::string(line, tab);
+    line = tab == nullptr ? line + std::strlen(line) : tab + 1;
+    return out;
+}
+
+static Run run_one(const std::string& command){
+    Run run;
+    pool::lines(command, [&run](char* line){
+        std::string type = field(line);
+        if(type == "step"){
+            int index = std::atoi(field(line).c_str());
+            if(index < 0){
+                return;
+            }
+            if(index >= int(run.steps.size())){
+                run.steps.resize(index + 1);
+            }
+            StepPose& step = run.steps[index];
+            step.seen = true;
+            step.kind = field(line);
+            step.call = field(line);
+            step.x = std::atof(field(line).c_str());
+            step.y = std::atof(field(line).c_str());
+            step.theta = std::atof(field(line).c_str());
+            step.label = field(line);
+        }else if(type == "end"){
+            run.finished = true;
+            run.time = std::atof(field(line).c_str());
+            run.x = std::atof(field(line).c_str());
+            run.y = std::atof(field(line).c_str());
+            run.theta = std::atof(field(line).c_str());
+        }
+    });
+    return run;
+}
+
+//value at fraction q of a sorted list
+static double percentile(const std::vector<double>& sorted, double q){
+    if(sorted.empty()){
+        return 0;
+    }
+    return sorted[std::min(sorted.size() - 1, size_t(q * (sorted.size() - 1) + 0.5))];
+}
+
+static void row(const char* name, std::vector<double> values){
+    std::sort(values.begin(), values.end());
+    double mean = 0;
+    for(double v : values){
+        mean += v;
+    }
+    mean /= std::max<size_t>(1, values.size());
+    double sd = 0;
+    for(double v : values){
+        sd += (v - mean) * (v - mean);
+    }
+    sd = std::sqrt(sd / std::max<size_t>(1, values.size()));
+    printf("  %-16s %8.2f %8.2f %8.2f %8.2f %8.2f\n", name, mean, sd, percentile(values, 0.05), percentile(values, 0.5), percentile(values, 0.95));
+}
+
+int main(int argc, char** argv){
+    if(argc < 2){
+        printf("usage: %s <auton> [-n runs] [-j threads] [--tolerance in] [sim error options]\n", argv[0]);
+        return 1;
+    }
+    std::string auton;
+    int runs = 1000;
+    int threads = pool::threads_default();
+    double tolerance = 2;
+    std::vector<std::pair<std::string, std::string>> noise;
+    for(const auto& option : DEFAULT_NOISE){
+        noise.push_back({option[0], option[1]});
+    }
+    for(int i = 1; i < argc; i++){
+        bool value = i + 1 < argc;
+        if(std::strcmp(argv[i], "-n") == 0 && value){
+            runs = std::max(1, std::atoi(argv[++i]));
+        }else if(std::strcmp(argv[i], "-j") == 0 && value){
+            threads = std::max(1, std::atoi(argv[++i]));
+        }else if(std::strcmp(argv[i], "--tolerance") == 0 && value){
+            tolerance = std::atof(argv[++i]);
+        }else if(std::strncmp(argv[i], "--", 2) == 0 && value){
+            bool known = false;
+            for(auto& [name, setting] : noise){
+                if(name == argv[i]){
+                    setting = argv[i + 1];
+                    known = true;
+                }
+            }
+            if(!known){
+                printf("unknown option %s\n", argv[i]);
+                return 1;
+            }
+            i++;
+        }else{
+            auton = argv[i];
+        }
+    }
+
+    std::string command = pool::quote(pool::sibling(argv[0], "sim")) + " --trace";
+    for(const auto& [name, setting] : noise){
+        command += " " + name + " " + pool::quote(setting);
+    }
+    command += " " + pool::quote(auton);
+
+    auto wall_start = std::chrono::steady_clock::now();
+    Run model = run_one(command + " --seed 0");
+    if(!model.finished){
+        printf("%s didn't run, check the name with sim/build/sim \"%s\"\n", auton.c_str(), auton.c_str());
+        return 1;
+    }
+
+    std::vector<Run> results(runs);
+    threads = std::min(threads, runs);
+    pool::run(runs, threads, [&](int job){
+        results[job] = run_one(command + " --seed " + std::to_string(job + 1));
+    });
+    double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+
+    std::vector<double> xs, ys, thetas, offs, times;
+    for(const Run& run : results){
+        if(!run.finished){
+            continue;
+        }
+        xs.push_back(run.x);
+        ys.push_back(run.y);
+        thetas.push_back(model.theta + wrap(run.theta - model.theta));
+        offs.push_back(std::hypot(run.x - model.x, run.y - model.y));
+        times.push_back(run.time);
+    }
+    printf("%s: %i runs in %.1fs on %i threads, %i finished\n", auton.c_str(), runs, wall, threads, int(xs.size()));
+    printf("model ends at (%.1f, %.1f, %.1f) in %.2fs\n\n", model.x, model.y, model.theta, model.time);
+    printf("  final pose           mean       sd       p5      p50      p95\n");
+    row("x", xs);
+    row("y", ys);
+    row("theta", thetas);
+    row("off model (in)", offs);
+    row("time (s)", times);
+
+    //error from the model at the end of every step, it grows between resets and drops at them
+    printf("\n  error from the model when each step finished, in\n");
+    printf("  %4s  %-10s %-22s %-24s %7s %7s %7s %7s\n", "step", "kind", "call", "label", "p50", "p95", "max", "growth");
+    double last_p95 = 0;
+    std::vector<int> scoring;
+    for(int i = 0; i < int(model.steps.size()); i++){
+        const StepPose& expected = model.steps[i];
+        if(!expected.seen){
+            continue;
+        }
+        std::vector<double> errors;
+        for(const Run& run : results){
+            if(i < int(run.steps.size()) && run.steps[i].seen && run.steps[i].call == expected.call && run.steps[i].label == expected.label){
+                errors.push_back(std::hypot(run.steps[i].x - expected.x, run.steps[i].y - expected.y));
+            }
+        }
+        std::sort(errors.begin(), errors.end());
+        double p95 = percentile(errors, 0.95);
+        printf("  %4i  %-10s %-22s %-24s %7.2f %7.2f %7.2f %+7.2f\n", i, expected.kind.c_str(), expected.call.c_str(), expected.label.c_str(),
+               percentile(errors, 0.5), p95, errors.empty() ? 0 : errors.back(), p95 - last_p95);
+        last_p95 = p95;
+        if(expected.label.find("score") != std::string::npos){
+            scoring.push_back(i);
+        }
+    }
+
+    printf("\n  scoring steps out of position, more than %.1fin or %.0fdeg from the model\n", tolerance, ANGLE_TOLERANCE);
+    for(int i : scoring){
+        const StepPose& expected = model.steps[i];
+        int out = 0;
+        int total = 0;
+        for(const Run& run : results){
+            if(i < int(run.steps.size()) && run.steps[i].seen && run.steps[i].label == expected.label){
+                total++;
+                const StepPose& step = run.steps[i];
+                out += std::hypot(step.x - expected.x, step.y - expected.y) > tolerance || std::fabs(wrap(step.theta - expected.theta)) > ANGLE_TOLERANCE;
+            }
+        }
+        printf("  %4i  %-24s %6.1f%%\n", i, expected.label.c_str(), total == 0 ? 0.0 : 100.0 * out / total);
+    }
+    return 0;
+}
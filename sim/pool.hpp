@@ -0,0 +1,122 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdio>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*! \namespace pool
+ *  \brief Runs sim processes in parallel for the host tools
+ *
+ *  The sim's tasks, world and chassis are globals, so every run is its own process. Jobs are
+ *  dealt round robin to one deque per thread, and a thread that runs out steals from the back
+ *  of the others.
+ */
+namespace pool{
+
+    /*!
+    * \brief jobs one thread starts with
+    */
+    struct Queue{
+        std::mutex lock;
+        std::deque<int> jobs;
+    };
+
+    /*!
+    * \brief quote text for the shell
+    */
+    inline std::string quote(const std::string& text){
+        std::string out = "'";
+        for(char c : text){
+            out += c == '\'' ? std::string("'\\''") : std::string(1, c);
+        }
+        return out + "'";
+    }
+
+    /*!
+    * \brief the path of a program built next to this one
+    * \param argv0 argv[0] of this program
+    * \param name the other program
+    */
+    inline std::string sibling(const char* argv0, const char* name){
+        std::string self = argv0;
+        size_t slash = self.find_last_of('/');
+        return (slash == std::string::npos ? std::string(".") : self.substr(0, slash)) + "/" + name;
+    }
+
+    /*!
+    * \brief run a shell command and hand every line it prints to a callback
+    * \return false if it couldn't be started
+    */
+    inline bool lines(const std::string& command, std::function<void(char* line)> callback){
+        FILE* process = popen(command.c_str(), "r");
+        if(process == nullptr){
+            return false;
+        }
+        char buffer[512];
+        while(std::fgets(buffer, sizeof(buffer), process) != nullptr){
+            callback(buffer);
+        }
+        pclose(process);
+        return true;
+    }
+
+    /*!
+    * \brief take the next job, from this thread's deque or stolen from another
+    */
+    inline bool take(std::vector<Queue>& queues, int self, int& job){
+        {
+            std::lock_guard<std::mutex> guard(queues[self].lock);
+            if(!queues[self].jobs.empty()){
+                job = queues[self].jobs.front();
+                queues[self].jobs.pop_front();
+                return true;
+            }
+        }
+        for(int i = 1; i < int(queues.size()); i++){
+            Queue& other = queues[(self + i) % queues.size()];
+            std::lock_guard<std::mutex> guard(other.lock);
+            if(!other.jobs.empty()){
+                job = other.jobs.back();
+                other.jobs.pop_back();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /*!
+    * \brief run jobs 0 to count - 1 on threads, returns once all of them are done
+    * \param work called once per job, from any of the threads
+    */
+    inline void run(int count, int threads, std::function<void(int job)> work){
+        threads = std::max(1, std::min(threads, count));
+        std::vector<Queue> queues(threads);
+        for(int i = 0; i < count; i++){
+            queues[i % threads].jobs.push_back(i);
+        }
+        std::vector<std::thread> workers;
+        for(int t = 0; t < threads; t++){
+            workers.emplace_back([&queues, &work, t]{
+                int job;
+                while(take(queues, t, job)){
+                    work(job);
+                }
+            });
+        }
+        for(std::thread& worker : workers){
+            worker.join();
+        }
+    }
+
+    /*!
+    * \brief threads to use when none are asked for
+    */
+    inline int threads_default(){
+        return std::max(1u, std::thread::hardware_concurrency());
+    }
+}
@@ -0,0 +1,799 @@
+#include <cerrno>
+#include <cmath>
+#include "api.h"
+#include "sim.hpp"
+
+/*
+PROS for the host, backed by the sim world and scheduler.
+Only what the project uses does anything, the rest returns success or zero.
+*/
+
+static std::int32_t unplugged(){
+    errno = ENODEV;
+    return PROS_ERR;
+}
+
+//imu set_rotation() offsets by port, the class itself has no room for them
+static double imu_offsets[22] = {};
+
+static double unplugged_f(){
+    errno = ENODEV;
+    return PROS_ERR_F;
+}
+
+extern "C"{
+    namespace pros::c{
+        std::uint32_t millis(){
+            return sim::micros() / 1000;
+        }
+
+        std::uint64_t micros(){
+            return sim::micros();
+        }
+
+        void delay(const std::uint32_t milliseconds){
+            sim::sleep_until(sim::micros() + std::uint64_t(milliseconds) * 1000);
+        }
+
+        void task_delay(const std::uint32_t milliseconds){
+            delay(milliseconds);
+        }
+
+        void task_delay_until(std::uint32_t* const prev_time, const std::uint32_t delta){
+            *prev_time += delta;
+            sim::sleep_until(std::uint64_t(*prev_time) * 1000);
+        }
+
+        task_t task_create(task_fn_t function, void* const parameters, std::uint32_t prio, const std::uint16_t stack_depth, const char* const name){
+            return sim::task_create([function, parameters]{ function(parameters); }, prio, name);
+        }
+
+        std::int32_t serctl(const std::uint32_t action, void* const extra_arg){
+            return 0;
+        }
+
+        std::int32_t fdctl(int file, const std::uint32_t action, void* const extra_arg){
+            return 0;
+        }
+    }
+}
+
+namespace pros{
+    namespace competition{
+        std::uint8_t get_status(){
+            return 0;
+        }
+
+        std::uint8_t is_autonomous(){
+            return 1;
+        }
+
+        std::uint8_t is_connected(){
+            return 0;
+        }
+
+        std::uint8_t is_disabled(){
+            return 0;
+        }
+
+        std::uint8_t is_field_control(){
+            return 0;
+        }
+
+        std::uint8_t is_competition_switch(){
+            return 0;
+        }
+    }
+
+    namespace usd{
+        //no sd card, nothing gets written on the host
+        std::int32_t is_installed(){
+            return 0;
+        }
+    }
+
+    inline namespace rtos{
+        Task::Task(task_fn_t function, void* parameters, std::uint32_t prio, std::uint16_t stack_depth, const char* name){
+            task = pros::c::task_create(function, parameters, prio, stack_depth, name);
+        }
+
+        Task::Task(task_fn_t function, void* parameters, const char* name)
+            : Task(function, parameters, TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, name){}
+
+        Task::Task(task_t task) : task(task){}
+
+        Task Task::current(){
+            return Task(static_cast<task_t>(sim::task_current()));
+        }
+
+        Task& Task::operator=(task_t in){
+            task = in;
+            return *this;
+        }
+
+        std::uint32_t Task::get_priority(){
+            return sim::task_priority_get(task);
+        }
+
+        void Task::set_priority(std::uint32_t prio){
+            sim::task_priority_set(task, prio);
+        }
+
+        const char* Task::get_name(){
+            return sim::task_name(task);
+        }
+
+        void Task::remove(){
+            sim::task_kill(task);
+        }
+
+        std::uint32_t Task::get_state(){
+            return sim::task_alive(task) ? E_TASK_STATE_READY : E_TASK_STATE_DELETED;
+        }
+
+        void Task::delay(const std::uint32_t milliseconds){
+            pros::c::delay(milliseconds);
+        }
+
+        void Task::delay_until(std::uint32_t* const prev_time, const std::uint32_t delta){
+            pros::c::task_delay_until(prev_time, delta);
+        }
+
+        //only one task runs at a time, so there is never anything to wait for
+        Mutex::Mutex(){}
+
+        bool Mutex::take(){
+            return true;
+        }
+
+        bool Mutex::take(std::uint32_t timeout){
+            return true;
+        }
+
+        bool Mutex::give(){
+            return true;
+        }
+
+        void Mutex::lock(){}
+
+        void Mutex::unlock(){}
+
+        bool Mutex::try_lock(){
+            return true;
+        }
+    }
+
+    inline namespace v5{
+        Device::Device(const std::uint8_t port) : _port(port){}
+
+        std::uint8_t Device::get_port() const{
+            return _port;
+        }
+
+        bool Device::is_installed(){
+            return sim::plugged(_port);
+        }
+
+        DeviceType Device::get_plugged_type() const{
+            return get_plugged_type(_port);
+        }
+
+        DeviceType Device::get_plugged_type(std::uint8_t port){
+            return static_cast<DeviceType>(sim::device_type(port));
+        }
+
+        Motor::Motor(const std::int8_t port, const MotorGears gearset, const MotorUnits encoder_units)
+            : Device(std::abs(port), DeviceType::motor), _port(port){
+            sim::motor_add(port);
+        }
+
+        std::int32_t Motor::move(std::int32_t voltage) const{
+            return move_voltage(voltage * 12000 / 127);
+        }
+
+        std::int32_t Motor::move_absolute(const double position, const std::int32_t velocity) const{
+            return PROS_SUCCESS;
+        }
+
+        std::int32_t Motor::move_relative(const double position, const std::int32_t velocity) const{
+            return PROS_SUCCESS;
+        }
+
+        std::int32_t Motor::move_velocity(const std::int32_t velocity) const{
+            return move_voltage(velocity * 12000 / 600);
+        }
+
+        std::int32_t Motor::move_voltage(const std::int32_t voltage) const{
+            sim::motor_voltage_set(_port, voltage / 1000.0);
+            return PROS_SUCCESS;
+        }
+
+        std::int32_t Motor::brake(void) const{
+            return move_voltage(0);
+        }
+
+        std::int32_t Motor::modify_profiled_velocity(const std::int32_t velocity) const{
+            return PROS_SUCCESS;
+        }
+
+        double Motor::get_target_position(const std::uint8_t index) const{
+            return 0;
+        }
+
+        std::int32_t Motor::get_target_velocity(const std::uint8_t index) const{
+            return PROS_SUCCESS;
+        }
+
+        double Motor::get_actual_velocity(const std::uint8_t index) const{
+            if(!sim::plugged(_port)) return unplugged_f();
+            return sim::motor_velocity(_port);
+        }
+
+        std::int32_t Motor::get_current_draw(const std::uint8_t index) const{
+            if(!sim::plugged(_port)) return unplugged();
+            return std::int32_t(sim::motor_current(_port));
+        }
+
+        std::int32_t Motor::get_direction(const std::uint8_t index) const{
+            return sim::motor_velocity(_port) < 0 ? -1 : 1;
+        }
+
+        double Motor::get_efficiency(const std::uint8_t index) const{
+            return 100;
+        }
+
+        std::uint32_t Motor::get_faults(const std::uint8_t index) const{
+            return 0;
+        }
+
+        std::uint32_t Motor::get_flags(const std::uint8_t index) const{
+            return 0;
+        }
+
+        double Motor::get_position(const std::uint8_t index) const{
+            if(!sim::plugged(_port)) return unplugged_f();
+            return sim::motor_position(_port);
+        }
+
+        double Motor::get_power(const std::uint8_t index) const{
+            return 0;
+        }
+
+        std::int32_t Motor::get_raw_position(std::uint32_t* const timestamp, const std::uint8_t index) const{
+            if(timestamp != nullptr) *timestamp = pros::c::millis();
+            return std::int32_t(sim::motor_position(_port));
+        }
+
+        double Motor::get_temperature(const std::uint8_t index) const{
+            if(!sim::plugged(_port)) return unplugged_f();
+            return sim::motor_temperature(_port);
+        }
+
+        double Motor::get_torque(const std::uint8_t index) const{
+            return 0;
+        }
+
+        std::int32_t Motor::get_voltage(const std::uint8_t index) const{
+            return std::int32_t(sim::motor_voltage(_port) * 1000);
+        }
+
+        std::int32_t Motor::is_over_current(const std::uint8_t index) const{
+            return sim::motor_current(_port) >= 2400;
+        }
+
+        std::int32_t Motor::is_over_temp(const std::uint8_t index) const{
+            return PROS_SUCCESS;
+        }
+
+        MotorBrake Motor::get_brake_mode(const std::uint8_t index) const{
+            return MotorBrake::coast;
+        }
+
+        std::int32_t Motor::get_current_limit(const std::uint8_t index) const{
+            return 2500;
+        }
+
+        MotorUnits Motor::get_encoder_units(const std::uint8_t index) const{
+            return MotorUnits::degrees;
+        }
+
+        MotorGears Motor::get_gearing(const std::uint8_t index) const{
+            return MotorGears::blue;
+        }
+
+        std::int32_t Motor::get_voltage_limit(const std::uint8_t index) const{
+            return 12000;
+        }
+
+        std::int32_t Motor::is_reversed(const std::uint8_t index) const{
+            return _port < 0;
+        }
+
+        std::int32_t Motor::set_brake_mode(const MotorBrake mode, const std::uint8_t index) const{
+            sim::motor_brake_set(_port, mode == MotorBrake::hold);
+            return PROS_SUCCESS;
+        }
+
+        std::int32_t Motor::set_brake_mode(const pros::motor_brake_mode_e_t mode, const std::uint8_t index) const{
+            return set_brake_mode(static_cast<MotorBrake>(mode), index);
+        }
+
+        std::int32_t Motor::set_current_limit(const std::int32_t limit, const std::uint8_t index) const{
+            return PROS_SUCCESS;
+        }
+
+        std::int32_t Motor::set_encoder_units(const MotorUnits units, const std::uint8_t index) const{
+            return PROS_SUCCESS;
+        }
+
+        std::int32_t Motor::set_encoder_units(const pros::motor_encoder_units_e_t units, const std::uint8_t index) const{
+            return PROS_SUCCESS;
+        }
+
+        std::int32_t Motor::set_gearing(const MotorGears gearset, const std::uint8_t index) const{
+            return PROS_SUCCESS;
+        }
+
+        std::int32_t Motor::set_gearing(const pros::motor_gearset_e_t gearset, const std::uint8_t index) const{
+            return PROS_SUCCESS;
+        }
+
+        std::int32_t Motor::set_reversed(const bool reverse, const std::uint8_t index){
+            _port = reverse ? -std::abs(_port) : std::abs(_port);
+            return PROS_SUCCESS;
+        }
+
+        std::int32_t Motor::set_voltage_limit(const std::int32_t limit, const std::uint8_t index) const{
+            return PROS_SUCCESS;
+        }
+
+        std::int32_t Motor::set_zero_position(const double position, const std::uint8_t index) const{
+            sim::motor_tare(_port, sim::motor_position(_port) - position);
+            return PROS_SUCCESS;
+        }
+
+        std::int32_t Motor::tare_position(const std::uint8_t index) const{
+            sim::motor_tare(_port);
+            return PROS_SUCCESS;
+        }
+
+        std::int8_t Motor::size(void) const{
+            return 1;
+        }
+
+        std::vector<Motor> Motor::get_all_devices(){
+            return {};
+        }
+
+        std::int8_t Motor::get_port(const std::uint8_t index) const{
+            return _port;
+        }
+
+        std::vector<double> Motor::get_target_position_all(void) const{
+            return {get_target_position()};
+        }
+
+        std::vector<std::int32_t> Motor::get_target_velocity_all(void) const{
+            return {get_target_velocity()};
+        }
+
+        std::vector<double> Motor::get_actual_velocity_all(void) const{
+            return {get_actual_velocity()};
+        }
+
+        std::vector<std::int32_t> Motor::get_current_draw_all(void) const{
+            return {get_current_draw()};
+        }
+
+        std::vector<std::int32_t> Motor::get_direction_all(void) const{
+            return {get_direction()};
+        }
+
+        std::vector<double> Motor::get_efficiency_all(void) const{
+            return {get_efficiency()};
+        }
+
+        std::vector<std::uint32_t> Motor::get_faults_all(void) const{
+            return {get_faults()};
+        }
+
+        std::vector<std::uint32_t> Motor::get_flags_all(void) const{
+            return {get_flags()};
+        }
+
+        std::vector<double> Motor::get_position_all(void) const{
+            return {get_position()};
+        }
+
+        std::vector<double> Motor::get_power_all(void) const{
+            return {get_power()};
+        }
+
+        std::vector<std::int32_t> Motor::get_raw_position_all(std::uint32_t* const timestamp) const{
+            return {get_raw_position(timestamp)};
+        }
+
+        std::vector<double> Motor::get_temperature_all(void) const{
+            return {get_temperature()};
+        }
+
+        std::vector<double> Motor::get_torque_all(void) const{
+            return {get_torque()};
+        }
+
+        std::vector<std::int32_t> Motor::get_voltage_all(void) const{
+            return {get_voltage()};
+        }
+
+        std::vector<std::int32_t> Motor::is_over_current_all(void) const{
+            return {is_over_current()};
+        }
+
+        std::vector<std::int32_t> Motor::is_over_temp_all(void) const{
+            return {is_over_temp()};
+        }
+
+        std::vector<MotorBrake> Motor::get_brake_mode_all(void) const{
+            return {get_brake_mode()};
+        }
+
+        std::vector<std::int32_t> Motor::get_current_limit_all(void) const{
+            return {get_current_limit()};
+        }
+
+        std::vector<MotorUnits> Motor::get_encoder_units_all(void) const{
+            return {get_encoder_units()};
+        }
+
+        std::vector<MotorGears> Motor::get_gearing_all(void) const{
+            return {get_gearing()};
+        }
+
+        std::vector<std::int8_t> Motor::get_port_all(void) const{
+            return {get_port()};
+        }
+
+        std::vector<std::int32_t> Motor::get_voltage_limit_all(void) const{
+            return {get_voltage_limit()};
+        }
+
+        std::vector<std::int32_t> Motor::is_reversed_all(void) const{
+            return {is_reversed()};
+        }
+
+        std::int32_t Motor::set_brake_mode_all(const MotorBrake mode) const{
+            return set_brake_mode(mode);
+        }
+
+        std::int32_t Motor::set_brake_mode_all(const pros::motor_brake_mode_e_t mode) const{
+            return set_brake_mode(mode);
+        }
+
+        std::int32_t Motor::set_current_limit_all(const std::int32_t limit) const{
+            return set_current_limit(limit);
+        }
+
+        std::int32_t Motor::set_encoder_units_all(const MotorUnits units) const{
+            return set_encoder_units(units);
+        }
+
+        std::int32_t Motor::set_encoder_units_all(const pros::motor_encoder_units_e_t units) const{
+            return set_encoder_units(units);
+        }
+
+        std::int32_t Motor::set_gearing_all(const MotorGears gearset) const{
+            return set_gearing(gearset);
+        }
+
+        std::int32_t Motor::set_gearing_all(const pros::motor_gearset_e_t gearset) const{
+            return set_gearing(gearset);
+        }
+
+        std::int32_t Motor::set_reversed_all(const bool reverse){
+            return set_reversed(reverse);
+        }
+
+        std::int32_t Motor::set_voltage_limit_all(const std::int32_t limit) const{
+            return set_voltage_limit(limit);
+        }
+
+        std::int32_t Motor::set_zero_position_all(const double position) const{
+            return set_zero_position(position);
+        }
+
+        std::int32_t Motor::tare_position_all(void) const{
+            return tare_position();
+        }
+
+        std::int32_t Imu::reset(bool blocking) const{
+            return PROS_SUCCESS;
+        }
+
+        std::int32_t Imu::set_data_rate(std::uint32_t rate) const{
+            return PROS_SUCCESS;
+        }
+
+        double Imu::get_rotation() const{
+            if(!sim::plugged(_port)) return unplugged_f();
+            return sim::imu_rotation() + imu_offsets[_port];
+        }
+
+        double Imu::get_heading() const{
+            if(!sim::plugged(_port)) return unplugged_f();
+            double heading = std::fmod(get_rotation(), 360.0);
+            return heading < 0 ? heading + 360.0 : heading;
+        }
+
+        pros::quaternion_s_t Imu::get_quaternion() const{
+            return {};
+        }
+
+        pros::euler_s_t Imu::get_euler() const{
+            return {0, 0, get_yaw()};
+        }
+
+        double Imu::get_pitch() const{
+            return 0;
+        }
+
+        double Imu::get_roll() const{
+            return 0;
+        }
+
+        double Imu::get_yaw() const{
+            double heading = get_heading();
+            return heading > 180 ? heading - 360 : heading;
+        }
+
+        pros::imu_gyro_s_t Imu::get_gyro_rate() const{
+            return {};
+        }
+
+        std::int32_t Imu::tare_rotation() const{
+            return set_rotation(0);
+        }
+
+        std::int32_t Imu::tare_heading() const{
+            return set_rotation(0);
+        }
+
+        std::int32_t Imu::tare_pitch() const{
+            return PROS_SUCCESS;
+        }
+
+        std::int32_t Imu::tare_yaw() const{
+            return set_rotation(0);
+        }
+
+        std::int32_t Imu::tare_roll() const{
+            return PROS_SUCCESS;
+        }
+
+        std::int32_t Imu::tare() const{
+            return set_rotation(0);
+        }
+
+        std::int32_t Imu::tare_euler() const{
+            return set_rotation(0);
+        }
+
+        std::int32_t Imu::set_heading(const double target) const{
+            return set_rotation(target);
+        }
+
+        std::int32_t Imu::set_rotation(const double target) const{
+            imu_offsets[_port] = target - sim::imu_rotation();
+            return PROS_SUCCESS;
+        }
+
+        std::int32_t Imu::set_yaw(const double target) const{
+            return set_rotation(target);
+        }
+
+        std::int32_t Imu::set_pitch(const double target) const{
+            return PROS_SUCCESS;
+        }
+
+        std::int32_t Imu::set_roll(const double target) const{
+            return PROS_SUCCESS;
+        }
+
+        std::int32_t Imu::set_euler(const pros::euler_s_t target) const{
+            return set_rotation(target.yaw);
+        }
+
+        pros::imu_accel_s_t Imu::get_accel() const{
+            return {};
+        }
+
+        pros::ImuStatus Imu::get_status() const{
+            return pros::ImuStatus::ready;
+        }
+
+        bool Imu::is_calibrating() const{
+            return false;
+        }
+
+        imu_orientation_e_t Imu::get_physical_orientation() const{
+            return pros::E_IMU_Z_UP;
+        }
+
+        Rotation::Rotation(const std::int8_t port) : Device(std::abs(port), DeviceType::rotation){}
+
+        std::int32_t Rotation::reset(){
+            return reset_position();
+        }
+
+        std::int32_t Rotation::set_data_rate(std::uint32_t rate) const{
+            return PROS_SUCCESS;
+        }
+
+        std::int32_t Rotation::set_position(std::uint32_t position) const{
+            return PROS_SUCCESS;
+        }
+
+        std::int32_t Rotation::reset_position() const{
+            sim::rotation_tare(_port);
+            return PROS_SUCCESS;
+        }
+
+        std::int32_t Rotation::get_position() const{
+            if(!sim::plugged(_port)) return unplugged();
+            return std::int32_t(std::lround(sim::rotation_position(_port)));
+        }
+
+        std::int32_t Rotation::get_velocity() const{
+            return 0;
+        }
+
+        std::int32_t Rotation::get_angle() const{
+            std::int32_t angle = get_position() % 36000;
+            return angle < 0 ? angle + 36000 : angle;
+        }
+
+        std::int32_t Rotation::set_reversed(bool value) const{
+            return PROS_SUCCESS;
+        }
+
+        std::int32_t Rotation::reverse() const{
+            return PROS_SUCCESS;
+        }
+
+        std::int32_t Rotation::get_reversed() const{
+            return 0;
+        }
+
+        Distance::Distance(const std::uint8_t port) : Device(port, DeviceType::distance){}
+
+        std::int32_t Distance::get(){
+            return get_distance();
+        }
+
+        std::int32_t Distance::get_distance(){
+            if(!sim::plugged(_port)) return unplugged();
+            return sim::distance_reading(_port);
+        }
+
+        std::int32_t Distance::get_confidence(){
+            return 63;
+        }
+
+        std::int32_t Distance::get_object_size(){
+            return 400;
+        }
+
+        double Distance::get_object_velocity(){
+            return 0;
+        }
+
+        Optical::Optical(const std::uint8_t port) : Device(port, DeviceType::optical){}
+
+        double Optical::get_hue(){
+            if(!sim::plugged(_port)) return unplugged_f();
+            return sim::optical_hue(_port);
+        }
+
+        double Optical::get_saturation(){
+            return 0;
+        }
+
+        double Optical::get_brightness(){
+            return 0;
+        }
+
+        std::int32_t Optical::get_proximity(){
+            if(!sim::plugged(_port)) return unplugged();
+            return sim::optical_proximity(_port);
+        }
+
+        std::int32_t Optical::set_led_pwm(uint8_t value){
+            return PROS_SUCCESS;
+        }
+
+        std::int32_t Optical::get_led_pwm(){
+            return 0;
+        }
+
+        pros::c::optical_rgb_s_t Optical::get_rgb(){
+            return {};
+        }
+
+        pros::c::optical_raw_s_t Optical::get_raw(){
+            return {};
+        }
+
+        pros::c::optical_direction_e_t Optical::get_gesture(){
+            return pros::c::NO_GESTURE;
+        }
+
+        pros::c::optical_gesture_s_t Optical::get_gesture_raw(){
+            return {};
+        }
+
+        std::int32_t Optical::enable_gesture(){
+            return PROS_SUCCESS;
+        }
+
+        std::int32_t Optical::disable_gesture(){
+            return PROS_SUCCESS;
+        }
+
+        std::int32_t Optical::set_integration_time(double time){
+            return PROS_SUCCESS;
+        }
+
+        Controller::Controller(controller_id_e_t id) : _id(id){}
+
+        std::int32_t Controller::is_connected(){
+            return 1;
+        }
+
+        std::int32_t Controller::get_analog(controller_analog_e_t channel){
+            return sim::controller_analog(channel);
+        }
+
+        std::int32_t Controller::get_digital(controller_digital_e_t button){
+            return sim::controller_digital(button);
+        }
+
+        std::int32_t Controller::get_digital_new_press(controller_digital_e_t button){
+            return 0;
+        }
+
+        std::int32_t Controller::rumble(const char* rumble_pattern){
+            return PROS_SUCCESS;
+        }
+    }
+
+    namespace adi{
+        Port::Port(std::uint8_t adi_port, adi_port_config_e_t type) : _smart_port(INTERNAL_ADI_PORT), _adi_port(adi_port){}
+
+        ext_adi_port_tuple_t Port::get_port() const{
+            return {_smart_port, _adi_port, 0};
+        }
+
+        std::int32_t Port::set_value(std::int32_t value) const{
+            sim::digital_set(char(_adi_port >= 'A' ? _adi_port : 'A' + _adi_port - 1), value != 0);
+            return PROS_SUCCESS;
+        }
+
+        DigitalOut::DigitalOut(std::uint8_t adi_port, bool init_state) : Port(adi_port, E_ADI_DIGITAL_OUT){
+            set_value(init_state);
+        }
+
+        Encoder::Encoder(std::uint8_t adi_port_top, std::uint8_t adi_port_bottom, bool reversed)
+            : Port(adi_port_top, E_ADI_LEGACY_ENCODER), _port_pair({INTERNAL_ADI_PORT, adi_port_top}){}
+
+        std::int32_t Encoder::reset() const{
+            return PROS_SUCCESS;
+        }
+
+        std::int32_t Encoder::get_value() const{
+            return 0;
+        }
+
+        ext_adi_port_tuple_t Encoder::get_port() const{
+            return {_port_pair.first, _port_pair.second, 0};
+        }
+    }
+}
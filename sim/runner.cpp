@@ -0,0 +1,729 @@
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "main.h"
+#include "alloc.hpp"
+#include "air.hpp"
+#include "balls.hpp"
+#include "driver.hpp"
+#include "dsr.hpp"
+#include "health.hpp"
+#include "intake.hpp"
+#include "profiler.hpp"
+#include "replay.hpp"
+#include "sim.hpp"
+#include "stream.hpp"
+#include "tasks.hpp"
+#include "telemetry.hpp"
+#include "trace.hpp"
+#include "tune.hpp"
+
+/*
+Runs autons from src/ against the simulated field and checks where they end up.
+
+    sim/build/sim                   run every case and check it
+    sim/build/sim -v                the same with EZ-Template's and the settle printouts on
+    sim/build/sim "skills 106"      run one auton by the first line of its selector name, it is checked if it has a case
+
+Randomized runs, used by montecarlo.cpp:
+
+    --seed N        draw this run's errors with seed N, 0 or leaving it out is the model itself
+    --start IN      sd of the start position
+    --angle DEG     sd of the start heading
+    --slip F        most a drive side's wheels slip, as a fraction
+    --drift DEG     sd of the imu drift in degrees per second
+    --dsr MM        sd of the distance sensor noise
+    --strength F    sd of each drive motor's strength, as a fraction
+    --trace         print every profiler step with where the robot really was, tab separated:
+                    step index kind call x y theta label ms slack settled current_low balls_stopped exit
+    --air           print the tank pressure at the end of each run and each piston's moves
+    --faults        drive a route with the simulated controller, unplugging the vertical tracker and then the imu on
+                    the way, and check odom keeps up with the robot
+    --replay        drive a route with the simulated controller while recording it, then play it back on drive
+                    motors of different strength without and with pose correction and print how far each ended
+                    from the recording, then cut a playback off halfway like the field does
+    --log FILE      write the telemetry log of every run to FILE, in the format of the sd card's tlm files
+    --stream FILE   stream every channel every tick to FILE, the bytes the brain would send on its serial link,
+                    for sim/build/decode
+    --link BPS      bytes per second the streamed link takes, the stream decimates to stay under it
+    --alloc         print the heap allocations of every task and region after the runs, and the hot tasks'
+                    violations, exits with an error if there were any. Also how building paths went
+    --spans FILE    save the trace spans of the last run to FILE, in the format of the sd card's trace.bin,
+                    for sim/build/timeline
+    --paths FILE    save the path cache to FILE after the runs, in the format of the sd card's paths.bin, and check
+                    it loads back and gives the same path as building it again
+
+Gain tuning, used by tuner.cpp:
+
+    --tune GROUP    run the motions of one PID group from tune.hpp instead of an auton
+    --set V,V,...   that group's parameters, in the order --tune prints them
+*/
+
+//odom has to agree with the world this well at the end of a run, in inches
+static const double ODOM_TOLERANCE = 3;
+
+/*!
+* \brief one auton run and what it has to reach
+*/
+struct Case{
+    const char* auton;
+    sim::Pose start;
+    sim::Pose end;              // where the robot has to finish, or be when the period ends
+    double tolerance;           // inches, degrees for theta
+    double period;              // seconds, the field disables the robot after this
+    bool field_odom;            // the auton resets odom against the walls, otherwise odom starts at 0 where the robot starts
+    bool holds;                 // the auton waits out the period at its end, so being cut off is how it finishes
+    double odom_tolerance = ODOM_TOLERANCE;  // inches odom may be off from the robot at the end
+    balls::Color alliance = balls::NONE;     // the color picked in the selector
+    const char* feed = "";                   // balls the robot is given in order, R red and B blue, the other color has to be thrown out
+    double feed_at = 0;                      // seconds into the run they are there to take
+    int scored = 0;                          // balls it has to score at least
+};
+
+//the autonomous period of a match and of a skills run
+static const double MATCH = 15;
+static const double SKILLS = 60;
+
+//more balls than the rollers can take in a roller tuning sweep
+static const char* TUNE_FEED = "BBBBBBBBBBBBBBBBBBBBBBBBBBBBBBBBBBBBBBBBBBBBBBBB";
+
+//every auton in the selector, from where it starts on the field. Match autons start on the blue side with their back
+//to the wall, the left ones mirror the right ones. There are no goals or barriers in the sim, so pushes into a goal
+//carry on until something else stops them and the end poses are where the empty field leaves the robot. The 7 ball
+//autons are handed a red ball among blue ones at the matchloader, it has to be thrown out before the long goal
+static const Case cases[] = {
+    {"skills 106", {30, 30, 180}, {19, 85, 0}, 3, SKILLS, true, false},
+    {"SAWP with push", {96, 24, -90}, {94, 90.1, -133.7}, 3, MATCH, true, true},
+    {"SAWP no push", {95, 24, 90}, {77.5, 74.3, -133.7}, 3, MATCH, true, false},
+    {"right 7", {92, 12, 0}, {110.7, 60.5, 170}, 3, MATCH, false, true, ODOM_TOLERANCE, balls::BLUE, "BBRB", 6},
+    {"right counter 7", {95, 24, 90}, {112.5, 58.7, 180}, 3, MATCH, true, true},
+    {"right 7 ball rush", {95, 12, 0}, {112.9, 57.1, -174.5}, 3, MATCH, true, true},
+    {"left 7", {52, 12, 0}, {31.1, 60.2, 10}, 3, MATCH, false, true, ODOM_TOLERANCE, balls::BLUE, "BRBB", 6},
+    {"left counter 7", {46, 12, 0}, {49.4, 82, 10}, 3, MATCH, true, true},
+    {"left 7 ball rush", {46, 12, 0}, {28.8, 59.5, 10}, 3, MATCH, true, true},
+    {"skills 102", {100, 14, -90}, {69.7, 7.5, -100.2}, 3, SKILLS, true, false, 7},
+    {"move a bit", {92, 12, 0}, {92, 21.7, 0}, 3, MATCH, false, false},
+    {"dont do anything", {92, 12, 0}, {92, 12, 0}, 3, MATCH, false, false},
+    //calibration last, they set the offsets the runs above use. Measure Offsets after the DSR one, the tracker offsets
+    //it measures on the spinning sim robot throw off the odom of any run that turns after it
+    {"Measure DSR offsets", {70.5, 125, 0}, {70.7, 119.9, -133}, 3, SKILLS, false, false},
+    {"Measure Offsets", {70.5, 70.5, 0}, {70.5, 70.5, 7.2}, 3, MATCH, false, false},
+    //the tuners are fed balls the whole sweep, which has to be over before the period is
+    {"Tune long goal rollers", {70.5, 70.5, 0}, {70.5, 70.5, 0}, 3, MATCH, false, false, ODOM_TOLERANCE, balls::NONE, TUNE_FEED, 0, 15},
+    {"Tune middle goal rollers", {70.5, 70.5, 0}, {70.5, 70.5, 0}, 3, MATCH, false, false, ODOM_TOLERANCE, balls::NONE, TUNE_FEED, 0, 15},
+};
+
+static double beam_direction(Dir dir){
+    switch(dir){
+        case Right:
+            return 90;
+        case Back:
+            return 180;
+        case Left:
+            return -90;
+        default:
+            return 0;
+    }
+}
+
+//tell the world where the chassis' devices are, after initialize() has set them up
+static void devices_add(){
+    for(pros::Motor& motor : chassis.left_motors){
+        sim::drive_motor_add(motor.get_port(), true);
+    }
+    for(pros::Motor& motor : chassis.right_motors){
+        sim::drive_motor_add(motor.get_port(), false);
+    }
+    for(ez::tracking_wheel* tracker : {chassis.odom_tracker_left, chassis.odom_tracker_right}){
+        if(tracker != nullptr){
+            sim::tracker_add(tracker->smart_encoder.get_port(), true, tracker->distance_to_center_get(), tracker->wheel_diameter_get());
+        }
+    }
+    for(ez::tracking_wheel* tracker : {chassis.odom_tracker_back, chassis.odom_tracker_front}){
+        if(tracker != nullptr){
+            sim::tracker_add(tracker->smart_encoder.get_port(), false, tracker->distance_to_center_get(), tracker->wheel_diameter_get());
+        }
+    }
+    for(DSRDS& sensor : DSR::sensors){
+        sim::distance_add(sensor.get_port(), beam_direction(sensor.get_dir()), sensor.get_y_offset(), sensor.get_x_offset());
+    }
+    sim::optical_add(ball_sensor.get_port(), intake.motor.get_port());
+}
+
+//hues the optical sensor sees for each color, inside the ranges in balls.hpp
+static const double RED_BALL_HUE = 10;
+static const double BLUE_BALL_HUE = 220;
+
+//selector names can carry a description after a new line, only the first line has to match
+static bool auton_select(const char* name){
+    for(int i = 0; i < int(ez::as::auton_selector.Autons.size()); i++){
+        std::string first = ez::as::auton_selector.Autons[i].Name;
+        first = first.substr(0, first.find('\n'));
+        first.erase(first.find_last_not_of(' ') + 1);
+        if(first == name){
+            ez::as::auton_selector.auton_page_current = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool trace_steps = false;
+static bool air_report = false;
+static bool alloc_report = false;
+
+static void air_print(){
+    printf("  air %.1f psi, %i moves left, warning %s\n", air::pressure(), air::moves_left(), air::warning_to_string(air::warning()));
+    for(int i = 0; i < air::count(); i++){
+        air::Cylinder cylinder = air::get(i);
+        printf("    %-10s %3i out %3i in %6.2f in^3\n", cylinder.name, cylinder.extends, cylinder.retracts, cylinder.used);
+    }
+}
+
+static void alloc_print(){
+    printf("alloc: %u allocations, %u frees, %u violations\n", unsigned(alloc::allocations()), unsigned(alloc::frees()), unsigned(alloc::violations()));
+    for(int i = 0; i < alloc::task_count(); i++){
+        alloc::Counts counts = alloc::task(i);
+        printf("  task   %-16s %8u %10u bytes%s", counts.name, unsigned(counts.allocations), unsigned(counts.bytes), counts.hot ? "  hot" : "");
+        printf(counts.violations > 0 ? ", %u violations\n" : "\n", unsigned(counts.violations));
+    }
+    for(int i = 0; i < alloc::region_count(); i++){
+        alloc::Counts counts = alloc::region(i);
+        printf("  region %-16s %8u %10u bytes\n", counts.name, unsigned(counts.allocations), unsigned(counts.bytes));
+    }
+    if(alloc::violations() > 0){
+        alloc::Violation last = alloc::last_violation();
+        printf("  last violation: %u bytes in %s %s at %ums\n", unsigned(last.size), last.task, last.region, unsigned(last.time));
+    }
+    const path::Timing& paths = chassis.paths.timing();
+    printf("paths: %u built, %u from the cache, worst %uus, most %i points, most %i smoothing passes, %i from the cache, %u outgrew the buffers\n",
+           unsigned(paths.builds), unsigned(paths.hits), unsigned(paths.worst), paths.most_points, paths.most_passes, paths.hit_passes, unsigned(paths.grown));
+}
+
+//skills 106's way across the field, warmed by warm_paths()
+static const ez::united_odom CROSSING[] = {{{4_in, 35_in}, ez::rev, 110}, {{5_in, 95_in}, ez::rev, 110}, {{20_in, 110_in}, ez::rev, 110}};
+
+//a cached path can't be this far off the one EZ-Template smooths whole from the robot, in inches
+static const double SHAPE_TOLERANCE = 0.05;
+
+/*!
+* \brief compare a smoothed build with EZ-Template's smooth_path() over the robot's pose and the waypoints
+* \return true if no point is off by more than SHAPE_TOLERANCE
+*/
+static bool shape_check(ez::pose start, double spacing, const path::Smoothing& smoothing, const std::vector<ez::odom>& built){
+    std::vector<ez::odom> waypoints = {{start, ez::rev, 110}};
+    for(const ez::united_odom& waypoint : CROSSING){
+        waypoints.push_back(ez::util::united_odom_to_odom(waypoint));
+    }
+    path::Path injected;
+    injected.reserve();
+    std::vector<ez::odom> data = injected.build(path::INJECT, start, waypoints, spacing, smoothing);
+
+    //smooth_path() as EZ-Template has it, only the ends stay put
+    std::vector<ez::odom> whole = data;
+    double change = smoothing.tolerance;
+    while(change >= smoothing.tolerance){
+        change = 0;
+        for(std::size_t i = 1; i + 1 < whole.size(); i++){
+            ez::pose& point = whole[i].target;
+            double x = point.x;
+            double y = point.y;
+            point.x += smoothing.weight_data * (data[i].target.x - x) + smoothing.weight_smooth * (whole[i - 1].target.x + whole[i + 1].target.x - 2 * x);
+            point.y += smoothing.weight_data * (data[i].target.y - y) + smoothing.weight_smooth * (whole[i - 1].target.y + whole[i + 1].target.y - 2 * y);
+            change += std::fabs(x - point.x) + std::fabs(y - point.y);
+        }
+    }
+
+    //the robot's pose starts EZ-Template's path, not the one built
+    double worst = whole.size() == built.size() + 1 ? 0 : INFINITY;
+    for(std::size_t i = 0; i < built.size() && worst < INFINITY; i++){
+        worst = std::max(worst, std::hypot(built[i].target.x - whole[i + 1].target.x, built[i].target.y - whole[i + 1].target.y));
+    }
+    printf("paths: the crossing is %.3fin at most from the path smoothed whole\n", worst);
+    return worst <= SHAPE_TOLERANCE;
+}
+
+//builds from the cache averaged for their time
+static const int HIT_BUILDS = 100;
+
+static bool paths_check(const char* file){
+    if(!chassis.paths.save(file)){
+        printf("%s: couldn't write the paths\n", file);
+        return false;
+    }
+    path::Path loaded;
+    loaded.reserve();
+    int count = loaded.load(file);
+    int cached = chassis.paths.timing().cached;
+    printf("paths: %i of %i cached paths saved and loaded back\n", count, cached);
+
+    path::Path built;
+    built.reserve();
+    ez::pose start = {2, 10, 0};
+    path::Smoothing smoothing;
+    double spacing = chassis.odom_path_spacing_get();
+    std::vector<ez::odom> from_file = loaded.build(path::SMOOTH, start, CROSSING, spacing, smoothing);
+    auto begin = std::chrono::steady_clock::now();
+    const std::vector<ez::odom>& again = built.build(path::SMOOTH, start, CROSSING, spacing, smoothing);
+    double miss = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - begin).count();
+    int miss_passes = built.timing().last_passes;
+    bool same = from_file.size() == again.size() && loaded.timing().hits == 1 && built.timing().misses == 1;
+    for(std::size_t i = 0; same && i < again.size(); i++){
+        same = from_file[i].target.x == again[i].target.x && from_file[i].target.y == again[i].target.y &&
+               from_file[i].target.theta == again[i].target.theta && loaded.index(i) == built.index(i);
+    }
+    if(!same){
+        printf("  the crossing from the file isn't the one built again\n");
+    }
+
+    //pros::micros() is sim time here, so the host's clock times a build from the cache from a few starts
+    path::Path timed;
+    timed.reserve();
+    timed.warm(path::SMOOTH, CROSSING, spacing, smoothing);
+    begin = std::chrono::steady_clock::now();
+    for(int i = 0; i < HIT_BUILDS; i++){
+        timed.build(path::SMOOTH, {start.x + i % 5, start.y - i % 7, 0}, CROSSING, spacing, smoothing);
+    }
+    double hit = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - begin).count() / HIT_BUILDS;
+    printf("paths: the crossing from the cache takes at most %i passes and %.1fus on this host, built %i passes and %.1fus\n",
+           timed.timing().hit_passes, hit, miss_passes, miss);
+    return count == cached && same && shape_check(start, spacing, smoothing, again);
+}
+
+static void trace_step(int index, const prof::Step& step){
+    sim::Pose real = sim::pose();
+    printf("step\t%i\t%s\t%s\t%.3f\t%.3f\t%.3f\t%s\t%u\t%u\t%u\t%u\t%u\t%s\n", index, prof::kind_to_string(step.kind), step.call, real.x, real.y, real.theta, step.label,
+           unsigned(step.end - step.start), unsigned(step.slack), unsigned(step.settled), unsigned(step.current_low), unsigned(step.balls_stopped), step.exit);
+}
+
+/*!
+* \brief run one auton and check it
+* \return true if it passed, or had nothing to check
+*/
+//let the writer empty the ring and write the last block before leaving
+static void log_close(){
+    telemetry::flush();
+    pros::delay(3 * telemetry::WRITE_MS);
+    printf("log: %u records in %u blocks, %u dropped\n", unsigned(telemetry::written()), unsigned(telemetry::blocks()), unsigned(telemetry::dropped()));
+}
+
+//autonomous() runs in its own task like on the brain, so the end of the period can kill it
+static bool auton_running = false;
+
+static void auton_task(void* parameters){
+    autonomous();
+    auton_running = false;
+}
+
+/*!
+* \brief run the selected auton until it returns or the period ends, then disable like the field does
+* \return true if it returned before the period ended
+*/
+static bool auton_run(double period){
+    std::uint64_t end = sim::micros() + std::uint64_t(period * 1e6);
+    auton_running = true;
+    pros::Task task(auton_task, nullptr, TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "autonomous");
+    while(auton_running && sim::micros() < end){
+        pros::delay(1);
+    }
+    if(!auton_running){
+        return true;
+    }
+    task.remove();
+    auton_running = false;
+    disabled();
+    return false;
+}
+
+static bool run(const char* auton, const Case* check){
+    if(!auton_select(auton)){
+        printf("%s: no auton with that name\n", auton);
+        return false;
+    }
+    //stopped for a control tick like the field stops them between runs, a roller doesn't write a command it thinks
+    //the motor already has, so one the reset zeroes under it would stay stopped
+    rollers::set(rollers::STOP);
+    pros::delay(ctrl::period);
+    sim::reset(check != nullptr ? check->start : sim::Pose{sim::FIELD / 2, sim::FIELD / 2, 0});
+    sim::Pose start = sim::pose();
+    double start_time = sim::micros() / 1e6;
+    air::reset();
+    balls::clear();
+    balls::alliance_set(check != nullptr ? check->alliance : balls::NONE);
+    int wrong = 0;
+    for(const char* ball = check != nullptr ? check->feed : ""; *ball != '\0'; ball++){
+        balls::Color color = *ball == 'R' ? balls::RED : balls::BLUE;
+        sim::ball_feed(color == balls::RED ? RED_BALL_HUE : BLUE_BALL_HUE, sim::micros() + std::uint64_t(check->feed_at * 1e6));
+        wrong += check->alliance != balls::NONE && color != check->alliance;
+    }
+    int ejected = balls::ejected();
+    int scored = balls::scored();
+    std::uint32_t misses = chassis.paths.timing().misses;
+    bool finished = auton_run(check != nullptr ? check->period : MATCH);
+    double time = sim::micros() / 1e6 - start_time;
+
+    sim::Pose real = sim::pose();
+    ez::pose odom = chassis.odom_pose_get();
+    printf("%s: %.2fs%s, ended at (%.1f, %.1f, %.1f), odom (%.1f, %.1f, %.1f)\n", auton, time, finished ? "" : " until the period ended",
+           real.x, real.y, real.theta, odom.x, odom.y, odom.theta);
+    if(air_report){
+        air_print();
+    }
+    if(trace_steps){
+        printf("end\t%.3f\t%.3f\t%.3f\t%.3f\n", time, real.x, real.y, real.theta);
+    }
+    if(check == nullptr){
+        return true;
+    }
+
+    bool ok = true;
+    if(!finished && !check->holds){
+        printf("  FAIL the %.0fs period ended before the auton did\n", check->period);
+        ok = false;
+    }
+    double off = std::hypot(real.x - check->end.x, real.y - check->end.y);
+    double turned = util::wrap_angle(real.theta - check->end.theta);
+    if(off > check->tolerance || std::fabs(turned) > check->tolerance){
+        printf("  FAIL %.2fin and %.2fdeg from (%.1f, %.1f, %.1f)\n", off, turned, check->end.x, check->end.y, check->end.theta);
+        ok = false;
+    }
+
+    //odom that starts at 0 is compared in the frame the robot started in
+    sim::Pose expected = real;
+    if(!check->field_odom){
+        double a = util::to_rad(start.theta);
+        double dx = real.x - start.x;
+        double dy = real.y - start.y;
+        expected = {dx * std::cos(a) - dy * std::sin(a), dx * std::sin(a) + dy * std::cos(a), real.theta - start.theta};
+    }
+    double drift = std::hypot(odom.x - expected.x, odom.y - expected.y);
+    if(drift > check->odom_tolerance){
+        printf("  FAIL odom is %.2fin from where the robot is\n", drift);
+        ok = false;
+    }
+    ejected = balls::ejected() - ejected;
+    scored = balls::scored() - scored;
+    if(*check->feed != '\0'){
+        printf("  balls: given %i, scored %i, threw out %i of the other color\n", int(std::strlen(check->feed)), scored, ejected);
+    }
+    if(scored < check->scored){
+        printf("  FAIL scored %i balls, it has to score %i\n", scored, check->scored);
+        ok = false;
+    }
+    if(ejected != wrong){
+        printf("  FAIL threw out %i balls of the other color, it was given %i\n", ejected, wrong);
+        ok = false;
+    }
+    //every path an auton follows is warmed by warm_paths(), so one built at the start of a motion was missed there
+    misses = chassis.paths.timing().misses - misses;
+    if(misses > 0){
+        printf("  FAIL %u paths weren't warmed\n", unsigned(misses));
+        ok = false;
+    }
+    return ok;
+}
+
+//a corrected playback has to stay this close to the recorded poses, in inches
+static const double REPLAY_TOLERANCE = 1;
+
+//sticks held for a while, the right stick drives and the left turns
+struct Stick{
+    int ms;
+    int drive;
+    int turn;
+};
+
+static const Stick route[] = {
+    {500, 100, 0},
+    {600, 60, 40},
+    {400, 90, 0},
+    {400, 0, -60},
+    {600, 70, 15},
+    {500, 0, 0},
+};
+
+//drive with the sticks held like a driver would
+static void stick_hold(const Stick& stick){
+    sim::controller_analog_set(pros::E_CONTROLLER_ANALOG_RIGHT_Y, stick.drive);
+    sim::controller_analog_set(pros::E_CONTROLLER_ANALOG_LEFT_X, stick.turn);
+    for(int t = 0; t < stick.ms; t += driver::PERIOD_MS){
+        driver::read();
+        driver::arcade_flipped();
+        pros::delay(driver::PERIOD_MS);
+    }
+}
+
+//the same resets autonomous() does, so odom starts at 0 where the robot is
+static void odom_reset(sim::Pose start){
+    sim::reset(start);
+    chassis.pid_targets_reset();
+    chassis.drive_imu_reset();
+    chassis.drive_sensor_reset();
+    chassis.odom_xyt_set(0_in, 0_in, 0_deg);
+    pros::delay(50);
+}
+
+//the robot plays back with weaker and stronger drive motors than it recorded with, each one's strength off by this sd
+static const double REPLAY_STRENGTH = 0.1;
+static const std::uint64_t REPLAY_SEED = 1;
+
+static void play_task(void* parameters){
+    replay::play();
+}
+
+static bool replay_check(){
+    sim::Pose start = {sim::FIELD / 2, 30, 0};
+    odom_reset(start);
+    replay::record_start();
+    for(const Stick& stick : route){
+        stick_hold(stick);
+    }
+    replay::record_stop();
+    pros::delay(300);
+    sim::Pose recorded = sim::pose();
+    printf("replay: recorded %i frames, ended at (%.1f, %.1f, %.1f)\n", replay::frames(), recorded.x, recorded.y, recorded.theta);
+
+    double worst = 0;
+    double ended[2] = {};
+    for(int correct = 0; correct < 2; correct++){
+        //both playbacks get the same motors, drawn differently from the ones it recorded with
+        sim::noise_set({.strength = REPLAY_STRENGTH}, REPLAY_SEED);
+        odom_reset(start);
+        replay::play(correct);
+        pros::delay(300);
+        sim::Pose real = sim::pose();
+        replay::Tracking tracking = replay::tracking();
+        worst = tracking.worst;
+        ended[correct] = std::hypot(real.x - recorded.x, real.y - recorded.y);
+        printf("  %-9s ended %.2fin and %.2fdeg off, worst %.2fin off the recorded poses\n", correct ? "corrected" : "open loop",
+               ended[correct], util::wrap_angle(real.theta - recorded.theta), tracking.worst);
+    }
+    sim::noise_set(sim::Noise(), 0);
+
+    //the field ends the period partway through, the playback has to stop with the auton instead of driving on
+    odom_reset(start);
+    pros::Task task(play_task, nullptr, TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "autonomous");
+    pros::delay(replay::frames() * ctrl::period / 2);
+    task.remove();
+    disabled();
+    pros::delay(100);
+    double volts = 0;
+    for(pros::Motor& motor : chassis.left_motors){
+        volts = std::max(volts, std::fabs(sim::motor_voltage(motor.get_port())));
+    }
+    for(pros::Motor& motor : chassis.right_motors){
+        volts = std::max(volts, std::fabs(sim::motor_voltage(motor.get_port())));
+    }
+    bool stopped = !replay::playing() && volts == 0;
+    printf("  cut off   %s, %.1fV on the drive\n", stopped ? "stopped" : "still playing", volts);
+
+    //the corrected playback has to stay on the recorded poses and end closer than the open loop one
+    return replay::frames() > 0 && worst <= REPLAY_TOLERANCE && ended[1] < ended[0] && stopped;
+}
+
+//odom has to stay this close to the robot with the tracker and then the imu unplugged on the way, in inches
+static const double FAULT_TOLERANCE = 3;
+
+//the route with the vertical tracker unplugged after the second stick and the imu after the fourth, health has to
+//keep odom going on what is left. Failures latch, so this runs on its own
+static bool faults_check(){
+    sim::Pose start = {sim::FIELD / 2, 30, 0};
+    odom_reset(start);
+    int tracker = chassis.odom_tracker_left != nullptr ? chassis.odom_tracker_left->smart_encoder.get_port() : 0;
+    for(int i = 0; i < int(sizeof(route) / sizeof(route[0])); i++){
+        if(i == 2 && tracker != 0){
+            sim::unplug(tracker);
+        }
+        if(i == 4){
+            sim::unplug(chassis.imu.get_port());
+        }
+        stick_hold(route[i]);
+    }
+    pros::delay(300);
+
+    sim::Pose real = sim::pose();
+    ez::pose odom = chassis.odom_pose_get();
+    double a = util::to_rad(start.theta);
+    double dx = real.x - start.x;
+    double dy = real.y - start.y;
+    double off = std::hypot(odom.x - (dx * std::cos(a) - dy * std::sin(a)), odom.y - (dx * std::sin(a) + dy * std::cos(a)));
+    bool swapped = tracker == 0 || chassis.odom_tracker_left == nullptr;
+    printf("faults: tracker %s, imu %s, odom (%.1f, %.1f, %.1f) is %.2fin from the robot\n", swapped ? "taken out" : "still in",
+           health::imu_degraded() ? "dropped" : "still in", odom.x, odom.y, odom.theta, off);
+    return swapped && health::imu_degraded() && std::isfinite(off) && off <= FAULT_TOLERANCE;
+}
+
+int main(int argc, char** argv){
+    bool verbose = false;
+    const char* only = nullptr;
+    std::uint64_t seed = 0;
+    sim::Noise noise;
+    std::string tune_group;
+    std::vector<double> tune_values;
+    bool replay_mode = false;
+    bool faults_mode = false;
+    const char* log_path = nullptr;
+    const char* stream_path = nullptr;
+    const char* spans_path = nullptr;
+    const char* paths_path = nullptr;
+    std::uint32_t link = stream::LINK_BYTES;
+    for(int i = 1; i < argc; i++){
+        bool value = i + 1 < argc;
+        if(std::strcmp(argv[i], "-v") == 0){
+            verbose = true;
+        }else if(std::strcmp(argv[i], "--trace") == 0){
+            trace_steps = true;
+        }else if(std::strcmp(argv[i], "--alloc") == 0){
+            alloc_report = true;
+        }else if(std::strcmp(argv[i], "--air") == 0){
+            air_report = true;
+        }else if(std::strcmp(argv[i], "--replay") == 0){
+            replay_mode = true;
+        }else if(std::strcmp(argv[i], "--faults") == 0){
+            faults_mode = true;
+        }else if(std::strcmp(argv[i], "--log") == 0 && value){
+            log_path = argv[++i];
+        }else if(std::strcmp(argv[i], "--stream") == 0 && value){
+            stream_path = argv[++i];
+        }else if(std::strcmp(argv[i], "--spans") == 0 && value){
+            spans_path = argv[++i];
+        }else if(std::strcmp(argv[i], "--paths") == 0 && value){
+            paths_path = argv[++i];
+        }else if(std::strcmp(argv[i], "--link") == 0 && value){
+            link = std::strtoul(argv[++i], nullptr, 10);
+        }else if(std::strcmp(argv[i], "--seed") == 0 && value){
+            seed = std::strtoull(argv[++i], nullptr, 10);
+        }else if(std::strcmp(argv[i], "--start") == 0 && value){
+            noise.start = std::atof(argv[++i]);
+        }else if(std::strcmp(argv[i], "--angle") == 0 && value){
+            noise.start_angle = std::atof(argv[++i]);
+        }else if(std::strcmp(argv[i], "--slip") == 0 && value){
+            noise.slip = std::atof(argv[++i]);
+        }else if(std::strcmp(argv[i], "--drift") == 0 && value){
+            noise.drift = std::atof(argv[++i]);
+        }else if(std::strcmp(argv[i], "--dsr") == 0 && value){
+            noise.distance = std::atof(argv[++i]);
+        }else if(std::strcmp(argv[i], "--strength") == 0 && value){
+            noise.strength = std::atof(argv[++i]);
+        }else if(std::strcmp(argv[i], "--tune") == 0 && value){
+            tune_group = argv[++i];
+        }else if(std::strcmp(argv[i], "--set") == 0 && value){
+            for(char* number = std::strtok(argv[++i], ","); number != nullptr; number = std::strtok(nullptr, ",")){
+                tune_values.push_back(std::atof(number));
+            }
+        }else{
+            only = argv[i];
+        }
+    }
+    //seed 0 is the model, whatever noise was asked for
+    sim::noise_set(seed == 0 ? sim::Noise() : noise, seed);
+
+    setvbuf(stdout, nullptr, _IOLBF, 0);
+    auto wall_start = std::chrono::steady_clock::now();
+    sim::start(tasks::PRIORITY_USER);
+    //the imu is plugged in from boot, EZ-Template's tracking reads it while initialize() waits
+    sim::imu_add(chassis.imu.get_port());
+    initialize();
+    //before anything that waits, the control loop would find the drive unplugged and health would latch it
+    devices_add();
+    if(log_path != nullptr && !telemetry::open(log_path)){
+        printf("%s: couldn't make the log\n", log_path);
+        std::_Exit(1);
+    }
+    if(stream_path != nullptr){
+        FILE* file = std::fopen(stream_path, "wb");
+        if(file == nullptr){
+            printf("%s: couldn't make it\n", stream_path);
+            std::_Exit(1);
+        }
+        stream::output_set(file);
+        stream::link_set(link);
+        stream::start(stream::ALL, ctrl::period);
+    }
+    chassis.pid_print_toggle(verbose);
+    if(trace_steps){
+        prof::on_step(trace_step);
+    }
+
+    if(!tune_group.empty()){
+        if(!tune::group_valid(tune_group)){
+            printf("%s: no group with that name\n", tune_group.c_str());
+            std::_Exit(1);
+        }
+        tune::params_set(tune_group, tune_values);
+        for(const tune::Param& param : tune::params_get(tune_group)){
+            printf("param\t%s\t%g\t%i\n", param.name, param.value, int(param.kind));
+        }
+        tune::run(tune_group);
+        fflush(stdout);
+        std::_Exit(0);
+    }
+
+    if(replay_mode){
+        bool ok = replay_check();
+        printf("%s\n", ok ? "passed" : "FAILED");
+        fflush(stdout);
+        std::_Exit(ok ? 0 : 1);
+    }
+    if(faults_mode){
+        bool ok = faults_check();
+        printf("%s\n", ok ? "passed" : "FAILED");
+        fflush(stdout);
+        std::_Exit(ok ? 0 : 1);
+    }
+
+    bool ok = true;
+    for(const Case& check : cases){
+        if(only == nullptr || std::strcmp(only, check.auton) == 0){
+            ok &= run(check.auton, &check);
+        }
+    }
+    if(only != nullptr && !auton_select(only)){
+        printf("%s: no auton with that name\n", only);
+        ok = false;
+    }else if(only != nullptr){
+        bool has_case = false;
+        for(const Case& check : cases){
+            has_case |= std::strcmp(only, check.auton) == 0;
+        }
+        if(!has_case){
+            ok &= run(only, nullptr);
+        }
+    }
+
+    if(log_path != nullptr){
+        log_close();
+    }
+    if(stream_path != nullptr){
+        stream::Stats sent = stream::stats();
+        printf("stream: %u frames, %u bytes, %u samples skipped, decimated to 1 in %i at the end\n", unsigned(sent.frames), unsigned(sent.bytes),
+               unsigned(sent.skipped), sent.decimation);
+    }
+
+    if(alloc_report){
+        alloc_print();
+        ok &= alloc::violations() == 0;
+    }
+    if(spans_path != nullptr){
+        if(trace::save(spans_path)){
+            printf("spans: %u dropped\n", unsigned(trace::dropped()));
+        }else{
+            printf("%s: couldn't write the spans\n", spans_path);
+            ok = false;
+        }
+    }
+
+    if(paths_path != nullptr){
+        ok &= paths_check(paths_path);
+    }
+
+    double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+    printf("%s in %.3fs of wall time\n", ok ? "passed" : "FAILED", wall);
+    fflush(stdout);
+    //the tasks never return, leave without waiting on them
+    std::_Exit(ok ? 0 : 1);
+}
@@ -0,0 +1,145 @@
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "sim.hpp"
+
+//one of these per pros::Task, only the one in `running` is ever allowed to execute
+struct SimTask{
+    std::function<void()> function;
+    std::uint32_t priority = 0;
+    std::string name;
+    std::uint64_t wake = 0;
+    std::uint64_t order = 0;   // when it started waiting, first come first served between equals
+    std::condition_variable turn;
+};
+
+struct Scheduler{
+    std::mutex lock;
+    std::vector<SimTask*> tasks;
+    SimTask* running = nullptr;
+    std::uint64_t now = 0;
+    std::uint64_t next_order = 0;
+};
+
+//tasks are created from static constructors in main.cpp, so this can't be a plain global
+static Scheduler& scheduler(){
+    static Scheduler instance;
+    return instance;
+}
+
+//earliest wake first, then the highest priority, then whoever has waited longest
+static SimTask* pick(Scheduler& s){
+    SimTask* best = nullptr;
+    for(SimTask* task : s.tasks){
+        if(best == nullptr || task->wake < best->wake ||
+           (task->wake == best->wake && (task->priority > best->priority ||
+           (task->priority == best->priority && task->order < best->order)))){
+            best = task;
+        }
+    }
+    return best;
+}
+
+//hand the brain to the next task, stepping the world up to its wake time
+static void switch_from(Scheduler& s, std::unique_lock<std::mutex>& guard, SimTask* self){
+    SimTask* next = pick(s);
+    while(s.now < next->wake){
+        std::uint64_t dt = std::min(sim::STEP_US, next->wake - s.now);
+        s.now += dt;
+        sim::world_step(dt);
+    }
+    s.running = next;
+    next->turn.notify_one();
+    if(self != nullptr){
+        self->turn.wait(guard, [&]{ return s.running == self; });
+    }
+}
+
+namespace sim{
+    std::uint64_t micros(){
+        return scheduler().now;
+    }
+
+    void start(std::uint32_t priority){
+        Scheduler& s = scheduler();
+        std::unique_lock<std::mutex> guard(s.lock);
+        SimTask* task = new SimTask();
+        task->priority = priority;
+        task->name = "main";
+        task->order = s.next_order++;
+        s.tasks.push_back(task);
+        s.running = task;
+    }
+
+    void* task_create(std::function<void()> function, std::uint32_t priority, const char* name){
+        Scheduler& s = scheduler();
+        std::unique_lock<std::mutex> guard(s.lock);
+        SimTask* task = new SimTask();
+        task->function = function;
+        task->priority = priority;
+        task->name = name == nullptr ? "" : name;
+        task->wake = s.now;
+        task->order = s.next_order++;
+        s.tasks.push_back(task);
+
+        std::thread([task]{
+            Scheduler& s = scheduler();
+            {
+                std::unique_lock<std::mutex> guard(s.lock);
+                task->turn.wait(guard, [&]{ return s.running == task; });
+            }
+            task->function();
+
+            //the task returned, PROS deletes it
+            std::unique_lock<std::mutex> guard(s.lock);
+            std::erase(s.tasks, task);
+            switch_from(s, guard, nullptr);
+        }).detach();
+        return task;
+    }
+
+    void* task_current(){
+        return scheduler().running;
+    }
+
+    void task_priority_set(void* task, std::uint32_t priority){
+        if(task != nullptr){
+            static_cast<SimTask*>(task)->priority = priority;
+        }
+    }
+
+    std::uint32_t task_priority_get(void* task){
+        return task == nullptr ? 0 : static_cast<SimTask*>(task)->priority;
+    }
+
+    const char* task_name(void* task){
+        return task == nullptr ? "" : static_cast<SimTask*>(task)->name.c_str();
+    }
+
+    bool task_alive(void* task){
+        Scheduler& s = scheduler();
+        std::unique_lock<std::mutex> guard(s.lock);
+        return std::find(s.tasks.begin(), s.tasks.end(), task) != s.tasks.end();
+    }
+
+    //its thread stays blocked on its turn, which never comes again
+    void task_kill(void* task){
+        Scheduler& s = scheduler();
+        std::unique_lock<std::mutex> guard(s.lock);
+        if(task != s.running){
+            std::erase(s.tasks, static_cast<SimTask*>(task));
+        }
+    }
+
+    void sleep_until(std::uint64_t wake){
+        Scheduler& s = scheduler();
+        std::unique_lock<std::mutex> guard(s.lock);
+        SimTask* self = s.running;
+        self->wake = wake < s.now ? s.now : wake;
+        self->order = s.next_order++;
+        switch_from(s, guard, self);
+    }
+}
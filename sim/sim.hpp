@@ -0,0 +1,234 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+
+/*! \namespace sim
+ *  \brief Host side stand in for the brain, the field and the robot
+ *
+ *  It has the ability to:
+ *
+ *      -keep virtual time that only moves when every task is waiting
+ *
+ *      -run PROS tasks one at a time by priority, like the single core brain does
+ *
+ *      -simulate the 6 motor drive, the rollers, the imu, the tracking wheels and the distance sensors
+ *
+ *      -carry balls fed to the robot past the optical sensor
+ *
+ *  The shims in pros_shim.cpp and ez_shim.cpp read and write the devices through here, so the code
+ *  in src/ runs unchanged.
+ */
+namespace sim{
+
+    /*!
+    * \brief field wall to wall in inches, the same size DSR uses
+    */
+    inline const double FIELD = 140.94488189;
+
+    /*!
+    * \brief physics step in microseconds
+    */
+    inline const std::uint64_t STEP_US = 1000;
+
+    /*!
+    * \brief a pose on the field, inches and degrees clockwise from +y
+    */
+    struct Pose{
+        double x = 0;
+        double y = 0;
+        double theta = 0;
+    };
+
+    /*!
+    * \brief virtual time since the sim started
+    */
+    std::uint64_t micros();
+
+    /*!
+    * \brief make the calling thread the first task, call once at the start of main()
+    * \param priority priority the caller runs at
+    */
+    void start(std::uint32_t priority);
+
+    /*!
+    * \brief start a task, it runs the first time the caller waits
+    * \return a handle for the task
+    */
+    void* task_create(std::function<void()> function, std::uint32_t priority, const char* name);
+
+    /*!
+    * \brief handle of the task that is running
+    */
+    void* task_current();
+
+    /*!
+    * \brief change the priority of a task
+    */
+    void task_priority_set(void* task, std::uint32_t priority);
+
+    /*!
+    * \brief priority of a task
+    */
+    std::uint32_t task_priority_get(void* task);
+
+    /*!
+    * \brief name of a task
+    */
+    const char* task_name(void* task);
+
+    /*!
+    * \brief true until the task's function returns
+    */
+    bool task_alive(void* task);
+
+    /*!
+    * \brief stop a task that isn't the one running, it never runs again, like the field killing autonomous
+    */
+    void task_kill(void* task);
+
+    /*!
+    * \brief block the running task until the virtual time reaches wake
+    *
+    * Other tasks run in the meantime and the world is stepped up to wake.
+    */
+    void sleep_until(std::uint64_t wake);
+
+    /*!
+    * \brief advance the world, called by the scheduler as virtual time moves
+    * \param dt microseconds to step
+    */
+    void world_step(std::uint64_t dt);
+
+    /*!
+    * \brief how far one run may stray from the model, all 0 is the model itself
+    */
+    struct Noise{
+        double start = 0;         // in, sd of the start position
+        double start_angle = 0;   // deg, sd of the start heading
+        double slip = 0;          // most a drive side's wheels spin further than the robot moves, as a fraction
+        double drift = 0;         // deg/s, sd of the imu drift rate
+        double distance = 0;      // mm, sd of every distance sensor reading
+        double strength = 0;      // sd of each drive motor's strength as a fraction, for battery and wear
+    };
+
+    /*!
+    * \brief errors for the runs after the next reset() are drawn from this
+    * \param seed the same seed draws the same errors
+    */
+    void noise_set(const Noise& noise, std::uint64_t seed);
+
+    /*!
+    * \brief put the robot somewhere on the field and stop everything
+    *
+    * The start is moved and this run's errors are drawn by the noise set with noise_set().
+    */
+    void reset(Pose start);
+
+    /*!
+    * \brief where the robot really is
+    */
+    Pose pose();
+
+    /*!
+    * \brief forward speed in inches per second
+    */
+    double speed();
+
+    /*!
+    * \brief which drive side a motor port is on, set up from the chassis
+    * \param port the port with the sign the code uses
+    * \param left true for the left side
+    */
+    void drive_motor_add(int port, bool left);
+
+    /*!
+    * \brief add a tracking wheel
+    * \param port the rotation sensor port
+    * \param vertical true if it rolls forward, false if it rolls sideways
+    * \param offset distance from the center, right of center for vertical and in front of center for horizontal
+    * \param diameter wheel diameter in inches
+    */
+    void tracker_add(int port, bool vertical, double offset, double diameter);
+
+    /*!
+    * \brief add a distance sensor
+    * \param port the smart port
+    * \param direction 0 front, 90 right, 180 back, -90 left
+    * \param along distance from the center along the beam in inches
+    * \param across distance right of the beam in inches
+    */
+    void distance_add(int port, double direction, double along, double across);
+
+    /*!
+    * \brief add the optical sensor that sees the balls coming into the robot
+    * \param port the smart port
+    * \param feeder the motor whose forward spin carries balls past it
+    */
+    void optical_add(int port, int feeder);
+
+    /*!
+    * \brief give the robot a ball, it goes past the optical sensor after the ones before it once the feeder spins
+    * \param hue its color as the sensor sees it, in degrees
+    * \param at virtual time in microseconds it is there to take, like a ball put in the matchloader
+    */
+    void ball_feed(double hue, std::uint64_t at = 0);
+
+    /*!
+    * \brief the imu port
+    */
+    void imu_add(int port);
+
+    /*!
+    * \brief pull a device out of its port, or plug it back in
+    */
+    void unplug(int port, bool unplugged = true);
+
+    /*!
+    * \brief true if something is plugged into this port
+    */
+    bool plugged(int port);
+
+    /*!
+    * \brief what kind of device is on a port, the values of pros::DeviceType
+    */
+    int device_type(int port);
+
+    // devices, all values are the ones the code sees, reversing is left to the code
+
+    void motor_add(int port);
+    void motor_voltage_set(int port, double volts);
+    double motor_voltage(int port);
+    double motor_position(int port);       // degrees of the output shaft
+    double motor_velocity(int port);       // rpm of the output shaft
+    double motor_current(int port);        // mA
+    double motor_temperature(int port);    // C
+    void motor_tare(int port, double position = 0);
+    void motor_brake_set(int port, bool hold);
+
+    double imu_rotation();                 // degrees, unbounded
+    double rotation_position(int port);    // centidegrees
+    void rotation_tare(int port);
+    int distance_reading(int port);        // mm, 9999 with nothing in range
+    int optical_proximity(int port);       // 0 to 255, 255 with a ball in front of it
+    double optical_hue(int port);          // degrees
+
+    /*!
+    * \brief state of a three wire port, 'A' to 'H'
+    */
+    void digital_set(char port, bool value);
+    bool digital_get(char port);
+
+    /*!
+    * \brief times any three wire port changed state
+    */
+    int digital_changes(char port);
+
+    /*!
+    * \brief the master controller's sticks and buttons, by pros::controller_analog_e_t and pros::controller_digital_e_t
+    */
+    void controller_analog_set(int channel, int value);
+    int controller_analog(int channel);
+    void controller_digital_set(int button, bool held);
+    bool controller_digital(int button);
+}
@@ -0,0 +1,223 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <set>
+#include <string>
+#include <tuple>
+#include <vector>
+#include "pool.hpp"
+
+/*
+Ranks the fixed delays of an auton by how much of them the robot spent doing nothing, from the
+profiler's delay steps (see prof::delay).
+
+    sim/build/slack profile.csv ...                 /usd/profile.csv files copied off the brain, every run in them
+    sim/build/slack --sim "skills 106"              one run of the auton in the sim
+    sim/build/slack --sim "skills 106" -n 50 --slip 0.05
+                                                    50 sim runs with errors, the sim's error options are passed on
+
+A delay can be cut by what it had left in its worst run, the recoverable column. The sim has no balls,
+so in sim runs only the drive and the roller spin up bound a delay.
+*/
+
+/*!
+* \brief one delay step of one run
+*/
+struct Delay{
+    std::string auton;
+    int index = 0;
+    std::string label;
+    double ms = 0;
+    double slack = 0;
+    double settled = 0;
+    double current_low = 0;
+    double balls_stopped = 0;
+    std::string exit;
+};
+
+/*!
+* \brief every run of one delay
+*/
+struct Summary{
+    std::vector<Delay> runs;
+    double recoverable = 0;     // slack of the worst run
+};
+
+//splits a line on a separator, the new line is dropped
+static std::vector<std::string> split(const char* line, char separator){
+    std::vector<std::string> out(1);
+    for(const char* c = line; *c != '\0' && *c != '\n' && *c != '\r'; c++){
+        if(*c == separator){
+            out.emplace_back();
+        }else{
+            out.back() += *c;
+        }
+    }
+    return out;
+}
+
+static bool csv_read(const char* path, std::vector<Delay>& delays, std::set<std::string>& runs){
+    FILE* file = std::fopen(path, "r");
+    if(file == nullptr){
+        printf("%s: can't open it\n", path);
+        return false;
+    }
+    std::map<std::string, int> column;
+    char buffer[1024];
+    while(std::fgets(buffer, sizeof(buffer), file) != nullptr){
+        std::vector<std::string> cells = split(buffer, ',');
+        if(cells[0] == "run"){
+            column.clear();
+            for(int i = 0; i < int(cells.size()); i++){
+                column[cells[i]] = i;
+            }
+            continue;
+        }
+        if(column.count("settled_ms") == 0){
+            printf("%s: written before delays were sampled, profile the auton again\n", path);
+            std::fclose(file);
+            return false;
+        }
+        auto cell = [&](const char* name){
+            int i = column[name];
+            return i < int(cells.size()) ? cells[i] : std::string();
+        };
+        if(cell("kind") != "Delay"){
+            continue;
+        }
+        runs.insert(std::string(path) + ":" + cell("run"));
+        Delay delay;
+        delay.auton = cell("auton");
+        delay.index = std::atoi(cell("index").c_str());
+        delay.label = cell("label");
+        delay.ms = std::atof(cell("duration_ms").c_str());
+        delay.slack = std::atof(cell("slack_ms").c_str());
+        delay.settled = std::atof(cell("settled_ms").c_str());
+        delay.current_low = std::atof(cell("current_low_ms").c_str());
+        delay.balls_stopped = std::atof(cell("balls_stopped_ms").c_str());
+        delay.exit = cell("exit");
+        delays.push_back(delay);
+    }
+    std::fclose(file);
+    return true;
+}
+
+//one sim run's delays from its --trace lines
+static std::vector<Delay> sim_read(const std::string& command, const std::string& auton){
+    std::vector<Delay> delays;
+    pool::lines(command, [&](char* line){
+        std::vector<std::string> cells = split(line, '\t');
+        if(cells.size() < 14 || cells[0] != "step" || cells[2] != "Delay"){
+            return;
+        }
+        Delay delay;
+        delay.auton = auton;
+        delay.index = std::atoi(cells[1].c_str());
+        delay.label = cells[7];
+        delay.ms = std::atof(cells[8].c_str());
+        delay.slack = std::atof(cells[9].c_str());
+        delay.settled = std::atof(cells[10].c_str());
+        delay.current_low = std::atof(cells[11].c_str());
+        delay.balls_stopped = std::atof(cells[12].c_str());
+        delay.exit = cells[13];
+        delays.push_back(delay);
+    });
+    return delays;
+}
+
+int main(int argc, char** argv){
+    if(argc < 2){
+        printf("usage: %s <profile.csv ...> | --sim <auton> [-n runs] [-j threads] [sim error options]\n", argv[0]);
+        return 1;
+    }
+    std::vector<const char*> files;
+    std::string auton;
+    int sim_runs = 1;
+    int threads = pool::threads_default();
+    std::string sim_options;
+    for(int i = 1; i < argc; i++){
+        bool value = i + 1 < argc;
+        if(std::strcmp(argv[i], "--sim") == 0 && value){
+            auton = argv[++i];
+        }else if(std::strcmp(argv[i], "-n") == 0 && value){
+            sim_runs = std::max(1, std::atoi(argv[++i]));
+        }else if(std::strcmp(argv[i], "-j") == 0 && value){
+            threads = std::max(1, std::atoi(argv[++i]));
+        }else if(std::strncmp(argv[i], "--", 2) == 0 && value){
+            sim_options += std::string(" ") + argv[i] + " " + pool::quote(argv[i + 1]);
+            i++;
+        }else{
+            files.push_back(argv[i]);
+        }
+    }
+
+    std::vector<Delay> delays;
+    std::set<std::string> runs;
+    for(const char* path : files){
+        if(!csv_read(path, delays, runs)){
+            return 1;
+        }
+    }
+    if(!auton.empty()){
+        std::string command = pool::quote(pool::sibling(argv[0], "sim")) + " --trace" + sim_options + " " + pool::quote(auton);
+        std::vector<std::vector<Delay>> results(sim_runs);
+        //the first run is the model, the rest draw their errors with a seed each
+        pool::run(sim_runs, threads, [&](int job){
+            results[job] = sim_read(command + " --seed " + std::to_string(job), auton);
+        });
+        for(int job = 0; job < sim_runs; job++){
+            if(!results[job].empty()){
+                runs.insert("sim:" + std::to_string(job));
+            }
+            delays.insert(delays.end(), results[job].begin(), results[job].end());
+        }
+    }
+    if(delays.empty()){
+        printf("no delays found\n");
+        return 1;
+    }
+
+    //the same step of the same auton in every run
+    std::map<std::tuple<std::string, int, std::string>, Summary> summaries;
+    for(const Delay& delay : delays){
+        Summary& summary = summaries[{delay.auton, delay.index, delay.label}];
+        summary.recoverable = summary.runs.empty() ? delay.slack : std::min(summary.recoverable, delay.slack);
+        summary.runs.push_back(delay);
+    }
+    std::vector<const std::pair<const std::tuple<std::string, int, std::string>, Summary>*> ranked;
+    for(const auto& entry : summaries){
+        ranked.push_back(&entry);
+    }
+    std::stable_sort(ranked.begin(), ranked.end(), [](auto a, auto b){
+        return a->second.recoverable > b->second.recoverable;
+    });
+
+    printf("%i delays in %i runs, ranked by the time the worst run left over\n\n", int(summaries.size()), int(runs.size()));
+    printf("  %-12s %4s  %-22s %6s %8s %8s %8s %8s  %-8s %11s\n", "auton", "step", "label", "ms", "motion", "current", "balls", "slack", "bound by", "recoverable");
+    std::map<std::string, double> totals;
+    for(const auto* entry : ranked){
+        const Summary& summary = entry->second;
+        //when each thing settled in the run that needed the delay most
+        Delay worst = summary.runs[0];
+        for(const Delay& delay : summary.runs){
+            if(delay.slack < worst.slack){
+                worst = delay;
+            }
+        }
+        double mean = 0;
+        for(const Delay& delay : summary.runs){
+            mean += delay.slack;
+        }
+        mean /= summary.runs.size();
+        printf("  %-12.12s %4i  %-22.22s %6.0f %8.0f %8.0f %8.0f %8.0f  %-8s %10.2fs\n", worst.auton.c_str(), worst.index, worst.label.c_str(),
+               worst.ms, worst.settled, worst.current_low, worst.balls_stopped, mean, worst.exit.c_str(), summary.recoverable / 1000.0);
+        totals[worst.auton] += summary.recoverable;
+    }
+    printf("\n");
+    for(const auto& [name, total] : totals){
+        printf("  %s: %.2fs recoverable\n", name.c_str(), total / 1000.0);
+    }
+    return 0;
+}
@@ -0,0 +1,179 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "trace.hpp"
+
+/*
+Turns a trace saved by the brain (/usd/trace.bin, see trace.hpp) or by the sim with --spans into Chrome
+trace JSON, for ui.perfetto.dev or chrome://tracing.
+
+    sim/build/timeline trace.bin                    JSON on stdout
+    sim/build/timeline trace.bin -o trace.json      JSON to a file
+
+Every task is a thread, highest priority at the top, and every named track (a Machine's states) is a thread
+under them. Spans nest by time, so the control loop's stages sit inside its iterations and a pid_wait inside
+the motion that started it. What each track holds and how much of the run it was busy goes to stderr.
+*/
+
+struct Track{
+    trace::TrackHeader header;
+    std::vector<trace::Span> spans;
+};
+
+static bool read(FILE* file, void* out, std::size_t size){
+    return size == 0 || std::fread(out, size, 1, file) == 1;
+}
+
+//names and tracks come from the brain, quotes and control characters can't be left as they are
+static std::string escape(const std::string& text){
+    std::string out;
+    for(char c : text){
+        if(c == '"' || c == '\\'){
+            out += '\\';
+            out += c;
+        }else if(static_cast<unsigned char>(c) < 0x20){
+            char code[8];
+            snprintf(code, sizeof(code), "\\u%04x", unsigned(c));
+            out += code;
+        }else{
+            out += c;
+        }
+    }
+    return out;
+}
+
+//micros covered by at least one span, spans sorted by begin
+static double busy(const std::vector<trace::Span>& spans){
+    double total = 0;
+    std::uint64_t covered = 0;
+    for(const trace::Span& span : spans){
+        std::uint64_t begin = std::max<std::uint64_t>(span.begin, covered);
+        std::uint64_t end = std::uint64_t(span.begin) + span.duration;
+        if(end > begin){
+            total += end - begin;
+            covered = end;
+        }
+    }
+    return total;
+}
+
+int main(int argc, char** argv){
+    const char* path = nullptr;
+    const char* json_path = nullptr;
+    for(int i = 1; i < argc; i++){
+        if(std::strcmp(argv[i], "-o") == 0 && i + 1 < argc){
+            json_path = argv[++i];
+        }else{
+            path = argv[i];
+        }
+    }
+    if(path == nullptr){
+        fprintf(stderr, "usage: timeline FILE [-o JSON]\n");
+        return 2;
+    }
+    FILE* file = std::fopen(path, "rb");
+    if(file == nullptr){
+        fprintf(stderr, "%s: can't open it\n", path);
+        return 1;
+    }
+
+    trace::FileHeader header;
+    if(!read(file, &header, sizeof(header)) || std::memcmp(header.magic, "TRC1", 4) != 0){
+        fprintf(stderr, "%s: not a trace\n", path);
+        return 1;
+    }
+    std::vector<Track> tracks(header.tracks);
+    for(Track& track : tracks){
+        if(!read(file, &track.header, sizeof(track.header))){
+            fprintf(stderr, "%s: cut short in the tracks\n", path);
+            return 1;
+        }
+        track.header.name[sizeof(track.header.name) - 1] = '\0';
+    }
+    std::vector<std::string> names(header.names);
+    for(std::string& name : names){
+        std::uint16_t length = 0;
+        if(!read(file, &length, sizeof(length))){
+            fprintf(stderr, "%s: cut short in the names\n", path);
+            return 1;
+        }
+        name.resize(length);
+        if(!read(file, name.data(), length)){
+            fprintf(stderr, "%s: cut short in the names\n", path);
+            return 1;
+        }
+    }
+    for(Track& track : tracks){
+        track.spans.resize(track.header.spans);
+        if(!read(file, track.spans.data(), track.spans.size() * sizeof(trace::Span))){
+            fprintf(stderr, "%s: cut short in the spans of %s\n", path, track.header.name);
+            return 1;
+        }
+        //parents first, so a viewer that reads them in order still nests them
+        std::sort(track.spans.begin(), track.spans.end(), [](const trace::Span& a, const trace::Span& b){
+            return a.begin != b.begin ? a.begin < b.begin : a.duration > b.duration;
+        });
+    }
+    std::fclose(file);
+
+    //tasks by priority, highest first, then the named tracks in the order they were made
+    std::vector<int> order(tracks.size());
+    for(std::size_t i = 0; i < order.size(); i++){
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b){
+        const trace::TrackHeader& x = tracks[a].header;
+        const trace::TrackHeader& y = tracks[b].header;
+        return x.task != y.task ? x.task > y.task : x.priority > y.priority;
+    });
+
+    FILE* json = json_path == nullptr ? stdout : std::fopen(json_path, "w");
+    if(json == nullptr){
+        fprintf(stderr, "%s: can't write it\n", json_path);
+        return 1;
+    }
+    fprintf(json, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    fprintf(json, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"V5 brain\"}}");
+    std::uint64_t end = 0;
+    for(std::size_t rank = 0; rank < order.size(); rank++){
+        const Track& track = tracks[order[rank]];
+        int tid = order[rank] + 1;
+        std::string name = escape(track.header.name);
+        if(track.header.task){
+            name += " (priority " + std::to_string(track.header.priority) + ")";
+        }
+        fprintf(json, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%i,\"args\":{\"name\":\"%s\"}}", tid, name.c_str());
+        fprintf(json, ",\n{\"name\":\"thread_sort_index\",\"ph\":\"M\",\"pid\":1,\"tid\":%i,\"args\":{\"sort_index\":%zu}}", tid, rank);
+        const char* category = track.header.task ? "task" : "state";
+        for(const trace::Span& span : track.spans){
+            const std::string& span_name = span.name < names.size() ? names[span.name] : "?";
+            fprintf(json, ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%u,\"dur\":%u,\"pid\":1,\"tid\":%i}", escape(span_name).c_str(),
+                    category, unsigned(span.begin), unsigned(span.duration), tid);
+            end = std::max<std::uint64_t>(end, std::uint64_t(span.begin) + span.duration);
+        }
+    }
+    fprintf(json, "\n]}\n");
+    if(json != stdout){
+        std::fclose(json);
+    }
+
+    fprintf(stderr, "%-24s %9s %8s %12s\n", "track", "priority", "spans", "busy");
+    for(int index : order){
+        const Track& track = tracks[index];
+        double share = end == 0 ? 0 : 100 * busy(track.spans) / end;
+        fprintf(stderr, "%-24s %9s %8u %11.1f%%", track.header.name, track.header.task ? std::to_string(track.header.priority).c_str() : "-",
+                unsigned(track.header.spans), share);
+        if(track.header.overwritten > 0){
+            fprintf(stderr, "  %u older spans overwritten", unsigned(track.header.overwritten));
+        }
+        fprintf(stderr, "\n");
+    }
+    fprintf(stderr, "%.3fs traced, %zu names", end / 1e6, names.size());
+    if(header.dropped > 0){
+        fprintf(stderr, ", %u spans from tasks past the most tracks dropped", unsigned(header.dropped));
+    }
+    fprintf(stderr, "\n");
+    return 0;
+}
@@ -0,0 +1,164 @@
+#include "tune.hpp"
+#include <cmath>
+#include <cstdio>
+#include "main.h"
+#include "settle.hpp"
+#include "sim.hpp"
+#include "tasks.hpp"
+
+namespace tune{
+
+    //the speeds autons.cpp runs these motions at
+    static const int DRIVE_SPEED = 110;
+    static const int TURN_SPEED = 90;
+    static const int SWING_SPEED = 110;
+
+    //how long the robot is left to hold the target before its error is read
+    static const int REST_MS = 300;
+
+    //odom motions don't leave an overshoot in their settle::Record, it is sampled here instead
+    static bool sampling = false;
+    static ez::pose sample_from;
+    static ez::pose sample_target;
+    static double sample_overshoot = 0;
+
+    static void sample_task(){
+        while(true){
+            if(sampling){
+                double dx = sample_target.x - sample_from.x;
+                double dy = sample_target.y - sample_from.y;
+                double length = std::hypot(dx, dy);
+                ez::pose now = chassis.odom_pose_get();
+                if(length > 0){
+                    double past = ((now.x - sample_target.x) * dx + (now.y - sample_target.y) * dy) / length;
+                    sample_overshoot = std::fmax(sample_overshoot, past);
+                }
+            }
+            pros::delay(ez::util::DELAY_TIME);
+        }
+    }
+
+    static ez::PID& gains_pid(const std::string& group){
+        if(group == "drive"){
+            return chassis.forward_drivePID;
+        }else if(group == "swing"){
+            return chassis.swingPID;
+        }else if(group == "odom"){
+            return chassis.odom_angularPID;
+        }
+        return chassis.turnPID;
+    }
+
+    static ez::PID& exit_pid(const std::string& group){
+        if(group == "drive"){
+            return chassis.leftPID;
+        }else if(group == "swing"){
+            return chassis.swingPID;
+        }else if(group == "odom"){
+            return chassis.xyPID;
+        }
+        return chassis.turnPID;
+    }
+
+    //error of the running motion, the PIDs keep running while the robot holds
+    static double motion_error(const std::string& group){
+        if(group == "drive"){
+            return (chassis.leftPID.error + chassis.rightPID.error) / 2.0;
+        }
+        return exit_pid(group).error;
+    }
+
+    bool group_valid(const std::string& group){
+        for(const char* name : GROUPS){
+            if(group == name){
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::vector<Param> params_get(const std::string& group){
+        ez::PID::Constants gains = gains_pid(group).constants;
+        ez::PID::exit_condition_ exit = exit_pid(group).exit;
+        return {
+            {"kp", gains.kp, GAIN},
+            {"ki", gains.ki, GAIN},
+            {"kd", gains.kd, GAIN},
+            {"start_i", gains.start_i, ERROR},
+            {"small_exit_time", double(exit.small_exit_time), TIME},
+            {"small_error", exit.small_error, ERROR},
+            {"big_exit_time", double(exit.big_exit_time), TIME},
+            {"big_error", exit.big_error, ERROR},
+        };
+    }
+
+    void params_set(const std::string& group, const std::vector<double>& values){
+        std::vector<Param> params = params_get(group);
+        for(int i = 0; i < int(params.size()) && i < int(values.size()); i++){
+            params[i].value = values[i];
+        }
+        double kp = params[0].value, ki = params[1].value, kd = params[2].value, start_i = params[3].value;
+        int small_time = std::lround(params[4].value), big_time = std::lround(params[6].value);
+        double small_error = params[5].value, big_error = params[7].value;
+        ez::PID::exit_condition_ exit = exit_pid(group).exit;
+
+        if(group == "drive"){
+            chassis.pid_drive_constants_set(kp, ki, kd, start_i);
+            chassis.pid_drive_exit_condition_set(small_time, small_error, big_time, big_error, exit.velocity_exit_time, exit.mA_timeout);
+        }else if(group == "swing"){
+            chassis.pid_swing_constants_set(kp, ki, kd, start_i);
+            chassis.pid_swing_exit_condition_set(small_time, small_error, big_time, big_error, exit.velocity_exit_time, exit.mA_timeout);
+        }else if(group == "odom"){
+            chassis.pid_odom_angular_constants_set(kp, ki, kd, start_i);
+            chassis.pid_odom_drive_exit_condition_set(small_time, small_error, big_time, big_error, exit.velocity_exit_time, exit.mA_timeout);
+        }else{
+            chassis.pid_turn_constants_set(kp, ki, kd, start_i);
+            chassis.pid_turn_exit_condition_set(small_time, small_error, big_time, big_error, exit.velocity_exit_time, exit.mA_timeout);
+        }
+    }
+
+    //set motion index of the group, false once there are no more
+    static bool motion_set(const std::string& group, int index){
+        static const double turns[] = {30, -60, 120, 75};
+        static const double drives[] = {6, -24, 48, -30};
+        static const std::pair<ez::e_swing, double> swings[] = {{ez::LEFT_SWING, 45}, {ez::RIGHT_SWING, 0}, {ez::RIGHT_SWING, -45}, {ez::LEFT_SWING, 0}};
+        static const ez::odom points[] = {{{0, 24}, ez::fwd, DRIVE_SPEED}, {{-18, 8}, ez::fwd, DRIVE_SPEED}, {{0, -10}, ez::rev, DRIVE_SPEED}, {{0, 0}, ez::fwd, DRIVE_SPEED}};
+        if(index >= 4){
+            return false;
+        }
+        if(group == "drive"){
+            chassis.pid_drive_set(drives[index], DRIVE_SPEED);
+        }else if(group == "swing"){
+            chassis.pid_swing_set(swings[index].first, swings[index].second, SWING_SPEED);
+        }else if(group == "odom"){
+            sample_from = chassis.odom_pose_get();
+            sample_target = points[index].target;
+            sample_overshoot = 0;
+            chassis.pid_odom_set(points[index]);
+        }else{
+            chassis.pid_turn_set(turns[index], TURN_SPEED);
+        }
+        return true;
+    }
+
+    void run(const std::string& group){
+        sim::reset({sim::FIELD / 2, sim::FIELD / 2, 0});
+        chassis.pid_targets_reset();
+        chassis.drive_imu_reset();
+        chassis.drive_sensor_reset();
+        chassis.odom_xyt_set(0_in, 0_in, 0_deg);
+        chassis.drive_brake_set(MOTOR_BRAKE_HOLD);
+        pros::Task sampler(sample_task, tasks::PRIORITY_USER, TASK_STACK_DEPTH_DEFAULT, "tune sample");
+
+        for(int i = 0; motion_set(group, i); i++){
+            std::uint32_t start = pros::millis();
+            sampling = group == "odom";
+            chassis.pid_wait();
+            sampling = false;
+            std::uint32_t settled = pros::millis() - start;
+            double overshoot = group == "odom" ? sample_overshoot : settle::last().overshoot;
+            pros::delay(REST_MS);
+            printf("motion\t%s\t%i\t%u\t%.3f\t%.3f\n", group.c_str(), i, settled, std::fmax(0.0, overshoot), std::fabs(motion_error(group)));
+        }
+    }
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+/*! \namespace tune
+ *  \brief Runs a fixed set of motions with one PID's gains and exit conditions, for tuner.cpp
+ *
+ *  A group is the PID and exit conditions one kind of motion uses:
+ *
+ *      -turn       pid_turn_constants_set and pid_turn_exit_condition_set
+ *
+ *      -drive      pid_drive_constants_set and pid_drive_exit_condition_set
+ *
+ *      -swing      pid_swing_constants_set and pid_swing_exit_condition_set
+ *
+ *      -odom       pid_odom_angular_constants_set and pid_odom_drive_exit_condition_set
+ */
+namespace tune{
+
+    /*!
+    * \brief what a parameter is, the tuner searches each kind in its own range
+    */
+    enum Kind{
+        GAIN = 0,
+        TIME = 1,       // ms
+        ERROR = 2       // inches or degrees
+    };
+
+    /*!
+    * \brief one value the tuner can change
+    */
+    struct Param{
+        const char* name;
+        double value;
+        Kind kind;
+    };
+
+    /*!
+    * \brief the groups that can be tuned
+    */
+    inline const char* GROUPS[] = {"turn", "drive", "swing", "odom"};
+
+    /*!
+    * \brief true if group is one of GROUPS
+    */
+    bool group_valid(const std::string& group);
+
+    /*!
+    * \brief the parameters of a group with the values the chassis has now
+    *
+    * kp, ki, kd, start_i, small_exit_time, small_error, big_exit_time, big_error
+    */
+    std::vector<Param> params_get(const std::string& group);
+
+    /*!
+    * \brief give a group new values, in the order params_get() returns them
+    *
+    * The velocity exit time and the mA timeout are kept.
+    */
+    void params_set(const std::string& group, const std::vector<double>& values);
+
+    /*!
+    * \brief run the group's motions from the middle of the field
+    *
+    * Prints one line per motion, tab separated:
+    *
+    *     motion <group> <index> <ms to settle> <overshoot> <error after resting>
+    */
+    void run(const std::string& group);
+}
@@ -0,0 +1,316 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+#include "pool.hpp"
+
+/*
+Searches PID gains and exit conditions in the sim for the fastest settle that stays under an overshoot
+limit, and prints them as lines for default_constants() in autons.cpp.
+
+    sim/build/tuner turn                    tune the turn group, see tune.hpp for the groups
+    sim/build/tuner all -j 8                every group, 8 sims at a time
+    -p N                                    particles in the swarm
+    -i N                                    iterations
+    --overshoot X                           most a motion may go past its target, in or deg
+    --seed N                                the same seed searches the same way
+
+It is a particle swarm. Particle 0 starts at the constants the chassis has now, so the result is never
+worse than them on these motions. Every candidate is one sim process, see pool.hpp.
+*/
+
+//overshoot limits when none is given, in deg for turn and swing and in for drive and odom
+static const double TURN_OVERSHOOT = 3;
+static const double DRIVE_OVERSHOOT = 1;
+
+//cost of every in or deg past the overshoot limit or left as error after resting, in ms
+static const double PENALTY = 1000;
+
+//swarm weights, the standard constriction values
+static const double INERTIA = 0.729;
+static const double PULL = 1.49445;
+
+//kinds from tune.hpp
+enum Kind{
+    GAIN = 0,
+    TIME = 1,
+    ERROR = 2
+};
+
+struct Param{
+    std::string name;
+    double value;
+    Kind kind;
+    double low;
+    double high;
+};
+
+struct Motion{
+    double ms = 0;
+    double overshoot = 0;
+    double rest = 0;
+};
+
+/*!
+* \brief one run of a group's motions
+*/
+struct Result{
+    bool finished = false;
+    std::vector<double> values;
+    std::vector<Motion> motions;
+    double cost = 0;
+};
+
+static std::string sim_path;
+
+//pulls tab separated fields off the front of a line
+static std::string field(char*& line){
+    char* tab = std::strchr(line, '\t');
+    std::string out = tab == nullptr ? std::string(line, std::strcspn(line, "\n")) : std::string(line, tab);
+    line = tab == nullptr ? line + std::strlen(line) : tab + 1;
+    return out;
+}
+
+static Result evaluate(const std::string& group, const std::vector<double>& values, std::vector<Param>* params = nullptr){
+    std::string command = pool::quote(sim_path) + " --tune " + group;
+    if(!values.empty()){
+        std::string list;
+        for(double value : values){
+            char number[32];
+            snprintf(number, sizeof(number), "%s%.6g", list.empty() ? "" : ",", value);
+            list += number;
+        }
+        command += " --set " + list;
+    }
+    Result result;
+    pool::lines(command, [&](char* line){
+        std::string type = field(line);
+        if(type == "param"){
+            std::string name = field(line);
+            double value = std::atof(field(line).c_str());
+            Kind kind = Kind(std::atoi(field(line).c_str()));
+            result.values.push_back(value);
+            if(params != nullptr){
+                params->push_back({name, value, kind, 0, 0});
+            }
+        }else if(type == "motion"){
+            field(line);
+            field(line);
+            Motion motion;
+            motion.ms = std::atof(field(line).c_str());
+            motion.overshoot = std::atof(field(line).c_str());
+            motion.rest = std::atof(field(line).c_str());
+            result.motions.push_back(motion);
+        }
+    });
+    result.finished = !result.motions.empty();
+    return result;
+}
+
+//settle time with every broken limit added on top, the small error it started with is the limit for resting
+static double cost(const Result& result, double overshoot, double rest_limit){
+    if(!result.finished){
+        return 1e12;
+    }
+    double total = 0;
+    for(const Motion& motion : result.motions){
+        total += motion.ms;
+        total += PENALTY * std::fmax(0, motion.overshoot - overshoot);
+        total += PENALTY * std::fmax(0, motion.rest - rest_limit);
+    }
+    return total;
+}
+
+//the range searched for each parameter, from where it starts
+static void bounds_set(std::vector<Param>& params){
+    for(Param& param : params){
+        if(param.kind == GAIN){
+            //a gain that is off stays off, turning on i is a decision and not a tune, and one that is on
+            //stays on so the swarm can't trade p away for d on motions that barely use it
+            param.low = 0.2 * param.value;
+            param.high = 3 * param.value;
+        }else if(param.kind == TIME){
+            param.low = 40;
+            param.high = 400;
+        }else{
+            param.low = 0.25 * param.value;
+            param.high = 1.5 * param.value;
+        }
+    }
+}
+
+static std::vector<double> clamp(const std::vector<Param>& params, std::vector<double> values){
+    for(int i = 0; i < int(params.size()); i++){
+        values[i] = std::clamp(values[i], params[i].low, params[i].high);
+        if(params[i].kind == TIME){
+            values[i] = 10 * std::round(values[i] / 10);
+        }
+    }
+    //the big exit is the looser one, in both time and error
+    values[6] = std::max(values[6], values[4]);
+    values[7] = std::max(values[7], values[5]);
+    return values;
+}
+
+/*!
+* \brief one group's search
+* \return the best values found
+*/
+static Result swarm(const std::string& group, int particles, int iterations, int threads, double overshoot, std::uint64_t seed, Result& current){
+    std::vector<Param> params;
+    current = evaluate(group, {}, &params);
+    if(!current.finished){
+        return current;
+    }
+    bounds_set(params);
+    double rest_limit = params[5].value;
+    current.cost = cost(current, overshoot, rest_limit);
+
+    std::mt19937_64 random(seed);
+    std::uniform_real_distribution<double> unit(0, 1);
+    int dimensions = int(params.size());
+    std::vector<std::vector<double>> position(particles, std::vector<double>(dimensions));
+    std::vector<std::vector<double>> velocity(particles, std::vector<double>(dimensions, 0));
+    std::vector<Result> best(particles);
+    Result global = current;
+
+    for(int p = 0; p < particles; p++){
+        for(int d = 0; d < dimensions; d++){
+            double range = params[d].high - params[d].low;
+            position[p][d] = p == 0 ? current.values[d] : params[d].low + unit(random) * range;
+            velocity[p][d] = p == 0 ? 0 : (unit(random) - 0.5) * range * 0.2;
+        }
+        position[p] = clamp(params, position[p]);
+    }
+
+    for(int iteration = 0; iteration < iterations; iteration++){
+        std::vector<Result> results(particles);
+        pool::run(particles, threads, [&](int p){
+            results[p] = evaluate(group, position[p]);
+            results[p].values = position[p];
+            results[p].cost = cost(results[p], overshoot, rest_limit);
+        });
+        for(int p = 0; p < particles; p++){
+            if(best[p].values.empty() || results[p].cost < best[p].cost){
+                best[p] = results[p];
+            }
+            if(results[p].cost < global.cost){
+                global = results[p];
+            }
+        }
+        printf("  %s %3i/%i  best %.0fms\n", group.c_str(), iteration + 1, iterations, global.cost);
+
+        for(int p = 0; p < particles; p++){
+            for(int d = 0; d < dimensions; d++){
+                if(params[d].high <= params[d].low){
+                    continue;
+                }
+                velocity[p][d] = INERTIA * velocity[p][d]
+                               + PULL * unit(random) * (best[p].values[d] - position[p][d])
+                               + PULL * unit(random) * (global.values[d] - position[p][d]);
+                position[p][d] += velocity[p][d];
+            }
+            position[p] = clamp(params, position[p]);
+        }
+    }
+    return global;
+}
+
+//lines in the style of default_constants() in autons.cpp
+static void constants_print(const std::string& group, const std::vector<double>& v){
+    bool turn = group == "turn" || group == "swing";
+    const char* unit = turn ? "_deg" : "_in";
+    const char* constants = group == "odom" ? "odom_angular" : group.c_str();
+    const char* exit = group == "odom" ? "odom_drive" : group.c_str();
+    //the velocity exit and mA timeout are kept as autons.cpp has them
+    const char* tail = group == "odom" ? "500_ms, 750_ms" : "500_ms, 500_ms";
+    if(v[3] != 0){
+        printf("  chassis.pid_%s_constants_set(%.3g, %.3g, %.3g, %.3g);\n", constants, v[0], v[1], v[2], v[3]);
+    }else{
+        printf("  chassis.pid_%s_constants_set(%.3g, %.3g, %.3g);\n", constants, v[0], v[1], v[2]);
+    }
+    printf("  chassis.pid_%s_exit_condition_set(%.0f_ms, %.3g%s, %.0f_ms, %.3g%s, %s);\n", exit, v[4], v[5], unit, v[6], v[7], unit, tail);
+}
+
+static void compare_print(const std::string& group, const Result& current, const Result& tuned){
+    printf("\n  %s      settle ms          overshoot         rest error\n", group.c_str());
+    printf("  motion   now  tuned        now  tuned        now  tuned\n");
+    double now_total = 0;
+    double tuned_total = 0;
+    for(int i = 0; i < int(current.motions.size()) && i < int(tuned.motions.size()); i++){
+        const Motion& a = current.motions[i];
+        const Motion& b = tuned.motions[i];
+        printf("  %6i %5.0f %6.0f     %6.2f %6.2f     %6.2f %6.2f\n", i, a.ms, b.ms, a.overshoot, b.overshoot, a.rest, b.rest);
+        now_total += a.ms;
+        tuned_total += b.ms;
+    }
+    printf("  total  %5.0f %6.0f  (%+.0f%%)\n\n", now_total, tuned_total, now_total == 0 ? 0.0 : 100.0 * (tuned_total - now_total) / now_total);
+}
+
+int main(int argc, char** argv){
+    if(argc < 2){
+        printf("usage: %s <turn|drive|swing|odom|all> [-p particles] [-i iterations] [-j threads] [--overshoot x] [--seed n]\n", argv[0]);
+        return 1;
+    }
+    std::string which;
+    int particles = 24;
+    int iterations = 25;
+    int threads = pool::threads_default();
+    double overshoot = -1;
+    std::uint64_t seed = 1;
+    for(int i = 1; i < argc; i++){
+        bool value = i + 1 < argc;
+        if(std::strcmp(argv[i], "-p") == 0 && value){
+            particles = std::max(2, std::atoi(argv[++i]));
+        }else if(std::strcmp(argv[i], "-i") == 0 && value){
+            iterations = std::max(1, std::atoi(argv[++i]));
+        }else if(std::strcmp(argv[i], "-j") == 0 && value){
+            threads = std::max(1, std::atoi(argv[++i]));
+        }else if(std::strcmp(argv[i], "--overshoot") == 0 && value){
+            overshoot = std::atof(argv[++i]);
+        }else if(std::strcmp(argv[i], "--seed") == 0 && value){
+            seed = std::strtoull(argv[++i], nullptr, 10);
+        }else{
+            which = argv[i];
+        }
+    }
+    sim_path = pool::sibling(argv[0], "sim");
+
+    std::vector<std::string> groups;
+    if(which == "all"){
+        groups = {"turn", "drive", "swing", "odom"};
+    }else{
+        groups = {which};
+    }
+
+    auto wall_start = std::chrono::steady_clock::now();
+    std::vector<std::pair<std::string, Result>> tuned;
+    std::vector<Result> currents;
+    for(const std::string& group : groups){
+        double limit = overshoot >= 0 ? overshoot : group == "turn" || group == "swing" ? TURN_OVERSHOOT : DRIVE_OVERSHOOT;
+        Result current;
+        Result best = swarm(group, particles, iterations, threads, limit, seed, current);
+        if(!current.finished){
+            printf("%s: the sim didn't run it, check the group name\n", group.c_str());
+            return 1;
+        }
+        tuned.push_back({group, best});
+        currents.push_back(current);
+    }
+    double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+    printf("\n%i particles, %i iterations on %i threads in %.1fs\n", particles, iterations, threads, wall);
+
+    for(int i = 0; i < int(tuned.size()); i++){
+        compare_print(tuned[i].first, currents[i], tuned[i].second);
+    }
+    printf("  // Tuned in the sim by sim/build/tuner, check them on the robot before keeping them\n");
+    for(const auto& [group, best] : tuned){
+        constants_print(group, best.values);
+    }
+    return 0;
+}
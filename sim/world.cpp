@@ -0,0 +1,440 @@
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <deque>
+#include <map>
+#include <random>
+#include <set>
+#include <vector>
+#include "sim.hpp"
+
+//drive, matches the Chassis constructor in main.cpp (3.25" wheels at 480 rpm) on a ~15 lb robot
+static const double WHEEL_DIAMETER = 3.25;                                   // in
+static const double FREE_SPEED = 480.0 / 60.0 * M_PI * WHEEL_DIAMETER;      // in/s at 12 V
+static const double STALL_FORCE = 0.4375 / 0.041275 * 0.85;                 // N per motor at the wheel, 85% efficient
+static const double MASS = 6.8;                                             // kg
+static const double INERTIA = 0.16;                                         // kg m^2
+static const double TRACK = 11.5;                                           // in
+static const double ROLLING = 0.6;                                          // 1/s, linear drag
+static const double SCRUB = 4.0;                                            // 1/s, turning drag from the wheels scrubbing
+static const double RADIUS = 7.5;                                           // in, the robot is treated as a circle against the walls
+static const double STALL_CURRENT = 2500;                                   // mA
+
+//rollers, free spinning 600 rpm motors with a light load
+static const double ROLLER_FREE_RPM = 600;
+static const double ROLLER_TAU = 0.05;                                      // s
+
+//the imu reads short and drive_imu_scaler_set(1.0049) in default_constants() corrects it
+static const double IMU_GAIN = 1.0 / 1.0049;
+
+//vex distance sensors stop seeing the wall past 2 m
+static const double DISTANCE_RANGE = 2000;                                  // mm
+
+//balls carried past the optical sensor by the roller feeding it, a ball is in front of it for its diameter
+static const double BALL_DIAMETER = 3.5;                                    // in
+static const double BALL_GAP = 1;                                           // in between balls coming in
+static const double BALL_IN_PER_REV = 1.4;                                  // in a ball moves per feeder revolution
+
+static const double IN_TO_M = 0.0254;
+
+struct Motor{
+    double volts = 0;
+    double position = 0;     // deg
+    double velocity = 0;     // rpm
+    double current = 0;      // mA
+    double temperature = 25;
+    bool hold = false;
+    int side = -1;           // 0 left, 1 right, -1 not on the drive
+    double strength = 1;
+};
+
+struct Tracker{
+    bool vertical = true;
+    double offset = 0;
+    double diameter = 2.75;
+    double position = 0;     // centidegrees
+};
+
+struct Beam{
+    double direction = 0;
+    double along = 0;
+    double across = 0;
+};
+
+struct World{
+    sim::Pose pose;
+    double v = 0;            // in/s forward
+    double w = 0;            // deg/s clockwise
+    double imu = 0;          // deg, what the imu reports
+    int imu_port = 0;
+    std::map<int, Motor> motors;
+    std::map<int, Tracker> trackers;
+    std::map<int, Beam> beams;
+    std::set<int> unplugged;
+    int optical_port = 0;
+    int feeder_port = 0;
+    std::deque<std::pair<double, std::uint64_t>> fed;  // hue and micros of each ball given to the robot
+    double ball = -1;        // in the front ball has moved past the start of the sensor, negative with none
+    double ball_hue = 0;
+    bool digital[8] = {};
+    int digital_changes[8] = {};
+    int analog[4] = {};
+    bool buttons[32] = {};
+
+    //this run's errors
+    sim::Noise noise;
+    std::mt19937_64 random;
+    double slip[2] = {};
+    double drift = 0;        // deg/s
+};
+
+//the robot's globals add their devices during static init, so the world is built on first use
+static World& world(){
+    static World instance;
+    return instance;
+}
+
+static Motor& motor(int port){
+    return world().motors[std::abs(port)];
+}
+
+//force one side of the drive puts on the robot in newtons
+static double side_force(int side, double speed){
+    double force = 0;
+    for(auto& [port, m] : world().motors){
+        if(m.side != side || world().unplugged.count(port)){
+            continue;
+        }
+        double back_emf = speed / FREE_SPEED;
+        if(m.volts == 0){
+            //coast is free, hold pushes back like a stiff brake
+            force += m.hold ? -3 * STALL_FORCE * back_emf : 0;
+        }else{
+            force += m.strength * STALL_FORCE * (m.volts / 12.0 - back_emf);
+        }
+    }
+    return force;
+}
+
+//keep the robot inside the walls, only the part of the motion along a wall it drives into is kept
+static void walls(double dx, double dy){
+    double moved = std::hypot(dx, dy);
+    if(moved == 0){
+        return;
+    }
+    double keep = 1;
+    if(world().pose.x < RADIUS){
+        world().pose.x = RADIUS;
+        keep = dx < 0 ? std::fmin(keep, std::fabs(dy) / moved) : keep;
+    }
+    if(world().pose.x > sim::FIELD - RADIUS){
+        world().pose.x = sim::FIELD - RADIUS;
+        keep = dx > 0 ? std::fmin(keep, std::fabs(dy) / moved) : keep;
+    }
+    if(world().pose.y < RADIUS){
+        world().pose.y = RADIUS;
+        keep = dy < 0 ? std::fmin(keep, std::fabs(dx) / moved) : keep;
+    }
+    if(world().pose.y > sim::FIELD - RADIUS){
+        world().pose.y = sim::FIELD - RADIUS;
+        keep = dy > 0 ? std::fmin(keep, std::fabs(dx) / moved) : keep;
+    }
+    world().v *= keep;
+}
+
+namespace sim{
+    void world_step(std::uint64_t dt_us){
+        double dt = dt_us / 1e6;
+        double w_rad = world().w * M_PI / 180.0;
+        double left_speed = world().v + w_rad * TRACK / 2.0;
+        double right_speed = world().v - w_rad * TRACK / 2.0;
+
+        double left = side_force(0, left_speed);
+        double right = side_force(1, right_speed);
+
+        double a = (left + right) / MASS / IN_TO_M - ROLLING * world().v;                        // in/s^2
+        double alpha = (left - right) * (TRACK / 2.0 * IN_TO_M) / INERTIA - SCRUB * w_rad;      // rad/s^2
+        world().v += a * dt;
+        w_rad += alpha * dt;
+        world().w = w_rad * 180.0 / M_PI;
+
+        double turned = world().w * dt;
+        double heading = (world().pose.theta + turned / 2.0) * M_PI / 180.0;
+        double dx = world().v * std::sin(heading) * dt;
+        double dy = world().v * std::cos(heading) * dt;
+        world().pose.theta += turned;
+        world().pose.x += dx;
+        world().pose.y += dy;
+        walls(dx, dy);
+        world().imu += turned * IMU_GAIN + world().drift * dt;
+
+        //what each side's wheels actually did after the walls
+        w_rad = world().w * M_PI / 180.0;
+        left_speed = world().v + w_rad * TRACK / 2.0;
+        right_speed = world().v - w_rad * TRACK / 2.0;
+        for(auto& [port, m] : world().motors){
+            if(m.side >= 0){
+                double speed = m.side == 0 ? left_speed : right_speed;
+                m.velocity = speed * (1 + world().slip[m.side]) / (M_PI * WHEEL_DIAMETER) * 60.0;
+                m.current = m.volts == 0 ? 0 : std::min(STALL_CURRENT, std::fabs(m.volts / 12.0 - speed / FREE_SPEED) * STALL_CURRENT);
+            }else{
+                m.velocity += (m.volts / 12.0 * ROLLER_FREE_RPM - m.velocity) * std::min(1.0, dt / ROLLER_TAU);
+                m.current = std::fabs(m.volts / 12.0 - m.velocity / ROLLER_FREE_RPM) * STALL_CURRENT * 0.5;
+            }
+            m.position += m.velocity / 60.0 * 360.0 * dt;
+            m.temperature += (m.current * m.current * 1e-7 - (m.temperature - 25) * 0.002) * dt;
+        }
+
+        for(auto& [port, t] : world().trackers){
+            double moved = t.vertical ? (world().v - w_rad * t.offset) * dt : (w_rad * t.offset) * dt;
+            t.position += moved / (M_PI * t.diameter) * 36000.0;
+        }
+
+        //the feeder only carries balls in, one at a time past the sensor
+        if(world().optical_port != 0){
+            double feed = std::max(0.0, motor(world().feeder_port).velocity) / 60.0 * BALL_IN_PER_REV * dt;
+            if(world().ball >= 0){
+                world().ball += feed;
+                if(world().ball >= BALL_DIAMETER + BALL_GAP){
+                    world().ball = -1;
+                }
+            }else if(feed > 0 && !world().fed.empty() && world().fed.front().second <= micros()){
+                world().ball = 0;
+                world().ball_hue = world().fed.front().first;
+                world().fed.pop_front();
+            }
+        }
+    }
+
+    void noise_set(const Noise& noise, std::uint64_t seed){
+        world().noise = noise;
+        world().random.seed(seed);
+    }
+
+    void reset(Pose start){
+        std::normal_distribution<double> normal(0, 1);
+        std::uniform_real_distribution<double> uniform(0, 1);
+        const Noise& noise = world().noise;
+        start.x += normal(world().random) * noise.start;
+        start.y += normal(world().random) * noise.start;
+        start.theta += normal(world().random) * noise.start_angle;
+        world().slip[0] = uniform(world().random) * noise.slip;
+        world().slip[1] = uniform(world().random) * noise.slip;
+        world().drift = normal(world().random) * noise.drift;
+
+        world().pose = start;
+        world().v = 0;
+        world().w = 0;
+        world().imu = 0;
+        for(auto& [port, m] : world().motors){
+            m.volts = 0;
+            m.velocity = 0;
+            m.position = 0;
+            m.current = 0;
+            m.strength = m.side < 0 ? 1 : std::max(0.0, 1 + normal(world().random) * noise.strength);
+        }
+        for(auto& [port, t] : world().trackers){
+            t.position = 0;
+        }
+        world().unplugged.clear();
+        world().fed.clear();
+        world().ball = -1;
+    }
+
+    Pose pose(){
+        return world().pose;
+    }
+
+    double speed(){
+        return world().v;
+    }
+
+    void drive_motor_add(int port, bool left){
+        motor(port).side = left ? 0 : 1;
+    }
+
+    void tracker_add(int port, bool vertical, double offset, double diameter){
+        Tracker& t = world().trackers[std::abs(port)];
+        t.vertical = vertical;
+        t.offset = offset;
+        t.diameter = diameter;
+    }
+
+    void distance_add(int port, double direction, double along, double across){
+        Beam& b = world().beams[std::abs(port)];
+        b.direction = direction;
+        b.along = along;
+        b.across = across;
+    }
+
+    void optical_add(int port, int feeder){
+        world().optical_port = std::abs(port);
+        world().feeder_port = std::abs(feeder);
+    }
+
+    void ball_feed(double hue, std::uint64_t at){
+        world().fed.push_back({hue, at});
+    }
+
+    void imu_add(int port){
+        world().imu_port = std::abs(port);
+    }
+
+    void unplug(int port, bool unplugged){
+        if(unplugged){
+            world().unplugged.insert(std::abs(port));
+        }else{
+            world().unplugged.erase(std::abs(port));
+        }
+    }
+
+    bool plugged(int port){
+        return device_type(port) != 0;
+    }
+
+    int device_type(int port){
+        port = std::abs(port);
+        if(world().unplugged.count(port)){
+            return 0;
+        }
+        if(port == world().imu_port){
+            return 6;
+        }
+        if(world().beams.count(port)){
+            return 7;
+        }
+        if(port == world().optical_port){
+            return 16;
+        }
+        if(world().trackers.count(port)){
+            return 4;
+        }
+        if(world().motors.count(port)){
+            return 2;
+        }
+        return 0;
+    }
+
+    void motor_add(int port){
+        motor(port);
+    }
+
+    void motor_voltage_set(int port, double volts){
+        motor(port).volts = std::clamp(volts, -12.0, 12.0);
+    }
+
+    double motor_voltage(int port){
+        return motor(port).volts;
+    }
+
+    double motor_position(int port){
+        return motor(port).position;
+    }
+
+    double motor_velocity(int port){
+        return motor(port).velocity;
+    }
+
+    double motor_current(int port){
+        return motor(port).current;
+    }
+
+    double motor_temperature(int port){
+        return motor(port).temperature;
+    }
+
+    void motor_tare(int port, double position){
+        motor(port).position = position;
+    }
+
+    void motor_brake_set(int port, bool hold){
+        motor(port).hold = hold;
+    }
+
+    double imu_rotation(){
+        return world().imu;
+    }
+
+    double rotation_position(int port){
+        return world().trackers[std::abs(port)].position;
+    }
+
+    void rotation_tare(int port){
+        world().trackers[std::abs(port)].position = 0;
+    }
+
+    int optical_proximity(int port){
+        bool seen = std::abs(port) == world().optical_port && world().ball >= 0 && world().ball < BALL_DIAMETER;
+        return seen ? 255 : 0;
+    }
+
+    double optical_hue(int port){
+        return optical_proximity(port) > 0 ? world().ball_hue : 0;
+    }
+
+    int distance_reading(int port){
+        auto found = world().beams.find(std::abs(port));
+        if(found == world().beams.end()){
+            return 9999;
+        }
+        const Beam& b = found->second;
+        double heading = (world().pose.theta + b.direction) * M_PI / 180.0;
+        double ux = std::sin(heading), uy = std::cos(heading);
+        double px = world().pose.x + ux * b.along + std::cos(heading) * b.across;
+        double py = world().pose.y + uy * b.along - std::sin(heading) * b.across;
+
+        //the closest wall the beam hits
+        double hit = 1e9;
+        if(ux > 1e-9) hit = std::min(hit, (FIELD - px) / ux);
+        if(ux < -1e-9) hit = std::min(hit, -px / ux);
+        if(uy > 1e-9) hit = std::min(hit, (FIELD - py) / uy);
+        if(uy < -1e-9) hit = std::min(hit, -py / uy);
+
+        double mm = hit * 25.4;
+        if(world().noise.distance > 0){
+            mm += std::normal_distribution<double>(0, world().noise.distance)(world().random);
+        }
+        return mm > DISTANCE_RANGE || mm < 0 ? 9999 : int(std::lround(mm));
+    }
+
+    void digital_set(char port, bool value){
+        int i = std::toupper(port) - 'A';
+        if(i < 0 || i >= 8){
+            return;
+        }
+        if(world().digital[i] != value){
+            world().digital_changes[i]++;
+        }
+        world().digital[i] = value;
+    }
+
+    bool digital_get(char port){
+        int i = std::toupper(port) - 'A';
+        return i >= 0 && i < 8 && world().digital[i];
+    }
+
+    int digital_changes(char port){
+        int i = std::toupper(port) - 'A';
+        return i >= 0 && i < 8 ? world().digital_changes[i] : 0;
+    }
+
+    void controller_analog_set(int channel, int value){
+        if(channel >= 0 && channel < 4){
+            world().analog[channel] = std::max(-127, std::min(127, value));
+        }
+    }
+
+    int controller_analog(int channel){
+        return channel >= 0 && channel < 4 ? world().analog[channel] : 0;
+    }
+
+    void controller_digital_set(int button, bool held){
+        if(button >= 0 && button < 32){
+            world().buttons[button] = held;
+        }
+    }
+
+    bool controller_digital(int button){
+        return button >= 0 && button < 32 && world().buttons[button];
+    }
+}
@@ -0,0 +1,200 @@
+#include "air.hpp"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+static pros::Mutex air_lock;
+static std::vector<air::Cylinder> cylinders;
+static std::function<void(air::Warning, double)> warning_callback = nullptr;
+
+//the tank, see tank_set()
+static double tank_volume = 12.2;
+static double start_psi = 100;
+static double leak = 0;
+
+//psi at the last update, when that was, when the tank was last full and the psi the moves took since
+static double psi = 100;
+static std::uint32_t updated = 0;
+static std::uint32_t filled = 0;
+static double used_psi = 0;
+static air::Warning level = air::NONE;
+
+//cubic inches one move fills
+static double chamber(const air::Cylinder& cylinder, bool out){
+    if(!out && cylinder.rod == 0){
+        return 0;
+    }
+    double area = M_PI / 4 * (cylinder.bore * cylinder.bore - (out ? 0 : cylinder.rod * cylinder.rod));
+    return area * cylinder.stroke * cylinder.cylinders;
+}
+
+//the tank and the cylinder settle to one pressure, in absolute psi
+static double after_fill(double gauge, double volume){
+    double absolute = gauge + air::ATMOSPHERE_PSI;
+    return (absolute * tank_volume + air::ATMOSPHERE_PSI * volume) / (tank_volume + volume) - air::ATMOSPHERE_PSI;
+}
+
+//pressure with the leak since the last update, air_lock has to be held
+static double now_psi(std::uint32_t now){
+    return std::fmax(0, psi - leak * (now - updated) / 60000.0);
+}
+
+//pressure a while ahead, air_lock has to be held
+static double ahead_psi(std::uint32_t now, double seconds){
+    double elapsed = std::fmax(1, (now - filled) / 1000.0);
+    return std::fmax(0, now_psi(now) - (used_psi / elapsed + leak / 60) * seconds);
+}
+
+static air::Warning level_get(std::uint32_t now){
+    if(now_psi(now) < air::LOW_PSI){
+        return air::TOO_LOW;
+    }
+    return used_psi > 0 && ahead_psi(now, air::WARN_S) < air::LOW_PSI ? air::RUNNING_LOW : air::NONE;
+}
+
+namespace air{
+    void tank_set(double volume_in3, double start_psi, double leak_psi_per_min){
+        tank_volume = volume_in3;
+        ::start_psi = start_psi;
+        leak = leak_psi_per_min;
+        reset();
+    }
+
+    void add(const char* name, ez::Piston& piston, double bore_in, double stroke_in, double rod_in, int count){
+        Cylinder cylinder;
+        cylinder.name = name;
+        cylinder.piston = &piston;
+        cylinder.bore = bore_in;
+        cylinder.stroke = stroke_in;
+        cylinder.rod = rod_in;
+        cylinder.cylinders = count;
+        cylinders.push_back(cylinder);
+    }
+
+    void set(ez::Piston& piston, bool out){
+        if(piston.get() == out){
+            return;
+        }
+        piston.set(out);
+
+        std::uint32_t now = pros::millis();
+        air_lock.take();
+        Warning before = level;
+        for(Cylinder& cylinder : cylinders){
+            if(cylinder.piston != &piston){
+                continue;
+            }
+            double volume = chamber(cylinder, out);
+            psi = now_psi(now);
+            updated = now;
+            double next = std::fmax(0, after_fill(psi, volume));
+            used_psi += psi - next;
+            psi = next;
+            cylinder.used += volume;
+            out ? cylinder.extends++ : cylinder.retracts++;
+        }
+        level = level_get(now);
+        Warning after = level;
+        double reading = psi;
+        air_lock.give();
+
+        if(after > before && warning_callback != nullptr){
+            warning_callback(after, reading);
+        }
+    }
+
+    void reset(){
+        air_lock.take();
+        psi = start_psi;
+        updated = pros::millis();
+        filled = updated;
+        used_psi = 0;
+        level = NONE;
+        for(Cylinder& cylinder : cylinders){
+            cylinder.extends = 0;
+            cylinder.retracts = 0;
+            cylinder.used = 0;
+        }
+        air_lock.give();
+    }
+
+    double pressure(){
+        air_lock.take();
+        double out = now_psi(pros::millis());
+        air_lock.give();
+        return out;
+    }
+
+    double predict(double seconds){
+        air_lock.take();
+        double out = ahead_psi(pros::millis(), seconds);
+        air_lock.give();
+        return out;
+    }
+
+    int moves_left(){
+        air_lock.take();
+        //the moves so far are the best guess of the ones to come, before any it is every piston going out
+        double volume = 0;
+        int moves = 0;
+        for(const Cylinder& cylinder : cylinders){
+            volume += cylinder.used;
+            moves += cylinder.extends + cylinder.retracts;
+        }
+        if(moves == 0){
+            for(const Cylinder& cylinder : cylinders){
+                volume += chamber(cylinder, true);
+            }
+            moves = int(cylinders.size());
+        }
+        double gauge = now_psi(pros::millis());
+        air_lock.give();
+
+        if(moves == 0 || volume <= 0){
+            return 0;
+        }
+        double average = volume / moves;
+        int left = 0;
+        while(left < 10000){
+            gauge = after_fill(gauge, average);
+            if(gauge < LOW_PSI){
+                break;
+            }
+            left++;
+        }
+        return left;
+    }
+
+    Warning warning(){
+        air_lock.take();
+        Warning out = level_get(pros::millis());
+        air_lock.give();
+        return out;
+    }
+
+    void on_warning(std::function<void(Warning warning, double psi)> callback){
+        warning_callback = callback;
+    }
+
+    int count(){
+        return int(cylinders.size());
+    }
+
+    Cylinder get(int index){
+        air_lock.take();
+        Cylinder out = index >= 0 && index < int(cylinders.size()) ? cylinders[index] : Cylinder();
+        air_lock.give();
+        return out;
+    }
+
+    const char* warning_to_string(Warning warning){
+        switch(warning){
+            case RUNNING_LOW:
+                return "Running Low";
+            case TOO_LOW:
+                return "Too Low";
+            default:
+                return "None";
+        }
+    }
+}
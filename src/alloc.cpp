@@ -0,0 +1,259 @@
+#include "alloc.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+//a task's counts, found by its handle, everything but region can be bumped by any task
+struct TaskSlot{
+    std::atomic<const void*> key = nullptr;
+    const char* name = "";
+    std::atomic<std::uint32_t> allocations = 0;
+    std::atomic<std::uint32_t> bytes = 0;
+    std::atomic<std::uint32_t> violations = 0;
+    std::atomic<bool> hot = false;
+    int region = -1;          // the region the task is in, only the task itself changes it
+};
+
+struct RegionSlot{
+    std::atomic<const char*> name = nullptr;
+    std::atomic<std::uint32_t> allocations = 0;
+    std::atomic<std::uint32_t> bytes = 0;
+    std::atomic<std::uint32_t> violations = 0;
+};
+
+//constant initialized, so allocations from static constructors see OFF before any of this runs
+static std::atomic<int> mode = alloc::OFF;
+static TaskSlot task_slots[alloc::MAX_TASKS];
+static std::atomic<int> task_slot_count = 0;
+static RegionSlot region_slots[alloc::MAX_REGIONS];
+static std::atomic<int> region_slot_count = 0;
+static std::atomic<std::uint32_t> allocation_count = 0;
+static std::atomic<std::uint32_t> free_count = 0;
+static std::atomic<std::uint32_t> violation_count = 0;
+
+//two tasks violating at once can mix their fields, it is only ever shown
+static alloc::Violation last;
+
+static TaskSlot* slot_find(const void* key){
+    int count = std::min(int(task_slot_count), alloc::MAX_TASKS);
+    for(int i = 0; i < count; i++){
+        if(task_slots[i].key == key){
+            return &task_slots[i];
+        }
+    }
+    return nullptr;
+}
+
+static TaskSlot* slot_of(pros::Task task){
+    const void* key = static_cast<pros::task_t>(task);
+    TaskSlot* slot = slot_find(key);
+    if(slot != nullptr){
+        return slot;
+    }
+    int index = task_slot_count++;
+    if(index >= alloc::MAX_TASKS){
+        task_slot_count = alloc::MAX_TASKS;
+        return nullptr;
+    }
+    slot = &task_slots[index];
+    slot->name = task.get_name();
+    slot->key = key;
+    return slot;
+}
+
+static int region_of(const char* name){
+    int count = std::min(int(region_slot_count), alloc::MAX_REGIONS);
+    for(int i = 0; i < count; i++){
+        if(region_slots[i].name == name){
+            return i;
+        }
+    }
+    int index = region_slot_count++;
+    if(index >= alloc::MAX_REGIONS){
+        region_slot_count = alloc::MAX_REGIONS;
+        return -1;
+    }
+    region_slots[index].name = name;
+    return index;
+}
+
+static void counted(std::size_t size){
+    int now = mode;
+    if(now == alloc::OFF){
+        return;
+    }
+    allocation_count++;
+    TaskSlot* slot = slot_of(pros::Task::current());
+    if(slot == nullptr){
+        return;
+    }
+    slot->allocations++;
+    slot->bytes += size;
+    RegionSlot* region = slot->region >= 0 ? &region_slots[slot->region] : nullptr;
+    if(region != nullptr){
+        region->allocations++;
+        region->bytes += size;
+    }
+    if(now < alloc::FLAG || !slot->hot){
+        return;
+    }
+    violation_count++;
+    slot->violations++;
+    if(region != nullptr){
+        region->violations++;
+    }
+    last = {slot->name, region != nullptr ? region->name.load() : "", std::uint32_t(size), pros::millis()};
+    if(now == alloc::TRAP){
+        __builtin_trap();
+    }
+}
+
+static void freed(void* pointer){
+    if(pointer != nullptr && mode != alloc::OFF){
+        free_count++;
+    }
+    std::free(pointer);
+}
+
+void* operator new(std::size_t size){
+    counted(size);
+    void* pointer = std::malloc(size == 0 ? 1 : size);
+    if(pointer == nullptr){
+        throw std::bad_alloc();
+    }
+    return pointer;
+}
+
+void* operator new[](std::size_t size){
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept{
+    counted(size);
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept{
+    return operator new(size, tag);
+}
+
+void operator delete(void* pointer) noexcept{
+    freed(pointer);
+}
+
+void operator delete[](void* pointer) noexcept{
+    freed(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept{
+    freed(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept{
+    freed(pointer);
+}
+
+void operator delete(void* pointer, const std::nothrow_t&) noexcept{
+    freed(pointer);
+}
+
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept{
+    freed(pointer);
+}
+
+namespace alloc{
+    void mode_set(Mode next){
+        mode = next;
+    }
+
+    Mode mode_get(){
+        return Mode(int(mode));
+    }
+
+    void hot(){
+        hot(pros::Task::current());
+    }
+
+    void hot(pros::Task task){
+        TaskSlot* slot = slot_of(task);
+        if(slot != nullptr){
+            slot->hot = true;
+        }
+    }
+
+    void reset(){
+        for(int i = 0; i < task_count(); i++){
+            task_slots[i].allocations = 0;
+            task_slots[i].bytes = 0;
+            task_slots[i].violations = 0;
+        }
+        for(int i = 0; i < region_count(); i++){
+            region_slots[i].allocations = 0;
+            region_slots[i].bytes = 0;
+            region_slots[i].violations = 0;
+        }
+        allocation_count = 0;
+        free_count = 0;
+        violation_count = 0;
+        last = Violation();
+    }
+
+    std::uint32_t allocations(){
+        return allocation_count;
+    }
+
+    std::uint32_t frees(){
+        return free_count;
+    }
+
+    std::uint32_t violations(){
+        return violation_count;
+    }
+
+    Violation last_violation(){
+        return last;
+    }
+
+    Counts task(int id){
+        if(id < 0 || id >= task_count()){
+            return Counts();
+        }
+        const TaskSlot& slot = task_slots[id];
+        return {slot.name, slot.allocations, slot.bytes, slot.violations, slot.hot};
+    }
+
+    int task_count(){
+        return std::min(int(task_slot_count), MAX_TASKS);
+    }
+
+    Counts region(int id){
+        if(id < 0 || id >= region_count()){
+            return Counts();
+        }
+        const RegionSlot& slot = region_slots[id];
+        return {slot.name, slot.allocations, slot.bytes, slot.violations, false};
+    }
+
+    int region_count(){
+        return std::min(int(region_slot_count), MAX_REGIONS);
+    }
+
+    Region::Region(const char* name){
+        TaskSlot* slot = mode == OFF ? nullptr : slot_of(pros::Task::current());
+        previous = slot == nullptr ? -2 : slot->region;
+        if(slot != nullptr){
+            slot->region = region_of(name);
+        }
+    }
+
+    Region::~Region(){
+        if(previous == -2){
+            return;
+        }
+        TaskSlot* slot = slot_find(static_cast<pros::task_t>(pros::Task::current()));
+        if(slot != nullptr){
+            slot->region = previous;
+        }
+    }
+}
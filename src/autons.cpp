@@ -1,6 +1,11 @@
 #include "autons.hpp"
 #include "EZ-Template/util.hpp"
+#include "air.hpp"
+#include "balls.hpp"
 #include "dsr.hpp"
+#include "intake.hpp"
+#include "mech.hpp"
+#include "profiler.hpp"
 #include "main.h"
 #include "subsystems.hpp"
 
@@ -36,6 +41,12 @@ void default_constants() {
   chassis.pid_swing_chain_constant_set(5_deg);
   chassis.pid_drive_chain_constant_set(3_in);
 
+  // Velocity aware settle, exits once error and velocity stay low for the hold time
+  // (error in deg or in, velocity in deg/s or in/s, hold ms, prediction ms)
+  chassis.pid_turn_settle_set(2.0, 6.0, 40, 60);
+  chassis.pid_swing_settle_set(2.0, 6.0, 40, 60);
+  chassis.pid_drive_settle_set(0.75, 1.5, 40, 60);
+
   // Slew constants
   chassis.slew_turn_constants_set(3_deg, 70);
   chassis.slew_drive_constants_set(3_in, 60);
@@ -53,6 +64,77 @@ void default_constants() {
   chassis.drive_imu_scaler_set(1.0049);
 }
 
+///
+// Paths
+///
+// Every pure pursuit path the autons in the selector follow, defined once here for the auton and warm_paths()
+
+// skills 106
+static const ez::united_odom SKILLS_106_LOADER_1[] = {{{19_in, 20_in}, fwd, DRIVE_SPEED}, {{19_in, 0_in}, fwd, DRIVE_SPEED / 2}};
+static const ez::united_odom SKILLS_106_CROSS[] = {{{4_in, 35_in}, rev, DRIVE_SPEED}, {{5_in, 95_in}, rev, DRIVE_SPEED}, {{20_in, 110_in}, rev, DRIVE_SPEED}};
+static const ez::united_odom SKILLS_106_LOADER_2[] = {{{20_in, 120_in}, fwd, DRIVE_SPEED}, {{20_in, 144_in}, fwd, DRIVE_SPEED / 2}};
+
+// SAWP with push
+static const ez::united_odom SAWP_LOADER_1[] = {{{121_in, 20_in}, fwd, DRIVE_SPEED}, {{121_in, -4_in}, fwd, DRIVE_SPEED}};
+static const ez::united_odom SAWP_CROSS[] = {{{100_in, 43_in}, fwd, 120}, {{56_in, 43_in}, fwd, 120}, {{32_in, 30_in}, fwd, 120}};
+static const ez::united_odom SAWP_LOADER_2[] = {{{19_in, 24_in}, fwd, 120}, {{19_in, -4_in}, fwd, DRIVE_SPEED}};
+static const ez::united_odom SAWP_MIDDLE_GOAL[] = {{{20_in, 20_in}, rev, 120}, {{54_in, 52_in}, rev, 120}};
+
+// SAWP no push
+static const ez::united_odom SAWP2_LOADER_1[] = {{{121_in, 20_in}, fwd, DRIVE_SPEED}, {{121_in, -4_in}, fwd, DRIVE_SPEED}};
+static const ez::united_odom SAWP2_CROSS[] = {{{100_in, 43_in}, fwd, DRIVE_SPEED}, {{56_in, 43_in}, fwd, 120}, {{32_in, 30_in}, fwd, DRIVE_SPEED}};
+static const ez::united_odom SAWP2_LOADER_2[] = {{{19_in, 24_in}, fwd, 120}, {{19_in, -4_in}, fwd, DRIVE_SPEED}};
+static const ez::united_odom SAWP2_MIDDLE_GOAL[] = {{{20_in, 20_in}, rev, 120}, {{53_in, 51_in}, rev, 120}};
+
+// right 7
+static const ez::united_odom RIGHT_7_DESCORE[] = {{{18_in, 26_in}, rev, DRIVE_SPEED}, {{19_in, 44_in}, rev, DRIVE_SPEED}};
+
+// right counter 7
+static const ez::united_odom RIGHT_COUNTER_LOADER[] = {{{121_in, 20_in}, fwd, DRIVE_SPEED}, {{121_in, -4_in}, fwd, DRIVE_SPEED}};
+
+// right 7 ball rush
+static const ez::united_odom RIGHT_RUSH_LOADER[] = {{{121_in, 24_in}, fwd, DRIVE_SPEED}, {{121_in, -4_in}, fwd, DRIVE_SPEED / 2}};
+static const ez::united_odom RIGHT_RUSH_DESCORE[] = {{{112_in, 43_in}, rev, DRIVE_SPEED}, {{113_in, 57_in}, rev, DRIVE_SPEED}};
+
+// left 7
+static const ez::united_odom LEFT_7_DESCORE[] = {{{-20_in, 26_in}, fwd, DRIVE_SPEED}, {{-21_in, 44_in}, fwd, DRIVE_SPEED}};
+
+// left counter 7
+static const ez::united_odom LEFT_COUNTER_LONG_GOAL[] = {{{20_in, 24_in}, rev, DRIVE_SPEED}, {{18_in, 40_in}, rev, DRIVE_SPEED}};
+static const ez::united_odom LEFT_COUNTER_LOADER[] = {{{19_in, 24_in}, fwd, 120}, {{19_in, -4_in}, fwd, DRIVE_SPEED}};
+static const ez::united_odom LEFT_COUNTER_MIDDLE_GOAL[] = {{{20_in, 20_in}, rev, 120}, {{53_in, 51_in}, rev, 120}};
+
+// left 7 ball rush
+static const ez::united_odom LEFT_RUSH_LOADER[] = {{{20_in, 24_in}, fwd, DRIVE_SPEED}, {{20_in, -4_in}, fwd, DRIVE_SPEED / 2}};
+static const ez::united_odom LEFT_RUSH_DESCORE[] = {{{31_in, 43_in}, fwd, DRIVE_SPEED}, {{29_in, 55_in}, fwd, DRIVE_SPEED}};
+
+// skills 102
+static const ez::united_odom SKILLS_102_MIDDLE_GOAL[] = {{{48_in, 24_in}, rev, DRIVE_SPEED}, {{62_in, 36_in}, rev, DRIVE_SPEED}, {{58_in, 51_in}, rev, DRIVE_SPEED}};
+static const ez::united_odom SKILLS_102_LOADER_1[] = {{{19_in, 20_in}, fwd, DRIVE_SPEED}, {{19_in, 0_in}, fwd, DRIVE_SPEED / 2}};
+static const ez::united_odom SKILLS_102_CROSS_1[] = {{{4_in, 35_in}, rev, DRIVE_SPEED}, {{5_in, 95_in}, rev, DRIVE_SPEED}, {{20_in, 110_in}, rev, DRIVE_SPEED}};
+static const ez::united_odom SKILLS_102_LOADER_2[] = {{{19_in, 120_in}, fwd, DRIVE_SPEED}, {{19_in, 144_in}, fwd, DRIVE_SPEED / 2}};
+static const ez::united_odom SKILLS_102_TO_LOADER_3[] = {{{82_in, 120_in}, fwd, DRIVE_SPEED}, {{112_in, 120_in}, fwd, DRIVE_SPEED}};
+static const ez::united_odom SKILLS_102_LOADER_3[] = {{{121_in, 120_in}, fwd, DRIVE_SPEED}, {{121_in, 144_in}, fwd, DRIVE_SPEED / 2}};
+static const ez::united_odom SKILLS_102_CROSS_2[] = {{{139_in, 100_in}, rev, DRIVE_SPEED}, {{139_in, 40_in}, rev, DRIVE_SPEED}, {{125_in, 34_in}, rev, DRIVE_SPEED}};
+static const ez::united_odom SKILLS_102_LOADER_4[] = {{{121_in, 24_in}, fwd, DRIVE_SPEED}, {{121_in, 0_in}, fwd, DRIVE_SPEED / 2}};
+static const ez::united_odom SKILLS_102_PARK[] = {{{122_in, 20_in}, fwd, DRIVE_SPEED}, {{108_in, 8_in}, fwd, DRIVE_SPEED}, {{98_in, 6_in}, fwd, DRIVE_SPEED}};
+
+static const std::span<const ez::united_odom> PATHS[] = {
+    SKILLS_106_LOADER_1, SKILLS_106_CROSS, SKILLS_106_LOADER_2, SAWP_LOADER_1, SAWP_CROSS, SAWP_LOADER_2,
+    SAWP_MIDDLE_GOAL, SAWP2_LOADER_1, SAWP2_CROSS, SAWP2_LOADER_2, SAWP2_MIDDLE_GOAL, RIGHT_7_DESCORE,
+    RIGHT_COUNTER_LOADER, RIGHT_RUSH_LOADER, RIGHT_RUSH_DESCORE, LEFT_7_DESCORE, LEFT_COUNTER_LONG_GOAL,
+    LEFT_COUNTER_LOADER, LEFT_COUNTER_MIDDLE_GOAL, LEFT_RUSH_LOADER, LEFT_RUSH_DESCORE, SKILLS_102_MIDDLE_GOAL,
+    SKILLS_102_LOADER_1, SKILLS_102_CROSS_1, SKILLS_102_LOADER_2, SKILLS_102_TO_LOADER_3, SKILLS_102_LOADER_3,
+    SKILLS_102_CROSS_2, SKILLS_102_LOADER_4, SKILLS_102_PARK
+};
+
+void warm_paths() {
+  // Injected and smoothed here so the motions only look them up
+  for (std::span<const ez::united_odom> movements : PATHS) {
+    chassis.path_warm(path::SMOOTH, movements);
+  }
+}
+
 ///
 // Drive Example
 ///
@@ -363,6 +445,19 @@ void measure_dsr_offsets(){
   DSR::measure_offsets(5);
 }
 
+///
+// Find the roller speeds that score the most balls per second
+///
+void tune_long_goal(){
+  rollers::tune(rollers::LONG_GOAL);
+}
+
+void tune_middle_goal(){
+  air::set(Middle, true);
+  rollers::tune(rollers::MIDDLE_GOAL);
+  air::set(Middle, false);
+}
+
 // . . .
 // Make your own autonomous functions here!
 // . . .
@@ -383,14 +478,14 @@ void test(){
 
 void Right_7(){
   //intake start
-  intake.move(127);
+  mech::load();
 
   //first three balls
   chassis.pid_odom_set({{5_in, 33_in}, fwd, DRIVE_SPEED}, true);
 
   //timing for matchloader
-  pros::delay(700);
-  MatchLoad.set(true);
+  prof::delay(700);
+  mech::matchload(true);
   chassis.pid_wait_quick_chain();
 
   //go back a bit because went too far
@@ -400,22 +495,18 @@ void Right_7(){
   //align to low goal
   chassis.pid_turn_set({-2_in, 39.5_in}, fwd, DRIVE_SPEED);
   chassis.pid_wait();
-  MatchLoad.set(false);
+  mech::matchload(false);
 
   //go to low goal
   chassis.pid_odom_set({{-2_in, 39.5_in}, fwd, DRIVE_SPEED}, true);
   chassis.pid_wait_quick();
 
   //score in low goal
-  LowScore.set(true);
-  intake.move(-127);
-  outtake.move(-127);
-  pros::delay(1500);
+  mech::score_low();
+  prof::delay(1500);
 
   //stop intake
-  LowScore.set(false);
-  intake.move(0);
-  outtake.move(0);
+  mech::stop();
 
   //go to general long goal/matchload area
   chassis.pid_odom_set({{32_in, 14_in}, rev, DRIVE_SPEED}, true);
@@ -423,13 +514,13 @@ void Right_7(){
 
   //align to matchloader
   chassis.pid_turn_set({28_in, -1_in}, fwd, TURN_SPEED);
-  MatchLoad.set(true);
+  mech::matchload(true);
   chassis.pid_wait();
 
   //go to and intake matchloader
-  intake.move(127);
+  mech::load();
   chassis.pid_odom_set({{28_in, -4_in}, fwd, DRIVE_SPEED / 2}, true);
-  pros::delay(1300);
+  prof::delay(1300);
 
   //go to long goal
   chassis.pid_odom_set({{29_in, 28_in}, rev, DRIVE_SPEED}, true);
@@ -437,20 +528,18 @@ void Right_7(){
 
   //constant pressure to make sure i am aligned
   chassis.drive_set(-50,-50);
-  outtake.move(127);
+  mech::score_long();
 
-  //wait until wrong color
-  pros::delay(2000);
-  outtake.move(0);
-  intake.move(0);
-  MatchLoad.set(false);
+  balls::wait_wrong_color(2000);
+  mech::stop();
+  mech::matchload(false);
 
   //descore doesnt really matter
   chassis.pid_odom_set({{22_in, 20_in}, fwd, DRIVE_SPEED}, true);
   chassis.pid_wait();
 
   //descore actual alignment, please change if necessary
-  chassis.pid_odom_set({{{18_in, 26_in}, rev, DRIVE_SPEED}, {{19_in, 44_in}, rev, DRIVE_SPEED}}, true);
+  chassis.pid_odom_set(RIGHT_7_DESCORE, true);
   
   //the rest dont matter
   chassis.pid_wait_until_index(0);
@@ -464,10 +553,10 @@ void Right_7(){
 void right_7_rush(){
   //move so that i dont waste time
   chassis.pid_drive_set(10_in, DRIVE_SPEED, true);
-  pros::delay(100);
+  prof::delay(100);
 
   //start intake
-  intake.move(127);
+  mech::load();
 
   //reset position
   DSR::reset_tracking(R, B);
@@ -476,7 +565,7 @@ void right_7_rush(){
   chassis.pid_odom_set({{95_in, 45_in}, fwd, DRIVE_SPEED});
   //wait until close to trap the balls
   chassis.pid_wait_until_point({95_in, 40_in});
-  MatchLoad.set(true);
+  mech::matchload(true);
 
   //weird bug fix
   chassis.pid_wait_quick();
@@ -493,31 +582,31 @@ void right_7_rush(){
   DSR::reset_tracking(L, F);
 
   //matchload
-  chassis.pid_odom_set({{{121_in, 24_in}, fwd, DRIVE_SPEED}, {{121_in, -4_in}, fwd, DRIVE_SPEED / 2}}, true);
-  pros::delay(1400);
+  chassis.pid_odom_set(RIGHT_RUSH_LOADER, true);
+  prof::delay(1400);
 
   //go to long goal
   chassis.pid_odom_set({{122_in, 50_in}, rev, DRIVE_SPEED}, true);
 
   //dont score too early
-  pros::delay(900);
+  prof::delay(900);
 
   //score
-  outtake.move(127);
-  pros::delay(2100);
+  mech::score_long();
+  prof::delay(2100);
 
   //reset position
   DSR::reset_tracking(L,F);
 
   //no more score :(
-  outtake.move(0);
+  mech::load();
 
   //try not to crash
   chassis.pid_odom_set({{114_in, 30_in}, fwd, DRIVE_SPEED});
   chassis.pid_wait_quick_chain();
 
   //descore
-  chassis.pid_odom_set({{{112_in, 43_in}, rev, DRIVE_SPEED}, {{113_in, 57_in}, rev, DRIVE_SPEED}}, true);
+  chassis.pid_odom_set(RIGHT_RUSH_DESCORE, true);
   chassis.pid_wait_until_index(0);
   pros::delay(10000);
 }
@@ -527,30 +616,29 @@ void skills_102(){
   ////get the six balls in parking barrier
   //reset everything
   chassis.odom_theta_set(-90_deg);
-  Wing.set(true);
-  Middle.set(false);
+  mech::wing(true);
 
   //Push the blocks to the far side
-  MatchLoad.set(true);
-  pros::delay(100);
+  mech::matchload(true);
+  prof::delay(100);
   chassis.pid_drive_set(60_in, 30);
-  pros::delay(600);
+  prof::delay(600);
 
   //put matchloader back up
   chassis.pid_drive_set(0,100);
-  MatchLoad.set(false);
-  pros::delay(200);
+  mech::matchload(false);
+  prof::delay(200);
 
   //start intake
-  intake.move(127);
+  mech::load();
 
   //get in the parking barrier
   chassis.pid_drive_set(60_in, 90);
 
   //timing for trapping
-  pros::delay(700);
-  MatchLoad.set(true);
-  pros::delay(200);
+  prof::delay(700);
+  mech::matchload(true);
+  prof::delay(200);
 
   //get the blocks
   chassis.pid_drive_set(42_in, 80, true);
@@ -563,56 +651,45 @@ void skills_102(){
 
   ////middle goal scoring
   //move to the right area
-  chassis.pid_odom_set({{{48_in, 24_in}, rev, DRIVE_SPEED},
-                                      {{62_in, 36_in}, rev, DRIVE_SPEED},
-                                      {{58_in, 51_in}, rev, DRIVE_SPEED}}, true);
+  chassis.pid_odom_set(SKILLS_102_MIDDLE_GOAL, true);
   chassis.pid_wait_quick_chain();
 
   //fully align
-  MatchLoad.set(false);
-  chassis.drive_set(-60,-60);
-  pros::delay(700);
+  mech::matchload(false);
+  chassis.drive_push(-60, 700);
   chassis.pid_turn_set(-145_deg, TURN_SPEED);
   chassis.pid_wait();
 
   //constant pressure for scoring
   chassis.drive_set(-20,-20);
-  Middle.set(true);
 
-  //finicky stuff to make sure it doesn't jam
-  intake.move(-60);
-  outtake.move(-90);
-  pros::delay(200);
-  intake.move(90);
-  pros::delay(2000);
+  //the ball path opens Middle and backs the intake off first so it doesn't jam
+  mech::score_middle();
+  prof::delay(2200);
 
   //get the last ball
   chassis.pid_turn_set(-135_deg, TURN_SPEED);
   chassis.pid_wait_quick_chain();
   chassis.drive_set(-20,-20);
-  pros::delay(200);
-  Middle.set(false);
-  outtake.move(0);
+  prof::delay(200);
+  mech::load();
   chassis.pid_drive_set(9_in, DRIVE_SPEED / 2);
   chassis.pid_wait_quick();
 
   //realign
   chassis.pid_drive_set(-13_in,40);
-  pros::delay(600);
-  Middle.set(true);
-  outtake.move(-90);
-  pros::delay(1300);
-  intake.move(127);
-  Middle.set(false);
-  outtake.move(0);
+  prof::delay(600);
+  mech::score_middle();
+  prof::delay(1300);
+  mech::load();
 
   //// Matchloading and long goal scoring
   //go to general area
   chassis.pid_odom_set({{23_in, 23_in}, fwd, DRIVE_SPEED}, true);
 
   //get three extra balls
-  pros::delay(500);
-  MatchLoad.set(true);
+  prof::delay(500);
+  mech::matchload(true);
   chassis.pid_wait_quick_chain();
 
   //turn to face matchloader
@@ -626,16 +703,16 @@ void skills_102(){
   chassis.pid_odom_set({{19_in, 36_in}, rev, DRIVE_SPEED}, true);
   chassis.pid_wait_quick_chain();
   chassis.drive_set(-40,-40);
-  outtake.move(127);
-  pros::delay(1500);
-  outtake.move(0);
+  mech::score_long();
+  prof::delay(1500);
+  mech::load();
 
   //matchload
-  chassis.pid_odom_set({{{19_in, 20_in}, fwd, DRIVE_SPEED},{{19_in, 0_in}, fwd, DRIVE_SPEED / 2}});
-  pros::delay(2400);
+  chassis.pid_odom_set(SKILLS_102_LOADER_1);
+  prof::delay(2400);
 
   //go to other side
-  chassis.pid_odom_set({{{4_in, 35_in}, rev, DRIVE_SPEED},{{5_in, 95_in}, rev, DRIVE_SPEED}, {{20_in, 110_in}, rev, DRIVE_SPEED}});
+  chassis.pid_odom_set(SKILLS_102_CROSS_1);
   chassis.pid_wait_quick_chain();
 
   //turn to face matchloader
@@ -649,41 +726,37 @@ void skills_102(){
   chassis.pid_odom_set({{19_in, 85_in}, rev, DRIVE_SPEED / 2}, true);
 
   //dont score too early
-  pros::delay(750);
+  prof::delay(750);
 
   //score
-  outtake.move(127);
-  pros::delay(2000);
-  outtake.move(0);
+  mech::score_long();
+  prof::delay(2000);
+  mech::load();
 
   //reset position
   DSR::reset_tracking(L, F);
 
   // matchload
-  chassis.pid_odom_set({{{19_in, 120_in}, fwd, DRIVE_SPEED}, {{19_in, 144_in}, fwd, DRIVE_SPEED / 2}}, true);
-  pros::delay(2400);
+  chassis.pid_odom_set(SKILLS_102_LOADER_2, true);
+  prof::delay(2400);
 
   //go to long goal
   chassis.pid_odom_set({{19_in, 85_in}, rev, DRIVE_SPEED / 2}, true);
 
   //dont score too early
-  pros::delay(1000);
+  prof::delay(1000);
 
   //score
-  outtake.move(127);
-  pros::delay(1000);
-
-  //change speed to score more
-  outtake.move(90);
-  pros::delay(1000);
-  outtake.move(0);
+  mech::score_long();
+  prof::delay(2000);
+  mech::load();
 
   //reset position
   DSR::reset_tracking(L, F);
 
   //turn to get extra balls and reset matchloader
   chassis.pid_turn_set(105_deg, TURN_SPEED);
-  MatchLoad.set(false);
+  mech::matchload(false);
   chassis.pid_wait();
 
   //get the three balls
@@ -691,10 +764,10 @@ void skills_102(){
   chassis.pid_wait_quick_chain();
 
   //get extra balls with the power of pneumatics
-  MatchLoad.set(true);
+  mech::matchload(true);
 
   //go to general area
-  chassis.pid_odom_set({{{82_in, 120_in}, fwd, DRIVE_SPEED}, {{112_in, 120_in}, fwd, DRIVE_SPEED}});
+  chassis.pid_odom_set(SKILLS_102_TO_LOADER_3);
   chassis.pid_wait_quick();
 
   //turn to face match loader
@@ -708,22 +781,22 @@ void skills_102(){
   chassis.pid_odom_set({{122_in, 100_in}, rev, DRIVE_SPEED / 2});
 
   //dont score too early
-  pros::delay(800);
+  prof::delay(800);
 
   //score
-  outtake.move(127);
-  pros::delay(1200);
-  outtake.move(0);
+  mech::score_long();
+  prof::delay(1200);
+  mech::load();
 
   //reset position
   DSR::reset_tracking(R, F);
 
   //Matchload
-  chassis.pid_odom_set({{{121_in, 120_in}, fwd, DRIVE_SPEED}, {{121_in, 144_in}, fwd, DRIVE_SPEED / 2}}, true);
-  pros::delay(2400);
+  chassis.pid_odom_set(SKILLS_102_LOADER_3, true);
+  prof::delay(2400);
   
   //go around the long goal to go to the other side
-  chassis.pid_odom_set({{{139_in, 100_in}, rev, DRIVE_SPEED}, {{139_in, 40_in}, rev, DRIVE_SPEED}, {{125_in, 34_in}, rev, DRIVE_SPEED}}, true);
+  chassis.pid_odom_set(SKILLS_102_CROSS_2, true);
   chassis.pid_wait_quick();
 
   //turn to face the match loader
@@ -737,42 +810,38 @@ void skills_102(){
   chassis.pid_odom_set({{121_in, 45_in}, rev, DRIVE_SPEED / 2});
 
   //dont score too early
-  pros::delay(800);
+  prof::delay(800);
 
   //score
-  outtake.move(127);
-  pros::delay(2000);
-  outtake.move(0);
+  mech::score_long();
+  prof::delay(2000);
+  mech::load();
 
   //reset position
   DSR::reset_tracking(L, F);
 
   //matchload
-  chassis.pid_odom_set({{{121_in, 24_in}, fwd, DRIVE_SPEED}, {{121_in, 0_in}, fwd, DRIVE_SPEED / 2}}, true);
-  pros::delay(2400);
+  chassis.pid_odom_set(SKILLS_102_LOADER_4, true);
+  prof::delay(2400);
 
   //go to long goal
   chassis.pid_odom_set({{122_in, 45_in} ,rev, DRIVE_SPEED / 2});
 
   //dont score too early
-  pros::delay(900);
+  prof::delay(900);
 
   //reset match loader
-  MatchLoad.set(false);
+  mech::matchload(false);
 
   //score
-  outtake.move(127);
-  pros::delay(1000);
-
-  //change speed to score more
-  outtake.move(90);
-  pros::delay(1000);
-  outtake.move(0);
+  mech::score_long();
+  prof::delay(2000);
+  mech::load();
 
   //go to parking barrier
-  chassis.pid_odom_set({{{122_in, 20_in}, fwd, DRIVE_SPEED}, {{108_in, 8_in}, fwd, DRIVE_SPEED}, {{98_in, 6_in}, fwd, DRIVE_SPEED}}, true);
+  chassis.pid_odom_set(SKILLS_102_PARK, true);
   chassis.pid_wait_quick_chain();
-  Wing.set(true);
+  mech::wing(true);
 
   // turn to optimal angle
   chassis.pid_turn_set(-100_deg, TURN_SPEED);
@@ -785,14 +854,14 @@ void skills_102(){
 
 void Left_7(){
   //intake start
-  intake.move(127);
+  mech::load();
 
   //first three balls
   chassis.pid_odom_set({{-5_in, 33_in}, fwd, DRIVE_SPEED}, true);
 
   //timing for matchloader
-  pros::delay(700);
-  MatchLoad.set(true);
+  prof::delay(700);
+  mech::matchload(true);
   chassis.pid_wait_quick_chain();
 
   //go back a bit because went too far
@@ -802,24 +871,18 @@ void Left_7(){
   //align to middle goal
   chassis.pid_turn_set({4_in, 48.5_in}, rev, DRIVE_SPEED);
   chassis.pid_wait();
-  MatchLoad.set(false);
+  mech::matchload(false);
 
   //go to middle goal
   chassis.pid_odom_set({{6_in, 49.5_in}, rev, DRIVE_SPEED}, true);
   chassis.pid_wait_quick();
 
   //score in middle goal
-  Middle.set(true);
-  outtake.move(-127);
-  intake.move(-60);
-  pros::delay(300);
-  intake.move(127);
-  pros::delay(1500);
+  mech::score_middle();
+  prof::delay(1800);
 
   //stop intake
-  Middle.set(false);
-  intake.move(0);
-  outtake.move(0);
+  mech::stop();
 
   //go to general long goal/matchload area
   chassis.pid_odom_set({{-32_in, 14_in}, fwd, DRIVE_SPEED}, true);
@@ -827,13 +890,13 @@ void Left_7(){
 
   //align to matchloader
   chassis.pid_turn_set({-33_in, -1_in}, fwd, TURN_SPEED);
-  MatchLoad.set(true);
+  mech::matchload(true);
   chassis.pid_wait();
 
   //go to and intake matchloader
-  intake.move(127);
+  mech::load();
   chassis.pid_odom_set({{-33_in, -4_in}, fwd, DRIVE_SPEED / 2}, true);
-  pros::delay(1300);
+  prof::delay(1300);
 
   //go to long goal
   chassis.pid_odom_set({{-33_in, 28_in}, rev, DRIVE_SPEED}, true);
@@ -841,20 +904,18 @@ void Left_7(){
 
   //constant pressure to make sure i am aligned
   chassis.drive_set(-50,-50);
-  outtake.move(127);
+  mech::score_long();
 
-  //wait until wrong color
-  pros::delay(2000);
-  outtake.move(0);
-  intake.move(0);
-  MatchLoad.set(false);
+  balls::wait_wrong_color(2000);
+  mech::stop();
+  mech::matchload(false);
 
   //descore doesnt really matter
   chassis.pid_odom_set({{-22_in, 16_in}, fwd, DRIVE_SPEED}, true);
   chassis.pid_wait();
 
   //descore actual alignment, please change if necessary
-  chassis.pid_odom_set({{{-20_in, 26_in}, fwd, DRIVE_SPEED}, {{-21_in, 44_in}, fwd, DRIVE_SPEED}}, true);
+  chassis.pid_odom_set(LEFT_7_DESCORE, true);
   
   //the rest dont matter
   chassis.pid_wait_until_index(0);
@@ -869,10 +930,10 @@ void left_7_rush(){
 
   //move forward a little to not waste time
   chassis.pid_drive_set(10_in, DRIVE_SPEED, true);
-  pros::delay(100);
+  prof::delay(100);
 
   //start intake
-  intake.move(127);
+  mech::load();
 
   //reset tracking
   DSR::reset_tracking(L, B);
@@ -882,8 +943,8 @@ void left_7_rush(){
 
   //wait until close and trap the balls
   chassis.pid_wait_until_point({45,40});
-  MatchLoad.set(true);
-  pros::delay(300);
+  mech::matchload(true);
+  prof::delay(300);
 
   //go to general area
   chassis.pid_odom_set({{20_in, 30_in}, rev, DRIVE_SPEED}, true);
@@ -892,36 +953,35 @@ void left_7_rush(){
   //turn to matchloader
   chassis.pid_turn_set(180_deg, TURN_SPEED);
   chassis.pid_wait_quick();
-  MatchLoad.set(true);
+  mech::matchload(true);
 
   //reset position
   DSR::reset_tracking(R, F);
 
   //match load
-  chassis.pid_odom_set({{{20_in, 24_in}, fwd, DRIVE_SPEED}, {{20_in, -4_in}, fwd, DRIVE_SPEED / 2}}, true);
-  pros::delay(1400);
+  chassis.pid_odom_set(LEFT_RUSH_LOADER, true);
+  prof::delay(1400);
 
   // go to long goal
   chassis.pid_odom_set({{20_in, 50_in}, rev, DRIVE_SPEED}, true);
 
   //dont score too early
-  pros::delay(900);
+  prof::delay(900);
 
   //score
-  intake.move(127);
-  outtake.move(127);
-  pros::delay(2100);
+  mech::score_long();
+  prof::delay(2100);
 
   //reset match loader so that i dont cross
-  MatchLoad.set(false);
-  outtake.move(0);
+  mech::matchload(false);
+  mech::load();
 
   //try not to crash
   chassis.pid_odom_set({{25_in, 30_in}, fwd, DRIVE_SPEED});
   chassis.pid_wait_quick_chain();
 
   //go to descore
-  chassis.pid_odom_set({{{31_in, 43_in}, fwd, DRIVE_SPEED}, {{29_in, 55_in}, fwd, DRIVE_SPEED}}, true);
+  chassis.pid_odom_set(LEFT_RUSH_DESCORE, true);
   chassis.pid_wait_quick_chain();
 
   //turn for better descore
@@ -935,7 +995,7 @@ void left_7_rush(){
 
 void move_a_bit(){
   chassis.drive_set(60,60);
-  pros::delay(500);
+  prof::delay(500);
   chassis.drive_set(0,0);
 }
 
@@ -945,203 +1005,178 @@ void dont_do_anything(){
 
 void SAWP(){
   chassis.odom_theta_set(-90_deg);
-  intake.move(127);
+  mech::load();
   chassis.pid_drive_set(7_in, DRIVE_SPEED);
-  pros::delay(500);
+  prof::delay(500);
   DSR::reset_tracking(B, L);
   chassis.pid_odom_set({{118_in, 27_in}, rev, 127}, true);
   chassis.pid_wait_quick_chain();
   chassis.pid_turn_set(180_deg, TURN_SPEED);
   chassis.pid_wait_quick_chain();
-  MatchLoad.set(true);
+  mech::matchload(true);
   DSR::reset_tracking(L, F);
-  chassis.pid_odom_set({{{121_in, 20_in}, fwd, DRIVE_SPEED},
-  {{121_in, -4_in}, fwd, DRIVE_SPEED}}, true);
-  pros::delay(1200);
+  chassis.pid_odom_set(SAWP_LOADER_1, true);
+  prof::delay(1200);
   DSR::reset_tracking(L, F);
   chassis.pid_odom_set({{121_in, 50_in}, rev, DRIVE_SPEED}, true);
-  pros::delay(900);
-  outtake.move(127);
-  MatchLoad.set(false);
-  pros::delay(1300);
-  outtake.move(0);
+  prof::delay(900);
+  mech::score_long();
+  mech::matchload(false);
+  prof::delay(1300);
+  mech::load();
   DSR::reset_tracking(L, F);
-  chassis.pid_odom_set({{{100_in, 43_in}, fwd, 120}, 
-                        {{56_in, 43_in}, fwd, 120}, 
-                        {{32_in, 30_in}, fwd, 120}}, true);
+  chassis.pid_odom_set(SAWP_CROSS, true);
   chassis.pid_wait_until_index_started(1);
-  MatchLoad.set(true);
+  mech::matchload(true);
   chassis.pid_wait_quick_chain();
   chassis.pid_turn_set(180_deg, TURN_SPEED);
   chassis.pid_wait_quick_chain();
   DSR::reset_tracking(R, F);
   chassis.pid_odom_set({{18_in, 50_in}, rev, 120}, true);
-  pros::delay(300);
-  outtake.move(127);
-  pros::delay(1100);
-  outtake.move(0);
+  prof::delay(300);
+  mech::score_long();
+  prof::delay(1100);
+  mech::load();
   chassis.pid_turn_set(180_deg, TURN_SPEED);
   chassis.pid_wait_quick_chain();
   DSR::reset_tracking(R, F);
-  chassis.pid_odom_set({{{19_in, 24_in}, fwd, 120},
-                        {{19_in, -4_in}, fwd, DRIVE_SPEED}}, true);
-  pros::delay(1400);
+  chassis.pid_odom_set(SAWP_LOADER_2, true);
+  prof::delay(1400);
   DSR::reset_tracking(R, F);
-  chassis.pid_odom_set({{{20_in, 20_in}, rev, 120},
-                        {{54_in, 52_in}, rev, 120}}, true);
+  chassis.pid_odom_set(SAWP_MIDDLE_GOAL, true);
   chassis.pid_wait_quick_chain();
-  Middle.set(true);
   chassis.drive_set(-40,-40);
-  intake.move(0);
-  outtake.move(-127);
-  intake.move(-80);
-  pros::delay(300);
-  intake.move(127);
-  pros::delay(3000);
+  mech::score_middle();
+  prof::delay(3300);
 }
 
 void SAWP2(){
   chassis.odom_theta_set(90_deg);
   chassis.pid_drive_set(10_in, DRIVE_SPEED);
-  pros::delay(100);
+  prof::delay(100);
   DSR::reset_tracking(F, R);
   chassis.pid_odom_set({{118_in, 24_in}, fwd, 127}, true);
   chassis.pid_wait_quick_chain();
   chassis.pid_turn_set(180_deg, TURN_SPEED);
   chassis.pid_wait_quick_chain();
-  MatchLoad.set(true);
-  intake.move(127);
+  mech::matchload(true);
+  mech::load();
   DSR::reset_tracking(L, F);
-  chassis.pid_odom_set({{{121_in, 20_in}, fwd, DRIVE_SPEED},
-  {{121_in, -4_in}, fwd, DRIVE_SPEED}}, true);
-  pros::delay(1200);
+  chassis.pid_odom_set(SAWP2_LOADER_1, true);
+  prof::delay(1200);
   DSR::reset_tracking(L, F);
   chassis.pid_odom_set({{121_in, 50_in}, rev, DRIVE_SPEED}, true);
-  pros::delay(900);
-  outtake.move(127);
-  MatchLoad.set(false);
-  pros::delay(1300);
-  outtake.move(0);
+  prof::delay(900);
+  mech::score_long();
+  mech::matchload(false);
+  prof::delay(1300);
+  mech::load();
   DSR::reset_tracking(L, F);
-  chassis.pid_odom_set({{{100_in, 43_in}, fwd, DRIVE_SPEED}, 
-                        {{56_in, 43_in}, fwd, 120}, 
-                        {{32_in, 30_in}, fwd, DRIVE_SPEED}}, true);
+  chassis.pid_odom_set(SAWP2_CROSS, true);
   chassis.pid_wait_until_index_started(1);
-  MatchLoad.set(true);
+  mech::matchload(true);
   chassis.pid_wait_quick_chain();
   chassis.pid_turn_set(180_deg, TURN_SPEED);
   chassis.pid_wait_quick_chain();
   DSR::reset_tracking(R, F);
   chassis.pid_odom_set({{18_in, 50_in}, rev, DRIVE_SPEED}, true);
-  pros::delay(600);
-  outtake.move(127);
-  pros::delay(1100);
-  outtake.move(0);
+  prof::delay(600);
+  mech::score_long();
+  prof::delay(1100);
+  mech::load();
   chassis.pid_turn_set(180_deg, TURN_SPEED);
   chassis.pid_wait_quick_chain();
   DSR::reset_tracking(R, F);
-  chassis.pid_odom_set({{{19_in, 24_in}, fwd, 120},
-                        {{19_in, -4_in}, fwd, DRIVE_SPEED}}, true);
-  pros::delay(1400);
+  chassis.pid_odom_set(SAWP2_LOADER_2, true);
+  prof::delay(1400);
   DSR::reset_tracking(R, F);
-  chassis.pid_odom_set({{{20_in, 20_in}, rev, 120},
-                        {{53_in, 51_in}, rev, 120}}, true);
+  chassis.pid_odom_set(SAWP2_MIDDLE_GOAL, true);
   chassis.pid_wait_quick_chain();
-  Middle.set(true);
   chassis.drive_set(-50,-50);
-  outtake.move(-127);
-  intake.move(-80);
-  pros::delay(200);
-  intake.move(127);
-  pros::delay(1000);
+  mech::score_middle();
+  prof::delay(1200);
 }
 
 void Right_counter_7(){
   chassis.odom_theta_set(90_deg);
   chassis.pid_drive_set(10_in, DRIVE_SPEED);
-  pros::delay(100);
+  prof::delay(100);
   DSR::reset_tracking(F, R);
   chassis.pid_odom_set({{118_in, 24_in}, fwd, 127}, true);
   chassis.pid_wait_quick_chain();
   chassis.pid_turn_set(180_deg, TURN_SPEED);
   chassis.pid_wait_quick_chain();
-  intake.move(127);
-  MatchLoad.set(true);
+  mech::load();
+  mech::matchload(true);
   DSR::reset_tracking(L, F);
-  chassis.pid_odom_set({{{121_in, 20_in}, fwd, DRIVE_SPEED},
-  {{121_in, -4_in}, fwd, DRIVE_SPEED}}, true);
-  pros::delay(1200);
+  chassis.pid_odom_set(RIGHT_COUNTER_LOADER, true);
+  prof::delay(1200);
   DSR::reset_tracking(L, F);
   chassis.pid_odom_set({{121_in, 50_in}, rev, DRIVE_SPEED}, true);
-  pros::delay(700);
-  outtake.move(127);
-  MatchLoad.set(false);
-  pros::delay(1000);
-  outtake.move(0);
+  prof::delay(700);
+  mech::score_long();
+  mech::matchload(false);
+  prof::delay(1000);
+  mech::load();
   DSR::reset_tracking(L, F);
   chassis.pid_odom_set({{101_in, 43_in}, fwd, DRIVE_SPEED});
   chassis.pid_wait_quick_chain();
-  MatchLoad.set(true);
-  pros::delay(500);
-  MatchLoad.set(false);
-  LowScore.set(true);
+  mech::matchload(true);
+  prof::delay(500);
+  mech::matchload(false);
+  mech::load_low();  // LowScore opens on the way with the balls kept, so all of the second below is scoring
   chassis.pid_odom_set({{93.5_in, 49.5_in}, fwd, DRIVE_SPEED}, true);
   chassis.pid_wait_quick();
-  intake.move(-127);
-  outtake.move(-127);
-  pros::delay(1000);
+  mech::score_low();
+  prof::delay(1000);
   chassis.pid_odom_set({{144_in, 47_in}, rev, DRIVE_SPEED});
-  pros::delay(750);
-  Wing.set(true);
+  prof::delay(750);
+  mech::wing(true);
   chassis.pid_turn_set(180_deg, TURN_SPEED);
   chassis.pid_wait_quick();
-  Wing.set(false);
+  mech::wing(false);
   chassis.pid_drive_set(-12_in, DRIVE_SPEED);
   pros::delay(10000);
 }
 
 void Left_counter_7(){
   chassis.pid_drive_set(10_in, DRIVE_SPEED, true);
-  pros::delay(100);
-  intake.move(127);
+  prof::delay(100);
+  mech::load();
   DSR::reset_tracking(L, B);
   chassis.pid_odom_set({{45_in, 45_in}, fwd, DRIVE_SPEED});
   chassis.pid_wait_quick_chain();
-  MatchLoad.set(true);
-  chassis.pid_odom_set({{{20_in,24_in}, rev, DRIVE_SPEED},
-                        {{18_in, 40_in}, rev, DRIVE_SPEED}});
+  mech::matchload(true);
+  chassis.pid_odom_set(LEFT_COUNTER_LONG_GOAL);
   chassis.pid_wait_quick_chain();
-  outtake.move(127);
+  mech::score_long();
   chassis.drive_set(-20,-20);
-  pros::delay(1000);
-  outtake.move(0);
+  prof::delay(1000);
+  mech::load();
   chassis.pid_turn_set(180_deg, TURN_SPEED);
   chassis.pid_wait_quick_chain();
   DSR::reset_tracking(R, F);
-  chassis.pid_odom_set({{{19_in, 24_in}, fwd, 120},
-                        {{19_in, -4_in}, fwd, DRIVE_SPEED}}, true);
-  pros::delay(1400);
+  chassis.pid_odom_set(LEFT_COUNTER_LOADER, true);
+  prof::delay(1400);
   DSR::reset_tracking(R, F);
-  chassis.pid_odom_set({{{20_in, 20_in}, rev, 120},
-                        {{53_in, 51_in}, rev, 120}}, true);
+  chassis.pid_odom_set(LEFT_COUNTER_MIDDLE_GOAL, true);
   chassis.pid_wait_quick_chain();
-  Middle.set(true);
   chassis.drive_set(-50,-50);
-  outtake.move(-127);
-  pros::delay(1500);
-  Middle.set(false);
-  MatchLoad.set(false);
-  Wing.set(true);
+  mech::score_middle();
+  prof::delay(1500);
+  mech::load();
+  mech::matchload(false);
+  mech::wing(true);
   chassis.pid_odom_set({{20_in, 47_in}, fwd, DRIVE_SPEED});
-  pros::delay(800);
+  prof::delay(800);
   chassis.pid_turn_set(0_deg, TURN_SPEED);
   chassis.pid_wait_quick();
-  Wing.set(false);
+  mech::wing(false);
   chassis.pid_drive_set(10_in, DRIVE_SPEED);
   chassis.pid_wait_quick_chain();
   chassis.pid_turn_set(10_deg, TURN_SPEED);
   chassis.pid_wait_quick_chain();
-  intake.move(0);
+  mech::stop();
   chassis.pid_drive_set(0, 110);
   pros::delay(10000);
 }
@@ -1149,72 +1184,66 @@ void Left_counter_7(){
 void skills_106(){
   chassis.odom_theta_set(180);
   //Getting 6 balls out of barrier!!!
-  Wing.set(true);
-  intake.move(127);
+  prof::label("barrier");
+  mech::wing(true);
+  mech::load();
   chassis.pid_drive_set(600_in, 50);
-  MatchLoad.set(true);
-  pros::delay(800);
+  mech::matchload(true);
+  prof::delay(800, "barrier push");
   chassis.pid_drive_set(600_in, 50);
-  pros::delay(300);
-  MatchLoad.set(false);
+  prof::delay(300, "barrier push");
+  mech::matchload(false);
   chassis.pid_drive_set(600_in, 20);
-  pros::delay(1500);
-  MatchLoad.set(true);
+  prof::delay(1500, "barrier intake");
+  mech::matchload(true);
   chassis.pid_drive_set(-30_in, 127);
   chassis.pid_wait();
 
   DSR::reset_tracking(R, F);
 
   ////middle goal scoring
+  prof::label("middle goal");
   //move to the right area
   chassis.pid_odom_set({{58_in, 51_in}, rev, DRIVE_SPEED}, true);
   chassis.pid_wait_quick_chain();
 
   //fully align
-  MatchLoad.set(false);
-  chassis.drive_set(-60,-60);
-  pros::delay(700);
+  mech::matchload(false);
+  chassis.drive_push(-60, 700);
   chassis.pid_turn_set(-145_deg, TURN_SPEED);
   chassis.pid_wait();
 
   //constant pressure for scoring
   chassis.drive_set(-20,-20);
-  Middle.set(true);
 
-  //finicky stuff to make sure it doesn't jam
-  intake.move(-60);
-  outtake.move(-90);
-  pros::delay(200);
-  intake.move(90);
-  pros::delay(2000);
+  //the ball path opens Middle and backs the intake off first so it doesn't jam
+  mech::score_middle();
+  prof::delay(2200, "middle score");
 
   //get the last ball
   chassis.pid_turn_set(-135_deg, TURN_SPEED);
   chassis.pid_wait_quick_chain();
   chassis.drive_set(-20,-20);
-  pros::delay(200);
-  Middle.set(false);
-  outtake.move(0);
+  prof::delay(200, "middle last ball");
+  mech::load();
   chassis.pid_drive_set(9_in, DRIVE_SPEED / 2);
   chassis.pid_wait_quick();
 
   //realign
   chassis.pid_drive_set(-13_in,40);
-  pros::delay(600);
-  Middle.set(true);
-  outtake.move(-90);
-  pros::delay(1300);
-  intake.move(127);
-  Middle.set(false);
-  outtake.move(0);
+  prof::delay(600, "middle realign");
+  mech::score_middle();
+  prof::delay(1300, "middle score");
+  mech::load();
 
   //// Matchloading and long goal scoring
+  prof::label("first long goal");
   //go to general area
   chassis.pid_odom_set({{23_in, 23_in}, fwd, DRIVE_SPEED}, true);
 
   //get three extra balls
-  pros::delay(500);
-  MatchLoad.set(true);
+  prof::delay(500, "matchload open");
+  mech::matchload(true);
   chassis.pid_wait_quick_chain();
 
   //turn to face matchloader
@@ -1228,16 +1257,17 @@ void skills_106(){
   chassis.pid_odom_set({{19_in, 36_in}, rev, DRIVE_SPEED}, true);
   chassis.pid_wait_quick_chain();
   chassis.drive_set(-40,-40);
-  outtake.move(127);
-  pros::delay(1500);
-  outtake.move(0);
+  mech::score_long();
+  prof::delay(1500, "long goal score");
+  mech::load();
 
   //matchload
-  chassis.pid_odom_set({{{19_in, 20_in}, fwd, DRIVE_SPEED},{{19_in, 0_in}, fwd, DRIVE_SPEED / 2}});
-  pros::delay(1500);
+  chassis.pid_odom_set(SKILLS_106_LOADER_1);
+  prof::delay(1500, "matchload");
 
   //go to other side
-  chassis.pid_odom_set({{{4_in, 35_in}, rev, DRIVE_SPEED},{{5_in, 95_in}, rev, DRIVE_SPEED}, {{20_in, 110_in}, rev, DRIVE_SPEED}});
+  prof::label("second long goal");
+  chassis.pid_odom_set(SKILLS_106_CROSS);
   chassis.pid_wait_quick_chain();
 
   //turn to face matchloader
@@ -1251,32 +1281,28 @@ void skills_106(){
   chassis.pid_odom_set({{19_in, 85_in}, rev, DRIVE_SPEED / 2}, true);
 
   //dont score too early
-  pros::delay(750);
+  prof::delay(750, "long goal approach");
 
   //score
-  outtake.move(127);
-  pros::delay(2000);
-  outtake.move(0);
+  mech::score_long();
+  prof::delay(2000, "long goal score");
+  mech::load();
 
   //reset position
   DSR::reset_tracking(L, F);
 
   // matchload
-  chassis.pid_odom_set({{{20_in, 120_in}, fwd, DRIVE_SPEED}, {{20_in, 144_in}, fwd, DRIVE_SPEED / 2}}, true);
-  pros::delay(1500);
+  chassis.pid_odom_set(SKILLS_106_LOADER_2, true);
+  prof::delay(1500, "matchload");
 
   //go to long goal
   chassis.pid_odom_set({{19_in, 85_in}, rev, DRIVE_SPEED / 2}, true);
 
   //dont score too early
-  pros::delay(1000);
+  prof::delay(1000, "long goal approach");
 
   //score
-  outtake.move(127);
-  pros::delay(1000);
-
-  //change speed to score more
-  outtake.move(90);
-  pros::delay(1000);
-  outtake.move(0);
+  mech::score_long();
+  prof::delay(2000, "long goal score");
+  mech::load();
 }
\ No newline at end of file
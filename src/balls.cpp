@@ -0,0 +1,233 @@
+#include "balls.hpp"
+#include <cmath>
+#include <cstdio>
+#include "air.hpp"
+#include "health.hpp"
+#include "subsystems.hpp"
+
+static pros::Mutex inside_lock;
+//balls past the sensor, 0 is the one furthest along
+static balls::Ball inside[balls::MAX_BALLS];
+static int queued = 0;
+static balls::Color alliance = balls::NONE;
+static balls::Eject eject = balls::OFF;
+static int scored_count = 0;
+static int ejected_count = 0;
+static bool wrong_arrived = false;
+
+//the ball in front of the sensor, its hue is averaged as a direction so red can wrap around 0
+static bool present = false;
+static double hue_x = 0;
+static double hue_y = 0;
+
+//piston fired to throw a ball out, put back at restore_at
+static ez::Piston* fired = nullptr;
+static std::uint32_t restore_at = 0;
+
+//millis the last balls went out of the top
+static std::uint32_t exits[16] = {};
+static int exit_next = 0;
+
+static std::uint32_t last_tick = 0;
+
+static balls::Color classify(double hue){
+    if(hue < balls::RED_HUE || hue > 360 - balls::RED_HUE){
+        return balls::RED;
+    }
+    if(hue >= balls::BLUE_HUE_LOW && hue <= balls::BLUE_HUE_HIGH){
+        return balls::BLUE;
+    }
+    return balls::NONE;
+}
+
+static bool wrong(balls::Color color){
+    return alliance != balls::NONE && color != balls::NONE && color != alliance;
+}
+
+//drop ball i, inside_lock has to be held
+static void remove(int i){
+    for(int j = i; j < queued - 1; j++){
+        inside[j] = inside[j + 1];
+    }
+    queued--;
+}
+
+//false if nothing is set to throw it out
+static bool throw_out(int i, std::uint32_t now){
+    switch(eject){
+        case balls::OUTTAKE_REVERSE:
+            outtake.pulse(outtake.get_velocity() >= 0 ? -127 : 127, balls::EJECT_MS);
+            break;
+        case balls::MIDDLE:
+        case balls::LOW_SCORE:
+            fired = eject == balls::MIDDLE ? &Middle : &LowScore;
+            air::set(*fired, !fired->get());
+            restore_at = now + balls::EJECT_MS;
+            break;
+        default:
+            return false;
+    }
+    ejected_count++;
+    remove(i);
+    return true;
+}
+
+namespace balls{
+    void start(){
+        //the shortest integration time the sensor allows, with the light all the way up for it
+        ball_sensor.set_integration_time(3);
+        ball_sensor.set_led_pwm(100);
+        ctrl::add_subsystem(tick);
+    }
+
+    void tick(const ctrl::Sample& sample){
+        std::uint32_t now = sample.time / 1000;
+        double dt = last_tick == 0 ? 0 : (now - last_tick) / 1000.0;
+        last_tick = now;
+
+        if(fired != nullptr && now >= restore_at){
+            air::set(*fired, !fired->get());
+            fired = nullptr;
+        }
+
+        inside_lock.take();
+        //everything past the sensor moves with the outtake, a ball just in isn't pushed back out by one coasting
+        double speed = outtake.get_velocity();
+        double moved = std::fabs(speed) < STILL_RPM ? 0 : speed / 60.0 * INCHES_PER_REV * dt;
+        for(int i = queued - 1; i >= 0; i--){
+            inside[i].position += moved;
+            if(inside[i].position >= EJECT_IN && wrong(inside[i].color)){
+                wrong_arrived = true;
+                if(fired == nullptr && throw_out(i, now)){
+                    continue;
+                }
+            }
+            if(inside[i].position >= EXIT_IN){
+                //out of the top
+                scored_count++;
+                exits[exit_next] = now;
+                exit_next = (exit_next + 1) % 16;
+                remove(i);
+            }else if(inside[i].position < 0){
+                //back past the sensor, out the middle goal, the low goal or the intake
+                if(Middle.get() || LowScore.get()){
+                    scored_count++;
+                }
+                remove(i);
+            }
+        }
+
+        if(health::ok(ball_sensor.get_port())){
+            bool ball = ball_sensor.get_proximity() >= PROXIMITY_BALL;
+            if(ball){
+                double hue = ball_sensor.get_hue() * M_PI / 180.0;
+                hue_x += std::cos(hue);
+                hue_y += std::sin(hue);
+            }
+            //a ball the intake brings in is added, one going back out past the sensor is already in it. Into the
+            //middle goal the outtake runs backward while the intake brings balls in
+            if(ball && !present && intake.get_velocity() > STILL_RPM && queued < MAX_BALLS){
+                inside[queued++] = {NONE, 0, now};
+            }
+            if(!ball && present){
+                double hue = std::atan2(hue_y, hue_x) * 180.0 / M_PI;
+                if(queued > 0 && inside[queued - 1].color == NONE){
+                    inside[queued - 1].color = classify(hue < 0 ? hue + 360 : hue);
+                }
+                hue_x = 0;
+                hue_y = 0;
+            }
+            present = ball;
+        }
+        inside_lock.give();
+    }
+
+    void alliance_set(Color color){
+        alliance = color;
+    }
+
+    Color alliance_get(){
+        return alliance;
+    }
+
+    bool alliance_save(const char* file){
+        FILE* out = fopen(file, "w");
+        if(out == nullptr){
+            return false;
+        }
+        bool written = fprintf(out, "%i", int(alliance)) > 0;
+        return fclose(out) == 0 && written;
+    }
+
+    bool alliance_load(const char* file){
+        FILE* in = fopen(file, "r");
+        if(in == nullptr){
+            return false;
+        }
+        int color = NONE;
+        bool read = fscanf(in, "%i", &color) == 1 && color >= NONE && color <= BLUE;
+        fclose(in);
+        if(read){
+            alliance = Color(color);
+        }
+        return read;
+    }
+
+    void eject_set(Eject method){
+        eject = method;
+    }
+
+    void clear(){
+        inside_lock.take();
+        queued = 0;
+        inside_lock.give();
+    }
+
+    int ball_count(){
+        return queued;
+    }
+
+    Ball get(int index){
+        inside_lock.take();
+        Ball ball = index >= 0 && index < queued ? inside[index] : Ball();
+        inside_lock.give();
+        return ball;
+    }
+
+    int scored(){
+        return scored_count;
+    }
+
+    int ejected(){
+        return ejected_count;
+    }
+
+    double throughput(){
+        std::uint32_t now = pros::millis();
+        int count = 0;
+        for(std::uint32_t time : exits){
+            count += time != 0 && now - time <= THROUGHPUT_MS;
+        }
+        return count / (THROUGHPUT_MS / 1000.0);
+    }
+
+    bool wait_wrong_color(int timeout_ms){
+        std::uint32_t start = pros::millis();
+        wrong_arrived = false;
+        while(!wrong_arrived && pros::millis() - start < std::uint32_t(timeout_ms)){
+            pros::delay(ez::util::DELAY_TIME);
+        }
+        return wrong_arrived;
+    }
+
+    const char* color_to_string(Color color){
+        switch(color){
+            case RED:
+                return "Red";
+            case BLUE:
+                return "Blue";
+            default:
+                return "None";
+        }
+    }
+}
@@ -0,0 +1,365 @@
+#include "chassis.hpp"
+#include <cmath>
+#include <cstdlib>
+#include "control_loop.hpp"
+#include "dsr.hpp"
+#include "profiler.hpp"
+#include "trace.hpp"
+
+void Chassis::initialize(){
+    ez::Drive::initialize();
+    paths.reserve();
+}
+
+void Chassis::odom_path_smooth_constants_set(double weight_smooth, double weight_data, double tolerance){
+    ez::Drive::odom_path_smooth_constants_set(weight_smooth, weight_data, tolerance);
+    smoothing = {weight_smooth, weight_data, tolerance};
+}
+
+bool Chassis::path_warm(path::Build build, std::span<const ez::odom> movements){
+    return paths.warm(build, movements, odom_path_spacing_get(), smoothing);
+}
+
+bool Chassis::path_warm(path::Build build, std::span<const ez::united_odom> movements){
+    return paths.warm(build, movements, odom_path_spacing_get(), smoothing);
+}
+
+bool Chassis::path_warm(path::Build build, std::initializer_list<ez::odom> movements){
+    return path_warm(build, std::span<const ez::odom>(movements.begin(), movements.size()));
+}
+
+bool Chassis::path_warm(path::Build build, std::initializer_list<ez::united_odom> movements){
+    return path_warm(build, std::span<const ez::united_odom>(movements.begin(), movements.size()));
+}
+
+void Chassis::drive_set(int left, int right){
+    //stop PID now so the order of drive_set and pid_*_set calls is kept
+    drive_mode_set(ez::DISABLE, false);
+
+    prof::motion_set("drive_set", (left + right) / 2.0);
+    voltage_set(left, right);
+}
+
+void Chassis::voltage_set(int left, int right){
+    if(ctrl::running()){
+        ctrl::drive_set(left, right);
+    }else{
+        ez::Drive::drive_set(left, right);
+    }
+}
+
+//a V5 motor stalled at full voltage draws 2.5A
+static const double STALL_MA = 2500;
+
+//two sensors closer together across their beams than this can't tell the angle apart from their noise, in inches
+static const double MIN_SENSOR_SPAN = 2;
+
+//deg the robot is turned off square to the wall two sensors facing the same way see, from how much further one
+//reads than the other across the span between them, the way DSRDS::apply_offsets() places them. The imu's
+//heading off square to the field when there aren't two of them connected with readings
+double Chassis::wall_angle(DSRDS* first, DSRDS* second){
+    if(first != nullptr && second != nullptr && first->is_connected() && second->is_connected()){
+        double first_in = first->get_sensed_in();
+        double second_in = second->get_sensed_in();
+        double span = first->get_x_offset() - second->get_x_offset();
+        if(first_in >= 0 && second_in >= 0 && std::fabs(span) >= MIN_SENSOR_SPAN){
+            double depth = (first_in + first->get_y_offset()) - (second_in + second->get_y_offset());
+            return ez::util::to_deg(std::atan(depth / span));
+        }
+    }
+    double angle = std::fmod(odom_theta_get(), 90.0);
+    return angle > 45 ? angle - 90 : angle < -45 ? angle + 90 : angle;
+}
+
+Chassis::Push Chassis::drive_push(int power, int timeout_ms, int hold_power, double wall_in){
+    drive_mode_set(ez::DISABLE, false);
+    prof::motion_set("drive_push", power);
+    voltage_set(power, power);
+
+    //the DSR sensors looking the way the robot is pushing, a second one gives the angle to the wall
+    Dir facing = power < 0 ? Back : Front;
+    DSRDS* sensor = nullptr;
+    DSRDS* second = nullptr;
+    for(DSRDS& candidate : DSR::sensors){
+        if(candidate.get_dir() != facing || !candidate.is_connected()){
+            continue;
+        }
+        if(sensor == nullptr){
+            sensor = &candidate;
+        }else if(second == nullptr){
+            second = &candidate;
+        }
+    }
+
+    Push push;
+    std::uint32_t start = pros::millis();
+    std::uint32_t contact_start = 0;
+    bool touching = false;
+    double fastest = 0;
+    double current_limit = PUSH_CURRENT_FRACTION * STALL_MA * std::abs(power) / 127.0;
+    std::uint32_t last_jolt = 0;
+    bool jolted = false;
+    while(true){
+        pros::delay(ez::util::DELAY_TIME);
+        std::uint32_t now = pros::millis();
+        if(now - start >= std::uint32_t(timeout_ms)){
+            break;
+        }
+
+        double speed = std::max(std::abs(drive_velocity_left()), std::abs(drive_velocity_right()));
+        fastest = std::max(fastest, speed);
+        pros::imu_accel_s_t accel = imu.get_accel();
+        if(std::hypot(accel.x, accel.y) > PUSH_JOLT_G){
+            last_jolt = now;
+            jolted = true;
+        }
+        if(now - start < PUSH_SPINUP_MS){
+            continue;
+        }
+
+        bool slowed = speed < std::max(PUSH_SLOW_RPM, PUSH_SLOW_FRACTION * fastest);
+        bool loaded = (std::fabs(drive_mA_left()) + std::fabs(drive_mA_right())) / 2.0 > current_limit;
+        bool hit = jolted && now - last_jolt <= 2 * PUSH_CONFIRM_MS;
+        double range = sensor == nullptr ? -1 : sensor->read_sensed();
+        bool close = wall_in > 0 && range >= 0 && range <= wall_in;
+
+        if(slowed && (loaded || hit || close)){
+            if(!touching){
+                touching = true;
+                contact_start = now;
+            }
+            if(now - contact_start >= PUSH_CONFIRM_MS){
+                push.exit = Push::CONTACT;
+                break;
+            }
+        }else{
+            touching = false;
+        }
+    }
+
+    voltage_set(hold_power, hold_power);
+    push.time = pros::millis() - start;
+    push.wall_distance = sensor == nullptr ? -1 : sensor->read_sensed();
+    push.wall_angle = wall_angle(sensor, second);
+    prof::motion_done("drive_push", push.wall_distance, push.exit == Push::CONTACT ? "Contact" : "Timeout", 0);
+    return push;
+}
+
+void Chassis::pid_drive_settle_set(double error, double velocity, int hold_ms, int predict_ms){
+    drive_settle.constants_set(error, velocity, hold_ms, predict_ms);
+}
+
+void Chassis::pid_turn_settle_set(double error, double velocity, int hold_ms, int predict_ms){
+    turn_settle.constants_set(error, velocity, hold_ms, predict_ms);
+}
+
+void Chassis::pid_swing_settle_set(double error, double velocity, int hold_ms, int predict_ms){
+    swing_settle.constants_set(error, velocity, hold_ms, predict_ms);
+}
+
+double Chassis::motion_error(ez::e_mode mode){
+    if(mode == ez::DRIVE){
+        return (leftPID.error + rightPID.error) / 2.0;
+    }
+    return motion_pid(mode).error;
+}
+
+ez::PID& Chassis::motion_pid(ez::e_mode mode){
+    switch(mode){
+        case ez::DRIVE:
+            return leftPID;
+        case ez::SWING:
+            return swingPID;
+        case ez::TURN:
+        case ez::TURN_TO_POINT:
+            return turnPID;
+        default:
+            return xyPID;
+    }
+}
+
+static settle::Exit to_exit(ez::exit_output output){
+    switch(output){
+        case ez::SMALL_EXIT:
+            return settle::SMALL;
+        case ez::BIG_EXIT:
+            return settle::BIG;
+        case ez::VELOCITY_EXIT:
+            return settle::VELOCITY;
+        case ez::mA_EXIT:
+            return settle::MA;
+        case ez::RUNNING:
+            return settle::RUNNING;
+        default:
+            //ERROR_NO_CONSTANTS, or anything else that isn't running, ends the wait
+            return settle::NO_CONSTANTS;
+    }
+}
+
+settle::Exit Chassis::ez_exit(ez::e_mode mode, ez::exit_output& left, ez::exit_output& right){
+    switch(mode){
+        case ez::DRIVE:
+            //both sides have to exit, each one keeps the first reason it exited with
+            if(left == ez::RUNNING){
+                left = leftPID.exit_condition(left_motors[0]);
+            }
+            if(right == ez::RUNNING){
+                right = rightPID.exit_condition(right_motors[0]);
+            }
+            if(left == ez::RUNNING || right == ez::RUNNING){
+                return settle::RUNNING;
+            }
+            //the worse of the two is the reason
+            return to_exit(left > right ? left : right);
+        case ez::SWING:
+            left = swingPID.exit_condition(current_swing == ez::LEFT_SWING ? left_motors[0] : right_motors[0]);
+            return to_exit(left);
+        default:
+            left = turnPID.exit_condition({left_motors[0], right_motors[0]});
+            return to_exit(left);
+    }
+}
+
+void Chassis::pid_wait(){
+    std::uint64_t wait_start = pros::micros();
+    ez::e_mode mode = drive_mode_get();
+
+    settle::Record record;
+    record.mode = mode;
+    record.start = pros::millis();
+    record.target = motion_pid(mode).target_get();
+
+    if(mode != ez::DRIVE && mode != ez::TURN && mode != ez::TURN_TO_POINT && mode != ez::SWING){
+        //odom motions exit inside EZ-Template, which keeps its exit timers to itself, so only the error it stopped at is known
+        ez::Drive::pid_wait();
+        record.end = pros::millis();
+        record.final_error = xyPID.error;
+        record.exit = settle::UNKNOWN;
+        settle::add(record);
+        trace::record("pid_wait", wait_start, pros::micros());
+        prof::motion_done("pid_wait", record.final_error, settle::exit_to_string(record.exit), 0);
+        return;
+    }
+
+    SettleDetector& detector = mode == ez::DRIVE ? drive_settle : mode == ez::SWING ? swing_settle : turn_settle;
+    ez::PID& pid = motion_pid(mode);
+    detector.reset();
+
+    ez::exit_output left = ez::RUNNING;
+    ez::exit_output right = ez::RUNNING;
+    //a motion set right before this hasn't had a PID tick yet, its errors are still the last motion's
+    pros::delay(ez::util::DELAY_TIME);
+    double start_error = motion_error(mode);
+    double direction = start_error < 0 ? -1 : 1;
+    std::uint32_t last = record.start;
+
+    while(true){
+        double error = motion_error(mode);
+        std::uint32_t now = pros::millis();
+        SettleDetector::State state = detector.update(error, now);
+
+        //time since the last tick goes to the zone the error is in now
+        std::uint32_t dt = now - last;
+        last = now;
+        if(std::fabs(error) <= pid.exit.small_error){
+            record.phase_time[settle::SMALL_ZONE] += dt;
+        }else if(std::fabs(error) <= pid.exit.big_error){
+            record.phase_time[settle::BIG_ZONE] += dt;
+        }else{
+            record.phase_time[settle::FAR] += dt;
+        }
+        if(detector.enabled() && std::fabs(detector.velocity_get()) <= detector.velocity_threshold_get()){
+            record.phase_time[settle::STOPPED] += dt;
+        }
+        //error changes sign once the robot is past the target
+        record.overshoot = std::fmax(record.overshoot, -direction * error);
+
+        record.exit = ez_exit(mode, left, right);
+        if(record.exit == settle::RUNNING){
+            if(state == SettleDetector::SETTLED){
+                record.exit = settle::SETTLED;
+            }else if(state == SettleDetector::PREDICTED){
+                record.exit = settle::PREDICTED;
+            }else if(now - record.start >= settle::MAX_WAIT_MS){
+                record.exit = settle::TIMEOUT;
+            }
+        }
+        if(record.exit != settle::RUNNING){
+            record.final_error = error;
+            break;
+        }
+
+        pros::delay(ez::util::DELAY_TIME);
+    }
+
+    record.end = pros::millis();
+    interfered = record.exit == settle::VELOCITY || record.exit == settle::MA;
+    settle::add(record);
+    //the wait ends before the motion's step, so it nests inside it in the trace
+    trace::record("pid_wait", wait_start, pros::micros());
+    //time spent inside the small error is the robot already being there and waiting on the exit
+    prof::motion_done("pid_wait", record.final_error, settle::exit_to_string(record.exit), record.phase_time[settle::SMALL_ZONE]);
+}
+
+void Chassis::profile_set(const char* call){
+    ez::e_mode mode = drive_mode_get();
+    double target = mode == ez::DRIVE ? (leftPID.target_get() + rightPID.target_get()) / 2.0 : motion_pid(mode).target_get();
+    prof::motion_set(call, target);
+}
+
+void Chassis::profile_until(const char* call, std::uint32_t start){
+    prof::wait_until(call, start, motion_error(drive_mode_get()));
+}
+
+void Chassis::pid_wait_quick(){
+    std::uint64_t wait_start = pros::micros();
+    ez::Drive::pid_wait_quick();
+    trace::record("pid_wait_quick", wait_start, pros::micros());
+    //exits as soon as the target is crossed, nothing is spent waiting at it
+    prof::motion_done("pid_wait_quick", motion_error(drive_mode_get()), "Quick", 0);
+}
+
+void Chassis::pid_wait_quick_chain(){
+    std::uint64_t wait_start = pros::micros();
+    ez::Drive::pid_wait_quick_chain();
+    trace::record("pid_wait_quick_chain", wait_start, pros::micros());
+    prof::motion_done("pid_wait_quick_chain", motion_error(drive_mode_get()), "Chain", 0);
+}
+
+void Chassis::pid_wait_until(ez::pose target){
+    std::uint32_t start = pros::millis();
+    ez::Drive::pid_wait_until(target);
+    profile_until("pid_wait_until", start);
+}
+
+void Chassis::pid_wait_until(ez::united_pose target){
+    std::uint32_t start = pros::millis();
+    ez::Drive::pid_wait_until(target);
+    profile_until("pid_wait_until", start);
+}
+
+void Chassis::pid_wait_until_point(ez::pose target){
+    std::uint32_t start = pros::millis();
+    ez::Drive::pid_wait_until_point(target);
+    profile_until("pid_wait_until_point", start);
+}
+
+void Chassis::pid_wait_until_point(ez::united_pose target){
+    std::uint32_t start = pros::millis();
+    ez::Drive::pid_wait_until_point(target);
+    profile_until("pid_wait_until_point", start);
+}
+
+void Chassis::pid_wait_until_index(int index){
+    std::uint32_t start = pros::millis();
+    //EZ-Template got the path already injected, its indexes are points and ours are waypoints
+    ez::Drive::pid_wait_until_index(paths.index(index));
+    profile_until("pid_wait_until_index", start);
+}
+
+void Chassis::pid_wait_until_index_started(int index){
+    std::uint32_t start = pros::millis();
+    //started once it is past the point the waypoint before it ended at
+    ez::Drive::pid_wait_until_index_started(index <= 0 ? index : paths.index(index - 1) + 1);
+    profile_until("pid_wait_until_index_started", start);
+}
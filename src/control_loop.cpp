@@ -0,0 +1,151 @@
+#include "control_loop.hpp"
+#include <vector>
+#include "alloc.hpp"
+#include "dsr.hpp"
+#include "health.hpp"
+#include "subsystems.hpp"
+#include "tasks.hpp"
+#include "trace.hpp"
+
+static std::vector<Roller*> rollers;
+static std::vector<std::function<void(const ctrl::Sample&)>> subsystems;
+
+//chassis command buffered for the next actuate stage, packed as (left << 16) | right
+static std::atomic<bool> drive_pending = false;
+static std::atomic<std::int32_t> drive_command = 0;
+
+static pros::Mutex sample_lock;
+static ctrl::Sample latest;
+static ctrl::Timing stats;
+static bool started = false;
+
+static void sense(ctrl::Sample& sample){
+    TRACE_SPAN("sense");
+    sample.time = pros::micros();
+    sample.left = chassis.drive_sensor_left();
+    sample.right = chassis.drive_sensor_right();
+    sample.imu = chassis.drive_imu_get();
+    for(Roller* roller : rollers){
+        roller->sense();
+    }
+    for(DSRDS& sensor : DSR::sensors){
+        sensor.sense();
+    }
+}
+
+static void estimate(ctrl::Sample& sample){
+    TRACE_SPAN("estimate");
+    //EZ-Template updates odom in its own task, take the pose next to the sensor batch
+    sample.pose = chassis.odom_pose_get();
+}
+
+static void control(const ctrl::Sample& sample){
+    TRACE_SPAN("control");
+    //subsystems first, so what they command reaches the rollers this tick
+    for(auto& tick : subsystems){
+        tick(sample);
+    }
+    for(Roller* roller : rollers){
+        roller->control(sample.time / 1000);
+    }
+}
+
+static void actuate(){
+    TRACE_SPAN("actuate");
+    for(Roller* roller : rollers){
+        roller->actuate();
+    }
+    if(drive_pending.exchange(false)){
+        std::int32_t packed = drive_command;
+        //a pid_*_set after the drive_set already took the chassis over
+        if(chassis.drive_mode_get() == ez::DISABLE){
+            chassis.ez::Drive::drive_set(std::int16_t(packed >> 16), std::int16_t(packed & 0xFFFF));
+        }
+    }
+}
+
+static void record(std::uint64_t start, std::uint64_t end){
+    std::uint32_t tick = std::uint32_t(end - start);
+
+    sample_lock.take();
+    stats.ticks++;
+    stats.last_tick = tick;
+    if(tick > stats.worst_tick){
+        stats.worst_tick = tick;
+    }
+    sample_lock.give();
+}
+
+static void loop(){
+    int id = tasks::add("ctrl loop", tasks::PRIORITY_CONTROL, ctrl::period);
+    alloc::hot();
+    while(true){
+        ctrl::Sample sample;
+        sense(sample);
+        estimate(sample);
+
+        sample_lock.take();
+        latest = sample;
+        sample_lock.give();
+
+        //fallbacks change what odom uses, so they go before anything acts on the sample
+        health::check(sample);
+
+        control(sample);
+        actuate();
+
+        record(sample.time, pros::micros());
+
+        //the loop is the highest priority task, so it is the one that can notice starvation
+        tasks::check();
+        tasks::wait(id);
+    }
+}
+
+namespace ctrl{
+    void start(int period_ms){
+        if(started){
+            return;
+        }
+        period = period_ms;
+        started = true;
+        pros::Task(loop, tasks::PRIORITY_CONTROL, TASK_STACK_DEPTH_DEFAULT, "ctrl loop");
+    }
+
+    bool running(){
+        return started;
+    }
+
+    void add_roller(Roller& roller){
+        rollers.push_back(&roller);
+    }
+
+    void add_subsystem(std::function<void(const Sample&)> tick){
+        subsystems.push_back(tick);
+    }
+
+    void drive_set(int left, int right){
+        drive_command = (std::int32_t(left) << 16) | (std::int32_t(right) & 0xFFFF);
+        drive_pending = true;
+    }
+
+    Sample sample(){
+        sample_lock.take();
+        Sample copy = latest;
+        sample_lock.give();
+        return copy;
+    }
+
+    Timing timing(){
+        sample_lock.take();
+        Timing copy = stats;
+        sample_lock.give();
+        return copy;
+    }
+
+    void timing_reset(){
+        sample_lock.take();
+        stats.worst_tick = 0;
+        sample_lock.give();
+    }
+}
@@ -0,0 +1,153 @@
+#include "driver.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include "subsystems.hpp"
+
+static const int BUTTONS = pros::E_CONTROLLER_DIGITAL_A - pros::E_CONTROLLER_DIGITAL_L1 + 1;
+
+static driver::Snapshot now;
+static driver::Latency stats;
+//a stick moved this tick, so the next drive command is timed
+static bool moved = false;
+
+//curved stick for every input from -127 to 127
+static int left_curve[255];
+static int right_curve[255];
+static bool curves_built = false;
+//EZ-Template counts the curve buttons' hold time in DELAY_TIME steps, so they are only checked that often
+static std::uint32_t curve_checked = 0;
+//a bit for each curve button, like Snapshot::held
+static std::uint32_t curve_buttons = 0;
+static bool curve_buttons_read = false;
+
+//last drive command written, thresholded the way EZ-Template writes it, read by the replay recorder
+static std::atomic<int> last_left = 0;
+static std::atomic<int> last_right = 0;
+static bool written = false;
+
+static std::uint32_t bit(pros::controller_digital_e_t button){
+    int index = button - pros::E_CONTROLLER_DIGITAL_L1;
+    return index >= 0 && index < BUTTONS ? 1u << index : 0;
+}
+
+static int lookup(const int* curve, int stick){
+    return curve[std::max(-127, std::min(127, stick)) + 127];
+}
+
+//EZ-Template hands the curve buttons back as new vectors, so they are read into a mask once instead of every tick.
+//They are set in initialize() before the first drive call
+static bool curve_button_held(){
+    if(!curve_buttons_read){
+        for(pros::controller_digital_e_t button : chassis.opcontrol_curve_buttons_left_get()){
+            curve_buttons |= bit(button);
+        }
+        for(pros::controller_digital_e_t button : chassis.opcontrol_curve_buttons_right_get()){
+            curve_buttons |= bit(button);
+        }
+        curve_buttons_read = true;
+    }
+    return (now.held & curve_buttons) != 0;
+}
+
+namespace driver{
+    void read(){
+        Snapshot last = now;
+        now.time = pros::micros();
+        now.left_x = master.get_analog(pros::E_CONTROLLER_ANALOG_LEFT_X);
+        now.left_y = master.get_analog(pros::E_CONTROLLER_ANALOG_LEFT_Y);
+        now.right_x = master.get_analog(pros::E_CONTROLLER_ANALOG_RIGHT_X);
+        now.right_y = master.get_analog(pros::E_CONTROLLER_ANALOG_RIGHT_Y);
+        now.held = 0;
+        for(int i = 0; i < BUTTONS; i++){
+            if(master.get_digital(pros::controller_digital_e_t(pros::E_CONTROLLER_DIGITAL_L1 + i))){
+                now.held |= 1u << i;
+            }
+        }
+        now.pressed = now.held & ~last.held;
+        now.released = last.held & ~now.held;
+        moved = now.left_x != last.left_x || now.left_y != last.left_y || now.right_x != last.right_x || now.right_y != last.right_y;
+    }
+
+    const Snapshot& get(){
+        return now;
+    }
+
+    bool held(pros::controller_digital_e_t button){
+        return now.held & bit(button);
+    }
+
+    bool pressed(pros::controller_digital_e_t button){
+        return now.pressed & bit(button);
+    }
+
+    bool released(pros::controller_digital_e_t button){
+        return now.released & bit(button);
+    }
+
+    void curves_build(){
+        for(int x = -127; x <= 127; x++){
+            left_curve[x + 127] = int(chassis.opcontrol_curve_left(x));
+            right_curve[x + 127] = int(chassis.opcontrol_curve_right(x));
+        }
+        curves_built = true;
+    }
+
+    void arcade_flipped(){
+        std::uint32_t ms = now.time / 1000;
+        if(chassis.opcontrol_curve_buttons_toggle_get() && ms - curve_checked >= ez::util::DELAY_TIME){
+            curve_checked = ms;
+            chassis.opcontrol_curve_buttons_iterate();
+            if(curve_button_held()){
+                curves_built = false;
+            }
+        }
+        if(!curves_built){
+            curves_build();
+        }
+
+        int fwd = lookup(left_curve, now.right_y);
+        int turn = lookup(right_curve, now.left_x);
+        int left = fwd + turn;
+        int right = fwd - turn;
+
+        //inside the threshold EZ-Template writes 0, and active brake has to run every tick
+        int threshold = chassis.opcontrol_joystick_threshold_get();
+        bool still = std::abs(left) <= threshold && std::abs(right) <= threshold;
+        int command_left = still ? 0 : left;
+        int command_right = still ? 0 : right;
+        if(written && command_left == last_left && command_right == last_right && chassis.opcontrol_drive_activebrake_get() == 0){
+            stats.skipped++;
+            return;
+        }
+        chassis.opcontrol_joystick_threshold_iterate(left, right);
+        last_left = command_left;
+        last_right = command_right;
+        written = true;
+        stats.writes++;
+
+        if(moved){
+            std::uint32_t took = pros::micros() - now.time;
+            stats.last = took;
+            stats.max = std::max(stats.max, took);
+            stats.samples++;
+            stats.average += (took - stats.average) / stats.samples;
+        }
+    }
+
+    int left_command(){
+        return last_left;
+    }
+
+    int right_command(){
+        return last_right;
+    }
+
+    void outputs_reset(){
+        written = false;
+    }
+
+    Latency latency(){
+        return stats;
+    }
+}
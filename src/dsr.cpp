@@ -4,6 +4,8 @@
 #include "main.h"
 #include "pros/misc.hpp"
 #include "subsystems.hpp"
+#include "telemetry.hpp"
+#include "trace.hpp"
 
 //22.83
 //46.38
@@ -58,31 +60,46 @@ void triple_read(int angle, int iterations, int i){
 }
 
 void odom_reset(Dir senX_dir, Dir Xdir, int Xsen, Dir senY_dir, Dir Ydir, int Ysen){
+    TRACE_SPAN("dsr reset");
+    double x_before = chassis.odom_x_get();
+    double y_before = chassis.odom_y_get();
 
     //reset the tracking values based on the sensor readings and the direction of the sensors
-    if(int(senX_dir) == int(Xdir)){
-        chassis.odom_x_set(DSR::sensors[Xsen].read());
+    //an unplugged sensor reads -1, that axis keeps its odom value
+    double x_reading = DSR::sensors[Xsen].read();
+    if(x_reading < 0){
         if(debug){
-            ez::screen_print("X: true     Raw: " + util::to_string_with_precision(DSR::sensors[Xsen].read()) + " true: " + util::to_string_with_precision(DSR::sensors[Xsen].read_raw_in()),5);
+            ez::screen_print("X: sensor unplugged, skipped", 5);
+        }
+    }else if(int(senX_dir) == int(Xdir)){
+        chassis.odom_x_set(x_reading);
+        if(debug){
+            ez::screen_print("X: true     Raw: " + util::to_string_with_precision(x_reading) + " true: " + util::to_string_with_precision(DSR::sensors[Xsen].read_raw_in()),5);
         }
     }else{
-        chassis.odom_x_set(feild_size - DSR::sensors[Xsen].read());
+        chassis.odom_x_set(feild_size - x_reading);
         if(debug){
-            ez::screen_print("X: false     Raw: " + util::to_string_with_precision(DSR::sensors[Xsen].read()) + " true: " + util::to_string_with_precision(DSR::sensors[Xsen].read_raw_in()),5);
+            ez::screen_print("X: false     Raw: " + util::to_string_with_precision(x_reading) + " true: " + util::to_string_with_precision(DSR::sensors[Xsen].read_raw_in()),5);
         }
     }
 
-    if(int(senY_dir) == int(Ydir)){
-        chassis.odom_y_set(DSR::sensors[Ysen].read());
+    double y_reading = DSR::sensors[Ysen].read();
+    if(y_reading < 0){
+        if(debug){
+            ez::screen_print("Y: sensor unplugged, skipped", 6);
+        }
+    }else if(int(senY_dir) == int(Ydir)){
+        chassis.odom_y_set(y_reading);
         if(debug){
-            ez::screen_print("Y: true     Raw: " + util::to_string_with_precision(DSR::sensors[Ysen].read()) + " true: " + util::to_string_with_precision(DSR::sensors[Ysen].read_raw_in()), 6);
+            ez::screen_print("Y: true     Raw: " + util::to_string_with_precision(y_reading) + " true: " + util::to_string_with_precision(DSR::sensors[Ysen].read_raw_in()), 6);
         }
     }else{
-        chassis.odom_y_set(feild_size - DSR::sensors[Ysen].read());
+        chassis.odom_y_set(feild_size - y_reading);
         if(debug){
-            ez::screen_print("Y: false     Raw: " + util::to_string_with_precision(DSR::sensors[Ysen].read()) + " true: " + util::to_string_with_precision(DSR::sensors[Ysen].read_raw_in()), 6);
+            ez::screen_print("Y: false     Raw: " + util::to_string_with_precision(y_reading) + " true: " + util::to_string_with_precision(DSR::sensors[Ysen].read_raw_in()), 6);
         }
     }
+    telemetry::event(telemetry::DSR_RESET, Xsen, x_before, y_before, chassis.odom_x_get(), chassis.odom_y_get());
 }
 
 namespace DSR{
@@ -1,4 +1,6 @@
 #include "../include/dsr.hpp"
+#include <cerrno>
+#include <cmath>
 #include "EZ-Template/util.hpp"
 #include "main.h"
 
@@ -29,7 +31,15 @@ double DSRDS::read_raw(){
 double DSRDS::read_raw_in(int time_out){
     double reading = 9999;
     for(int i = 0; (reading >= 9999 || reading < 0) && time_out > 0; i++){
+        //an unplugged sensor would otherwise be retried for the whole time out
+        if(!connected){
+            return -1;
+        }
         reading = read_raw();
+        if(reading == PROS_ERR && errno == ENODEV){
+            connected = false;
+            return -1;
+        }
         pros::delay(10);
         time_out -= 10;
         if(debug){
@@ -42,7 +52,23 @@ double DSRDS::read_raw_in(int time_out){
     return reading / 25.4;
 }
 
+void DSRDS::sense(){
+    double reading = read_raw();
+    if(reading == PROS_ERR && errno == ENODEV){
+        connected = false;
+    }
+    sensed = (reading >= 9999 || reading < 0) ? -1 : reading / 25.4;
+}
+
+double DSRDS::get_sensed_in(){
+    return sensed;
+}
+
 double deg_mod_2(double a){
+    //an imu that read PROS_ERR_F would never get in range
+    if(!std::isfinite(a)){
+        return a;
+    }
     while(a < -45 || a > 45){
         if(a < -45){
             a += 90;
@@ -53,10 +79,19 @@ double deg_mod_2(double a){
     return a;
 }
 
-double DSRDS::read(int time_out){
+double DSRDS::apply_offsets(double reading){
     double angle = util::to_rad(deg_mod_2(chassis.odom_theta_get()));
-    return (read_raw_in(time_out) + y_offset) * cos(angle) - x_offset * sin(angle);
-}   
+    return (reading + y_offset) * cos(angle) - x_offset * sin(angle);
+}
+
+double DSRDS::read(int time_out){
+    double reading = read_raw_in(time_out);
+    return reading < 0 ? -1 : apply_offsets(reading);
+}
+
+double DSRDS::read_sensed(){
+    return sensed < 0 ? -1 : apply_offsets(sensed);
+}
 
 void DSRDS::set_x_offset(double x){
     x_offset = x;
@@ -96,6 +131,18 @@ std::string DSRDS::get_dir_string(){
     return dir_string;
 }
 
+int DSRDS::get_port(){
+    return sensor.get_port();
+}
+
+void DSRDS::set_connected(bool connected){
+    this->connected = connected;
+}
+
+bool DSRDS::is_connected(){
+    return connected;
+}
+
 void DSRDS::measure_offsets(double read45, double read30, double read0){
     y_offset = Ya * read45 - Yb * read30 + Yc * read0;
     x_offset = Xa * read45 - Xb * read30 + Xc * read0;
@@ -0,0 +1,209 @@
+#include "health.hpp"
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+#include "dsr.hpp"
+#include "subsystems.hpp"
+#include "telemetry.hpp"
+#include "trace.hpp"
+
+static std::vector<health::Device> devices;
+static std::function<void(const health::Device&)> fault_callback = nullptr;
+static int ticks = 0;
+
+//EZ-Template's tracking is turned off to change its trackers, so its task is never partway through an update
+//when one goes, and it stays off while the imu is gone
+static bool odom_paused = false;
+static bool odom_was_enabled = true;
+static std::uint32_t paused_at = 0;
+static std::uint32_t removing = 0;   // a bit for each tracker role waiting to be taken out
+
+//tracking from the drive motors while the imu is gone
+static bool imu_lost = false;
+static ez::pose last_pose = {0, 0, 0};
+static double last_left = 0;
+static double last_right = 0;
+
+static pros::DeviceType expected_type(health::Role role){
+    switch(role){
+        case health::DRIVE_MOTOR:
+        case health::ROLLER:
+            return pros::DeviceType::motor;
+        case health::IMU:
+            return pros::DeviceType::imu;
+        case health::DISTANCE:
+            return pros::DeviceType::distance;
+        case health::OPTICAL:
+            return pros::DeviceType::optical;
+        default:
+            return pros::DeviceType::rotation;
+    }
+}
+
+static void odom_pause(){
+    if(!odom_paused){
+        odom_was_enabled = chassis.odom_enabled();
+        chassis.odom_enable(false);
+        odom_paused = true;
+        paused_at = pros::millis();
+    }
+}
+
+static void degrade(health::Device& device){
+    device.degraded = true;
+    switch(device.role){
+        //taken out once EZ-Template's tracking has stopped, it falls back to the drive motors
+        case health::TRACKER_LEFT:
+        case health::TRACKER_RIGHT:
+        case health::TRACKER_FRONT:
+        case health::TRACKER_BACK:
+            removing |= 1u << device.role;
+            odom_pause();
+            break;
+        case health::IMU:
+            imu_lost = true;
+            odom_pause();
+            break;
+        case health::DISTANCE:
+            for(DSRDS& sensor : DSR::sensors){
+                if(sensor.get_port() == device.port){
+                    sensor.set_connected(false);
+                }
+            }
+            break;
+        default:
+            //nothing to fall back to for motors, it is only reported
+            break;
+    }
+}
+
+static void update(health::Device& device, bool plugged){
+    if(plugged == device.ok){
+        return;
+    }
+    device.ok = plugged;
+    if(!plugged){
+        device.faults++;
+        device.fault_time = pros::millis();
+        if(!device.degraded){
+            degrade(device);
+        }
+    }
+    telemetry::event(telemetry::FAULT, device.port, plugged, device.faults);
+    if(fault_callback != nullptr){
+        fault_callback(device);
+    }
+}
+
+//a whole EZ-Template tick after its tracking was turned off, whatever update it was in is done
+static void odom_handover(){
+    if(!odom_paused || pros::millis() - paused_at < std::uint32_t(ez::util::DELAY_TIME)){
+        return;
+    }
+    if(removing & (1u << health::TRACKER_LEFT)){
+        chassis.odom_tracker_left_set(nullptr);
+    }
+    if(removing & (1u << health::TRACKER_RIGHT)){
+        chassis.odom_tracker_right_set(nullptr);
+    }
+    if(removing & (1u << health::TRACKER_FRONT)){
+        chassis.odom_tracker_front_set(nullptr);
+    }
+    if(removing & (1u << health::TRACKER_BACK)){
+        chassis.odom_tracker_back_set(nullptr);
+    }
+    removing = 0;
+    //the trackers kept their last readings, so what moved while it was off is taken up by its next update
+    if(!imu_lost){
+        chassis.odom_enable(odom_was_enabled);
+        odom_paused = false;
+    }
+}
+
+//EZ-Template reads the imu in its tracking, so without one the pose comes from the drive motors here instead
+static void drive_tracking(const ctrl::Sample& sample){
+    if(!imu_lost){
+        //the last good pose and drive position to carry on from, EZ-Template's pose is inf or nan once it has
+        //read a dropped imu and util::wrap_angle() never returns on inf
+        if(std::isfinite(sample.pose.x) && std::isfinite(sample.pose.y) && std::isfinite(sample.pose.theta)){
+            last_pose = sample.pose;
+        }
+        last_left = sample.left;
+        last_right = sample.right;
+        return;
+    }
+    double width = chassis.drive_width_get();
+    if(width <= 0){
+        return;
+    }
+    double left = sample.left - last_left;
+    double right = sample.right - last_right;
+    last_left = sample.left;
+    last_right = sample.right;
+    //turning right (clockwise, positive) moves the left side forward relative to the right
+    double turned = (left - right) / width;
+    double forward = (left + right) / 2;
+    double heading = util::to_rad(last_pose.theta) + turned / 2;
+    last_pose.x += forward * std::sin(heading);
+    last_pose.y += forward * std::cos(heading);
+    last_pose.theta += util::to_deg(turned);
+    chassis.odom_pose_set(last_pose);
+}
+
+namespace health{
+    void add(const char* name, int port, Role role){
+        Device device;
+        device.name = name;
+        device.port = std::abs(port);
+        device.role = role;
+        devices.push_back(device);
+    }
+
+    void check(const ctrl::Sample& sample){
+        TRACE_SPAN("health");
+        //a dropped imu reads PROS_ERR_F, that is caught the same tick without waiting for the sweep
+        for(Device& device : devices){
+            if(device.role == IMU && std::isinf(sample.imu)){
+                update(device, false);
+            }
+        }
+
+        if(++ticks >= CHECK_TICKS){
+            ticks = 0;
+            for(Device& device : devices){
+                update(device, pros::Device::get_plugged_type(device.port) == expected_type(device.role));
+            }
+        }
+
+        odom_handover();
+        drive_tracking(sample);
+    }
+
+    void on_fault(std::function<void(const Device&)> callback){
+        fault_callback = callback;
+    }
+
+    bool ok(int port){
+        for(const Device& device : devices){
+            if(device.port == std::abs(port)){
+                return device.ok;
+            }
+        }
+        return true;
+    }
+
+    bool imu_degraded(){
+        return imu_lost;
+    }
+
+    int count(){
+        return devices.size();
+    }
+
+    Device get(int index){
+        if(index < 0 || index >= count()){
+            return Device();
+        }
+        return devices[index];
+    }
+}
@@ -1,22 +1,133 @@
 #include "intake.hpp"
+#include <cmath>
+#include <cstdio>
+#include "balls.hpp"
+#include "driver.hpp"
+#include "mech.hpp"
 #include "pros/misc.h"
 
 bool intake_type = true;
+static bool middle_mode = false;
+static bool low_mode = false;
 void intake_opcontrol(){
-    if(master.get_digital(pros::E_CONTROLLER_DIGITAL_R1)){
-        intake.move(127);
-        outtake.move(intake_type ? 0 : Middle.get() ? -127 : 127);
-    }else if(master.get_digital(pros::E_CONTROLLER_DIGITAL_R2)){
-        intake.move(-127);
-        outtake.move(-127);
+    if(driver::held(pros::E_CONTROLLER_DIGITAL_R1)){
+        intake_type ? mech::load() : middle_mode ? mech::score_middle() : mech::score_long();
+    }else if(driver::held(pros::E_CONTROLLER_DIGITAL_R2)){
+        low_mode ? mech::score_low() : mech::unload();
     }else{
-        intake.move(0);
-        outtake.move(0);
+        mech::stop();
     }
-    Middle.button_toggle(master.get_digital_new_press(pros::E_CONTROLLER_DIGITAL_DOWN));
-    Wing.button_toggle(master.get_digital_new_press(pros::E_CONTROLLER_DIGITAL_L1));
-    MatchLoad.button_toggle(master.get_digital_new_press(pros::E_CONTROLLER_DIGITAL_L2));
-    LowScore.button_toggle(master.get_digital_new_press(pros::E_CONTROLLER_DIGITAL_RIGHT));
+    //Middle and LowScore are moved by the ball path when it scores there, the buttons pick where R1 and R2 go
+    if(driver::pressed(pros::E_CONTROLLER_DIGITAL_DOWN)) middle_mode = !middle_mode;
+    if(driver::pressed(pros::E_CONTROLLER_DIGITAL_RIGHT)) low_mode = !low_mode;
+    if(driver::pressed(pros::E_CONTROLLER_DIGITAL_L1)) mech::wing(!mech::wing_get());
+    if(driver::pressed(pros::E_CONTROLLER_DIGITAL_L2)) mech::matchload(!mech::matchload_get());
 
-    master.get_digital_new_press(pros::E_CONTROLLER_DIGITAL_B) ? intake_type = !intake_type : intake_type = intake_type;
-}
\ No newline at end of file
+    driver::pressed(pros::E_CONTROLLER_DIGITAL_B) ? intake_type = !intake_type : intake_type = intake_type;
+}
+
+//full speed the way the rollers always ran at 127 until they are tuned with rollers::tune()
+static rollers::Profile profiles[] = {
+    {0, 0},         // STOP
+    {600, 0},       // INTAKE
+    {600, 600},     // LONG_GOAL
+    {600, -600},    // MIDDLE_GOAL
+    {-600, -600}    // LOW_SCORE
+};
+static rollers::Action current = rollers::STOP;
+
+//loading holds balls against the stopped outtake, so only the actions that move balls through look for jams
+static bool passes(rollers::Action action){
+    return action == rollers::LONG_GOAL || action == rollers::MIDDLE_GOAL || action == rollers::LOW_SCORE;
+}
+
+//hold a speed, or coast on 0
+static void run(Roller& roller, double rpm){
+    if(rpm == 0){
+        roller.move(0);
+    }else{
+        roller.move_velocity(rpm);
+    }
+}
+
+namespace rollers{
+    void set(Action action){
+        current = action;
+        intake.jam_arm(passes(action));
+        outtake.jam_arm(passes(action));
+        run(intake, profiles[action].intake_rpm);
+        run(outtake, profiles[action].outtake_rpm);
+    }
+
+    Action get(){
+        return current;
+    }
+
+    void profile_set(Action action, Profile profile){
+        profiles[action] = profile;
+    }
+
+    Profile profile_get(Action action){
+        return profiles[action];
+    }
+
+    Profile tune(Action action, int window_ms, double rpm_low, double rpm_step){
+        Profile start = profiles[action];
+        double peak = std::fmax(std::fabs(start.intake_rpm), std::fabs(start.outtake_rpm));
+        if(peak == 0 || rpm_step <= 0){
+            return start;
+        }
+
+        Profile best = start;
+        double best_rate = 0;
+        printf("tuning %s, %i ms a speed\n", action_to_string(action), window_ms);
+        for(double rpm = rpm_low; rpm <= MAX_RPM; rpm += rpm_step){
+            //the same split between the rollers, only faster or slower
+            Profile candidate = {start.intake_rpm / peak * rpm, start.outtake_rpm / peak * rpm};
+            profiles[action] = candidate;
+            set(action);
+            pros::delay(2 * Roller::SPINUP_MS);
+
+            int scored = balls::scored();
+            int jams = intake.get_jams() + outtake.get_jams();
+            pros::delay(window_ms);
+            double rate = (balls::scored() - scored) / (window_ms / 1000.0);
+            bool jammed = intake.get_jams() + outtake.get_jams() != jams;
+
+            printf("  %4.0f rpm  %4.0f / %4.0f  %.2f balls/s%s\n", rpm, candidate.intake_rpm, candidate.outtake_rpm, rate, jammed ? "  jammed" : "");
+            ez::screen_print(std::string(action_to_string(action)) + " " + ez::util::to_string_with_precision(rpm, 0) + " rpm: " +
+                             ez::util::to_string_with_precision(rate) + " balls/s" + (jammed ? " jammed" : ""), 5);
+            if(!jammed && rate > best_rate){
+                best = candidate;
+                best_rate = rate;
+            }
+        }
+        set(STOP);
+
+        profiles[action] = best;
+        if(best_rate == 0){
+            printf("no balls were scored without a jam, %s was left as it was\n", action_to_string(action));
+        }else{
+            printf("%.2f balls/s, keep it with\n", best_rate);
+            printf("  rollers::profile_set(rollers::%s, {%.0f, %.0f});\n", action_to_string(action), best.intake_rpm, best.outtake_rpm);
+        }
+        ez::screen_print("best " + ez::util::to_string_with_precision(best_rate) + " balls/s at " + ez::util::to_string_with_precision(best.intake_rpm, 0) +
+                         " / " + ez::util::to_string_with_precision(best.outtake_rpm, 0), 6);
+        return best;
+    }
+
+    const char* action_to_string(Action action){
+        switch(action){
+            case INTAKE:
+                return "INTAKE";
+            case LONG_GOAL:
+                return "LONG_GOAL";
+            case MIDDLE_GOAL:
+                return "MIDDLE_GOAL";
+            case LOW_SCORE:
+                return "LOW_SCORE";
+            default:
+                return "STOP";
+        }
+    }
+}
@@ -0,0 +1,92 @@
+#include "machine.hpp"
+#include "trace.hpp"
+
+Machine::Machine(const char* name, int initial) : name(name){
+    requested = initial;
+    state = initial;
+    entered = 0;
+}
+
+void Machine::state_add(int state, const char* name, std::uint32_t min_ms, std::function<void()> enter){
+    if(state < 0){
+        return;
+    }
+    if(state >= int(states.size())){
+        states.resize(state + 1);
+    }
+    states[state] = {name, min_ms, enter};
+}
+
+void Machine::transition_add(int from, int request, int to, std::function<bool()> guard){
+    transitions.push_back({from, request, to, guard});
+}
+
+void Machine::request(int state){
+    requested = state;
+}
+
+int Machine::get_request(){
+    return requested;
+}
+
+int Machine::get_state(){
+    return state;
+}
+
+const char* Machine::get_state_name(){
+    int now = state;
+    return now < int(states.size()) ? states[now].name : "";
+}
+
+const char* Machine::get_name(){
+    return name;
+}
+
+std::uint32_t Machine::get_entered(){
+    return entered;
+}
+
+void Machine::on_change(std::function<void(int from, int to)> callback){
+    change_callback = callback;
+}
+
+void Machine::enter(int to, std::uint32_t now_ms){
+    int from = state;
+    //the state just left, on a track of its own next to the control loop's
+    if(started && from != to && from < int(states.size())){
+        trace::record_on(name, states[from].name, std::uint64_t(entered) * 1000, std::uint64_t(now_ms) * 1000);
+    }
+    state = to;
+    entered = now_ms;
+    if(to < int(states.size()) && states[to].enter != nullptr){
+        states[to].enter();
+    }
+    if(change_callback != nullptr && from != to){
+        change_callback(from, to);
+    }
+}
+
+void Machine::tick(std::uint32_t now_ms){
+    //the first tick puts the mechanism in its initial state
+    if(!started){
+        started = true;
+        enter(state, now_ms);
+        return;
+    }
+
+    int now = state;
+    int wanted = requested;
+    if(now == wanted){
+        return;
+    }
+    if(now < int(states.size()) && now_ms - entered < states[now].min_ms){
+        return;
+    }
+    for(const Transition& transition : transitions){
+        if((transition.from == ANY || transition.from == now) && (transition.request == ANY || transition.request == wanted) &&
+           transition.to != now && (transition.guard == nullptr || transition.guard())){
+            enter(transition.to, now_ms);
+            return;
+        }
+    }
+}
@@ -1,6 +1,19 @@
 #include "main.h"
+#include "alloc.hpp"
 #include "autons.hpp"
+#include "air.hpp"
+#include "balls.hpp"
+#include "driver.hpp"
+#include "mech.hpp"
 #include "dsr.hpp"
+#include "control_loop.hpp"
+#include "tasks.hpp"
+#include "health.hpp"
+#include "profiler.hpp"
+#include "replay.hpp"
+#include "stream.hpp"
+#include "telemetry.hpp"
+#include "trace.hpp"
 
 /////
 // For installation, upgrading, documentations, and tutorials, check out our website!
@@ -8,7 +21,7 @@
 /////
 
 // Chassis constructor
-ez::Drive chassis(
+Chassis chassis(
     // These are your drive motors, the first motor is used for sensing!
     {-11, -12, 13},     // Left Chassis Ports (negative port will reverse it!)
     {-18, 19, 20},  // Right Chassis Ports (negative port will reverse it!)
@@ -50,6 +63,7 @@ void initialize() {
   //  - change `left` to `right` if the tracking wheel is to the right of the centerline
   //  - ignore this if you aren't using a vertical tracker
   chassis.odom_tracker_left_set(&vert_tracker);
+  chassis.drive_width_set(11.5_in);  // Center to center of the drive wheels, health tracks from the drive motors with it if the imu drops
 
   // Configure your chassis controls
   chassis.opcontrol_curve_buttons_toggle(true);   // Enables modifying the controller curve with buttons on the joysticks
@@ -79,17 +93,85 @@ void initialize() {
       {"dont do anything", dont_do_anything},
       {"Measure Offsets\n\nThis will turn the robot a bunch of times and calculate your offsets for your tracking wheels.", measure_offsets},
       {"Measure DSR offsets", measure_dsr_offsets},
+      {"Tune long goal rollers\n\nFace the long goal and keep feeding balls, it finds the most balls per second.", tune_long_goal},
+      {"Tune middle goal rollers\n\nFace the middle goal and keep feeding balls, it finds the most balls per second.", tune_middle_goal},
     });
 
   // Initialize chassis and auton selector
   chassis.initialize();
   ez::as::initialize();
+  if (pros::usd::is_installed()) {
+    chassis.paths.load("/usd/paths.bin");        // Pure pursuit paths saved after the last auton
+  }
+  warm_paths();                                  // Then any the autons added since, so motions only look them up
+  tasks::adopt("ez_auto", chassis.ez_auto, tasks::PRIORITY_EZ);  // Odom and PID run above opcontrol and the screen
   master.rumble(chassis.drive_imu_calibrated() ? "." : "---");
   // Add your distance sensors
   DSR::add_sensor(D1);
   DSR::add_sensor(D2);
   DSR::add_sensor(D3);
   DSR::add_sensor(D4);
+
+  // Watch every smart port, the control loop checks them and switches to fallbacks
+  for (pros::Motor& motor : chassis.left_motors) health::add("left drive", motor.get_port(), health::DRIVE_MOTOR);
+  for (pros::Motor& motor : chassis.right_motors) health::add("right drive", motor.get_port(), health::DRIVE_MOTOR);
+  health::add("imu", chassis.imu.get_port(), health::IMU);
+  health::add("horiz tracker", horiz_tracker.smart_encoder.get_port(), health::TRACKER_BACK);
+  health::add("vert tracker", vert_tracker.smart_encoder.get_port(), health::TRACKER_LEFT);
+  health::add("D1", D1.get_port(), health::DISTANCE);
+  health::add("D2", D2.get_port(), health::DISTANCE);
+  health::add("D3", D3.get_port(), health::DISTANCE);
+  health::add("D4", D4.get_port(), health::DISTANCE);
+  health::add("intake", intake.motor.get_port(), health::ROLLER);
+  health::add("outtake", outtake.motor.get_port(), health::ROLLER);
+  health::add("ball sensor", ball_sensor.get_port(), health::OPTICAL);
+
+  // Roller jams: over mA and under rpm for detect ms, then back out for ms at voltage, jams in a row before giving up
+  intake.jam_set(2000, 20, 60, 150, 100, 3);
+  outtake.jam_set(2000, 20, 60, 150, 100, 3);
+
+  // Roller velocity control: kv, ks, kp, ki, kd, the speeds of each action are in intake.cpp
+  intake.velocity_constants_set(127.0 / 600, 3, 0.1, 0.5, 0);
+  outtake.velocity_constants_set(127.0 / 600, 3, 0.1, 0.5, 0);
+
+  // Ball tracking, balls of the other alliance's color are thrown out, pick it in competition_initialize()
+  balls::eject_set(balls::OUTTAKE_REVERSE);
+  if (pros::usd::is_installed()) {
+    balls::alliance_load("/usd/alliance.txt");   // The color picked before the last restart
+  }
+  balls::start();
+
+  // Air: tank in^3, pumped psi, leak psi/min, then each piston's bore, stroke and rod in inches, measure them on the robot
+  air::tank_set(12.2, 100, 0.5);
+  air::add("Middle", Middle, 0.375, 2, 0.125);
+  air::add("Wing", Wing, 0.375, 2, 0.125);
+  air::add("MatchLoad", MatchLoad, 0.375, 2, 0.125, 2);
+  air::add("LowScore", LowScore, 0.375, 1, 0.125);
+  air::on_warning([](air::Warning warning, double psi) {
+    telemetry::event(telemetry::AIR, warning, psi, air::predict(air::WARN_S));
+    master.rumble(warning == air::TOO_LOW ? "---" : "-");  // Called from the control loop, rumble doesn't wait
+  });
+
+  // Mechanisms run as state machines in the control loop, autons and opcontrol post requests to them
+  mech::start();
+
+  // Routes recorded in opcontrol with UP, every one on the sd card is added to the auton selector
+  replay::start();
+
+  // Binary log of every run to /usd/tlm_<n>.bin, the file is made full size here so the match never waits on the sd card
+  telemetry::start();
+
+  // Live binary channels on the serial link instead of pid_print_toggle's text, read them with sim/build/decode
+  // stream::start(stream::POSE | stream::PID, 20);
+
+  // Start the control loop, everything it senses and actuates has to be added above
+  ctrl::add_roller(intake);
+  ctrl::add_roller(outtake);
+  ctrl::start();
+
+  // Count heap allocations by task from here on, the control loop and EZ's odom and PID must not make any, see alloc.hpp
+  alloc::hot(chassis.ez_auto);
+  alloc::mode_set(alloc::FLAG);
 }
 
 /**
@@ -99,7 +181,9 @@ void initialize() {
  */
 
 void disabled() {
-  // . . .
+  replay::stop();  // A replay auton cut off by the field would otherwise keep driving
+  prof::end();     // Saves the profile of an auton that was cut off by the field
+  telemetry::flush();
 }
 
 /**
@@ -112,7 +196,26 @@ void disabled() {
  * starts.
  */
 void competition_initialize() {
-  // . . .
+  warm_paths();  // Only builds the paths that aren't cached yet, like ones whose constants changed
+
+  // Pick the alliance with the controller while the selector is up, LEFT red, RIGHT blue, DOWN keeps every ball
+  ez::screen_print(std::string("alliance: ") + balls::color_to_string(balls::alliance_get()), 7);
+  while (true) {
+    driver::read();
+    balls::Color picked = balls::alliance_get();
+    if (driver::pressed(DIGITAL_LEFT)) picked = balls::RED;
+    if (driver::pressed(DIGITAL_RIGHT)) picked = balls::BLUE;
+    if (driver::pressed(DIGITAL_DOWN)) picked = balls::NONE;
+    if (picked != balls::alliance_get()) {
+      balls::alliance_set(picked);
+      if (pros::usd::is_installed()) {
+        balls::alliance_save("/usd/alliance.txt");
+      }
+      ez::screen_print(std::string("alliance: ") + balls::color_to_string(picked), 7);
+      master.rumble(picked == balls::RED ? "." : picked == balls::BLUE ? ".." : "-");
+    }
+    pros::delay(driver::PERIOD_MS);
+  }
 }
 
 /**
@@ -127,6 +230,7 @@ void competition_initialize() {
  * from where it left off.
  */
 void autonomous() {
+  air::reset();                               // The tank is pumped before every match
   chassis.pid_targets_reset();                // Resets PID targets to 0
   chassis.drive_imu_reset();                  // Reset gyro position to 0
   chassis.drive_sensor_reset();               // Reset drive sensors to 0
@@ -146,7 +250,20 @@ void autonomous() {
   to be consistent
   */
 
+  const char* name = ez::as::auton_selector.Autons[ez::as::auton_selector.auton_page_current].Name.c_str();
+  telemetry::begin(name);                        // Starts a run in the log, with the calibration in its header
+  trace::start();                                // Records what every task does, see trace.hpp
+  prof::begin(name);                             // Times every motion and delay of the auton
   ez::as::auton_selector.selected_auton_call();  // Calls selected auton from autonomous selector
+  prof::end();                                   // Writes /usd/profile.csv and ranks the steps by slack
+  trace::stop();
+  if (pros::usd::is_installed()) {
+    trace::save("/usd/trace.bin");               // sim/build/timeline turns it into a Chrome/Perfetto trace
+    if (chassis.paths.changed()) {
+      chassis.paths.save("/usd/paths.bin");      // Loaded in initialize() next boot
+    }
+  }
+  telemetry::flush();
 }
 
 /**
@@ -168,6 +285,8 @@ void screen_print_tracker(ez::tracking_wheel *tracker, std::string name, int lin
  * and will help you debug problems you're having
  */
 void ez_screen_task() {
+  // Lowest priority in the project so printing never delays odom or PID
+  int screen_task = tasks::add("ez screen", tasks::PRIORITY_DISPLAY, 50);
   while (true) {
     // Only run this when not connected to a competition switch
     if (!pros::competition::is_connected()) {
@@ -188,8 +307,9 @@ void ez_screen_task() {
           screen_print_tracker(chassis.odom_tracker_front, "f", 7);
         }
         if(ez::as::page_blank_is_on(1)){
+          // Use what the control loop already read, blocking here would hold the screen task up
           for(unsigned int i = 0; i < DSR::sensors.size(); i++){
-            ez::screen_print(DSR::sensors[i].get_dir_string() + " sensor: " + util::to_string_with_precision(DSR::sensors[i].read_raw_in(10)) + " norm: " + util::to_string_with_precision(DSR::sensors[i].read(10)), 1 + int(i));
+            ez::screen_print(DSR::sensors[i].get_dir_string() + " sensor: " + util::to_string_with_precision(DSR::sensors[i].get_sensed_in()) + " norm: " + util::to_string_with_precision(DSR::sensors[i].read_sensed()), 1 + int(i));
           }
         }
         if(ez::as::page_blank_is_on(2)){
@@ -197,6 +317,51 @@ void ez_screen_task() {
             ez::screen_print(DSR::sensors[i].get_dir_string() +  "offset x: " + util::to_string_with_precision(DSR::sensors[int(i)].get_x_offset()) + " offset y: " + util::to_string_with_precision(DSR::sensors[int(i)].get_y_offset()), 1 + int(i));
           }
         }
+        if(ez::as::page_blank_is_on(3)){
+          // Last auton's steps with the most slack first, the full run is in /usd/profile.csv
+          ez::screen_print(std::string(prof::auton()) + " " + std::to_string(prof::total()) + "ms, slack " + std::to_string(prof::total_slack()) + "ms", 1);
+          for(int i = 0; i < 6; i++){
+            prof::Step step = prof::ranked(i);
+            std::string line = "";
+            if(step.slack > 0){
+              line = std::to_string(step.slack) + "/" + std::to_string(step.end - step.start) + "ms " + step.label + " " + step.call + " " + step.exit;
+            }
+            ez::screen_print(line, 2 + i);
+          }
+        }
+        if(ez::as::page_blank_is_on(4)){
+          // Each registered task's share of the brain, run time this/worst in us, misses and overruns (!)
+          ez::screen_print("cpu " + util::to_string_with_precision(tasks::cpu_total(), 1) + "%, the rest is EZ, PROS and idle", 1);
+          for(int i = 0; i < tasks::count() && i < 6; i++){
+            tasks::Stats stats = tasks::get(i);
+            std::string line = std::string(stats.overruns > 0 ? "! " : "") + stats.name + " " + util::to_string_with_precision(stats.cpu, 1) + "%";
+            if(stats.period > 0){
+              line += " " + std::to_string(stats.last_run) + "/" + std::to_string(stats.worst_run) + "us of " + std::to_string(stats.period) + "ms, " +
+                      std::to_string(stats.misses) + " missed, " + std::to_string(stats.overruns) + " over";
+            }
+            ez::screen_print(line, 2 + i);
+          }
+        }
+        if(ez::as::page_blank_is_on(5)){
+          // Heap allocations by task since initialize, a hot task allocating at all is a violation (!)
+          alloc::Violation last = alloc::last_violation();
+          ez::screen_print(std::to_string(alloc::allocations()) + " allocs, " + std::to_string(alloc::violations()) + " violations " + last.task + " " + last.region, 1);
+          for(int i = 0; i < alloc::task_count() && i < 6; i++){
+            alloc::Counts counts = alloc::task(i);
+            ez::screen_print(std::string(counts.violations > 0 ? "! " : "") + counts.name + (counts.hot ? " (hot) " : " ") + std::to_string(counts.allocations) + " allocs " +
+                             std::to_string(counts.bytes) + " bytes", 2 + i);
+          }
+        }
+        if(ez::as::page_blank_is_on(6)){
+          // Air left in the tank, worked out from every piston move since it was last pumped
+          ez::screen_print(util::to_string_with_precision(air::pressure(), 1) + " psi, " + std::to_string(air::moves_left()) + " moves left, warning " +
+                           air::warning_to_string(air::warning()), 1);
+          for(int i = 0; i < air::count() && i < 6; i++){
+            air::Cylinder cylinder = air::get(i);
+            ez::screen_print(std::string(cylinder.name) + " " + std::to_string(cylinder.extends) + " out " + std::to_string(cylinder.retracts) + " in, " +
+                             util::to_string_with_precision(cylinder.used, 1) + " in^3", 2 + i);
+          }
+        }
       }
     }
 
@@ -206,10 +371,10 @@ void ez_screen_task() {
         ez::as::page_blank_remove_all();
     }
 
-    pros::delay(ez::util::DELAY_TIME);
+    tasks::wait(screen_task);
   }
 }
-pros::Task ezScreenTask(ez_screen_task);
+pros::Task ezScreenTask(ez_screen_task, tasks::PRIORITY_DISPLAY, TASK_STACK_DEPTH_DEFAULT, "ez screen");
 
 /**
  * Gives you some extras to run in your opcontrol:
@@ -217,6 +382,7 @@ pros::Task ezScreenTask(ez_screen_task);
  *   - to prevent this from accidentally happening at a competition, this
  *     is only enabled when you're not connected to competition control.
  * - gives you a GUI to change your PID values live by pressing X
+ * - records a route to replay as an auton by pressing UP
  */
 void ez_template_extras() {
   // Only run this when not connected to a competition switch
@@ -228,14 +394,26 @@ void ez_template_extras() {
     //  When enabled:
     //  * use A and Y to increment / decrement the constants
     //  * use the arrow keys to navigate the constants
-    if (master.get_digital_new_press(DIGITAL_X))
+    if (driver::pressed(DIGITAL_X))
       chassis.pid_tuner_toggle();
 
+    // Record a route to replay as an auton, UP starts and stops it
+    // - it is saved to the sd card and added to the auton selector when it stops
+    if (driver::pressed(DIGITAL_UP)) {
+      replay::record_toggle();
+      master.rumble(replay::recording() ? "-" : "..");
+    }
+
     // Trigger the selected autonomous routine
     
 
-    // Allow PID Tuner to iterate
-    chassis.pid_tuner_iterate();
+    // Allow PID Tuner to iterate, EZ-Template counts held buttons in DELAY_TIME steps so it only runs that often
+    static std::uint32_t tuner_iterated = 0;
+    std::uint32_t ms = driver::get().time / 1000;
+    if (ms - tuner_iterated >= ez::util::DELAY_TIME) {
+      tuner_iterated = ms;
+      chassis.pid_tuner_iterate();
+    }
   }
 
   // Disable PID Tuner when connected to a comp switch
@@ -259,21 +437,35 @@ void ez_template_extras() {
  * task, not resume it from where it left off.
  */
 void opcontrol() {
+  replay::stop();  // A replay auton still playing when opcontrol starts would fight the driver
+
   // This is preference to what you like to drive on
   chassis.drive_brake_set(MOTOR_BRAKE_COAST);
+  if (!pros::competition::is_connected()) {
+    air::reset();  // Pumped before practice, in a match the tank carries over from autonomous
+  }
+  prof::end();  // Saves the profile of an auton that was cut off by the field
+  telemetry::begin("opcontrol");
 
+  int opcontrol_task = tasks::add("opcontrol", tasks::PRIORITY_USER, driver::PERIOD_MS);
   while (true) {
+    driver::read();  // Every button and stick this iteration comes from this one read
+
     // Gives you some extras to make EZ-Template ezier
     ez_template_extras();
-    if (master.get_digital(DIGITAL_A) && master.get_digital(DIGITAL_LEFT)) {
+    if (driver::held(DIGITAL_A) && driver::held(DIGITAL_LEFT)) {
       pros::motor_brake_mode_e_t preference = chassis.drive_brake_get();
+      tasks::pause(opcontrol_task);   // The loop stops while the auton runs, that isn't starving
       autonomous();
+      tasks::resume(opcontrol_task);
       chassis.drive_brake_set(preference);
+      driver::outputs_reset();
     }
     // chassis.opcontrol_tank();  // Tank control
     // chassis.opcontrol_arcade_standard(ez::SPLIT);   // Standard split arcade
     // chassis.opcontrol_arcade_standard(ez::SINGLE);  // Standard single arcade
-    chassis.opcontrol_arcade_flipped(ez::SPLIT);    // Flipped split arcade
+    // chassis.opcontrol_arcade_flipped(ez::SPLIT);    // Flipped split arcade
+    driver::arcade_flipped();  // Flipped split arcade from the curve tables, only writes the drive when it changes
     // chassis.opcontrol_arcade_flipped(ez::SINGLE);   // Flipped single arcade
 
     // . . .
@@ -281,6 +473,6 @@ void opcontrol() {
     // . . .
     intake_opcontrol();
 
-    pros::delay(ez::util::DELAY_TIME);  // This is used for timer calculations!  Keep this ez::util::DELAY_TIME
+    tasks::wait(opcontrol_task);  // Waits out the rest of driver::PERIOD_MS
   }
 }
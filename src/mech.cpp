@@ -0,0 +1,175 @@
+#include "mech.hpp"
+#include "air.hpp"
+#include "intake.hpp"
+#include "subsystems.hpp"
+
+enum Stroke{
+    RETRACTED = 0,
+    EXTENDED = 1
+};
+
+static Machine path_machine("ball path", mech::IDLE);
+static Machine wing_state("wing", RETRACTED);
+static Machine matchload_state("matchload", RETRACTED);
+
+//time of the tick being run and the last time Middle or LowScore was moved
+static std::uint32_t tick_ms = 0;
+static std::uint32_t pistons_moved = 0;
+
+static void pistons_set(bool middle, bool low){
+    if(Middle.get() != middle || LowScore.get() != low){
+        pistons_moved = tick_ms;
+    }
+    air::set(Middle, middle);
+    air::set(LowScore, low);
+}
+
+//both in and done moving, so balls can go any way
+static bool closed(){
+    return !Middle.get() && !LowScore.get() && tick_ms - pistons_moved >= mech::PISTON_MS;
+}
+
+static void path_setup(){
+    using namespace mech;
+    Machine& m = path_machine;
+    m.state_add(IDLE, "idle", DWELL_MS, [](){
+        pistons_set(false, false);
+        rollers::set(rollers::STOP);
+    });
+    m.state_add(LOAD, "load", DWELL_MS, [](){
+        pistons_set(false, false);
+        rollers::set(rollers::INTAKE);
+    });
+    m.state_add(LOAD_LOW, "load open low", PISTON_MS, [](){
+        pistons_set(false, true);
+        rollers::set(rollers::INTAKE);
+    });
+    m.state_add(SCORE_LONG, "score long", DWELL_MS, [](){
+        rollers::set(rollers::LONG_GOAL);
+    });
+    m.state_add(OPEN_MIDDLE, "open middle", MIDDLE_OPEN_MS, [](){
+        pistons_set(true, false);
+        intake.jam_arm(true);
+        outtake.jam_arm(true);
+        intake.move_velocity(MIDDLE_BACKOFF_RPM);
+        outtake.move_velocity(rollers::profile_get(rollers::MIDDLE_GOAL).outtake_rpm);
+    });
+    m.state_add(SCORE_MIDDLE, "score middle", DWELL_MS, [](){
+        rollers::set(rollers::MIDDLE_GOAL);
+    });
+    m.state_add(OPEN_LOW, "open low", PISTON_MS, [](){
+        pistons_set(false, true);
+        rollers::set(rollers::STOP);
+    });
+    m.state_add(SCORE_LOW, "score low", DWELL_MS, [](){
+        rollers::set(rollers::LOW_SCORE);
+    });
+    m.state_add(UNLOAD, "unload", DWELL_MS, [](){
+        rollers::set(rollers::LOW_SCORE);
+    });
+    m.state_add(CLOSING, "closing", PISTON_MS, [](){
+        pistons_set(false, false);
+        rollers::set(rollers::STOP);
+    });
+
+    //stopping and loading never push balls at a piston, they close them on the way in or open LowScore to score low next
+    m.transition_add(Machine::ANY, IDLE, IDLE);
+    m.transition_add(Machine::ANY, LOAD, LOAD);
+    m.transition_add(Machine::ANY, LOAD_LOW, LOAD_LOW);
+
+    //the rest send balls one way, the pistons for every other way have to be in first
+    m.transition_add(Machine::ANY, SCORE_LONG, SCORE_LONG, closed);
+    m.transition_add(Machine::ANY, SCORE_LONG, CLOSING);
+    m.transition_add(Machine::ANY, UNLOAD, UNLOAD, closed);
+    m.transition_add(Machine::ANY, UNLOAD, CLOSING);
+    m.transition_add(OPEN_MIDDLE, SCORE_MIDDLE, SCORE_MIDDLE);
+    m.transition_add(Machine::ANY, SCORE_MIDDLE, OPEN_MIDDLE, [](){ return !LowScore.get(); });
+    m.transition_add(Machine::ANY, SCORE_MIDDLE, CLOSING);
+    m.transition_add(OPEN_LOW, SCORE_LOW, SCORE_LOW);
+    m.transition_add(LOAD_LOW, SCORE_LOW, SCORE_LOW);
+    m.transition_add(Machine::ANY, SCORE_LOW, OPEN_LOW, [](){ return !Middle.get(); });
+    m.transition_add(Machine::ANY, SCORE_LOW, CLOSING);
+}
+
+static void piston_setup(Machine& m, ez::Piston& piston){
+    m.state_add(RETRACTED, "in", mech::PISTON_MS, [&piston](){ air::set(piston, false); });
+    m.state_add(EXTENDED, "out", mech::PISTON_MS, [&piston](){ air::set(piston, true); });
+    m.transition_add(Machine::ANY, RETRACTED, RETRACTED);
+    m.transition_add(Machine::ANY, EXTENDED, EXTENDED);
+}
+
+namespace mech{
+    void start(){
+        path_setup();
+        piston_setup(wing_state, Wing);
+        piston_setup(matchload_state, MatchLoad);
+        ctrl::add_subsystem(tick);
+    }
+
+    void tick(const ctrl::Sample& sample){
+        tick_ms = sample.time / 1000;
+        path_machine.tick(tick_ms);
+        wing_state.tick(tick_ms);
+        matchload_state.tick(tick_ms);
+    }
+
+    void stop(){
+        path_machine.request(IDLE);
+    }
+
+    void load(){
+        path_machine.request(LOAD);
+    }
+
+    void load_low(){
+        path_machine.request(LOAD_LOW);
+    }
+
+    void score_long(){
+        path_machine.request(SCORE_LONG);
+    }
+
+    void score_middle(){
+        path_machine.request(SCORE_MIDDLE);
+    }
+
+    void score_low(){
+        path_machine.request(SCORE_LOW);
+    }
+
+    void unload(){
+        path_machine.request(UNLOAD);
+    }
+
+    void wing(bool out){
+        wing_state.request(out ? EXTENDED : RETRACTED);
+    }
+
+    void matchload(bool out){
+        matchload_state.request(out ? EXTENDED : RETRACTED);
+    }
+
+    bool wing_get(){
+        return wing_state.get_request() == EXTENDED;
+    }
+
+    bool matchload_get(){
+        return matchload_state.get_request() == EXTENDED;
+    }
+
+    Path get_path(){
+        return Path(path_machine.get_state());
+    }
+
+    Machine& path(){
+        return path_machine;
+    }
+
+    Machine& wing_machine(){
+        return wing_state;
+    }
+
+    Machine& matchload_machine(){
+        return matchload_state;
+    }
+}
@@ -0,0 +1,393 @@
+#include "path.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include "trace.hpp"
+
+static_assert(sizeof(path::FileHeader) == 20, "the file header is 20 bytes");
+static_assert(sizeof(path::Entry) == 24, "entries are 24 bytes in the file");
+
+//FNV-1a, the fields one at a time so padding never gets in
+static std::uint64_t mix(std::uint64_t hash, const void* data, std::size_t size){
+    const std::uint8_t* bytes = static_cast<const std::uint8_t*>(data);
+    for(std::size_t i = 0; i < size; i++){
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+template <typename Value>
+static std::uint64_t mix(std::uint64_t hash, Value value){
+    return mix(hash, &value, sizeof(value));
+}
+
+static std::uint64_t key(path::Build build, std::span<const ez::odom> waypoints, double spacing, const path::Smoothing& smoothing){
+    std::uint64_t hash = mix(14695981039346656037ull, int(build));
+    if(build != path::RAW){
+        hash = mix(hash, spacing);
+    }
+    if(build == path::SMOOTH){
+        hash = mix(hash, smoothing.weight_smooth);
+        hash = mix(hash, smoothing.weight_data);
+        hash = mix(hash, smoothing.tolerance);
+    }
+    for(const ez::odom& waypoint : waypoints){
+        hash = mix(hash, waypoint.target.x);
+        hash = mix(hash, waypoint.target.y);
+        hash = mix(hash, waypoint.target.theta);
+        hash = mix(hash, int(waypoint.drive_direction));
+        hash = mix(hash, waypoint.max_xy_speed);
+        hash = mix(hash, int(waypoint.turn_behavior));
+    }
+    return hash;
+}
+
+//points from one pose toward a waypoint, the last one is the waypoint itself
+static void inject(std::vector<ez::odom>& points, ez::pose from, const ez::odom& to, int steps, bool last){
+    for(int i = 1; i <= steps; i++){
+        if(i == steps && !last){
+            return;
+        }
+        ez::odom point = to;
+        point.target.x = from.x + (to.target.x - from.x) * i / steps;
+        point.target.y = from.y + (to.target.y - from.y) * i / steps;
+        point.target.theta = i == steps ? to.target.theta : ez::ANGLE_NOT_SET;
+        points.push_back(point);
+    }
+}
+
+namespace path{
+    void Path::reserve(){
+        points.reserve(MAX_POINTS);
+        data.reserve(MAX_POINTS);
+        raw.reserve(MAX_POINTS);
+        ends.reserve(MAX_POINTS);
+        entries.reserve(MAX_CACHED);
+        used.reserve(MAX_CACHED);
+        cached_points.reserve(MAX_CACHED_POINTS);
+        cached_raw.reserve(MAX_CACHED_POINTS);
+        cached_ends.reserve(MAX_CACHED_POINTS);
+    }
+
+    std::size_t Path::capacity() const{
+        return points.capacity() + data.capacity() + raw.capacity() + ends.capacity();
+    }
+
+    const std::vector<ez::odom>& Path::build(Build build, ez::pose start, std::span<const ez::odom> waypoints, double spacing, const Smoothing& smoothing){
+        TRACE_SPAN("path build");
+        std::uint64_t begin = pros::micros();
+        std::size_t before = capacity();
+        if(waypoints.empty()){
+            points.clear();
+            ends.clear();
+            return points;
+        }
+        //copied, the waypoints can be in data and smoothing writes over it
+        ez::odom first = waypoints.front();
+        std::uint64_t hash = key(build, waypoints, spacing, smoothing);
+        int entry = find(hash);
+        bool hit = entry >= 0;
+        int passes = 0;
+        if(hit){
+            times.hits++;
+        }else{
+            times.misses++;
+            passes = body(build, waypoints, spacing, smoothing);
+            entry = store(hash, build);
+        }
+        passes += finish(build, start, first, entry, spacing, smoothing);
+
+        std::uint32_t took = pros::micros() - begin;
+        if(hit){
+            times.hit_worst = std::max(times.hit_worst, took);
+            times.hit_passes = std::max(times.hit_passes, passes);
+        }
+        times.builds++;
+        times.last = took;
+        times.worst = std::max(times.worst, took);
+        times.last_points = points.size();
+        times.most_points = std::max(times.most_points, times.last_points);
+        times.last_passes = passes;
+        times.most_passes = std::max(times.most_passes, passes);
+        if(capacity() != before){
+            times.grown++;
+        }
+        return points;
+    }
+
+    const std::vector<ez::odom>& Path::build(Build build, ez::pose start, std::span<const ez::united_odom> waypoints, double spacing, const Smoothing& smoothing){
+        //data holds the waypoints until smoothing needs it
+        data.clear();
+        for(const ez::united_odom& waypoint : waypoints){
+            data.push_back(ez::util::united_odom_to_odom(waypoint));
+        }
+        return this->build(build, start, std::span<const ez::odom>(data), spacing, smoothing);
+    }
+
+    bool Path::warm(Build build, std::span<const ez::odom> waypoints, double spacing, const Smoothing& smoothing){
+        if(waypoints.empty()){
+            return true;
+        }
+        std::uint64_t hash = key(build, waypoints, spacing, smoothing);
+        if(find(hash) >= 0){
+            return true;
+        }
+        body(build, waypoints, spacing, smoothing);
+        return store(hash, build) >= 0;
+    }
+
+    bool Path::warm(Build build, std::span<const ez::united_odom> waypoints, double spacing, const Smoothing& smoothing){
+        data.clear();
+        for(const ez::united_odom& waypoint : waypoints){
+            data.push_back(ez::util::united_odom_to_odom(waypoint));
+        }
+        return warm(build, std::span<const ez::odom>(data), spacing, smoothing);
+    }
+
+    int Path::find(std::uint64_t hash){
+        for(std::size_t i = 0; i < entries.size(); i++){
+            if(entries[i].key == hash){
+                used[i] = true;
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    //points injected between the waypoints into path, and the point each waypoint ended up at into ends
+    void Path::injected(std::vector<ez::odom>& path, std::span<const ez::odom> waypoints, double spacing){
+        //a segment gets at most length / spacing points, widen the spacing until every one fits and leaves
+        //a quarter of the path for the way to the first waypoint
+        double length = 0;
+        for(std::size_t i = 1; i < waypoints.size(); i++){
+            length += ez::util::distance_to_point(waypoints[i].target, waypoints[i - 1].target);
+        }
+        int room = MAX_POINTS * 3 / 4 - int(waypoints.size());
+        if(room > 0){
+            spacing = std::max(spacing, length / room);
+        }
+
+        path.clear();
+        ends.clear();
+        path.push_back(waypoints.front());
+        ends.push_back(0);
+        for(std::size_t i = 1; i < waypoints.size(); i++){
+            ez::pose last = waypoints[i - 1].target;
+            int steps = std::max(1, int(ez::util::distance_to_point(waypoints[i].target, last) / spacing));
+            inject(path, last, waypoints[i], steps, true);
+            ends.push_back(path.size() - 1);
+        }
+    }
+
+    int Path::body(Build build, std::span<const ez::odom> waypoints, double spacing, const Smoothing& smoothing){
+        points.clear();
+        ends.clear();
+        if(build == RAW){
+            for(std::size_t i = 0; i < waypoints.size(); i++){
+                points.push_back(waypoints[i]);
+                ends.push_back(i);
+            }
+            return 0;
+        }
+        if(build == INJECT){
+            injected(points, waypoints, spacing);
+            return 0;
+        }
+        //smoothed on its own with the first waypoint pinned, the joint with the way there is smoothed at motion start
+        injected(raw, waypoints, spacing);
+        points.assign(raw.begin(), raw.end());
+        return smooth(smoothing, points.front().target, 1, points.size() - 1);
+    }
+
+    //gradient descent from points toward a path that is both near the injected one in raw and straight, only
+    //the points from first to before last move, from is the pose before the path when first is 0
+    int Path::smooth(const Smoothing& smoothing, ez::pose from, int first, int last){
+        int passes = 0;
+        double change = smoothing.tolerance;
+        while(change >= smoothing.tolerance && passes < MAX_SMOOTH_PASSES && last - first > 0){
+            change = 0;
+            for(int i = first; i < last; i++){
+                const ez::pose& before = i == 0 ? from : points[i - 1].target;
+                ez::pose& point = points[i].target;
+                double x = point.x;
+                double y = point.y;
+                point.x += smoothing.weight_data * (raw[i].target.x - point.x) +
+                           smoothing.weight_smooth * (before.x + points[i + 1].target.x - 2 * point.x);
+                point.y += smoothing.weight_data * (raw[i].target.y - point.y) +
+                           smoothing.weight_smooth * (before.y + points[i + 1].target.y - 2 * point.y);
+                change += std::fabs(x - point.x) + std::fabs(y - point.y);
+            }
+            passes++;
+        }
+        return passes;
+    }
+
+    int Path::store(std::uint64_t hash, Build build){
+        if(int(entries.size()) >= MAX_CACHED || int(cached_points.size() + points.size()) > MAX_CACHED_POINTS ||
+           int(cached_ends.size() + ends.size()) > MAX_CACHED_POINTS){
+            return -1;
+        }
+        Entry entry;
+        entry.key = hash;
+        entry.first = cached_points.size();
+        entry.ends = cached_ends.size();
+        entry.points = points.size();
+        entry.waypoints = ends.size();
+        cached_points.insert(cached_points.end(), points.begin(), points.end());
+        //what the joint is smoothed toward, only smoothed paths differ from it
+        const std::vector<ez::odom>& unsmoothed = build == SMOOTH ? raw : points;
+        cached_raw.insert(cached_raw.end(), unsmoothed.begin(), unsmoothed.end());
+        cached_ends.insert(cached_ends.end(), ends.begin(), ends.end());
+        entries.push_back(entry);
+        used.push_back(true);
+        unsaved = true;
+        times.cached = entries.size();
+        return entries.size() - 1;
+    }
+
+    int Path::finish(Build build, ez::pose start, const ez::odom& first, int entry, double spacing, const Smoothing& smoothing){
+        //the rest of the path goes in data and unsmoothed in raw, from the cache or from building it when the
+        //cache was full
+        if(entry >= 0){
+            const Entry& cached = entries[entry];
+            data.assign(cached_points.begin() + cached.first, cached_points.begin() + cached.first + cached.points);
+            if(build == SMOOTH){
+                raw.assign(cached_raw.begin() + cached.first, cached_raw.begin() + cached.first + cached.points);
+            }
+            ends.assign(cached_ends.begin() + cached.ends, cached_ends.begin() + cached.ends + cached.waypoints);
+        }else{
+            std::swap(points, data);
+        }
+
+        points.clear();
+        if(build != RAW){
+            double length = ez::util::distance_to_point(first.target, start);
+            int room = MAX_POINTS - int(data.size());
+            if(room > 0){
+                spacing = std::max(spacing, length / room);
+            }
+            inject(points, start, first, std::max(1, int(length / spacing)), false);
+        }
+        for(std::uint16_t& end : ends){
+            end += points.size();
+        }
+        if(build != SMOOTH){
+            points.insert(points.end(), data.begin(), data.end());
+            return 0;
+        }
+        //the corner at the first waypoint smoothed like EZ-Template smooths the whole path from the robot, farther
+        //from it the straight way there and the cached body are already what that would give
+        int joint = points.size();
+        raw.insert(raw.begin(), points.begin(), points.end());
+        points.insert(points.end(), data.begin(), data.end());
+        return smooth(smoothing, start, std::max(0, joint - JOINT_POINTS), std::min(int(points.size()) - 1, joint + JOINT_POINTS));
+    }
+
+    int Path::index(int waypoint) const{
+        if(waypoint < 0 || waypoint >= int(ends.size())){
+            return waypoint;
+        }
+        return ends[waypoint];
+    }
+
+    bool Path::save(const char* file){
+        //only what this boot used, so paths that were changed don't pile up in the file
+        FileHeader header;
+        for(std::size_t i = 0; i < entries.size(); i++){
+            if(used[i]){
+                header.entries++;
+                header.points += entries[i].points;
+                header.ends += entries[i].waypoints;
+            }
+        }
+        FILE* out = fopen(file, "wb");
+        if(out == nullptr){
+            return false;
+        }
+        bool ok = fwrite(&header, sizeof(header), 1, out) == 1;
+        Entry written;
+        for(std::size_t i = 0; i < entries.size() && ok; i++){
+            if(used[i]){
+                Entry entry = entries[i];
+                entry.first = written.first;
+                entry.ends = written.ends;
+                written.first += entry.points;
+                written.ends += entry.waypoints;
+                ok = fwrite(&entry, sizeof(entry), 1, out) == 1;
+            }
+        }
+        for(std::size_t i = 0; i < entries.size() && ok; i++){
+            if(used[i]){
+                ok = fwrite(&cached_points[entries[i].first], sizeof(ez::odom), entries[i].points, out) == entries[i].points;
+            }
+        }
+        for(std::size_t i = 0; i < entries.size() && ok; i++){
+            if(used[i]){
+                ok = fwrite(&cached_raw[entries[i].first], sizeof(ez::odom), entries[i].points, out) == entries[i].points;
+            }
+        }
+        for(std::size_t i = 0; i < entries.size() && ok; i++){
+            if(used[i]){
+                ok = fwrite(&cached_ends[entries[i].ends], sizeof(std::uint16_t), entries[i].waypoints, out) == entries[i].waypoints;
+            }
+        }
+        ok &= fclose(out) == 0;
+        if(ok){
+            unsaved = false;
+        }
+        return ok;
+    }
+
+    int Path::load(const char* file){
+        FILE* in = fopen(file, "rb");
+        if(in == nullptr){
+            return 0;
+        }
+        FileHeader header;
+        bool ok = fread(&header, sizeof(header), 1, in) == 1 && std::memcmp(header.magic, "PTH2", 4) == 0 &&
+                  header.point_size == sizeof(ez::odom) && entries.size() + header.entries <= std::size_t(MAX_CACHED) &&
+                  cached_points.size() + header.points <= std::size_t(MAX_CACHED_POINTS) &&
+                  cached_ends.size() + header.ends <= std::size_t(MAX_CACHED_POINTS);
+        std::size_t old_entries = entries.size();
+        std::size_t old_points = cached_points.size();
+        std::size_t old_ends = cached_ends.size();
+        if(ok){
+            entries.resize(old_entries + header.entries);
+            cached_points.resize(old_points + header.points);
+            cached_raw.resize(old_points + header.points);
+            cached_ends.resize(old_ends + header.ends);
+            ok = fread(&entries[old_entries], sizeof(Entry), header.entries, in) == header.entries &&
+                 fread(&cached_points[old_points], sizeof(ez::odom), header.points, in) == header.points &&
+                 fread(&cached_raw[old_points], sizeof(ez::odom), header.points, in) == header.points &&
+                 fread(&cached_ends[old_ends], sizeof(std::uint16_t), header.ends, in) == header.ends;
+        }
+        fclose(in);
+        for(std::size_t i = old_entries; i < entries.size() && ok; i++){
+            Entry& entry = entries[i];
+            ok = entry.first + entry.points <= header.points && entry.ends + entry.waypoints <= header.ends;
+            entry.first += old_points;
+            entry.ends += old_ends;
+        }
+        if(!ok){
+            entries.resize(old_entries);
+            cached_points.resize(old_points);
+            cached_raw.resize(old_points);
+            cached_ends.resize(old_ends);
+            return 0;
+        }
+        //unused until warmed or followed, so a path nothing asks for again is left out of the next save
+        used.resize(entries.size(), false);
+        times.cached = entries.size();
+        return header.entries;
+    }
+
+    bool Path::changed() const{
+        return unsaved || std::find(used.begin(), used.end(), false) != used.end();
+    }
+
+    const Timing& Path::timing() const{
+        return times;
+    }
+}
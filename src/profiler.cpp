@@ -0,0 +1,267 @@
+#include "profiler.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include "subsystems.hpp"
+#include "telemetry.hpp"
+#include "trace.hpp"
+
+static prof::Step steps[prof::MAX_STEPS];
+static int ranks[prof::MAX_STEPS];
+static int step_count = 0;
+static int open_motion = -1;
+static bool recording = false;
+static const char* current_label = "";
+static char auton_name[32] = "";
+static std::uint32_t run_start = 0;
+static std::uint32_t run_end = 0;
+static std::function<void(int, const prof::Step&)> step_callback = nullptr;
+
+//next free step, nullptr once the buffer is full
+static prof::Step* next_step(prof::Kind kind, const char* call, std::uint32_t start){
+    if(step_count >= prof::MAX_STEPS){
+        return nullptr;
+    }
+    prof::Step& step = steps[step_count++];
+    step = prof::Step();
+    step.kind = kind;
+    step.label = current_label;
+    step.call = call;
+    step.start = start;
+    return &step;
+}
+
+static void finish(prof::Step& step, const char* wait, double final_error, const char* exit, std::uint32_t slack){
+    step.wait = wait;
+    step.end = pros::millis();
+    step.final_error = final_error;
+    step.exit = exit;
+    step.slack = slack;
+    step.pose = chassis.odom_pose_get();
+    step.jams = intake.get_jams() + outtake.get_jams();
+    int index = &step - steps;
+    telemetry::event(telemetry::STEP, index, step.kind, step.end - step.start, step.slack, step.target, final_error);
+    telemetry::text(telemetry::STEP, step.call);
+    trace::record(step.call, std::uint64_t(step.start) * 1000, pros::micros());
+    if(step_callback != nullptr){
+        step_callback(index, step);
+    }
+}
+
+//what a roller was told to do, a voltage or an rpm, only ever compared with itself
+static double request(Roller& roller){
+    return roller.is_velocity() ? roller.get_target_velocity() : roller.get_command();
+}
+
+static void write_csv(){
+    if(!pros::usd::is_installed()){
+        return;
+    }
+    FILE* file = fopen("/usd/profile.csv", "a");
+    if(file == nullptr){
+        return;
+    }
+    fseek(file, 0, SEEK_END);
+    if(ftell(file) == 0){
+        fputs("run,auton,index,kind,label,call,wait,exit,start_ms,end_ms,duration_ms,slack_ms,target,final_error,x,y,theta,settled_ms,current_low_ms,balls_stopped_ms,jams\n", file);
+    }
+    for(int i = 0; i < step_count; i++){
+        const prof::Step& step = steps[i];
+        fprintf(file, "%u,%s,%i,%s,%s,%s,%s,%s,%u,%u,%u,%u,%.2f,%.2f,%.2f,%.2f,%.2f,%u,%u,%u,%i\n",
+                unsigned(run_start), auton_name, i, prof::kind_to_string(step.kind), step.label, step.call, step.wait, step.exit,
+                unsigned(step.start - run_start), unsigned(step.end - run_start), unsigned(step.end - step.start), unsigned(step.slack),
+                step.target, step.final_error, step.pose.x, step.pose.y, step.pose.theta,
+                unsigned(step.settled), unsigned(step.current_low), unsigned(step.balls_stopped), step.jams);
+    }
+    fclose(file);
+}
+
+namespace prof{
+    void begin(const char* auton){
+        //names from the auton selector carry a description after a new line, and commas would break the csv
+        int length = 0;
+        for(; auton[length] != '\0' && auton[length] != '\n' && length < int(sizeof(auton_name)) - 1; length++){
+            auton_name[length] = auton[length] == ',' ? ' ' : auton[length];
+        }
+        auton_name[length] = '\0';
+
+        step_count = 0;
+        open_motion = -1;
+        current_label = auton_name;
+        run_start = pros::millis();
+        run_end = run_start;
+        recording = true;
+    }
+
+    void end(){
+        if(!recording){
+            return;
+        }
+        if(open_motion >= 0){
+            finish(steps[open_motion], "", 0, "Unfinished", 0);
+            open_motion = -1;
+        }
+        recording = false;
+        run_end = pros::millis();
+
+        for(int i = 0; i < step_count; i++){
+            ranks[i] = i;
+        }
+        std::stable_sort(ranks, ranks + step_count, [](int a, int b){
+            return steps[a].slack > steps[b].slack;
+        });
+
+        write_csv();
+    }
+
+    bool running(){
+        return recording;
+    }
+
+    void label(const char* name){
+        current_label = name == nullptr ? auton_name : name;
+    }
+
+    void motion_set(const char* call, double target){
+        if(!recording){
+            return;
+        }
+        std::uint32_t now = pros::millis();
+        if(open_motion >= 0){
+            finish(steps[open_motion], "", 0, "Replaced", 0);
+        }
+        Step* step = next_step(MOTION, call, now);
+        open_motion = step == nullptr ? -1 : step_count - 1;
+        if(step != nullptr){
+            step->target = target;
+        }
+    }
+
+    void motion_done(const char* wait, double final_error, const char* exit, std::uint32_t slack){
+        if(!recording || open_motion < 0){
+            return;
+        }
+        finish(steps[open_motion], wait, final_error, exit, slack);
+        open_motion = -1;
+    }
+
+    void wait_until(const char* wait, std::uint32_t start, double final_error){
+        if(!recording){
+            return;
+        }
+        Step* step = next_step(WAIT_UNTIL, wait, start);
+        if(step != nullptr){
+            finish(*step, wait, final_error, "Reached", 0);
+        }
+    }
+
+    void delay(int ms, const char* label){
+        std::uint32_t start = pros::millis();
+        if(!recording){
+            pros::delay(ms);
+            return;
+        }
+
+        //ms into the delay each of them was last seen busy
+        std::uint32_t settled = 0;
+        std::uint32_t current_low = 0;
+        std::uint32_t balls_stopped = 0;
+        Roller* rollers[] = {&intake, &outtake};
+        double fastest[] = {0, 0};
+        double commands[] = {request(intake), request(outtake)};
+        std::uint32_t changed[] = {0, 0};
+        std::uint32_t now = start;
+        while(now - start < std::uint32_t(ms)){
+            pros::delay(std::min<std::uint32_t>(ez::util::DELAY_TIME, start + ms - now));
+            now = pros::millis();
+            std::uint32_t at = now - start;
+            if(std::max(std::abs(chassis.drive_velocity_left()), std::abs(chassis.drive_velocity_right())) > DRIVE_STILL_RPM){
+                settled = at;
+            }
+            for(int i = 0; i < 2; i++){
+                if(rollers[i]->get_current() > ROLLER_LOADED_MA){
+                    current_low = at;
+                }
+                //a new command has a new top speed, and one set right before the delay may still be spinning up or down
+                if(request(*rollers[i]) != commands[i]){
+                    commands[i] = request(*rollers[i]);
+                    changed[i] = at;
+                    fastest[i] = 0;
+                }
+                if(at - changed[i] < ROLLER_SPIN_MS){
+                    continue;
+                }
+                double speed = std::fabs(rollers[i]->get_velocity());
+                fastest[i] = std::max(fastest[i], speed);
+                if(commands[i] != 0 && speed < BALL_SLOWDOWN * fastest[i]){
+                    balls_stopped = at;
+                }
+            }
+        }
+
+        Step* step = next_step(DELAY, "delay", start);
+        if(step != nullptr){
+            if(label != nullptr){
+                step->label = label;
+            }
+            step->target = ms;
+            step->settled = settled;
+            step->current_low = current_low;
+            step->balls_stopped = balls_stopped;
+            std::uint32_t needed = std::max({settled, current_low, balls_stopped});
+            const char* exit = needed == 0 ? "Idle" : needed == balls_stopped ? "Balls" : needed == current_low ? "Current" : "Motion";
+            std::uint32_t elapsed = pros::millis() - start;
+            finish(*step, "delay", 0, exit, elapsed - std::min(elapsed, needed));
+        }
+    }
+
+    void on_step(std::function<void(int index, const Step& step)> callback){
+        step_callback = callback;
+    }
+
+    int count(){
+        return step_count;
+    }
+
+    Step get(int index){
+        if(index < 0 || index >= step_count){
+            return Step();
+        }
+        return steps[index];
+    }
+
+    Step ranked(int rank){
+        if(recording || rank < 0 || rank >= step_count){
+            return Step();
+        }
+        return steps[ranks[rank]];
+    }
+
+    const char* auton(){
+        return auton_name;
+    }
+
+    std::uint32_t total(){
+        return (recording ? pros::millis() : run_end) - run_start;
+    }
+
+    std::uint32_t total_slack(){
+        std::uint32_t slack = 0;
+        for(int i = 0; i < step_count; i++){
+            slack += steps[i].slack;
+        }
+        return slack;
+    }
+
+    const char* kind_to_string(Kind kind){
+        switch(kind){
+            case WAIT_UNTIL:
+                return "Wait until";
+            case DELAY:
+                return "Delay";
+            default:
+                return "Motion";
+        }
+    }
+}
@@ -0,0 +1,262 @@
+#include "replay.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include "driver.hpp"
+#include "mech.hpp"
+#include "profiler.hpp"
+#include "subsystems.hpp"
+
+//the recording being made or played, written by the control loop while recording
+static replay::Frame frames_buffer[replay::MAX_FRAMES];
+static std::atomic<int> frame_count = 0;
+static std::uint16_t frame_period = 0;
+
+static std::atomic<bool> is_recording = false;
+static std::atomic<bool> is_playing = false;
+static bool correcting = true;
+static int play_index = 0;
+static replay::Tracking stats;
+
+//where the robot was when recording or playing started, frames are relative to it
+static ez::pose origin = {0, 0, 0};
+
+//the mechanism requests last sent while playing, -1 before the first frame
+static int sent_path = -1;
+static int sent_pistons = -1;
+
+static std::string slot_path(int slot){
+    return "/usd/replay_" + std::to_string(slot) + ".bin";
+}
+
+//pose relative to the origin, with the origin facing +y
+static ez::pose relative(const ez::pose& pose){
+    double a = util::to_rad(origin.theta);
+    double dx = pose.x - origin.x;
+    double dy = pose.y - origin.y;
+    return {dx * std::cos(a) - dy * std::sin(a), dx * std::sin(a) + dy * std::cos(a), util::wrap_angle(pose.theta - origin.theta)};
+}
+
+static std::int16_t hundredths(double value){
+    return std::int16_t(std::clamp(std::round(value * 100), -32768.0, 32767.0));
+}
+
+static void record_frame(const ctrl::Sample& sample){
+    int i = frame_count;
+    if(i >= replay::MAX_FRAMES){
+        is_recording = false;
+        return;
+    }
+    ez::pose pose = relative(sample.pose);
+    replay::Frame& frame = frames_buffer[i];
+    frame.x = hundredths(pose.x);
+    frame.y = hundredths(pose.y);
+    frame.theta = hundredths(pose.theta);
+    frame.left = std::int8_t(std::clamp(driver::left_command(), -127, 127));
+    frame.right = std::int8_t(std::clamp(driver::right_command(), -127, 127));
+    frame.path = std::uint8_t(mech::path().get_request());
+    frame.pistons = (mech::wing_get() ? 1 : 0) | (mech::matchload_get() ? 2 : 0);
+    frame_count = i + 1;
+}
+
+static void play_frame(const ctrl::Sample& sample){
+    if(play_index >= frame_count){
+        ctrl::drive_set(0, 0);
+        is_playing = false;
+        return;
+    }
+    const replay::Frame& frame = frames_buffer[play_index++];
+
+    if(frame.path != sent_path){
+        sent_path = frame.path;
+        mech::path().request(frame.path);
+    }
+    if(frame.pistons != sent_pistons){
+        sent_pistons = frame.pistons;
+        mech::wing(frame.pistons & 1);
+        mech::matchload(frame.pistons & 2);
+    }
+
+    //error to the recorded pose, in the robot's frame
+    ez::pose pose = relative(sample.pose);
+    double dx = frame.x / 100.0 - pose.x;
+    double dy = frame.y / 100.0 - pose.y;
+    double a = util::to_rad(pose.theta);
+    double along = dx * std::sin(a) + dy * std::cos(a);
+    double cross = dx * std::cos(a) - dy * std::sin(a);
+    double heading = util::wrap_angle(frame.theta / 100.0 - pose.theta);
+
+    stats.frames = play_index;
+    stats.last = std::hypot(dx, dy);
+    stats.worst = std::max(stats.worst, stats.last);
+    stats.heading = heading;
+
+    double fwd = (frame.left + frame.right) / 2.0;
+    double turn = (frame.left - frame.right) / 2.0;
+    //a released stick coasts, a small correcting voltage under the motors' back emf would brake them instead
+    if(correcting && (frame.left != 0 || frame.right != 0)){
+        fwd += replay::ALONG_KP * along;
+        turn += replay::HEADING_KP * heading + replay::CROSS_KP * cross;
+    }
+    ctrl::drive_set(int(std::clamp(fwd + turn, -127.0, 127.0)), int(std::clamp(fwd - turn, -127.0, 127.0)));
+}
+
+static void selector_add(int slot, std::uint32_t count, std::uint16_t period){
+    char seconds[16];
+    snprintf(seconds, sizeof(seconds), "%.1f", count * period / 1000.0);
+    std::string name = "replay " + std::to_string(slot) + "\n\nDrives the route recorded in opcontrol, " + seconds + "s";
+    ez::as::auton_selector.autons_add({{name, [slot](){ replay::run(slot); }}});
+}
+
+//header of a slot file, false if it isn't one
+static bool header_read(FILE* file, replay::Header& header){
+    replay::Header expected;
+    return fread(&header, sizeof(header), 1, file) == 1 && std::equal(header.magic, header.magic + 4, expected.magic) &&
+           header.frames <= std::uint32_t(replay::MAX_FRAMES) && header.period > 0;
+}
+
+namespace replay{
+    void start(){
+        ctrl::add_subsystem(tick);
+        if(!pros::usd::is_installed()){
+            return;
+        }
+        for(int slot = 0; slot < MAX_SLOTS; slot++){
+            FILE* file = fopen(slot_path(slot).c_str(), "rb");
+            if(file == nullptr){
+                continue;
+            }
+            Header header;
+            if(header_read(file, header)){
+                selector_add(slot, header.frames, header.period);
+            }
+            fclose(file);
+        }
+    }
+
+    void tick(const ctrl::Sample& sample){
+        if(is_recording){
+            record_frame(sample);
+        }else if(is_playing){
+            play_frame(sample);
+        }
+    }
+
+    void record_start(){
+        if(is_playing){
+            return;
+        }
+        origin = ctrl::sample().pose;
+        frame_period = std::uint16_t(ctrl::period);
+        frame_count = 0;
+        is_recording = true;
+    }
+
+    int record_stop(){
+        is_recording = false;
+        int count = frame_count;
+        if(count == 0 || !pros::usd::is_installed()){
+            return -1;
+        }
+        for(int slot = 0; slot < MAX_SLOTS; slot++){
+            std::string path = slot_path(slot);
+            FILE* taken = fopen(path.c_str(), "rb");
+            if(taken != nullptr){
+                fclose(taken);
+                continue;
+            }
+            FILE* file = fopen(path.c_str(), "wb");
+            if(file == nullptr){
+                return -1;
+            }
+            Header header;
+            header.period = frame_period;
+            header.frames = count;
+            bool written = fwrite(&header, sizeof(header), 1, file) == 1 && fwrite(frames_buffer, sizeof(Frame), count, file) == std::size_t(count);
+            fclose(file);
+            if(!written){
+                return -1;
+            }
+            selector_add(slot, count, frame_period);
+            return slot;
+        }
+        return -1;
+    }
+
+    void record_toggle(){
+        if(is_recording){
+            record_stop();
+        }else{
+            record_start();
+        }
+    }
+
+    bool recording(){
+        return is_recording;
+    }
+
+    bool load(int slot){
+        if(is_recording || is_playing){
+            return false;
+        }
+        FILE* file = fopen(slot_path(slot).c_str(), "rb");
+        if(file == nullptr){
+            return false;
+        }
+        Header header;
+        bool ok = header_read(file, header) && fread(frames_buffer, sizeof(Frame), header.frames, file) == header.frames;
+        fclose(file);
+        frame_count = ok ? int(header.frames) : 0;
+        frame_period = header.period;
+        if(ok && frame_period != ctrl::period){
+            printf("replay %i was recorded every %ims, the control loop runs every %ims\n", slot, int(frame_period), ctrl::period);
+        }
+        return ok;
+    }
+
+    void play(bool correct){
+        if(is_recording || frame_count == 0){
+            return;
+        }
+        chassis.drive_mode_set(ez::DISABLE, false);
+        prof::motion_set("replay::play", frame_count);
+        origin = ctrl::sample().pose;
+        correcting = correct;
+        play_index = 0;
+        sent_path = -1;
+        sent_pistons = -1;
+        stats = Tracking();
+        is_playing = true;
+        while(is_playing){
+            pros::delay(ez::util::DELAY_TIME);
+        }
+        prof::motion_done("replay::play", stats.last, "done", 0);
+    }
+
+    void run(int slot){
+        if(load(slot)){
+            play();
+        }
+    }
+
+    void stop(){
+        is_recording = false;
+        if(is_playing.exchange(false)){
+            ctrl::drive_set(0, 0);
+        }
+    }
+
+    bool playing(){
+        return is_playing;
+    }
+
+    int frames(){
+        return frame_count;
+    }
+
+    Tracking tracking(){
+        return stats;
+    }
+}
@@ -0,0 +1,217 @@
+#include "roller.hpp"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include "control_loop.hpp"
+#include "telemetry.hpp"
+
+//V5 motors halve their current limit for every 5C past 55C, a hot jam draws less
+static double heat_scale(double temperature){
+    return temperature < 55 ? 1.0 : std::pow(0.5, 1 + std::floor((temperature - 55) / 5));
+}
+
+Roller::Roller(int port) : motor(port){
+    command = 0;
+    target = 0;
+    velocity_mode = false;
+    requests = 0;
+    output = 0;
+    jams = 0;
+    jam_armed = true;
+    written = 0;
+    velocity = 0;
+    current = 0;
+    temperature = 0;
+}
+
+void Roller::move(int voltage){
+    if(velocity_mode || voltage != command){
+        requests++;
+    }
+    velocity_mode = false;
+    command = voltage;
+
+    //nothing will pick the command up, so write it now
+    if(!ctrl::running()){
+        actuate();
+    }
+}
+
+void Roller::move_velocity(double rpm){
+    if(!velocity_mode || rpm != target){
+        requests++;
+    }
+    target = rpm;
+    velocity_mode = true;
+
+    //nothing will run the controller, the motor's own one holds it instead
+    if(!ctrl::running()){
+        motor.move_velocity(std::lround(rpm));
+        written = INT_MIN;
+    }
+}
+
+void Roller::velocity_constants_set(double kv, double ks, double kp, double ki, double kd){
+    this->kv = kv;
+    this->ks = ks;
+    this->kp = kp;
+    this->ki = ki;
+    this->kd = kd;
+}
+
+int Roller::get_command(){
+    return command;
+}
+
+bool Roller::is_velocity(){
+    return velocity_mode;
+}
+
+double Roller::get_target_velocity(){
+    return velocity_mode ? double(target) : 0.0;
+}
+
+void Roller::sense(){
+    velocity = motor.get_actual_velocity();
+    current = motor.get_current_draw();
+    temperature = motor.get_temperature();
+}
+
+void Roller::pulse(int voltage, int ms){
+    pulse_voltage = voltage;
+    pulse_end = pros::millis() + ms;
+    output = voltage;
+}
+
+int Roller::velocity_output(std::uint32_t now_ms){
+    double rpm = target;
+    double dt = last_control == 0 ? 0 : (now_ms - last_control) / 1000.0;
+    last_control = now_ms;
+    if(rpm == 0){
+        //coast to a stop like move(0) instead of braking against the error
+        integral = 0;
+        last_error = 0;
+        return 0;
+    }
+    double error = rpm - velocity;
+    double derivative = dt > 0 ? (error - last_error) / dt : 0;
+    last_error = error;
+    double out = kv * rpm + (rpm > 0 ? ks : -ks) + kp * error + ki * integral + kd * derivative;
+    if(std::fabs(out) < 127){
+        integral += error * dt;
+    }
+    return std::clamp(int(std::lround(out)), -127, 127);
+}
+
+void Roller::control(std::uint32_t now_ms){
+    //a new command starts over, that is also how STUCK is left
+    int request = requests;
+    if(request != last_request){
+        last_request = request;
+        jam_state = CLEAR;
+        state_start = now_ms;
+        stall_start = 0;
+        integral = 0;
+        last_error = 0;
+        last_control = 0;
+    }
+
+    bool holding = velocity_mode;
+    int wanted = holding ? velocity_output(now_ms) : int(command);
+    double direction = holding ? double(target) : wanted;
+    if(pulse_end != 0 && now_ms < pulse_end){
+        output = pulse_voltage;
+        stall_start = 0;
+        return;
+    }
+    pulse_end = 0;
+    if(jam_current <= 0){
+        output = wanted;
+        return;
+    }
+
+    if(jam_state == REVERSING && now_ms - state_start >= jam_reverse){
+        jam_state = RESUMING;
+        state_start = now_ms;
+    }else if(jam_state == RESUMING && now_ms - state_start >= SPINUP_MS){
+        jam_state = CLEAR;
+    }
+
+    if(!jam_armed){
+        stall_start = 0;
+    }else if(jam_state == CLEAR && direction != 0 && now_ms - state_start >= SPINUP_MS){
+        bool stalled = current > jam_current * heat_scale(temperature) && std::fabs(velocity) < jam_velocity;
+        if(!stalled){
+            stall_start = 0;
+        }else if(stall_start == 0){
+            stall_start = now_ms;
+        }else if(now_ms - stall_start >= jam_detect){
+            jams++;
+            telemetry::event(telemetry::JAM, motor.get_port(), jams);
+            streak = last_jam != 0 && now_ms - last_jam <= JAM_STREAK_MS ? streak + 1 : 1;
+            last_jam = now_ms;
+            stall_start = 0;
+            jam_state = streak > jam_retries ? STUCK : REVERSING;
+            state_start = now_ms;
+            if(jam_callback != nullptr){
+                jam_callback(jams);
+            }
+        }
+    }
+
+    if(jam_state == REVERSING || jam_state == STUCK){
+        //the controller didn't drive these ticks, don't let it carry what it saw into the resume
+        integral = 0;
+    }
+    if(jam_state == REVERSING){
+        output = direction > 0 ? -jam_voltage : jam_voltage;
+    }else{
+        output = jam_state == STUCK ? 0 : wanted;
+    }
+}
+
+void Roller::jam_set(double current_ma, double velocity_rpm, int detect_ms, int reverse_ms, int reverse_voltage, int retries){
+    jam_current = current_ma;
+    jam_velocity = velocity_rpm;
+    jam_detect = detect_ms;
+    jam_reverse = reverse_ms;
+    jam_voltage = reverse_voltage;
+    jam_retries = retries;
+}
+
+void Roller::jam_arm(bool armed){
+    jam_armed = armed;
+}
+
+void Roller::on_jam(std::function<void(int jams)> callback){
+    jam_callback = callback;
+}
+
+int Roller::get_jams(){
+    return jams;
+}
+
+Roller::JamState Roller::get_jam_state(){
+    return jam_state;
+}
+
+void Roller::actuate(){
+    //without the control loop nothing runs control(), the command goes straight out
+    int next = ctrl::running() ? int(output) : int(command);
+    if(next != written){
+        motor.move(next);
+        written = next;
+    }
+}
+
+double Roller::get_velocity(){
+    return velocity;
+}
+
+double Roller::get_current(){
+    return current;
+}
+
+double Roller::get_temperature(){
+    return temperature;
+}
@@ -0,0 +1,150 @@
+#include "settle.hpp"
+#include <cmath>
+#include "subsystems.hpp"
+
+SettleDetector::SettleDetector(double error, double velocity, int hold_ms, int predict_ms){
+    constants_set(error, velocity, hold_ms, predict_ms);
+}
+
+void SettleDetector::constants_set(double error, double velocity, int hold_ms, int predict_ms){
+    error_threshold = std::fabs(error);
+    velocity_threshold = std::fabs(velocity);
+    hold_time = hold_ms;
+    predict_time = predict_ms;
+}
+
+bool SettleDetector::enabled(){
+    return error_threshold > 0 && velocity_threshold > 0;
+}
+
+void SettleDetector::reset(){
+    has_sample = false;
+    filtered_error = 0;
+    filtered_velocity = 0;
+    holding = false;
+}
+
+SettleDetector::State SettleDetector::update(double error, std::uint32_t time_ms){
+    if(!has_sample){
+        has_sample = true;
+        filtered_error = error;
+        filtered_velocity = 0;
+        last_time = time_ms;
+        return MOVING;
+    }
+
+    double dt = (time_ms - last_time) / 1000.0;
+    if(dt <= 0){
+        return holding ? HOLDING : MOVING;
+    }
+    last_time = time_ms;
+
+    //velocity is taken from the filtered error so sensor noise doesn't show up as motion
+    double previous = filtered_error;
+    filtered_error += FILTER * (error - filtered_error);
+    filtered_velocity += FILTER * ((filtered_error - previous) / dt - filtered_velocity);
+
+    if(!enabled()){
+        return MOVING;
+    }
+
+    if(std::fabs(filtered_error) <= error_threshold && std::fabs(filtered_velocity) <= velocity_threshold){
+        if(!holding){
+            holding = true;
+            hold_start = time_ms;
+        }
+        return int(time_ms - hold_start) >= hold_time ? SETTLED : HOLDING;
+    }
+    holding = false;
+
+    //closing in on the target and will be inside the threshold within the horizon
+    if(predict_time > 0){
+        bool closing = filtered_error * filtered_velocity < 0;
+        double predicted = filtered_error + filtered_velocity * predict_time / 1000.0;
+        if(closing && std::fabs(filtered_error) <= 2 * error_threshold && std::fabs(predicted) <= error_threshold){
+            return PREDICTED;
+        }
+    }
+    return MOVING;
+}
+
+double SettleDetector::error_get(){
+    return filtered_error;
+}
+
+double SettleDetector::velocity_get(){
+    return filtered_velocity;
+}
+
+double SettleDetector::velocity_threshold_get(){
+    return velocity_threshold;
+}
+
+static settle::Record records[settle::RECORDS];
+static int record_count = 0;
+static int record_next = 0;
+static std::function<void(const settle::Record&)> record_callback = nullptr;
+
+namespace settle{
+    void add(const Record& record){
+        records[record_next] = record;
+        record_next = (record_next + 1) % RECORDS;
+        if(record_count < RECORDS){
+            record_count++;
+        }
+
+        if(chassis.pid_print_toggle_get()){
+            printf("  %s exit in %ims, error %.2f, overshoot %.2f, far %ims big %ims small %ims stopped %ims\n",
+                   exit_to_string(record.exit), int(record.end - record.start), record.final_error, record.overshoot,
+                   int(record.phase_time[FAR]), int(record.phase_time[BIG_ZONE]), int(record.phase_time[SMALL_ZONE]), int(record.phase_time[STOPPED]));
+        }
+        if(record_callback != nullptr){
+            record_callback(record);
+        }
+    }
+
+    void on_record(std::function<void(const Record&)> callback){
+        record_callback = callback;
+    }
+
+    int count(){
+        return record_count;
+    }
+
+    Record get(int index){
+        if(index < 0 || index >= record_count){
+            return Record();
+        }
+        int oldest = record_count < RECORDS ? 0 : record_next;
+        return records[(oldest + index) % RECORDS];
+    }
+
+    Record last(){
+        return get(record_count - 1);
+    }
+
+    const char* exit_to_string(Exit exit){
+        switch(exit){
+            case SMALL:
+                return "Small";
+            case BIG:
+                return "Big";
+            case VELOCITY:
+                return "Velocity";
+            case MA:
+                return "mA";
+            case SETTLED:
+                return "Settled";
+            case PREDICTED:
+                return "Predicted";
+            case NO_CONSTANTS:
+                return "No constants";
+            case TIMEOUT:
+                return "Timeout";
+            case UNKNOWN:
+                return "Unknown";
+            default:
+                return "Running";
+        }
+    }
+}
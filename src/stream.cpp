@@ -0,0 +1,242 @@
+#include "stream.hpp"
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include "control_loop.hpp"
+#include "pros/apix.h"
+#include "subsystems.hpp"
+#include "tasks.hpp"
+
+//samples sent since the last time the link ran out, before the decimation is halved again
+static const int RECOVER_FRAMES = 50;
+
+static std::atomic<bool> running = false;
+static std::atomic<bool> task_started = false;
+static std::atomic<std::uint32_t> mask = 0;
+static std::atomic<std::uint32_t> period_ticks = 1;
+static std::atomic<std::uint32_t> link_bytes = stream::LINK_BYTES;
+static std::atomic<bool> schema_due = true;
+static FILE* out = stdout;
+
+//only the stream task touches these
+static stream::Stats sent;
+static int shift = 0;
+static int ticks = 0;
+static int clean_frames = 0;
+static int since_key = stream::KEY_EVERY;
+static double budget = 0;
+static std::uint32_t last_refill = 0;
+static std::uint32_t last_schema = 0;
+static std::uint32_t last_time = 0;
+static std::uint16_t sequence = 0;
+static std::int32_t last_values[stream::CHANNELS] = {};
+
+static pros::Mutex stats_lock;
+
+//the PID of the running motion that best says how it is going
+static ez::PID* active_pid(){
+    switch(chassis.drive_mode_get()){
+        case ez::DRIVE:
+            return &chassis.leftPID;
+        case ez::TURN:
+        case ez::TURN_TO_POINT:
+            return &chassis.turnPID;
+        case ez::SWING:
+            return &chassis.swingPID;
+        case ez::POINT_TO_POINT:
+        case ez::PURE_PURSUIT:
+            return &chassis.xyPID;
+        default:
+            return nullptr;
+    }
+}
+
+static void values_read(double values[stream::CHANNELS]){
+    ctrl::Sample sample = ctrl::sample();
+    ez::PID* pid = active_pid();
+    values[stream::X] = sample.pose.x;
+    values[stream::Y] = sample.pose.y;
+    values[stream::THETA] = sample.pose.theta;
+    values[stream::LEFT] = sample.left;
+    values[stream::RIGHT] = sample.right;
+    values[stream::IMU] = sample.imu;
+    values[stream::PID_TARGET] = pid == nullptr ? 0 : pid->target;
+    values[stream::PID_ERROR] = pid == nullptr ? 0 : pid->error;
+    values[stream::PID_OUTPUT] = pid == nullptr ? 0 : pid->output;
+    values[stream::INTAKE_RPM] = intake.get_velocity();
+    values[stream::OUTTAKE_RPM] = outtake.get_velocity();
+    values[stream::INTAKE_MA] = intake.get_current();
+    values[stream::OUTTAKE_MA] = outtake.get_current();
+    values[stream::CPU] = tasks::cpu_total();
+    values[stream::LOOP_RUN] = ctrl::timing().last_tick;
+    values[stream::OVERRUNS] = tasks::overruns_total();
+}
+
+static std::int32_t quantize(double value, int channel){
+    double scaled = std::round(value * stream::SCALES[channel]);
+    return std::isfinite(scaled) ? std::int32_t(std::clamp(scaled, -2147483647.0, 2147483647.0)) : 0;
+}
+
+//payload to frame, then out if the budget has room for it
+static bool send(const std::uint8_t* payload, std::size_t size){
+    std::uint8_t whole[stream::MAX_PAYLOAD + 2];
+    std::copy(payload, payload + size, whole);
+    std::uint16_t crc = stream::crc16(payload, size);
+    whole[size] = std::uint8_t(crc);
+    whole[size + 1] = std::uint8_t(crc >> 8);
+    std::uint8_t frame[stream::MAX_FRAME];
+    std::size_t length = stream::cobs_encode(whole, size + 2, frame);
+    frame[length++] = 0;
+
+    if(budget < length){
+        return false;
+    }
+    budget -= length;
+    sequence++;
+    ssize_t written = write(fileno(out), frame, length);
+    stats_lock.take();
+    if(written == ssize_t(length)){
+        sent.frames++;
+        sent.bytes += length;
+    }else{
+        //the rest of the frame is lost, the host drops it on the CRC and needs a KEY to pick the values up again
+        sent.short_writes++;
+        since_key = stream::KEY_EVERY;
+        shift = std::min(shift + 1, stream::MAX_DECIMATION_SHIFT);
+    }
+    stats_lock.give();
+    return true;
+}
+
+static std::uint8_t* header(std::uint8_t* at, stream::Kind kind){
+    *at++ = kind;
+    *at++ = std::uint8_t(sequence);
+    *at++ = std::uint8_t(sequence >> 8);
+    return at;
+}
+
+static void put_u16(std::uint8_t*& at, std::uint16_t value){
+    *at++ = std::uint8_t(value);
+    *at++ = std::uint8_t(value >> 8);
+}
+
+static bool schema_send(std::uint32_t now, std::uint32_t channels){
+    std::uint8_t payload[stream::MAX_PAYLOAD];
+    std::uint8_t* at = header(payload, stream::SCHEMA);
+    stream::varint_put(at, now);
+    *at++ = stream::VERSION;
+    put_u16(at, std::uint16_t(period_ticks * ctrl::period));
+    *at++ = std::uint8_t(1 << shift);
+    for(int i = 0; i < 4; i++){
+        *at++ = std::uint8_t(channels >> (8 * i));
+    }
+    for(int channel = 0; channel < stream::CHANNELS; channel++){
+        if(channels & (1u << channel)){
+            std::memcpy(at, &stream::SCALES[channel], sizeof(float));
+            at += sizeof(float);
+        }
+    }
+    return send(payload, at - payload);
+}
+
+static void sample_send(std::uint32_t now){
+    std::uint32_t channels = mask;
+    if(schema_due || now - last_schema >= stream::SCHEMA_MS){
+        if(!schema_send(now, channels)){
+            return;
+        }
+        schema_due = false;
+        last_schema = now;
+        since_key = stream::KEY_EVERY;
+    }
+
+    double values[stream::CHANNELS];
+    values_read(values);
+    bool key = since_key >= stream::KEY_EVERY;
+    std::uint8_t payload[stream::MAX_PAYLOAD];
+    std::uint8_t* at = header(payload, key ? stream::KEY : stream::DELTA);
+    stream::varint_put(at, key ? now : now - last_time);
+    std::int32_t quantized[stream::CHANNELS];
+    for(int channel = 0; channel < stream::CHANNELS; channel++){
+        if(channels & (1u << channel)){
+            quantized[channel] = quantize(values[channel], channel);
+            stream::varint_put(at, stream::zigzag(key ? quantized[channel] : quantized[channel] - last_values[channel]));
+        }
+    }
+
+    if(!send(payload, at - payload)){
+        //saturated, send half as often and keep the deltas against the last frame that went out
+        stats_lock.take();
+        sent.skipped++;
+        stats_lock.give();
+        shift = std::min(shift + 1, stream::MAX_DECIMATION_SHIFT);
+        clean_frames = 0;
+        return;
+    }
+    std::copy(quantized, quantized + stream::CHANNELS, last_values);
+    last_time = now;
+    since_key = key ? 1 : since_key + 1;
+    if(++clean_frames >= RECOVER_FRAMES && shift > 0){
+        shift--;
+        clean_frames = 0;
+    }
+}
+
+static void sender(){
+    int id = tasks::add("stream", tasks::PRIORITY_LOG, ctrl::period);
+    while(true){
+        std::uint32_t now = pros::millis();
+        double cap = std::max<double>(stream::MAX_FRAME * 4, link_bytes / 10.0);
+        budget = std::min(cap, budget + link_bytes * (now - last_refill) / 1000.0);
+        last_refill = now;
+
+        if(running && ++ticks >= int(period_ticks) << shift){
+            ticks = 0;
+            sample_send(now);
+        }
+        stats_lock.take();
+        sent.decimation = 1 << shift;
+        stats_lock.give();
+        tasks::wait(id);
+    }
+}
+
+namespace stream{
+    void start(std::uint32_t channels, std::uint32_t period_ms){
+        mask = channels & ALL;
+        period_ticks = std::max<std::uint32_t>(1, (period_ms + ctrl::period / 2) / ctrl::period);
+        schema_due = true;
+        running = true;
+        if(task_started.exchange(true)){
+            return;
+        }
+        if(out == stdout){
+            //raw bytes on the link, and a full serial buffer drops the rest of a frame instead of waiting
+            pros::c::serctl(SERCTL_DISABLE_COBS, nullptr);
+            pros::c::fdctl(fileno(out), SERCTL_NOBLKWRITE, nullptr);
+        }
+        last_refill = pros::millis();
+        pros::Task task(sender, tasks::PRIORITY_LOG, TASK_STACK_DEPTH_DEFAULT, "stream");
+    }
+
+    void stop(){
+        running = false;
+    }
+
+    void link_set(std::uint32_t bytes_per_second){
+        link_bytes = bytes_per_second;
+    }
+
+    void output_set(FILE* file){
+        out = file;
+    }
+
+    Stats stats(){
+        stats_lock.take();
+        Stats copy = sent;
+        stats_lock.give();
+        return copy;
+    }
+}
@@ -0,0 +1,247 @@
+#include "tasks.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include "EZ-Template/util.hpp"
+#include "telemetry.hpp"
+#include "trace.hpp"
+
+struct Entry{
+    tasks::Stats stats;
+    pros::task_t task = nullptr;  // the task that registered, deadlines stop being checked once it's gone
+    bool paused = false;
+    std::uint32_t release = 0;    // ms, the release the task is currently waiting on or running for
+    bool starving = false;
+    std::uint64_t charged_start = 0;  // charged when the iteration started
+    std::uint64_t window_start = 0;   // micros the cpu window started
+    std::uint64_t window_run = 0;     // run time in the window so far
+};
+
+//fixed size so registering never allocates, entries are written by their own task and read by anyone
+static Entry entries[tasks::MAX_TASKS];
+static std::atomic<int> entry_count = 0;
+static std::function<void(int)> miss_callback = nullptr;
+static std::function<void(int)> overrun_callback = nullptr;
+
+//run time of every iteration of every registered task so far, a task's window less what this grew by in it
+//is what the task itself ran
+static std::atomic<std::uint64_t> charged = 0;
+
+static int registered(){
+    return std::min(int(entry_count), tasks::MAX_TASKS);
+}
+
+static int find(const char* name){
+    int count = registered();
+    for(int i = 0; i < count; i++){
+        if(std::strcmp(entries[i].stats.name, name) == 0){
+            return i;
+        }
+    }
+    return -1;
+}
+
+//tasks on different threads register at once, so a new entry is taken with one increment
+static int claim(const char* name){
+    int id = find(name);
+    if(id >= 0){
+        return id;
+    }
+    id = entry_count++;
+    if(id >= tasks::MAX_TASKS){
+        entry_count = tasks::MAX_TASKS;
+        return -1;
+    }
+    return id;
+}
+
+//a task PROS killed, opcontrol when autonomous starts, can't run again until it's added again
+static bool gone(const Entry& entry){
+    if(entry.task == nullptr){
+        return false;
+    }
+    std::uint32_t state = pros::Task(entry.task).get_state();
+    return state == pros::E_TASK_STATE_DELETED || state == pros::E_TASK_STATE_INVALID;
+}
+
+static void overran(int id){
+    telemetry::event(telemetry::OVERRUN, id, entries[id].stats.last_run, entries[id].stats.period * 1000.0, entries[id].stats.overruns);
+    if(overrun_callback != nullptr){
+        overrun_callback(id);
+    }
+}
+
+//the iteration that is ending, how long it ran and the share of the brain over the window
+static void measure(Entry& entry, int id, std::uint64_t now){
+    tasks::Stats& stats = entry.stats;
+    std::uint64_t others = charged - entry.charged_start;
+    std::uint64_t elapsed = now - stats.last_start;
+    std::uint32_t run = std::uint32_t(elapsed > others ? elapsed - others : 0);
+    charged += run;
+    stats.last_run = run;
+    if(run > stats.worst_run){
+        stats.worst_run = run;
+    }
+    entry.window_run += run;
+    if(now - entry.window_start >= std::uint64_t(tasks::USAGE_MS) * 1000){
+        stats.cpu = float(100.0 * entry.window_run / (now - entry.window_start));
+        entry.window_start = now;
+        entry.window_run = 0;
+    }
+    if(run > stats.period * 1000){
+        stats.overruns++;
+        overran(id);
+    }
+}
+
+static void missed(int id){
+    telemetry::event(telemetry::DEADLINE, id, entries[id].stats.misses, entries[id].stats.starved);
+    if(miss_callback != nullptr){
+        miss_callback(id);
+    }
+}
+
+namespace tasks{
+    int add(const char* name, std::uint32_t priority, std::uint32_t period_ms){
+        pros::Task::current().set_priority(priority);
+
+        int id = claim(name);
+        if(id < 0){
+            return -1;
+        }
+        Entry& entry = entries[id];
+        entry.stats.name = name;
+        entry.stats.priority = priority;
+        entry.stats.period = period_ms;
+        entry.task = static_cast<pros::task_t>(pros::Task::current());
+        entry.paused = false;
+        entry.window_start = pros::micros();
+        entry.window_run = 0;
+        resume(id);
+        return id;
+    }
+
+    int adopt(const char* name, pros::Task task, std::uint32_t priority){
+        task.set_priority(priority);
+
+        int id = claim(name);
+        if(id < 0){
+            return -1;
+        }
+        entries[id].stats.name = name;
+        entries[id].stats.priority = priority;
+        return id;
+    }
+
+    void pause(int id){
+        if(id >= 0){
+            entries[id].paused = true;
+        }
+    }
+
+    void resume(int id){
+        if(id < 0){
+            return;
+        }
+        Entry& entry = entries[id];
+        entry.stats.last_start = pros::micros();
+        entry.release = pros::millis();
+        entry.starving = false;
+        entry.charged_start = charged;
+        entry.paused = false;
+    }
+
+    void wait(int id){
+        if(id < 0){
+            pros::delay(ez::util::DELAY_TIME);
+            return;
+        }
+        Entry& entry = entries[id];
+        Stats& stats = entry.stats;
+
+        //the iteration from its start to here, the sleep after it is the gap before the next one
+        std::uint64_t now = pros::micros();
+        trace::record(stats.name, stats.last_start, now);
+        measure(entry, id, now);
+
+        //the deadline of an iteration is the next release
+        std::uint64_t deadline = (std::uint64_t(entry.release) + stats.period) * 1000;
+        if(now > deadline){
+            stats.misses++;
+            missed(id);
+        }
+
+        pros::Task::delay_until(&entry.release, stats.period);
+
+        std::uint64_t start = pros::micros();
+        std::uint32_t late = std::uint32_t(start - std::uint64_t(entry.release) * 1000);
+        stats.last_period = std::uint32_t(start - stats.last_start);
+        stats.last_start = start;
+        entry.charged_start = charged;
+        stats.runs++;
+        if(stats.last_period > stats.worst_period){
+            stats.worst_period = stats.last_period;
+        }
+        if(late > stats.worst_late){
+            stats.worst_late = late;
+        }
+        entry.starving = false;
+    }
+
+    void check(){
+        //tasks get killed when the robot is disabled, that isn't starvation
+        if(pros::competition::is_disabled()){
+            return;
+        }
+        std::uint64_t now = pros::micros();
+        int count = registered();
+        for(int i = 0; i < count; i++){
+            Entry& entry = entries[i];
+            if(entry.stats.period == 0 || entry.starving || entry.paused || gone(entry)){
+                continue;
+            }
+            if(now - entry.stats.last_start > std::uint64_t(STARVE_PERIODS) * entry.stats.period * 1000){
+                entry.starving = true;
+                entry.stats.starved++;
+                missed(i);
+            }
+        }
+    }
+
+    void on_miss(std::function<void(int)> callback){
+        miss_callback = callback;
+    }
+
+    void on_overrun(std::function<void(int)> callback){
+        overrun_callback = callback;
+    }
+
+    float cpu_total(){
+        float total = 0;
+        int count = registered();
+        for(int i = 0; i < count; i++){
+            total += entries[i].stats.cpu;
+        }
+        return total;
+    }
+
+    std::uint32_t overruns_total(){
+        std::uint32_t total = 0;
+        int count = registered();
+        for(int i = 0; i < count; i++){
+            total += entries[i].stats.overruns;
+        }
+        return total;
+    }
+
+    Stats get(int id){
+        if(id < 0 || id >= registered()){
+            return Stats();
+        }
+        return entries[id].stats;
+    }
+
+    int count(){
+        return registered();
+    }
+}
@@ -0,0 +1,344 @@
+#include "telemetry.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include "control_loop.hpp"
+#include "dsr.hpp"
+#include "subsystems.hpp"
+#include "tasks.hpp"
+
+static_assert(sizeof(telemetry::Record) == 32, "records are 32 bytes in the file");
+static_assert(sizeof(telemetry::Block) == sizeof(telemetry::Record), "a block header takes one record");
+static_assert(sizeof(telemetry::Header) == telemetry::BLOCK_BYTES, "a run header is one block");
+
+//bounded multi producer ring, a slot is ready to read when its sequence is one past its position
+//and free to write when its sequence equals its position
+struct Slot{
+    std::atomic<std::uint32_t> sequence = 0;
+    telemetry::Record record;
+};
+static Slot ring[telemetry::RING_RECORDS];
+static std::atomic<std::uint32_t> head = 0;
+static std::uint32_t tail = 0;
+
+static std::atomic<bool> logging = false;
+static std::atomic<bool> flush_wanted = false;
+static std::atomic<std::uint32_t> dropped_count = 0;
+static std::atomic<std::uint32_t> written_count = 0;
+static std::atomic<std::uint32_t> block_count = 0;
+
+//only the writer task touches the file and the block being filled
+static FILE* file = nullptr;
+static std::uint32_t file_used = 0;
+static std::uint8_t block[telemetry::BLOCK_BYTES];
+static int block_used = 0;
+static std::uint16_t run = 0;
+
+//the header begin() made for the next run, picked up when the writer gets to its RUN event
+static pros::Mutex header_lock;
+static telemetry::Header next_header;
+
+static int ticks = 0;
+
+static telemetry::Record make(telemetry::Type type, int id){
+    telemetry::Record record;
+    record.time = pros::micros();
+    record.type = type;
+    record.id = std::uint8_t(id);
+    return record;
+}
+
+static void pid_push(telemetry::Pid id, ez::PID& pid){
+    telemetry::Record record = make(telemetry::PID, id);
+    float values[] = {float(pid.target), float(pid.cur), float(pid.error), float(pid.integral), float(pid.derivative), float(pid.output)};
+    std::memcpy(record.values, values, sizeof(values));
+    telemetry::push(record);
+}
+
+static void motor_push(int port, double current, double temperature, double velocity, double command, int jams){
+    telemetry::Record record = make(telemetry::MOTOR, std::abs(port));
+    float values[] = {float(current), float(temperature), float(velocity), float(command), float(jams), 0};
+    std::memcpy(record.values, values, sizeof(values));
+    telemetry::push(record);
+}
+
+//the whole block goes out at once, the file was made full size so this never grows it
+static bool block_write(const void* data){
+    if(file == nullptr){
+        return false;
+    }
+    if(file_used + telemetry::BLOCK_BYTES > telemetry::FILE_BYTES){
+        return false;
+    }
+    if(fwrite(data, telemetry::BLOCK_BYTES, 1, file) != 1){
+        return false;
+    }
+    file_used += telemetry::BLOCK_BYTES;
+    block_count++;
+    return true;
+}
+
+static void block_start(){
+    std::memset(block, 0, sizeof(block));
+    block_used = 0;
+}
+
+static void block_finish(){
+    if(block_used == 0){
+        return;
+    }
+    telemetry::Block header;
+    header.sequence = block_count;
+    header.run = run;
+    header.records = block_used;
+    header.dropped = dropped_count;
+    std::memcpy(block, &header, sizeof(header));
+    if(block_write(block)){
+        written_count += block_used;
+    }else{
+        dropped_count += block_used;
+    }
+    block_start();
+}
+
+static void record_add(const telemetry::Record& record){
+    if(record.type == telemetry::EVENT && record.id == telemetry::RUN){
+        block_finish();
+        header_lock.take();
+        telemetry::Header header = next_header;
+        header_lock.give();
+        run = header.run;
+        header.sequence = block_count;
+        header.dropped = dropped_count;
+        block_write(&header);
+    }
+    std::memcpy(block + (block_used + 1) * sizeof(telemetry::Record), &record, sizeof(record));
+    block_used++;
+    if(block_used == telemetry::BLOCK_RECORDS){
+        block_finish();
+    }
+}
+
+static bool pop(telemetry::Record& record){
+    Slot& slot = ring[tail % telemetry::RING_RECORDS];
+    if(slot.sequence.load(std::memory_order_acquire) != tail + 1){
+        return false;
+    }
+    record = slot.record;
+    slot.sequence.store(tail + telemetry::RING_RECORDS, std::memory_order_release);
+    tail++;
+    return true;
+}
+
+static void writer(){
+    int id = tasks::add("telemetry", tasks::PRIORITY_LOG, telemetry::WRITE_MS);
+    while(true){
+        telemetry::Record record;
+        while(pop(record)){
+            record_add(record);
+        }
+        if(flush_wanted.exchange(false)){
+            block_finish();
+            if(file != nullptr){
+                fflush(file);
+            }
+        }
+        tasks::wait(id);
+    }
+}
+
+namespace telemetry{
+    void start(){
+        for(int i = 0; i < RING_RECORDS; i++){
+            ring[i].sequence = i;
+        }
+        block_start();
+        ctrl::add_subsystem(tick);
+        pros::Task task(writer, tasks::PRIORITY_LOG, TASK_STACK_DEPTH_DEFAULT, "telemetry");
+
+        if(!pros::usd::is_installed()){
+            return;
+        }
+        for(int n = 0; n < 100; n++){
+            std::string path = "/usd/tlm_" + std::to_string(n) + ".bin";
+            FILE* taken = fopen(path.c_str(), "rb");
+            if(taken != nullptr){
+                fclose(taken);
+                continue;
+            }
+            open(path.c_str());
+            return;
+        }
+    }
+
+    bool open(const char* path){
+        logging = false;
+        if(file != nullptr){
+            fclose(file);
+        }
+        file_used = 0;
+        file = fopen(path, "wb");
+        if(file == nullptr){
+            return false;
+        }
+        //unbuffered, every write is already a whole block, and sized now so no write has to grow it mid match
+        setvbuf(file, nullptr, _IONBF, 0);
+        bool sized = fseek(file, FILE_BYTES - 1, SEEK_SET) == 0 && fputc(0, file) != EOF && fflush(file) == 0 && fseek(file, 0, SEEK_SET) == 0;
+        if(!sized){
+            fclose(file);
+            file = nullptr;
+            return false;
+        }
+        logging = true;
+        return true;
+    }
+
+    void begin(const char* name){
+        Header header;
+        header.run = run + 1;
+        header.start = pros::micros();
+        std::strncpy(header.name, name, sizeof(header.name) - 1);
+        header.tick_per_inch = chassis.drive_tick_per_inch();
+        header.drive_width = chassis.drive_width_get();
+        header.imu_scaler = chassis.drive_imu_scaler_get();
+        ez::tracking_wheel* trackers[] = {chassis.odom_tracker_left, chassis.odom_tracker_right, chassis.odom_tracker_front, chassis.odom_tracker_back};
+        for(int i = 0; i < 4; i++){
+            header.trackers[i] = trackers[i] == nullptr ? 0 : trackers[i]->distance_to_center_get();
+        }
+        header.dsr_count = std::min<std::uint32_t>(::DSR::sensors.size(), 8);
+        for(std::uint32_t i = 0; i < header.dsr_count; i++){
+            header.dsr_offsets[i][0] = ::DSR::sensors[i].get_x_offset();
+            header.dsr_offsets[i][1] = ::DSR::sensors[i].get_y_offset();
+        }
+        ez::PID* pids[] = {&chassis.leftPID, &chassis.rightPID, &chassis.turnPID, &chassis.swingPID, &chassis.headingPID, &chassis.xyPID, &chassis.current_a_odomPID};
+        for(int i = 0; i < 7; i++){
+            ez::PID::Constants constants = pids[i]->constants_get();
+            float values[] = {float(constants.kp), float(constants.ki), float(constants.kd), float(constants.start_i)};
+            std::memcpy(header.pid[i], values, sizeof(values));
+        }
+        header_lock.take();
+        next_header = header;
+        header_lock.give();
+        event(RUN, header.run);
+    }
+
+    void push(const Record& record){
+        if(!logging){
+            return;
+        }
+        std::uint32_t position = head.load(std::memory_order_relaxed);
+        Slot* slot;
+        while(true){
+            slot = &ring[position % RING_RECORDS];
+            std::int32_t lead = std::int32_t(slot->sequence.load(std::memory_order_acquire) - position);
+            if(lead == 0){
+                if(head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)){
+                    break;
+                }
+            }else if(lead < 0){
+                //the writer hasn't freed this slot yet, the buffer is full
+                dropped_count++;
+                return;
+            }else{
+                position = head.load(std::memory_order_relaxed);
+            }
+        }
+        slot->record = record;
+        slot->sequence.store(position + 1, std::memory_order_release);
+    }
+
+    void tick(const ctrl::Sample& sample){
+        if(!logging){
+            return;
+        }
+        Record pose = make(POSE, 0);
+        float values[] = {float(sample.pose.x), float(sample.pose.y), float(sample.pose.theta), float(sample.left), float(sample.right), float(sample.imu)};
+        std::memcpy(pose.values, values, sizeof(values));
+        push(pose);
+
+        ez::e_mode mode = chassis.drive_mode_get();
+        if(mode != ez::DISABLE){
+            Record target = make(TARGET, mode);
+            float targets[] = {float(chassis.leftPID.target), float(chassis.rightPID.target), float(chassis.turnPID.target),
+                               float(chassis.swingPID.target), float(chassis.headingPID.target), float(chassis.xyPID.target)};
+            std::memcpy(target.values, targets, sizeof(targets));
+            push(target);
+        }
+        switch(mode){
+            case ez::SWING:
+                pid_push(PID_SWING, chassis.swingPID);
+                break;
+            case ez::TURN:
+            case ez::TURN_TO_POINT:
+                pid_push(PID_TURN, chassis.turnPID);
+                break;
+            case ez::DRIVE:
+                pid_push(PID_LEFT, chassis.leftPID);
+                pid_push(PID_RIGHT, chassis.rightPID);
+                pid_push(PID_HEADING, chassis.headingPID);
+                break;
+            case ez::POINT_TO_POINT:
+            case ez::PURE_PURSUIT:
+                pid_push(PID_XY, chassis.xyPID);
+                pid_push(PID_ANGULAR, chassis.current_a_odomPID);
+                break;
+            default:
+                break;
+        }
+
+        for(unsigned int i = 0; i < ::DSR::sensors.size(); i++){
+            DSRDS& sensor = ::DSR::sensors[i];
+            Record distance = make(DISTANCE, i);
+            float readings[] = {float(sensor.get_sensed_in()), float(sensor.read_sensed()), float(sensor.get_x_offset()), float(sensor.get_y_offset()), 0, 0};
+            std::memcpy(distance.values, readings, sizeof(readings));
+            push(distance);
+        }
+
+        if(++ticks < MOTOR_TICKS){
+            return;
+        }
+        ticks = 0;
+        for(Roller* roller : {&intake, &outtake}){
+            motor_push(roller->motor.get_port(), roller->get_current(), roller->get_temperature(), roller->get_velocity(),
+                       roller->is_velocity() ? roller->get_target_velocity() : roller->get_command(), roller->get_jams());
+        }
+        for(std::vector<pros::Motor>* side : {&chassis.left_motors, &chassis.right_motors}){
+            for(pros::Motor& motor : *side){
+                motor_push(motor.get_port(), motor.get_current_draw(), motor.get_temperature(), motor.get_actual_velocity(), motor.get_voltage() / 1000.0, 0);
+            }
+        }
+    }
+
+    void event(Event event, int port, float a, float b, float c, float d, float e, float f){
+        Record record = make(EVENT, event);
+        record.port = std::uint16_t(port);
+        float values[] = {a, b, c, d, e, f};
+        std::memcpy(record.values, values, sizeof(values));
+        push(record);
+    }
+
+    void text(Event event, const char* text){
+        Record record = make(TEXT, event);
+        std::memcpy(record.text, text, strnlen(text, sizeof(record.text)));
+        push(record);
+    }
+
+    void flush(){
+        flush_wanted = true;
+    }
+
+    std::uint32_t dropped(){
+        return dropped_count;
+    }
+
+    std::uint32_t written(){
+        return written_count;
+    }
+
+    std::uint32_t blocks(){
+        return block_count;
+    }
+}
@@ -0,0 +1,197 @@
+#include "trace.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+#include "api.h"
+
+static_assert(sizeof(trace::FileHeader) == 16, "the file header is 16 bytes");
+static_assert(sizeof(trace::TrackHeader) == 48, "track headers are 48 bytes in the file");
+static_assert(sizeof(trace::Span) == 12, "spans are 12 bytes in the file");
+
+struct Entry{
+    const char* name;
+    std::uint32_t begin;      // micros since start()
+    std::uint32_t duration;
+};
+
+//a ring of spans, written only by the task it belongs to, or the one task writing a named track
+struct Track{
+    std::atomic<const void*> key = nullptr;    // the task handle, or the track's name
+    const char* name = "";
+    std::uint32_t priority = 0;
+    bool task = false;
+    std::atomic<std::uint32_t> written = 0;
+    Entry spans[trace::MAX_SPANS];
+};
+
+static Track tracks[trace::MAX_TRACKS];
+static std::atomic<int> track_count = 0;
+static std::atomic<bool> on = false;
+static std::atomic<std::uint64_t> origin = 0;
+static std::atomic<std::uint32_t> untracked = 0;
+
+static Track* find(const void* key){
+    int count = std::min(int(track_count), trace::MAX_TRACKS);
+    for(int i = 0; i < count; i++){
+        if(tracks[i].key == key){
+            return &tracks[i];
+        }
+    }
+    return nullptr;
+}
+
+//a new track, nullptr once they are all taken
+static Track* claim(const void* key, const char* name, std::uint32_t priority, bool task){
+    int index = track_count++;
+    if(index >= trace::MAX_TRACKS){
+        track_count = trace::MAX_TRACKS;
+        return nullptr;
+    }
+    Track& track = tracks[index];
+    track.name = name;
+    track.priority = priority;
+    track.task = task;
+    track.written = 0;
+    track.key = key;
+    return &track;
+}
+
+static void add(Track* track, const char* name, std::uint64_t begin, std::uint64_t end){
+    if(track == nullptr){
+        untracked++;
+        return;
+    }
+    //started before recording did
+    std::uint64_t first = origin;
+    if(begin < first){
+        return;
+    }
+    std::uint32_t at = track->written;
+    track->spans[at % trace::MAX_SPANS] = {name, std::uint32_t(begin - first), std::uint32_t(end > begin ? end - begin : 0)};
+    track->written = at + 1;
+}
+
+namespace trace{
+    void start(){
+        on = false;
+        int count = std::min(int(track_count), MAX_TRACKS);
+        for(int i = 0; i < count; i++){
+            tracks[i].written = 0;
+        }
+        untracked = 0;
+        origin = pros::micros();
+        on = true;
+    }
+
+    void stop(){
+        on = false;
+    }
+
+    bool recording(){
+        return on;
+    }
+
+    void record(const char* name, std::uint64_t begin, std::uint64_t end){
+        if(!on){
+            return;
+        }
+        pros::Task current = pros::Task::current();
+        const void* key = static_cast<pros::task_t>(current);
+        Track* track = find(key);
+        if(track == nullptr){
+            track = claim(key, current.get_name(), current.get_priority(), true);
+        }
+        add(track, name, begin, end);
+    }
+
+    void record_on(const char* name_of_track, const char* name, std::uint64_t begin, std::uint64_t end){
+        if(!on){
+            return;
+        }
+        Track* track = find(name_of_track);
+        if(track == nullptr){
+            track = claim(name_of_track, name_of_track, 0, false);
+        }
+        add(track, name, begin, end);
+    }
+
+    bool save(const char* path){
+        FILE* file = fopen(path, "wb");
+        if(file == nullptr){
+            return false;
+        }
+        int count = std::min(int(track_count), MAX_TRACKS);
+
+        //every name once, in the order they are first seen
+        std::unordered_map<const char*, std::uint16_t> indexes;
+        std::vector<const char*> names;
+        auto index = [&](const char* name){
+            auto found = indexes.find(name);
+            if(found != indexes.end()){
+                return found->second;
+            }
+            std::uint16_t next = std::uint16_t(names.size());
+            indexes[name] = next;
+            names.push_back(name);
+            return next;
+        };
+
+        FileHeader header;
+        header.tracks = count;
+        header.dropped = untracked;
+        std::vector<TrackHeader> headers(count);
+        std::vector<Span> spans;
+        for(int i = 0; i < count; i++){
+            const Track& track = tracks[i];
+            std::uint32_t written = track.written;
+            std::uint32_t kept = std::min<std::uint32_t>(written, MAX_SPANS);
+            TrackHeader& out = headers[i];
+            std::memcpy(out.name, track.name, strnlen(track.name, sizeof(out.name) - 1));
+            out.priority = track.priority;
+            out.spans = kept;
+            out.overwritten = written - kept;
+            out.task = track.task;
+            for(std::uint32_t n = written - kept; n != written; n++){
+                const Entry& entry = track.spans[n % MAX_SPANS];
+                Span span;
+                span.begin = entry.begin;
+                span.duration = entry.duration;
+                span.name = index(entry.name);
+                spans.push_back(span);
+            }
+        }
+        header.names = names.size();
+
+        bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+        ok &= headers.empty() || fwrite(headers.data(), sizeof(TrackHeader), headers.size(), file) == headers.size();
+        for(const char* name : names){
+            std::uint16_t length = std::uint16_t(strnlen(name, 0xFFFF));
+            ok &= fwrite(&length, sizeof(length), 1, file) == 1;
+            ok &= length == 0 || fwrite(name, length, 1, file) == 1;
+        }
+        ok &= spans.empty() || fwrite(spans.data(), sizeof(Span), spans.size(), file) == spans.size();
+        ok &= fclose(file) == 0;
+        return ok;
+    }
+
+    std::uint32_t dropped(){
+        std::uint32_t lost = untracked;
+        int count = std::min(int(track_count), MAX_TRACKS);
+        for(int i = 0; i < count; i++){
+            std::uint32_t written = tracks[i].written;
+            lost += written - std::min<std::uint32_t>(written, MAX_SPANS);
+        }
+        return lost;
+    }
+
+    Scope::Scope(const char* name) : name(name), begin(on ? pros::micros() : 0){}
+
+    Scope::~Scope(){
+        if(begin != 0){
+            record(name, begin, pros::micros());
+        }
+    }
+}